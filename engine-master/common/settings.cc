@@ -38,9 +38,13 @@ std::string Settings::ToString() const {
   stream << "trace_skia: " << trace_skia << std::endl;
   stream << "trace_startup: " << trace_startup << std::endl;
   stream << "trace_systrace: " << trace_systrace << std::endl;
+  stream << "disable_trace_recorder: " << disable_trace_recorder << std::endl;
+  stream << "trace_recorder_dump_path: " << trace_recorder_dump_path
+         << std::endl;
   stream << "dump_skp_on_shader_compilation: " << dump_skp_on_shader_compilation
          << std::endl;
   stream << "cache_sksl: " << cache_sksl << std::endl;
+  stream << "enable_adaptive_vsync: " << enable_adaptive_vsync << std::endl;
   stream << "endless_trace_buffer: " << endless_trace_buffer << std::endl;
   stream << "enable_dart_profiling: " << enable_dart_profiling << std::endl;
   stream << "disable_dart_asserts: " << disable_dart_asserts << std::endl;
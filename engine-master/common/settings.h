@@ -93,8 +93,15 @@ struct Settings {
   bool trace_skia = false;
   bool trace_startup = false;
   bool trace_systrace = false;
+  bool disable_trace_recorder = false;
+  // If non-empty, the trace recorder is dumped to this file when the process
+  // receives SIGUSR2.
+  std::string trace_recorder_dump_path;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
+  // Predict the cost of frames and adapt the vsyncs on which frames are
+  // started to it. See |AdaptiveVsyncScheduler|.
+  bool enable_adaptive_vsync = false;
   bool endless_trace_buffer = false;
   bool enable_dart_profiling = false;
   bool disable_dart_asserts = false;
@@ -5,6 +5,7 @@
 #include "flutter/flow/instrumentation.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "third_party/skia/include/core/SkPath.h"
@@ -316,4 +317,93 @@ int64_t CounterValues::GetMinValue() const {
   return min;
 }
 
+DurationHistogram::DurationHistogram() {
+  Reset();
+}
+
+DurationHistogram::~DurationHistogram() = default;
+
+void DurationHistogram::Reset() {
+  buckets_.fill(0);
+  count_ = 0;
+  sum_micros_ = 0;
+  min_micros_ = std::numeric_limits<uint64_t>::max();
+  max_micros_ = 0;
+}
+
+size_t DurationHistogram::BucketIndexForValue(uint64_t micros) {
+  if (micros < kSubBucketCount) {
+    return micros;
+  }
+  size_t magnitude = 0;
+  for (uint64_t value = micros; value >= kSubBucketCount * 2; value >>= 1) {
+    magnitude++;
+  }
+  // The top |kSubBucketBits| + 1 bits select the sub-bucket. The leading bit
+  // is always set, so it is dropped from the index.
+  const size_t sub_bucket = (micros >> magnitude) - kSubBucketCount;
+  const size_t index = (magnitude + 1) * kSubBucketCount + sub_bucket;
+  return std::min(index, kBucketCount - 1);
+}
+
+uint64_t DurationHistogram::HighestValueForBucket(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  const size_t magnitude = index / kSubBucketCount - 1;
+  const uint64_t sub_bucket = index % kSubBucketCount + kSubBucketCount;
+  return ((sub_bucket + 1) << magnitude) - 1;
+}
+
+void DurationHistogram::Record(fml::TimeDelta duration) {
+  const uint64_t micros =
+      static_cast<uint64_t>(std::max<int64_t>(duration.ToMicroseconds(), 0));
+  buckets_[BucketIndexForValue(micros)]++;
+  count_++;
+  sum_micros_ += micros;
+  min_micros_ = std::min(min_micros_, micros);
+  max_micros_ = std::max(max_micros_, micros);
+}
+
+fml::TimeDelta DurationHistogram::GetMin() const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  return fml::TimeDelta::FromMicroseconds(min_micros_);
+}
+
+fml::TimeDelta DurationHistogram::GetMax() const {
+  return fml::TimeDelta::FromMicroseconds(max_micros_);
+}
+
+fml::TimeDelta DurationHistogram::GetMean() const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  return fml::TimeDelta::FromMicroseconds(sum_micros_ / count_);
+}
+
+fml::TimeDelta DurationHistogram::GetPercentile(double percentile) const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // The bucket bound may overshoot the largest sample actually seen, and
+      // the last bucket also holds every clamped sample.
+      const uint64_t value =
+          i == kBucketCount - 1
+              ? max_micros_
+              : std::min(HighestValueForBucket(i), max_micros_);
+      return fml::TimeDelta::FromMicroseconds(std::max(value, min_micros_));
+    }
+  }
+  return GetMax();
+}
+
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_INSTRUMENTATION_H_
 #define FLUTTER_FLOW_INSTRUMENTATION_H_
 
+#include <array>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -96,6 +97,70 @@ class CounterValues {
   FML_DISALLOW_COPY_AND_ASSIGN(CounterValues);
 };
 
+//------------------------------------------------------------------------------
+/// A fixed-size, log-linear histogram of durations with microsecond
+/// resolution.
+///
+/// Unlike `Stopwatch`, which keeps the last few laps for the performance
+/// overlay, this keeps every recorded sample (bucketed) for the lifetime of
+/// the histogram so that percentiles can be reported over long runs. Values
+/// are bucketed HDR-style: each power of two is split into
+/// `kSubBucketCount` linear sub-buckets, which bounds the relative error of
+/// any reported value to 1/`kSubBucketCount` while the memory footprint stays
+/// constant. Recording is O(1) and never allocates.
+///
+/// This class is not thread safe. Callers that record and query from
+/// different threads must provide their own synchronization.
+///
+class DurationHistogram {
+ public:
+  DurationHistogram();
+
+  ~DurationHistogram();
+
+  void Record(fml::TimeDelta duration);
+
+  void Reset();
+
+  size_t GetCount() const { return count_; }
+
+  fml::TimeDelta GetMin() const;
+
+  fml::TimeDelta GetMax() const;
+
+  fml::TimeDelta GetMean() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the smallest recorded value such that `percentile`
+  ///             percent of all samples are less than or equal to it. The
+  ///             result is the highest value equivalent to the bucket the
+  ///             percentile falls into, so it never under-reports.
+  ///
+  /// @param[in]  percentile  A percentile in the range [0, 100].
+  ///
+  fml::TimeDelta GetPercentile(double percentile) const;
+
+ private:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBucketCount = 1 << kSubBucketBits;
+  // Durations are tracked up to 2^36 microseconds (a little over 19 hours).
+  // Anything longer is clamped into the last bucket.
+  static constexpr size_t kMaxValueBits = 36;
+  static constexpr size_t kBucketCount =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  static size_t BucketIndexForValue(uint64_t micros);
+  static uint64_t HighestValueForBucket(size_t index);
+
+  std::array<uint64_t, kBucketCount> buckets_;
+  size_t count_;
+  uint64_t sum_micros_;
+  uint64_t min_micros_;
+  uint64_t max_micros_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DurationHistogram);
+};
+
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_INSTRUMENTATION_H_
@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/instrumentation.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(DurationHistogram, EmptyHistogramReportsZero) {
+  DurationHistogram histogram;
+  ASSERT_EQ(histogram.GetCount(), 0u);
+  ASSERT_EQ(histogram.GetMin(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.GetMax(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.GetMean(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.GetPercentile(99), fml::TimeDelta::Zero());
+}
+
+TEST(DurationHistogram, SmallValuesAreExact) {
+  DurationHistogram histogram;
+  for (int64_t i = 1; i <= 10; i++) {
+    histogram.Record(fml::TimeDelta::FromMicroseconds(i));
+  }
+  ASSERT_EQ(histogram.GetCount(), 10u);
+  ASSERT_EQ(histogram.GetMin().ToMicroseconds(), 1);
+  ASSERT_EQ(histogram.GetMax().ToMicroseconds(), 10);
+  ASSERT_EQ(histogram.GetPercentile(50).ToMicroseconds(), 5);
+  ASSERT_EQ(histogram.GetPercentile(90).ToMicroseconds(), 9);
+  ASSERT_EQ(histogram.GetPercentile(100).ToMicroseconds(), 10);
+}
+
+TEST(DurationHistogram, PercentilesStayWithinRelativeError) {
+  DurationHistogram histogram;
+  for (int64_t i = 1; i <= 1000; i++) {
+    histogram.Record(fml::TimeDelta::FromMicroseconds(i * 100));
+  }
+  const auto expect_near = [&](double percentile, int64_t expected) {
+    const int64_t actual = histogram.GetPercentile(percentile).ToMicroseconds();
+    ASSERT_GE(actual, expected);
+    ASSERT_LE(actual, expected + expected / 16);
+  };
+  expect_near(50, 50000);
+  expect_near(90, 90000);
+  expect_near(99, 99000);
+  ASSERT_EQ(histogram.GetPercentile(100).ToMicroseconds(), 100000);
+  ASSERT_EQ(histogram.GetMean().ToMicroseconds(), 50050);
+}
+
+TEST(DurationHistogram, NegativeAndHugeValuesAreClamped) {
+  DurationHistogram histogram;
+  histogram.Record(fml::TimeDelta::FromMicroseconds(-5));
+  histogram.Record(fml::TimeDelta::FromSeconds(100000));
+  ASSERT_EQ(histogram.GetCount(), 2u);
+  ASSERT_EQ(histogram.GetMin(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.GetPercentile(100), fml::TimeDelta::FromSeconds(100000));
+}
+
+TEST(DurationHistogram, ResetClearsSamples) {
+  DurationHistogram histogram;
+  histogram.Record(fml::TimeDelta::FromMilliseconds(16));
+  histogram.Reset();
+  ASSERT_EQ(histogram.GetCount(), 0u);
+  ASSERT_EQ(histogram.GetPercentile(50), fml::TimeDelta::Zero());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -21,9 +21,13 @@ LayerTree::LayerTree(const SkISize& frame_size,
       checkerboard_raster_cache_images_(false),
       checkerboard_offscreen_layers_(false) {}
 
-void LayerTree::RecordBuildTime(fml::TimePoint start) {
-  build_start_ = start;
+void LayerTree::RecordBuildTime(fml::TimePoint vsync_start,
+                                fml::TimePoint build_start,
+                                fml::TimePoint target_time) {
+  vsync_start_ = vsync_start;
+  build_start_ = build_start;
   build_finish_ = fml::TimePoint::Now();
+  target_time_ = target_time;
 }
 
 bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
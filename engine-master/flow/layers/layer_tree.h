@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer.h"
@@ -53,10 +54,40 @@ class LayerTree {
   float frame_physical_depth() const { return frame_physical_depth_; }
   float frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; }
 
-  void RecordBuildTime(fml::TimePoint begin_start);
+  // Notes the vsync that produced this layer tree, the time at which the
+  // framework started building it and the time by which it should have been
+  // presented. The build is assumed to have finished now.
+  void RecordBuildTime(fml::TimePoint vsync_start,
+                       fml::TimePoint build_start,
+                       fml::TimePoint target_time);
+  fml::TimePoint vsync_start() const { return vsync_start_; }
   fml::TimePoint build_start() const { return build_start_; }
   fml::TimePoint build_finish() const { return build_finish_; }
-  fml::TimeDelta build_time() const { return build_finish_ - build_start_; }
+  fml::TimePoint target_time() const { return target_time_; }
+  // As in |FrameTiming| and the performance overlay, the build phase is
+  // measured from the vsync rather than from |build_start|.
+  fml::TimeDelta build_time() const { return build_finish_ - vsync_start_; }
+
+  // Whether the root isolate collected garbage while this layer tree was being
+  // built. Used to attribute jank.
+  void set_collected_garbage_during_build(bool collected_garbage) {
+    collected_garbage_during_build_ = collected_garbage;
+  }
+
+  bool collected_garbage_during_build() const {
+    return collected_garbage_during_build_;
+  }
+
+  // The "PointerEvent" trace flow ids of the input events whose handling
+  // produced this layer tree. The rasterizer ends these flows once the frame
+  // has been submitted.
+  void set_pointer_trace_flow_ids(std::vector<uint64_t> trace_flow_ids) {
+    pointer_trace_flow_ids_ = std::move(trace_flow_ids);
+  }
+
+  const std::vector<uint64_t>& pointer_trace_flow_ids() const {
+    return pointer_trace_flow_ids_;
+  }
 
   // The number of frame intervals missed after which the compositor must
   // trace the rasterized picture to a trace file. Specify 0 to disable all
@@ -81,8 +112,12 @@ class LayerTree {
 
  private:
   std::shared_ptr<Layer> root_layer_;
+  fml::TimePoint vsync_start_;
   fml::TimePoint build_start_;
   fml::TimePoint build_finish_;
+  fml::TimePoint target_time_;
+  bool collected_garbage_during_build_ = false;
+  std::vector<uint64_t> pointer_trace_flow_ids_;
   SkISize frame_size_ = SkISize::MakeEmpty();  // Physical pixels.
   float frame_physical_depth_;
   float frame_device_pixel_ratio_ = 1.0f;  // Logical / Physical pixels ratio.
@@ -182,6 +182,7 @@ void RasterCache::Prepare(PrerollContext* context,
             layer->Paint(paintContext);
           }
         });
+    population_count_++;
   }
 }
 
@@ -223,6 +224,7 @@ bool RasterCache::Prepare(GrContext* context,
     entry.image = RasterizePicture(picture, context, transformation_matrix,
                                    dst_color_space, checkerboard_images_);
     picture_cached_this_frame_++;
+    population_count_++;
   }
   return true;
 }
@@ -258,6 +260,10 @@ size_t RasterCache::GetCachedEntriesCount() const {
   return layer_cache_.size() + picture_cache_.size();
 }
 
+size_t RasterCache::GetPopulationCount() const {
+  return population_count_;
+}
+
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   if (checkerboard_images_ == checkerboard) {
     return;
@@ -102,6 +102,11 @@ class RasterCache {
 
   size_t GetCachedEntriesCount() const;
 
+  // The number of pictures and layers rasterized into the cache since it was
+  // created. Populating the cache is expensive, so an increase of this count
+  // during a frame is a likely cause of jank.
+  size_t GetPopulationCount() const;
+
  private:
   struct Entry {
     bool used_this_frame = false;
@@ -129,6 +134,7 @@ class RasterCache {
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
   size_t picture_cached_this_frame_ = 0;
+  size_t population_count_ = 0;
   PictureRasterCacheKey::Map<Entry> picture_cache_;
   LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
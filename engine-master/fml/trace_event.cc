@@ -10,6 +10,7 @@
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 namespace tracing {
@@ -34,9 +35,12 @@ void TraceTimelineEvent(TraceArg category_group,
     c_values[i] = values[i].c_str();
   }
 
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, type, category_group, name, identifier,
+                        argument_count, c_names.data(), c_values.data());
   Dart_TimelineEvent(
       name,                                      // label
-      Dart_TimelineGetMicros(),                  // timestamp0
+      timestamp,                                 // timestamp0
       identifier,                                // timestamp1_or_async_id
       type,                                      // event type
       argument_count,                            // argument_count
@@ -46,8 +50,11 @@ void TraceTimelineEvent(TraceArg category_group,
 }
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Begin, category_group,
+                        name, 0, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
+                     timestamp,                  // timestamp0
                      0,                          // timestamp1_or_async_id
                      Dart_Timeline_Event_Begin,  // event type
                      0,                          // argument_count
@@ -62,8 +69,11 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Begin, category_group,
+                        name, 0, 1, arg_names, arg_values);
   Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
+                     timestamp,                  // timestamp0
                      0,                          // timestamp1_or_async_id
                      Dart_Timeline_Event_Begin,  // event type
                      1,                          // argument_count
@@ -80,8 +90,11 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Begin, category_group,
+                        name, 0, 2, arg_names, arg_values);
   Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
+                     timestamp,                  // timestamp0
                      0,                          // timestamp1_or_async_id
                      Dart_Timeline_Event_Begin,  // event type
                      2,                          // argument_count
@@ -91,13 +104,16 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
-  Dart_TimelineEvent(name,                      // label
-                     Dart_TimelineGetMicros(),  // timestamp0
-                     0,                         // timestamp1_or_async_id
-                     Dart_Timeline_Event_End,   // event type
-                     0,                         // argument_count
-                     nullptr,                   // argument_names
-                     nullptr                    // argument_values
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_End, "", name, 0, 0,
+                        nullptr, nullptr);
+  Dart_TimelineEvent(name,                     // label
+                     timestamp,                // timestamp0
+                     0,                        // timestamp1_or_async_id
+                     Dart_Timeline_Event_End,  // event type
+                     0,                        // argument_count
+                     nullptr,                  // argument_names
+                     nullptr                   // argument_values
   );
 }
 
@@ -111,6 +127,9 @@ void TraceEventAsyncComplete(TraceArg category_group,
     std::swap(begin, end);
   }
 
+  TraceRecorder::Record(begin.ToEpochDelta().ToMicroseconds(),
+                        Dart_Timeline_Event_Async_Begin, category_group, name,
+                        identifier, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                                   // label
                      begin.ToEpochDelta().ToMicroseconds(),  // timestamp0
                      identifier,                       // timestamp1_or_async_id
@@ -119,6 +138,9 @@ void TraceEventAsyncComplete(TraceArg category_group,
                      nullptr,                          // argument_names
                      nullptr                           // argument_values
   );
+  TraceRecorder::Record(end.ToEpochDelta().ToMicroseconds(),
+                        Dart_Timeline_Event_Async_End, category_group, name,
+                        identifier, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                                 // label
                      end.ToEpochDelta().ToMicroseconds(),  // timestamp0
                      identifier,                     // timestamp1_or_async_id
@@ -132,8 +154,11 @@ void TraceEventAsyncComplete(TraceArg category_group,
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Async_Begin,
+                        category_group, name, id, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                             // label
-                     Dart_TimelineGetMicros(),         // timestamp0
+                     timestamp,                        // timestamp0
                      id,                               // timestamp1_or_async_id
                      Dart_Timeline_Event_Async_Begin,  // event type
                      0,                                // argument_count
@@ -145,8 +170,11 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Async_End,
+                        category_group, name, id, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                           // label
-                     Dart_TimelineGetMicros(),       // timestamp0
+                     timestamp,                      // timestamp0
                      id,                             // timestamp1_or_async_id
                      Dart_Timeline_Event_Async_End,  // event type
                      0,                              // argument_count
@@ -162,8 +190,11 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Async_Begin,
+                        category_group, name, id, 1, arg_names, arg_values);
   Dart_TimelineEvent(name,                             // label
-                     Dart_TimelineGetMicros(),         // timestamp0
+                     timestamp,                        // timestamp0
                      id,                               // timestamp1_or_async_id
                      Dart_Timeline_Event_Async_Begin,  // event type
                      1,                                // argument_count
@@ -179,8 +210,11 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Async_End,
+                        category_group, name, id, 1, arg_names, arg_values);
   Dart_TimelineEvent(name,                           // label
-                     Dart_TimelineGetMicros(),       // timestamp0
+                     timestamp,                      // timestamp0
                      id,                             // timestamp1_or_async_id
                      Dart_Timeline_Event_Async_End,  // event type
                      1,                              // argument_count
@@ -190,8 +224,11 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Instant, category_group,
+                        name, 0, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                         // label
-                     Dart_TimelineGetMicros(),     // timestamp0
+                     timestamp,                    // timestamp0
                      0,                            // timestamp1_or_async_id
                      Dart_Timeline_Event_Instant,  // event type
                      0,                            // argument_count
@@ -203,8 +240,11 @@ void TraceEventInstant0(TraceArg category_group, TraceArg name) {
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Flow_Begin,
+                        category_group, name, id, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                            // label
-                     Dart_TimelineGetMicros(),        // timestamp0
+                     timestamp,                       // timestamp0
                      id,                              // timestamp1_or_async_id
                      Dart_Timeline_Event_Flow_Begin,  // event type
                      0,                               // argument_count
@@ -216,8 +256,11 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Flow_Step,
+                        category_group, name, id, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                           // label
-                     Dart_TimelineGetMicros(),       // timestamp0
+                     timestamp,                      // timestamp0
                      id,                             // timestamp1_or_async_id
                      Dart_Timeline_Event_Flow_Step,  // event type
                      0,                              // argument_count
@@ -227,8 +270,11 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
+  const int64_t timestamp = Dart_TimelineGetMicros();
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Flow_End, category_group,
+                        name, id, 0, nullptr, nullptr);
   Dart_TimelineEvent(name,                          // label
-                     Dart_TimelineGetMicros(),      // timestamp0
+                     timestamp,                     // timestamp0
                      id,                            // timestamp1_or_async_id
                      Dart_Timeline_Event_Flow_End,  // event type
                      0,                             // argument_count
@@ -0,0 +1,581 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/thread_local.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "flutter/fml/eintr_wrapper.h"
+#endif  // defined(OS_POSIX)
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <sys/syscall.h>
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+// At 64 bytes a record, each thread that emits trace events uses 256 KiB.
+constexpr size_t kRecordsPerThread = 4096;
+constexpr size_t kMaxThreadBuffers = 128;
+constexpr size_t kMaxInternedStrings = 4096;
+constexpr size_t kMaxRecordArguments = 2;
+constexpr size_t kInternCacheSize = 64;
+
+// String id 0 is reserved for strings that could not be interned.
+constexpr uint16_t kDroppedStringID = 0;
+
+// Argument values (counter values, formatted deadlines and the like) are
+// different for almost every event, so they are copied into the record
+// instead of being interned. Each is NUL terminated.
+struct TraceRecord {
+  int64_t timestamp_micros;
+  int64_t id;
+  uint16_t category;
+  uint16_t name;
+  uint16_t argument_names[kMaxRecordArguments];
+  uint8_t type;
+  uint8_t argument_count;
+  char argument_values[kMaxRecordArguments]
+                      [TraceRecorder::kMaxArgumentValueLength + 1];
+};
+
+static_assert(sizeof(TraceRecord) == 64, "Trace records must stay compact.");
+
+// A ring buffer written by exactly one thread at a time and read by dumps on
+// any thread. Readers copy a record and then check (seqlock style) that the
+// writer has not started overwriting it in the meantime.
+struct ThreadBuffer {
+  std::atomic<bool> in_use = {false};
+  std::atomic<uint64_t> thread_id = {0};
+  // The number of records written to this buffer since it was last acquired.
+  // The next record goes into |records[head % kRecordsPerThread]|.
+  std::atomic<uint64_t> head = {0};
+  TraceRecord records[kRecordsPerThread];
+};
+
+// All globals below are constant initialized so that they can be accessed by
+// a signal handler at any point in the life of the process.
+std::atomic<bool> gEnabled = {true};
+
+std::mutex gThreadBuffersMutex;
+std::atomic<ThreadBuffer*> gThreadBuffers[kMaxThreadBuffers];
+std::atomic<size_t> gThreadBufferCount = {0};
+
+std::mutex gStringsMutex;
+std::atomic<const char*> gStrings[kMaxInternedStrings];
+std::atomic<size_t> gStringCount = {kDroppedStringID + 1};
+
+uint64_t CurrentThreadID() {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  return static_cast<uint64_t>(syscall(__NR_gettid));
+#else
+  return std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+}
+
+uint16_t InternString(const char* string) {
+  std::scoped_lock lock(gStringsMutex);
+  static auto* ids = new std::unordered_map<std::string_view, uint16_t>();
+
+  auto found = ids->find(string);
+  if (found != ids->end()) {
+    return found->second;
+  }
+
+  const size_t count = gStringCount.load(std::memory_order_relaxed);
+  if (count >= kMaxInternedStrings) {
+    return kDroppedStringID;
+  }
+
+  // Interned strings are never collected.
+  const size_t length = strlen(string);
+  char* copy = new char[length + 1];
+  memcpy(copy, string, length + 1);
+  gStrings[count].store(copy, std::memory_order_release);
+  gStringCount.store(count + 1, std::memory_order_release);
+  (*ids)[std::string_view{copy, length}] = count;
+  return count;
+}
+
+ThreadBuffer* AcquireThreadBuffer() {
+  std::scoped_lock lock(gThreadBuffersMutex);
+  const size_t count = gThreadBufferCount.load(std::memory_order_relaxed);
+
+  // Reuse the buffer of a thread that has exited. Its records are discarded.
+  ThreadBuffer* buffer = nullptr;
+  for (size_t i = 0; i < count; i++) {
+    auto* candidate = gThreadBuffers[i].load(std::memory_order_relaxed);
+    if (!candidate->in_use.load(std::memory_order_acquire)) {
+      buffer = candidate;
+      break;
+    }
+  }
+
+  if (buffer == nullptr) {
+    if (count == kMaxThreadBuffers) {
+      return nullptr;
+    }
+    buffer = new ThreadBuffer();
+    gThreadBuffers[count].store(buffer, std::memory_order_release);
+    gThreadBufferCount.store(count + 1, std::memory_order_release);
+  }
+
+  buffer->in_use.store(true, std::memory_order_relaxed);
+  buffer->thread_id.store(CurrentThreadID(), std::memory_order_relaxed);
+  buffer->head.store(0, std::memory_order_release);
+  return buffer;
+}
+
+// The per-thread state of the recorder. Owns the ring buffer of the thread
+// for as long as the thread is alive.
+class ThreadRecorder {
+ public:
+  ThreadRecorder() : buffer_(AcquireThreadBuffer()) {}
+
+  ~ThreadRecorder() {
+    if (buffer_ != nullptr) {
+      buffer_->in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  ThreadBuffer* buffer() const { return buffer_; }
+
+  uint16_t Intern(const char* string) {
+    if (string == nullptr) {
+      return kDroppedStringID;
+    }
+    // Trace event names are almost always string literals, so a cache keyed by
+    // address avoids taking the string table lock. The contents still need to
+    // be compared because a name may be formatted into a reused buffer.
+    auto& entry = cache_[(reinterpret_cast<uintptr_t>(string) >> 3) %
+                         kInternCacheSize];
+    if (entry.string == string) {
+      const char* interned = gStrings[entry.id].load(std::memory_order_relaxed);
+      if (interned != nullptr && strcmp(interned, string) == 0) {
+        return entry.id;
+      }
+    }
+    entry.string = string;
+    entry.id = InternString(string);
+    return entry.id;
+  }
+
+ private:
+  struct CacheEntry {
+    const char* string = nullptr;
+    uint16_t id = kDroppedStringID;
+  };
+
+  ThreadBuffer* const buffer_;
+  CacheEntry cache_[kInternCacheSize];
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadRecorder);
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadRecorder> tls_thread_recorder;
+
+// Serializes the dump. The file descriptor variant must not allocate so
+// everything is written through a small fixed size buffer.
+class TraceWriter {
+ public:
+  virtual ~TraceWriter() = default;
+
+  bool ok() const { return ok_; }
+
+  void Write(const char* data, size_t length) {
+    while (length > 0) {
+      if (used_ == sizeof(buffer_)) {
+        Flush();
+      }
+      const size_t chunk = std::min(length, sizeof(buffer_) - used_);
+      memcpy(buffer_ + used_, data, chunk);
+      used_ += chunk;
+      data += chunk;
+      length -= chunk;
+    }
+  }
+
+  void Write(const char* string) { Write(string, strlen(string)); }
+
+  void WriteInteger(int64_t value) {
+    char digits[24];
+    size_t count = 0;
+    uint64_t magnitude = value < 0 ? -static_cast<uint64_t>(value) : value;
+    do {
+      digits[sizeof(digits) - ++count] = '0' + magnitude % 10;
+      magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+      digits[sizeof(digits) - ++count] = '-';
+    }
+    Write(digits + sizeof(digits) - count, count);
+  }
+
+  void WriteHex(uint64_t value) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    char digits[16];
+    size_t count = 0;
+    do {
+      digits[sizeof(digits) - ++count] = kHexDigits[value & 0xf];
+      value >>= 4;
+    } while (value != 0);
+    Write("0x");
+    Write(digits + sizeof(digits) - count, count);
+  }
+
+  void WriteQuoted(const char* string) {
+    Write("\"");
+    for (const char* c = string; *c != '\0'; c++) {
+      const unsigned char character = static_cast<unsigned char>(*c);
+      if (character == '"' || character == '\\') {
+        const char escaped[] = {'\\', static_cast<char>(character)};
+        Write(escaped, sizeof(escaped));
+      } else if (character < 0x20) {
+        static const char kHexDigits[] = "0123456789abcdef";
+        const char escaped[] = {'\\', 'u', '0', '0', kHexDigits[character >> 4],
+                                kHexDigits[character & 0xf]};
+        Write(escaped, sizeof(escaped));
+      } else {
+        Write(c, 1);
+      }
+    }
+    Write("\"");
+  }
+
+  void Flush() {
+    if (used_ > 0) {
+      ok_ = Emit(buffer_, used_) && ok_;
+      used_ = 0;
+    }
+  }
+
+ protected:
+  virtual bool Emit(const char* data, size_t length) = 0;
+
+ private:
+  char buffer_[1024];
+  size_t used_ = 0;
+  bool ok_ = true;
+};
+
+class StringTraceWriter final : public TraceWriter {
+ public:
+  StringTraceWriter(std::string& string) : string_(string) {}
+
+  ~StringTraceWriter() override = default;
+
+ private:
+  std::string& string_;
+
+  // |TraceWriter|
+  bool Emit(const char* data, size_t length) override {
+    string_.append(data, length);
+    return true;
+  }
+};
+
+#if defined(OS_POSIX)
+class FileDescriptorTraceWriter final : public TraceWriter {
+ public:
+  FileDescriptorTraceWriter(int fd) : fd_(fd) {}
+
+  ~FileDescriptorTraceWriter() override = default;
+
+ private:
+  const int fd_;
+
+  // |TraceWriter|
+  bool Emit(const char* data, size_t length) override {
+    while (length > 0) {
+      const ssize_t written = FML_HANDLE_EINTR(::write(fd_, data, length));
+      if (written <= 0) {
+        return false;
+      }
+      data += written;
+      length -= written;
+    }
+    return true;
+  }
+};
+#endif  // defined(OS_POSIX)
+
+const char* StringForID(uint16_t id) {
+  const char* string = id < kMaxInternedStrings
+                           ? gStrings[id].load(std::memory_order_acquire)
+                           : nullptr;
+  return string != nullptr ? string : "<dropped>";
+}
+
+const char* PhaseForType(uint8_t type) {
+  switch (static_cast<Dart_Timeline_Event_Type>(type)) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+  }
+  return "i";
+}
+
+bool IsNumber(const char* string) {
+  if (*string == '-') {
+    string++;
+  }
+  if (*string == '\0') {
+    return false;
+  }
+  for (; *string != '\0'; string++) {
+    if ((*string < '0' || *string > '9') && *string != '.') {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WriteRecord(TraceWriter& writer,
+                 const TraceRecord& record,
+                 int64_t pid,
+                 uint64_t tid) {
+  const auto type = static_cast<Dart_Timeline_Event_Type>(record.type);
+  writer.Write("{\"name\":");
+  writer.WriteQuoted(StringForID(record.name));
+  writer.Write(",\"cat\":");
+  writer.WriteQuoted(StringForID(record.category));
+  writer.Write(",\"ph\":\"");
+  writer.Write(PhaseForType(record.type));
+  writer.Write("\",\"ts\":");
+  writer.WriteInteger(record.timestamp_micros);
+  writer.Write(",\"pid\":");
+  writer.WriteInteger(pid);
+  writer.Write(",\"tid\":");
+  writer.WriteInteger(static_cast<int64_t>(tid));
+  switch (type) {
+    case Dart_Timeline_Event_Async_Begin:
+    case Dart_Timeline_Event_Async_End:
+    case Dart_Timeline_Event_Async_Instant:
+    case Dart_Timeline_Event_Counter:
+    case Dart_Timeline_Event_Flow_Begin:
+    case Dart_Timeline_Event_Flow_Step:
+    case Dart_Timeline_Event_Flow_End:
+      writer.Write(",\"id\":\"");
+      writer.WriteHex(static_cast<uint64_t>(record.id));
+      writer.Write("\"");
+      break;
+    default:
+      break;
+  }
+  if (type == Dart_Timeline_Event_Flow_End) {
+    // Bind the end of the flow to the enclosing slice.
+    writer.Write(",\"bp\":\"e\"");
+  } else if (type == Dart_Timeline_Event_Instant) {
+    writer.Write(",\"s\":\"t\"");
+  }
+  if (record.argument_count > 0) {
+    writer.Write(",\"args\":{");
+    for (size_t i = 0; i < record.argument_count; i++) {
+      if (i > 0) {
+        writer.Write(",");
+      }
+      writer.WriteQuoted(StringForID(record.argument_names[i]));
+      writer.Write(":");
+      const char* value = record.argument_values[i];
+      // The trace viewer only plots numeric counter values.
+      if (type == Dart_Timeline_Event_Counter && IsNumber(value)) {
+        writer.Write(value);
+      } else {
+        writer.WriteQuoted(value);
+      }
+    }
+    writer.Write("}");
+  }
+  writer.Write("}");
+}
+
+void WriteChromeTrace(TraceWriter& writer) {
+#if defined(OS_POSIX)
+  const int64_t pid = getpid();
+#else
+  const int64_t pid = 0;
+#endif  // defined(OS_POSIX)
+
+  bool first = true;
+  writer.Write("{\"traceEvents\":[");
+  const size_t buffer_count =
+      gThreadBufferCount.load(std::memory_order_acquire);
+  for (size_t i = 0; i < buffer_count; i++) {
+    const ThreadBuffer* buffer =
+        gThreadBuffers[i].load(std::memory_order_acquire);
+    const uint64_t tid = buffer->thread_id.load(std::memory_order_relaxed);
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t tail =
+        head > kRecordsPerThread ? head - kRecordsPerThread : 0;
+    for (uint64_t index = tail; index < head; index++) {
+      const TraceRecord record = buffer->records[index % kRecordsPerThread];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // Discard the copy if the writer may have overwritten the slot while it
+      // was being read or if the buffer was handed to a new thread.
+      const uint64_t current = buffer->head.load(std::memory_order_relaxed);
+      if (index >= current || index + kRecordsPerThread <= current) {
+        continue;
+      }
+      if (!first) {
+        writer.Write(",");
+      }
+      first = false;
+      WriteRecord(writer, record, pid, tid);
+    }
+  }
+  writer.Write("]}");
+  writer.Flush();
+}
+
+#if defined(OS_POSIX)
+char gDumpSignalPath[4096];
+
+void OnDumpSignal(int signal) {
+  const int fd = FML_HANDLE_EINTR(
+      ::open(gDumpSignalPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd < 0) {
+    return;
+  }
+  TraceRecorder::DumpChromeTrace(fd);
+  ::close(fd);
+}
+#endif  // defined(OS_POSIX)
+
+}  // namespace
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::IsEnabled() {
+  return gEnabled.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::Record(int64_t timestamp_micros,
+                           Dart_Timeline_Event_Type type,
+                           const char* category_group,
+                           const char* name,
+                           int64_t id,
+                           size_t argument_count,
+                           const char* const* argument_names,
+                           const char* const* argument_values) {
+  if (!gEnabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  auto* recorder = tls_thread_recorder.get();
+  if (recorder == nullptr) {
+    recorder = new ThreadRecorder();
+    tls_thread_recorder.reset(recorder);
+  }
+
+  ThreadBuffer* buffer = recorder->buffer();
+  if (buffer == nullptr) {
+    return;
+  }
+
+  const uint64_t index = buffer->head.load(std::memory_order_relaxed);
+  // Pairs with the fence in |WriteChromeTrace| so that a reader that observes
+  // any part of this record also observes that |head| has moved past the
+  // record previously held by the slot.
+  std::atomic_thread_fence(std::memory_order_release);
+
+  TraceRecord& record = buffer->records[index % kRecordsPerThread];
+  record.timestamp_micros = timestamp_micros;
+  record.id = id;
+  record.category = recorder->Intern(category_group);
+  record.name = recorder->Intern(name);
+  record.type = static_cast<uint8_t>(type);
+  record.argument_count = std::min(argument_count, kMaxRecordArguments);
+  for (size_t i = 0; i < record.argument_count; i++) {
+    record.argument_names[i] = recorder->Intern(argument_names[i]);
+    char* value = record.argument_values[i];
+    size_t length = 0;
+    if (argument_values[i] != nullptr) {
+      for (; length < kMaxArgumentValueLength &&
+             argument_values[i][length] != '\0';
+           length++) {
+        value[length] = argument_values[i][length];
+      }
+    }
+    value[length] = '\0';
+  }
+
+  buffer->head.store(index + 1, std::memory_order_release);
+}
+
+std::string TraceRecorder::DumpChromeTrace() {
+  std::string trace;
+  StringTraceWriter writer(trace);
+  WriteChromeTrace(writer);
+  return trace;
+}
+
+bool TraceRecorder::DumpChromeTrace(int fd) {
+#if defined(OS_POSIX)
+  FileDescriptorTraceWriter writer(fd);
+  WriteChromeTrace(writer);
+  return writer.ok();
+#else
+  return false;
+#endif  // defined(OS_POSIX)
+}
+
+bool TraceRecorder::InstallDumpSignalHandler(int signal,
+                                             const std::string& path) {
+#if defined(OS_POSIX)
+  if (path.empty() || path.size() >= sizeof(gDumpSignalPath)) {
+    return false;
+  }
+  memcpy(gDumpSignalPath, path.c_str(), path.size() + 1);
+
+  struct sigaction action = {};
+  action.sa_handler = &OnDumpSignal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return ::sigaction(signal, &action, nullptr) == 0;
+#else
+  return false;
+#endif  // defined(OS_POSIX)
+}
+
+}  // namespace tracing
+}  // namespace fml
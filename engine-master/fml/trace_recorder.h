@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+//------------------------------------------------------------------------------
+/// An always-on flight recorder for the events emitted by the `TRACE_EVENT*`,
+/// `TRACE_FLOW*` and `FML_TRACE_COUNTER` macros.
+///
+/// The Dart timeline only records events while it is enabled, and formats each
+/// event into a JSON oriented block as it is recorded. That is far too costly
+/// to leave on in the field. Instead, the recorder keeps the most recent events
+/// of each thread in a fixed-size ring buffer of compact binary records. The
+/// categories, names and argument names of events are interned into a process
+/// wide string table, and argument values are copied into the record itself,
+/// so that a record is only a timestamp, an id, a handful of string ids and
+/// two short values. Recording never allocates and never takes a lock on the
+/// common path.
+///
+/// When jank is observed in the field, the contents of all buffers can be
+/// dumped on demand in the Chrome trace event format (which is also accepted
+/// by Perfetto), either through the service protocol or from a signal handler.
+///
+/// Argument values longer than `kMaxArgumentValueLength` characters are
+/// truncated. Names that do not fit in the string table any more are recorded
+/// as "<dropped>".
+///
+class TraceRecorder {
+ public:
+  static constexpr size_t kMaxArgumentValueLength = 18;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Enables or disables recording. Recording is enabled by
+  ///             default. Events already recorded are retained.
+  ///
+  static void SetEnabled(bool enabled);
+
+  static bool IsEnabled();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records a single trace event into the ring buffer of the
+  ///             calling thread. Only the first two arguments are recorded.
+  ///
+  /// @param[in]  timestamp_micros  The timestamp of the event on the timeline
+  ///                               clock (see `Dart_TimelineGetMicros`).
+  ///
+  static void Record(int64_t timestamp_micros,
+                     Dart_Timeline_Event_Type type,
+                     const char* category_group,
+                     const char* name,
+                     int64_t id,
+                     size_t argument_count,
+                     const char* const* argument_names,
+                     const char* const* argument_values);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Dumps the contents of all thread buffers in the Chrome trace
+  ///             event JSON format.
+  ///
+  static std::string DumpChromeTrace();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the same dump as `DumpChromeTrace` to the given file
+  ///             descriptor. Unlike `DumpChromeTrace`, this call does not
+  ///             allocate and is async-signal-safe.
+  ///
+  /// @return     If all bytes of the dump could be written.
+  ///
+  static bool DumpChromeTrace(int fd);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Installs a handler for `signal` that dumps the recorder to the
+  ///             file at `path` (truncating it). This is only supported on
+  ///             POSIX platforms.
+  ///
+  /// @return     If the signal handler could be installed.
+  ///
+  static bool InstallDumpSignalHandler(int signal, const std::string& path);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+static void RecordBegin(int64_t timestamp, const char* name) {
+  TraceRecorder::Record(timestamp, Dart_Timeline_Event_Begin, "flutter", name,
+                        0, 0, nullptr, nullptr);
+}
+
+static bool Contains(const std::string& haystack, const std::string& needle) {
+  return haystack.find(needle) != std::string::npos;
+}
+
+TEST(TraceRecorderTest, DumpsRecordedEventsInChromeTraceFormat) {
+  RecordBegin(1234, "TraceRecorderTest::Event");
+  const char* arg_names[] = {"mode", "frame"};
+  const char* arg_values[] = {"basic", "\"odd\""};
+  TraceRecorder::Record(1235, Dart_Timeline_Event_Flow_End, "flutter",
+                        "TraceRecorderTest::Flow", 42, 2, arg_names,
+                        arg_values);
+
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+  ASSERT_TRUE(Contains(trace,
+                       "{\"name\":\"TraceRecorderTest::Event\",\"cat\":"
+                       "\"flutter\",\"ph\":\"B\",\"ts\":1234,"));
+  ASSERT_TRUE(Contains(trace, "\"ph\":\"f\",\"ts\":1235,"));
+  ASSERT_TRUE(Contains(trace,
+                       "\"id\":\"0x2a\",\"bp\":\"e\",\"args\":{\"mode\":"
+                       "\"basic\",\"frame\":\"\\\"odd\\\"\"}}"));
+  ASSERT_EQ(trace.substr(trace.size() - 2), "]}");
+}
+
+TEST(TraceRecorderTest, CounterValuesAreNumeric) {
+  const char* arg_names[] = {"frames in flight"};
+  const char* arg_values[] = {"2"};
+  TraceRecorder::Record(99, Dart_Timeline_Event_Counter, "flutter",
+                        "TraceRecorderTest::Counter", 7, 1, arg_names,
+                        arg_values);
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_TRUE(Contains(trace, "\"args\":{\"frames in flight\":2}"));
+}
+
+TEST(TraceRecorderTest, RingBufferKeepsMostRecentEvents) {
+  // Use a fresh thread so that events recorded by other tests do not count.
+  std::thread thread([] {
+    for (int64_t i = 0; i < 10000; i++) {
+      TraceRecorder::Record(i, Dart_Timeline_Event_Async_Begin, "flutter",
+                            "TraceRecorderTest::Ring", i, 0, nullptr, nullptr);
+    }
+  });
+  thread.join();
+
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_TRUE(Contains(trace, "\"ts\":9999,"));
+  ASSERT_FALSE(Contains(trace, "\"ts\":0,"));
+  ASSERT_FALSE(Contains(trace, "\"ts\":5000,"));
+}
+
+TEST(TraceRecorderTest, DisabledRecorderDropsEvents) {
+  TraceRecorder::SetEnabled(false);
+  RecordBegin(1, "TraceRecorderTest::Disabled");
+  TraceRecorder::SetEnabled(true);
+  ASSERT_TRUE(TraceRecorder::IsEnabled());
+  ASSERT_FALSE(Contains(TraceRecorder::DumpChromeTrace(),
+                        "TraceRecorderTest::Disabled"));
+}
+
+TEST(TraceRecorderTest, ArgumentValuesAreCopiedIntoRecords) {
+  char value[8] = "first";
+  const char* arg_names[] = {"value"};
+  const char* arg_values[] = {value};
+  TraceRecorder::Record(10, Dart_Timeline_Event_Instant, "flutter",
+                        "TraceRecorderTest::Reused", 0, 1, arg_names,
+                        arg_values);
+  strcpy(value, "second");
+  TraceRecorder::Record(11, Dart_Timeline_Event_Instant, "flutter",
+                        "TraceRecorderTest::Reused", 0, 1, arg_names,
+                        arg_values);
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_TRUE(Contains(trace, "{\"value\":\"first\"}"));
+  ASSERT_TRUE(Contains(trace, "{\"value\":\"second\"}"));
+}
+
+TEST(TraceRecorderTest, DistinctArgumentValuesDoNotFillStringTable) {
+  const char* arg_names[] = {"MBytes"};
+  for (int i = 0; i < 10000; i++) {
+    const std::string value = std::to_string(i);
+    const char* arg_values[] = {value.c_str()};
+    TraceRecorder::Record(100 + i, Dart_Timeline_Event_Counter, "flutter",
+                          "TraceRecorderTest::Distinct", 0, 1, arg_names,
+                          arg_values);
+  }
+  RecordBegin(20000, "TraceRecorderTest::AfterDistinctValues");
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_TRUE(Contains(trace, "{\"MBytes\":9999}"));
+  ASSERT_TRUE(Contains(trace, "\"TraceRecorderTest::AfterDistinctValues\""));
+}
+
+TEST(TraceRecorderTest, LongArgumentValuesAreTruncated) {
+  const char* arg_names[] = {"deadline"};
+  const char* arg_values[] = {"0123456789012345678901234"};
+  TraceRecorder::Record(30000, Dart_Timeline_Event_Instant, "flutter",
+                        "TraceRecorderTest::Long", 0, 1, arg_names,
+                        arg_values);
+  const auto trace = TraceRecorder::DumpChromeTrace();
+  ASSERT_TRUE(Contains(trace, "{\"deadline\":\"012345678901234567\"}"));
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
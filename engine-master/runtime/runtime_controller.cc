@@ -10,6 +10,7 @@
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/runtime_delegate.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/tonic/dart_message_handler.h"
 
 namespace flutter {
@@ -389,6 +390,24 @@ std::pair<bool, uint32_t> RuntimeController::GetRootIsolateReturnCode() {
   return root_isolate_return_code_;
 }
 
+int64_t RuntimeController::GetRootIsolateGCCount() {
+  std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock();
+  if (!root_isolate) {
+    return -1;
+  }
+  Dart_Isolate isolate = root_isolate->isolate();
+  int64_t count = 0;
+  for (auto kind :
+       {Dart_GCHistogram_ScavengePause, Dart_GCHistogram_OldSpacePause}) {
+    Dart_GCHistogram histogram;
+    if (!Dart_IsolateGCHistogram(isolate, kind, &histogram)) {
+      return -1;
+    }
+    count += histogram.count;
+  }
+  return count;
+}
+
 RuntimeController::Locale::Locale(std::string language_code_,
                                   std::string country_code_,
                                   std::string script_code_,
@@ -88,6 +88,11 @@ class RuntimeController final : public WindowClient {
 
   std::pair<bool, uint32_t> GetRootIsolateReturnCode();
 
+  // The number of garbage collections (scavenges and old space collections) of
+  // the root isolate heap so far, or -1 if there is no root isolate. Unlike
+  // heap metrics, this is also available in product mode.
+  int64_t GetRootIsolateGCCount();
+
  private:
   struct Locale {
     Locale(std::string language_code_,
@@ -32,6 +32,12 @@ const std::string_view ServiceProtocol::kSetAssetBundlePathExtensionName =
     "_flutter.setAssetBundlePath";
 const std::string_view ServiceProtocol::kGetDisplayRefreshRateExtensionName =
     "_flutter.getDisplayRefreshRate";
+const std::string_view ServiceProtocol::kGetInputLatencyExtensionName =
+    "_flutter.getInputLatency";
+const std::string_view ServiceProtocol::kGetFrameTimingStatisticsExtensionName =
+    "_flutter.getFrameTimingStatistics";
+const std::string_view ServiceProtocol::kDumpTraceRecorderExtensionName =
+    "_flutter.dumpTraceRecorder";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -49,6 +55,9 @@ ServiceProtocol::ServiceProtocol()
           kFlushUIThreadTasksExtensionName,
           kSetAssetBundlePathExtensionName,
           kGetDisplayRefreshRateExtensionName,
+          kGetInputLatencyExtensionName,
+          kGetFrameTimingStatisticsExtensionName,
+          kDumpTraceRecorderExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
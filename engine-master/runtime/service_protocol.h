@@ -27,6 +27,9 @@ class ServiceProtocol {
   static const std::string_view kFlushUIThreadTasksExtensionName;
   static const std::string_view kSetAssetBundlePathExtensionName;
   static const std::string_view kGetDisplayRefreshRateExtensionName;
+  static const std::string_view kGetInputLatencyExtensionName;
+  static const std::string_view kGetFrameTimingStatisticsExtensionName;
+  static const std::string_view kDumpTraceRecorderExtensionName;
 
   class Handler {
    public:
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/adaptive_vsync_scheduler.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+// The weights of a new sample in the smoothed mean and deviation, as
+// recommended by RFC 6298.
+static constexpr int64_t kMeanGainDivisor = 8;
+static constexpr int64_t kDeviationGainDivisor = 4;
+
+// The number of deviations added to the mean to predict a duration. Higher
+// values make fewer frames miss their target at the cost of lower cadences.
+static constexpr int64_t kDeviationMultiplier = 2;
+
+// A cadence is only lowered again once the prediction fits into the shorter
+// budget with this much headroom (in percent) to avoid oscillating.
+static constexpr int64_t kCadenceHeadroomPercent = 20;
+
+void AdaptiveVsyncScheduler::DurationPredictor::AddSample(
+    fml::TimeDelta sample) {
+  if (!has_samples_) {
+    mean_ = sample;
+    deviation_ = sample / 2;
+    has_samples_ = true;
+    return;
+  }
+  const auto error = sample - mean_;
+  const auto abs_error =
+      error < fml::TimeDelta::Zero() ? fml::TimeDelta::Zero() - error : error;
+  deviation_ = deviation_ + (abs_error - deviation_) / kDeviationGainDivisor;
+  mean_ = mean_ + error / kMeanGainDivisor;
+}
+
+fml::TimeDelta AdaptiveVsyncScheduler::DurationPredictor::Predict() const {
+  return mean_ + deviation_ * kDeviationMultiplier;
+}
+
+AdaptiveVsyncScheduler::AdaptiveVsyncScheduler() = default;
+
+AdaptiveVsyncScheduler::~AdaptiveVsyncScheduler() = default;
+
+void AdaptiveVsyncScheduler::RecordFrame(fml::TimeDelta build_time,
+                                         fml::TimeDelta raster_time) {
+  std::scoped_lock lock(mutex_);
+  build_time_.AddSample(build_time);
+  raster_time_.AddSample(raster_time);
+  frame_count_++;
+}
+
+void AdaptiveVsyncScheduler::UpdateCadence(fml::TimeDelta interval) {
+  // The UI and GPU threads work on consecutive frames in parallel, so the
+  // sustainable frame rate is limited by the slower of the two.
+  const auto bottleneck =
+      std::max(build_time_.Predict(), raster_time_.Predict());
+  const size_t needed = std::clamp<size_t>(
+      (bottleneck + interval - fml::TimeDelta::FromMicroseconds(1)) / interval,
+      1, kMaxCadence);
+  if (needed > cadence_) {
+    cadence_ = needed;
+  } else if (needed < cadence_ &&
+             bottleneck * 100 <=
+                 interval * needed * (100 - kCadenceHeadroomPercent)) {
+    cadence_ = needed;
+  }
+}
+
+AdaptiveVsyncScheduler::Decision AdaptiveVsyncScheduler::OnVsync(
+    fml::TimePoint frame_start_time,
+    fml::TimePoint frame_target_time) {
+  std::scoped_lock lock(mutex_);
+
+  Decision decision;
+  decision.build_start_time = frame_start_time;
+  decision.frame_target_time = frame_target_time;
+
+  const auto interval = frame_target_time - frame_start_time;
+  if (interval <= fml::TimeDelta::Zero() || frame_count_ < kMinFrameCount) {
+    last_frame_start_time_ = frame_start_time;
+    return decision;
+  }
+
+  UpdateCadence(interval);
+
+  // Wait until |cadence_| intervals have passed since the last frame. Half an
+  // interval of tolerance absorbs jitter in the vsync timestamps.
+  if (last_frame_start_time_ != fml::TimePoint() &&
+      frame_start_time - last_frame_start_time_ <
+          interval * cadence_ - interval / 2) {
+    decision.skip = true;
+    return decision;
+  }
+  last_frame_start_time_ = frame_start_time;
+
+  const auto budget = interval * cadence_;
+  decision.frame_target_time = frame_start_time + budget;
+
+  // Shift the start of the build by the slack left after the predicted cost of
+  // the frame and a safety margin of a quarter interval. The shift is capped
+  // at half an interval so that mispredictions can still be absorbed.
+  const auto slack = budget - build_time_.Predict() - raster_time_.Predict() -
+                     interval / 4;
+  decision.build_start_time =
+      frame_start_time +
+      std::clamp(slack, fml::TimeDelta::Zero(), interval / 2);
+  return decision;
+}
+
+fml::TimeDelta AdaptiveVsyncScheduler::GetPredictedBuildTime() const {
+  std::scoped_lock lock(mutex_);
+  return build_time_.Predict();
+}
+
+fml::TimeDelta AdaptiveVsyncScheduler::GetPredictedRasterTime() const {
+  std::scoped_lock lock(mutex_);
+  return raster_time_.Predict();
+}
+
+size_t AdaptiveVsyncScheduler::GetCadence() const {
+  std::scoped_lock lock(mutex_);
+  return cadence_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_ADAPTIVE_VSYNC_SCHEDULER_H_
+#define FLUTTER_SHELL_COMMON_ADAPTIVE_VSYNC_SCHEDULER_H_
+
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Decides when the UI thread should start working on a frame given the
+/// recent cost of frames.
+///
+/// Without a scheduler, the UI thread starts building a frame as soon as the
+/// vsync it requested fires. On high refresh rate displays, frames whose build
+/// or raster time barely exceeds the vsync interval then miss every other
+/// vsync, which is perceived as more janky than a steady lower frame rate.
+///
+/// The scheduler predicts the build and raster time of the next frame from
+/// the history of previous frames. If either thread cannot keep up with the
+/// display, frames are produced on every Nth vsync only (the cadence) and
+/// target the vsync at which they will actually be presented. If there is
+/// ample headroom, the start of the UI work is shifted towards the end of the
+/// interval, so that the frame reflects more recent input.
+///
+/// Frames are recorded on the GPU thread while vsyncs are handled on the
+/// thread that fires them. All methods are thread safe.
+///
+class AdaptiveVsyncScheduler {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      What to do with a frame request on a given vsync.
+  ///
+  struct Decision {
+    /// Whether the request should be deferred to a later vsync.
+    bool skip = false;
+    /// When the UI thread should start building the frame.
+    fml::TimePoint build_start_time;
+    /// When the frame is expected to be presented.
+    fml::TimePoint frame_target_time;
+  };
+
+  /// The lowest cadence is one frame every |kMaxCadence| vsyncs.
+  static constexpr size_t kMaxCadence = 4;
+
+  /// No adaptation happens before this number of frames has been recorded.
+  static constexpr size_t kMinFrameCount = 8;
+
+  AdaptiveVsyncScheduler();
+
+  ~AdaptiveVsyncScheduler();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the cost of a frame that has been rasterized to the
+  ///             history used for predictions.
+  ///
+  void RecordFrame(fml::TimeDelta build_time, fml::TimeDelta raster_time);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Decides how to service a pending frame request on the vsync
+  ///             that spans `frame_start_time` to `frame_target_time`.
+  ///
+  Decision OnVsync(fml::TimePoint frame_start_time,
+                   fml::TimePoint frame_target_time);
+
+  fml::TimeDelta GetPredictedBuildTime() const;
+
+  fml::TimeDelta GetPredictedRasterTime() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of vsync intervals between two frames.
+  ///
+  size_t GetCadence() const;
+
+ private:
+  // Predicts the next value of a noisy duration the way TCP estimates round
+  // trip times (RFC 6298): a smoothed mean plus a multiple of the smoothed
+  // mean deviation. This reacts quickly to sustained changes while ignoring
+  // isolated outliers.
+  class DurationPredictor {
+   public:
+    void AddSample(fml::TimeDelta sample);
+
+    fml::TimeDelta Predict() const;
+
+   private:
+    fml::TimeDelta mean_;
+    fml::TimeDelta deviation_;
+    bool has_samples_ = false;
+  };
+
+  mutable std::mutex mutex_;
+  DurationPredictor build_time_;
+  DurationPredictor raster_time_;
+  size_t frame_count_ = 0;
+  size_t cadence_ = 1;
+  fml::TimePoint last_frame_start_time_;
+
+  void UpdateCadence(fml::TimeDelta interval);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AdaptiveVsyncScheduler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_ADAPTIVE_VSYNC_SCHEDULER_H_
@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <future>
+#include <memory>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/shell/common/adaptive_vsync_scheduler.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/vsync_waiters_test.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static constexpr fml::TimeDelta kInterval =
+    fml::TimeDelta::FromMicroseconds(16667);
+
+static fml::TimePoint VsyncTime(int64_t index) {
+  return fml::TimePoint::FromEpochDelta(kInterval * index);
+}
+
+static void RecordFrames(AdaptiveVsyncScheduler& scheduler,
+                         size_t count,
+                         fml::TimeDelta build_time,
+                         fml::TimeDelta raster_time) {
+  for (size_t i = 0; i < count; i++) {
+    scheduler.RecordFrame(build_time, raster_time);
+  }
+}
+
+TEST(AdaptiveVsyncSchedulerTest, DoesNotAdaptWithoutHistory) {
+  AdaptiveVsyncScheduler scheduler;
+  RecordFrames(scheduler, AdaptiveVsyncScheduler::kMinFrameCount - 1,
+               kInterval * 2, kInterval * 2);
+  for (int64_t i = 1; i < 4; i++) {
+    auto decision = scheduler.OnVsync(VsyncTime(i), VsyncTime(i + 1));
+    ASSERT_FALSE(decision.skip);
+    ASSERT_EQ(decision.build_start_time, VsyncTime(i));
+    ASSERT_EQ(decision.frame_target_time, VsyncTime(i + 1));
+  }
+}
+
+TEST(AdaptiveVsyncSchedulerTest, ShiftsBuildStartOfFastFrames) {
+  AdaptiveVsyncScheduler scheduler;
+  RecordFrames(scheduler, 16, fml::TimeDelta::FromMilliseconds(2),
+               fml::TimeDelta::FromMilliseconds(2));
+  auto decision = scheduler.OnVsync(VsyncTime(1), VsyncTime(2));
+  ASSERT_FALSE(decision.skip);
+  ASSERT_EQ(scheduler.GetCadence(), 1u);
+  ASSERT_EQ(decision.frame_target_time, VsyncTime(2));
+  ASSERT_GT(decision.build_start_time, VsyncTime(1));
+  ASSERT_LE(decision.build_start_time, VsyncTime(1) + kInterval / 2);
+
+  // Frames that take most of the interval start right away.
+  RecordFrames(scheduler, 16, fml::TimeDelta::FromMilliseconds(7),
+               fml::TimeDelta::FromMilliseconds(7));
+  decision = scheduler.OnVsync(VsyncTime(2), VsyncTime(3));
+  ASSERT_FALSE(decision.skip);
+  ASSERT_EQ(decision.build_start_time, VsyncTime(2));
+}
+
+TEST(AdaptiveVsyncSchedulerTest, LowersCadenceOfSlowFrames) {
+  AdaptiveVsyncScheduler scheduler;
+  RecordFrames(scheduler, 16, fml::TimeDelta::FromMilliseconds(4),
+               fml::TimeDelta::FromMilliseconds(20));
+
+  ASSERT_FALSE(scheduler.OnVsync(VsyncTime(1), VsyncTime(2)).skip);
+  ASSERT_EQ(scheduler.GetCadence(), 2u);
+  ASSERT_TRUE(scheduler.OnVsync(VsyncTime(2), VsyncTime(3)).skip);
+  auto decision = scheduler.OnVsync(VsyncTime(3), VsyncTime(4));
+  ASSERT_FALSE(decision.skip);
+  ASSERT_EQ(decision.frame_target_time, VsyncTime(5));
+
+  // The cadence is restored once frames are fast again.
+  RecordFrames(scheduler, 32, fml::TimeDelta::FromMilliseconds(4),
+               fml::TimeDelta::FromMilliseconds(4));
+  ASSERT_FALSE(scheduler.OnVsync(VsyncTime(5), VsyncTime(6)).skip);
+  ASSERT_EQ(scheduler.GetCadence(), 1u);
+  ASSERT_FALSE(scheduler.OnVsync(VsyncTime(6), VsyncTime(7)).skip);
+}
+
+TEST(AdaptiveVsyncSchedulerTest, IgnoresIsolatedSlowFrames) {
+  AdaptiveVsyncScheduler scheduler;
+  RecordFrames(scheduler, 32, fml::TimeDelta::FromMilliseconds(4),
+               fml::TimeDelta::FromMilliseconds(4));
+  RecordFrames(scheduler, 1, fml::TimeDelta::FromMilliseconds(4),
+               fml::TimeDelta::FromMilliseconds(18));
+  ASSERT_FALSE(scheduler.OnVsync(VsyncTime(1), VsyncTime(2)).skip);
+  ASSERT_EQ(scheduler.GetCadence(), 1u);
+}
+
+TEST_F(ShellTest, VsyncWaiterSkipsVsyncsRejectedByScheduler) {
+  auto task_runners = GetTaskRunnersForFixture();
+  auto scheduler = std::make_shared<AdaptiveVsyncScheduler>();
+  RecordFrames(*scheduler, 16, fml::TimeDelta::FromMilliseconds(4),
+               fml::TimeDelta::FromMilliseconds(20));
+  auto vsync_waiter =
+      std::make_shared<SimulatedDisplayVsyncWaiter>(task_runners, kInterval);
+  vsync_waiter->SetScheduler(scheduler);
+
+  auto request_frame = [&]() {
+    std::promise<std::pair<fml::TimePoint, fml::TimePoint>> frame_times;
+    auto frame_times_future = frame_times.get_future();
+    task_runners.GetUITaskRunner()->PostTask([&]() {
+      vsync_waiter->AsyncWaitForVsync(
+          [&frame_times](fml::TimePoint frame_start_time,
+                         fml::TimePoint frame_target_time) {
+            frame_times.set_value({frame_start_time, frame_target_time});
+          });
+    });
+    return frame_times_future.get();
+  };
+
+  auto first_frame = request_frame();
+  ASSERT_EQ(first_frame.first, VsyncTime(1));
+  ASSERT_EQ(first_frame.second, VsyncTime(3));
+  ASSERT_EQ(vsync_waiter->GetVsyncCount(), 1u);
+
+  // The second vsync is skipped to keep a steady cadence of one frame every
+  // two vsyncs.
+  auto second_frame = request_frame();
+  ASSERT_EQ(second_frame.first, VsyncTime(3));
+  ASSERT_EQ(second_frame.second, VsyncTime(5));
+  ASSERT_EQ(vsync_waiter->GetVsyncCount(), 3u);
+
+  // Flush the UI thread before the waiter is collected.
+  fml::AutoResetWaitableEvent latch;
+  task_runners.GetUITaskRunner()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -99,12 +99,14 @@ static int64_t FxlToDartOrEarlier(fml::TimePoint time) {
 
 void Animator::BeginFrame(fml::TimePoint frame_start_time,
                           fml::TimePoint frame_target_time) {
+  const auto build_start_time = fml::TimePoint::Now();
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
 
   TRACE_EVENT0("flutter", "Animator::BeginFrame");
   while (!trace_flow_ids_.empty()) {
     uint64_t trace_flow_id = trace_flow_ids_.front();
-    TRACE_FLOW_END("flutter", "PointerEvent", trace_flow_id);
+    TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+    frame_trace_flow_ids_.push_back(trace_flow_id);
     trace_flow_ids_.pop_front();
   }
 
@@ -133,6 +135,8 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   FML_DCHECK(producer_continuation_);
 
   last_begin_frame_time_ = frame_start_time;
+  last_build_start_time_ = build_start_time;
+  last_frame_target_time_ = frame_target_time;
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
@@ -178,7 +182,10 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
   if (layer_tree) {
     // Note the frame time for instrumentation.
-    layer_tree->RecordBuildTime(last_begin_frame_time_);
+    layer_tree->RecordBuildTime(last_begin_frame_time_, last_build_start_time_,
+                                last_frame_target_time_);
+    layer_tree->set_pointer_trace_flow_ids(std::move(frame_trace_flow_ids_));
+    frame_trace_flow_ids_.clear();
   }
 
   // Commit the pending continuation.
@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_COMMON_ANIMATOR_H_
 
 #include <deque>
+#include <vector>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/memory/ref_ptr.h"
@@ -76,7 +77,8 @@ class Animator final {
   void SetDimensionChangePending();
 
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The corresponding flow
-  // will be ended during the next |BeginFrame|.
+  // will be stepped during the next |BeginFrame| and handed over to the layer
+  // tree rendered for that frame, where the rasterizer ends it.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
  private:
@@ -97,6 +99,8 @@ class Animator final {
   std::shared_ptr<VsyncWaiter> waiter_;
 
   fml::TimePoint last_begin_frame_time_;
+  fml::TimePoint last_build_start_time_;
+  fml::TimePoint last_frame_target_time_;
   int64_t dart_frame_deadline_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   fml::Semaphore pending_frame_semaphore_;
@@ -109,6 +113,7 @@ class Animator final {
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_;
   std::deque<uint64_t> trace_flow_ids_;
+  std::vector<uint64_t> frame_trace_flow_ids_;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
@@ -219,6 +219,7 @@ Engine::RunStatus Engine::PrepareAndLaunchIsolate(
 
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
+  frame_begin_gc_count_ = runtime_controller_->GetRootIsolateGCCount();
   runtime_controller_->BeginFrame(frame_time);
 }
 
@@ -443,6 +444,10 @@ void Engine::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
       layer_tree->frame_device_pixel_ratio() <= 0.0f)
     return;
 
+  layer_tree->set_collected_garbage_during_build(
+      frame_begin_gc_count_ >= 0 &&
+      runtime_controller_->GetRootIsolateGCCount() != frame_begin_gc_count_);
+
   animator_->Render(std::move(layer_tree));
 }
 
@@ -746,6 +746,10 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   std::shared_ptr<AssetManager> asset_manager_;
   bool activity_running_;
   bool have_surface_;
+  // The number of root isolate garbage collections when the current frame
+  // started building. A change by the time the frame is rendered means that
+  // garbage was collected during the build.
+  int64_t frame_begin_gc_count_ = -1;
   FontCollection font_collection_;
   ImageDecoder image_decoder_;
   TaskRunners task_runners_;
@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_statistics.h"
+
+namespace flutter {
+
+static FrameTimingStatistics::Distribution GetDistribution(
+    const DurationHistogram& histogram) {
+  FrameTimingStatistics::Distribution distribution;
+  distribution.min = histogram.GetMin();
+  distribution.mean = histogram.GetMean();
+  distribution.p50 = histogram.GetPercentile(50);
+  distribution.p90 = histogram.GetPercentile(90);
+  distribution.p99 = histogram.GetPercentile(99);
+  distribution.max = histogram.GetMax();
+  return distribution;
+}
+
+FrameTimingStatistics::FrameTimingStatistics() = default;
+
+FrameTimingStatistics::~FrameTimingStatistics() = default;
+
+bool FrameTimingStatistics::IsJanky(const Frame& frame) {
+  return frame.target_time != fml::TimePoint() &&
+         frame.raster_finish > frame.target_time;
+}
+
+void FrameTimingStatistics::RecordFrame(const Frame& frame) {
+  std::scoped_lock lock(mutex_);
+  vsync_delay_.Record(frame.build_start - frame.vsync_start);
+  build_.Record(frame.build_finish - frame.build_start);
+  raster_.Record(frame.raster_finish - frame.raster_start);
+  present_.Record(frame.raster_finish - frame.vsync_start);
+
+  if (!IsJanky(frame)) {
+    return;
+  }
+
+  janky_frame_count_++;
+  if (frame.compiled_shaders) {
+    shader_compilation_jank_count_++;
+  }
+  if (frame.collected_garbage) {
+    garbage_collection_jank_count_++;
+  }
+  if (frame.populated_raster_cache) {
+    raster_cache_population_jank_count_++;
+  }
+  if (!frame.compiled_shaders && !frame.collected_garbage &&
+      !frame.populated_raster_cache) {
+    unattributed_jank_count_++;
+  }
+}
+
+FrameTimingStatistics::Summary FrameTimingStatistics::GetSummary() const {
+  std::scoped_lock lock(mutex_);
+  return GetSummaryLocked();
+}
+
+FrameTimingStatistics::Summary FrameTimingStatistics::GetSummaryAndReset() {
+  std::scoped_lock lock(mutex_);
+  const auto summary = GetSummaryLocked();
+  ResetLocked();
+  return summary;
+}
+
+void FrameTimingStatistics::Reset() {
+  std::scoped_lock lock(mutex_);
+  ResetLocked();
+}
+
+FrameTimingStatistics::Summary FrameTimingStatistics::GetSummaryLocked() const {
+  Summary summary;
+  summary.frame_count = present_.GetCount();
+  summary.janky_frame_count = janky_frame_count_;
+  summary.shader_compilation_jank_count = shader_compilation_jank_count_;
+  summary.garbage_collection_jank_count = garbage_collection_jank_count_;
+  summary.raster_cache_population_jank_count =
+      raster_cache_population_jank_count_;
+  summary.unattributed_jank_count = unattributed_jank_count_;
+  summary.vsync_delay = GetDistribution(vsync_delay_);
+  summary.build = GetDistribution(build_);
+  summary.raster = GetDistribution(raster_);
+  summary.present = GetDistribution(present_);
+  return summary;
+}
+
+void FrameTimingStatistics::ResetLocked() {
+  janky_frame_count_ = 0;
+  shader_compilation_jank_count_ = 0;
+  garbage_collection_jank_count_ = 0;
+  raster_cache_population_jank_count_ = 0;
+  unattributed_jank_count_ = 0;
+  vsync_delay_.Reset();
+  build_.Reset();
+  raster_.Reset();
+  present_.Reset();
+}
+
+}  // namespace flutter
@@ -0,0 +1,130 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_STATISTICS_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_STATISTICS_H_
+
+#include <mutex>
+
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Aggregates the timings of every frame rasterized by a shell into
+/// histograms and classifies janky frames by their likely cause.
+///
+/// The phases are recorded into `DurationHistogram`s (see there for how they
+/// differ from the `Stopwatch` used by the performance overlay), so only a
+/// summary needs to be uploaded for fleet telemetry.
+///
+/// A frame is janky if it was not rasterized by the time it was targeted to be
+/// presented, that is, it missed its vsync. Janky frames are attributed to
+/// shader compilation, garbage collection in the root isolate, or raster cache
+/// population when these happened during the frame. A frame may be attributed
+/// to multiple causes.
+///
+/// Frames are recorded on the GPU thread while statistics may be queried from
+/// any thread. All methods are thread safe.
+///
+class FrameTimingStatistics {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      The timings of a single rasterized frame along with the
+  ///             events that happened while it was produced.
+  ///
+  struct Frame {
+    /// The start of the vsync interval the frame was produced for.
+    fml::TimePoint vsync_start;
+    /// The time at which the UI thread started building the frame.
+    fml::TimePoint build_start;
+    fml::TimePoint build_finish;
+    fml::TimePoint raster_start;
+    fml::TimePoint raster_finish;
+    /// The time by which the frame should have been rasterized.
+    fml::TimePoint target_time;
+    bool compiled_shaders = false;
+    bool collected_garbage = false;
+    bool populated_raster_cache = false;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      A snapshot of one of the frame phase histograms.
+  ///
+  struct Distribution {
+    fml::TimeDelta min;
+    fml::TimeDelta mean;
+    fml::TimeDelta p50;
+    fml::TimeDelta p90;
+    fml::TimeDelta p99;
+    fml::TimeDelta max;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      A snapshot of all statistics.
+  ///
+  struct Summary {
+    size_t frame_count = 0;
+    size_t janky_frame_count = 0;
+    size_t shader_compilation_jank_count = 0;
+    size_t garbage_collection_jank_count = 0;
+    size_t raster_cache_population_jank_count = 0;
+    /// Janky frames that could not be attributed to any of the causes above.
+    size_t unattributed_jank_count = 0;
+
+    /// From the vsync to the UI thread starting to build the frame.
+    Distribution vsync_delay;
+    Distribution build;
+    Distribution raster;
+    /// From the vsync to the frame being rasterized.
+    Distribution present;
+  };
+
+  FrameTimingStatistics();
+
+  ~FrameTimingStatistics();
+
+  void RecordFrame(const Frame& frame);
+
+  Summary GetSummary() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the summary and resets the statistics under a single
+  ///             lock, so that no frame recorded in between is lost.
+  ///
+  Summary GetSummaryAndReset();
+
+  void Reset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the frame missed the vsync it was targeted at. Frames
+  ///             without a target time (for example, layer trees submitted
+  ///             without going through the animator) are never janky.
+  ///
+  static bool IsJanky(const Frame& frame);
+
+ private:
+  mutable std::mutex mutex_;
+  size_t janky_frame_count_ = 0;
+  size_t shader_compilation_jank_count_ = 0;
+  size_t garbage_collection_jank_count_ = 0;
+  size_t raster_cache_population_jank_count_ = 0;
+  size_t unattributed_jank_count_ = 0;
+  DurationHistogram vsync_delay_;
+  DurationHistogram build_;
+  DurationHistogram raster_;
+  DurationHistogram present_;
+
+  Summary GetSummaryLocked() const;
+
+  void ResetLocked();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingStatistics);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_STATISTICS_H_
@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_statistics.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static FrameTimingStatistics::Frame CreateFrame(int64_t vsync_millis,
+                                                int64_t build_millis,
+                                                int64_t raster_millis) {
+  const auto vsync_start = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(vsync_millis));
+  FrameTimingStatistics::Frame frame;
+  frame.vsync_start = vsync_start;
+  frame.build_start = vsync_start + fml::TimeDelta::FromMilliseconds(1);
+  frame.build_finish =
+      frame.build_start + fml::TimeDelta::FromMilliseconds(build_millis);
+  frame.raster_start = frame.build_finish;
+  frame.raster_finish =
+      frame.raster_start + fml::TimeDelta::FromMilliseconds(raster_millis);
+  frame.target_time = vsync_start + fml::TimeDelta::FromMilliseconds(16);
+  return frame;
+}
+
+TEST(FrameTimingStatisticsTest, RecordsPhaseDurations) {
+  FrameTimingStatistics statistics;
+  for (int64_t i = 0; i < 10; i++) {
+    statistics.RecordFrame(CreateFrame(i * 16, 2, i + 1));
+  }
+
+  auto summary = statistics.GetSummary();
+  ASSERT_EQ(summary.frame_count, 10u);
+  ASSERT_EQ(summary.janky_frame_count, 0u);
+  ASSERT_EQ(summary.vsync_delay.max, fml::TimeDelta::FromMilliseconds(1));
+  ASSERT_EQ(summary.build.p50, fml::TimeDelta::FromMilliseconds(2));
+  ASSERT_EQ(summary.raster.min, fml::TimeDelta::FromMilliseconds(1));
+  ASSERT_EQ(summary.raster.max, fml::TimeDelta::FromMilliseconds(10));
+  ASSERT_EQ(summary.present.max, fml::TimeDelta::FromMilliseconds(13));
+
+  statistics.Reset();
+  ASSERT_EQ(statistics.GetSummary().frame_count, 0u);
+}
+
+TEST(FrameTimingStatisticsTest, ClassifiesJankyFrames) {
+  FrameTimingStatistics statistics;
+  statistics.RecordFrame(CreateFrame(0, 2, 2));
+
+  auto shader_compilation = CreateFrame(16, 2, 20);
+  shader_compilation.compiled_shaders = true;
+  statistics.RecordFrame(shader_compilation);
+
+  auto garbage_collection = CreateFrame(32, 20, 2);
+  garbage_collection.collected_garbage = true;
+  garbage_collection.populated_raster_cache = true;
+  statistics.RecordFrame(garbage_collection);
+
+  // Non-janky frames are not attributed even if a cause was observed.
+  auto raster_cache_population = CreateFrame(48, 2, 2);
+  raster_cache_population.populated_raster_cache = true;
+  statistics.RecordFrame(raster_cache_population);
+
+  statistics.RecordFrame(CreateFrame(64, 10, 10));
+
+  // Frames without a target time are never janky.
+  auto untargeted = CreateFrame(80, 10, 10);
+  untargeted.target_time = fml::TimePoint();
+  statistics.RecordFrame(untargeted);
+
+  auto summary = statistics.GetSummary();
+  ASSERT_EQ(summary.frame_count, 6u);
+  ASSERT_EQ(summary.janky_frame_count, 3u);
+  ASSERT_EQ(summary.shader_compilation_jank_count, 1u);
+  ASSERT_EQ(summary.garbage_collection_jank_count, 1u);
+  ASSERT_EQ(summary.raster_cache_population_jank_count, 1u);
+  ASSERT_EQ(summary.unattributed_jank_count, 1u);
+}
+
+TEST(FrameTimingStatisticsTest, GetSummaryAndResetClearsStatistics) {
+  FrameTimingStatistics statistics;
+  statistics.RecordFrame(CreateFrame(0, 2, 2));
+  statistics.RecordFrame(CreateFrame(16, 20, 2));
+
+  auto summary = statistics.GetSummaryAndReset();
+  ASSERT_EQ(summary.frame_count, 2u);
+  ASSERT_EQ(summary.janky_frame_count, 1u);
+
+  summary = statistics.GetSummary();
+  ASSERT_EQ(summary.frame_count, 0u);
+  ASSERT_EQ(summary.janky_frame_count, 0u);
+  ASSERT_EQ(summary.unattributed_jank_count, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/input_latency_tracker.h"
+
+namespace flutter {
+
+InputLatencyTracker::InputLatencyTracker() = default;
+
+InputLatencyTracker::~InputLatencyTracker() = default;
+
+void InputLatencyTracker::OnEventDispatched(uint64_t trace_flow_id,
+                                            fml::TimePoint dispatch_time) {
+  std::scoped_lock lock(mutex_);
+  events_in_flight_[trace_flow_id] = dispatch_time;
+  while (events_in_flight_.size() > kMaxEventsInFlight) {
+    events_in_flight_.erase(events_in_flight_.begin());
+  }
+}
+
+void InputLatencyTracker::OnEventsPresented(
+    const std::vector<uint64_t>& trace_flow_ids,
+    fml::TimePoint presentation_time) {
+  if (trace_flow_ids.empty()) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  for (uint64_t trace_flow_id : trace_flow_ids) {
+    auto found = events_in_flight_.find(trace_flow_id);
+    if (found == events_in_flight_.end()) {
+      continue;
+    }
+    histogram_.Record(presentation_time - found->second);
+    events_in_flight_.erase(found);
+  }
+}
+
+InputLatencyTracker::Statistics InputLatencyTracker::GetStatistics() const {
+  std::scoped_lock lock(mutex_);
+  return GetStatisticsLocked();
+}
+
+InputLatencyTracker::Statistics InputLatencyTracker::GetStatisticsAndReset() {
+  std::scoped_lock lock(mutex_);
+  const auto statistics = GetStatisticsLocked();
+  histogram_.Reset();
+  return statistics;
+}
+
+InputLatencyTracker::Statistics InputLatencyTracker::GetStatisticsLocked()
+    const {
+  Statistics statistics;
+  statistics.event_count = histogram_.GetCount();
+  statistics.min = histogram_.GetMin();
+  statistics.mean = histogram_.GetMean();
+  statistics.p50 = histogram_.GetPercentile(50);
+  statistics.p90 = histogram_.GetPercentile(90);
+  statistics.p99 = histogram_.GetPercentile(99);
+  statistics.max = histogram_.GetMax();
+  return statistics;
+}
+
+void InputLatencyTracker::Reset() {
+  std::scoped_lock lock(mutex_);
+  events_in_flight_.clear();
+  histogram_.Reset();
+}
+
+}  // namespace flutter
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_INPUT_LATENCY_TRACKER_H_
+#define FLUTTER_SHELL_COMMON_INPUT_LATENCY_TRACKER_H_
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Measures input-to-photon latency of pointer events.
+///
+/// Every pointer data packet dispatched by the platform view is assigned a
+/// trace flow id by the shell (the same id that links the "PointerEvent" trace
+/// flow). That id is carried through the `PointerDataDispatcher`, the
+/// `Animator` and the layer tree pipeline to the rasterizer. Once the frame
+/// containing the effects of the event has been submitted to the on-screen
+/// surface, the latency of the event is recorded into a histogram.
+///
+/// Events are dispatched on the platform thread and presented on the GPU
+/// thread while statistics may be queried from any thread. All methods are
+/// thread safe.
+///
+class InputLatencyTracker {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      A snapshot of the latency histogram.
+  ///
+  struct Statistics {
+    size_t event_count = 0;
+    fml::TimeDelta min;
+    fml::TimeDelta mean;
+    fml::TimeDelta p50;
+    fml::TimeDelta p90;
+    fml::TimeDelta p99;
+    fml::TimeDelta max;
+  };
+
+  InputLatencyTracker();
+
+  ~InputLatencyTracker();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notes the time at which the platform handed an event with the
+  ///             given trace flow id to the shell.
+  ///
+  void OnEventDispatched(uint64_t trace_flow_id, fml::TimePoint dispatch_time);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the latency of all events whose effects were
+  ///             presented by a frame submitted at `presentation_time`.
+  ///             Unknown ids (for example, events dispatched before the
+  ///             tracker was reset) are ignored.
+  ///
+  void OnEventsPresented(const std::vector<uint64_t>& trace_flow_ids,
+                         fml::TimePoint presentation_time);
+
+  Statistics GetStatistics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a snapshot of the histogram and clears it under the
+  ///             same lock, so that no event presented in between is lost.
+  ///             Events still in flight are kept.
+  ///
+  Statistics GetStatisticsAndReset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Clears the histogram and forgets events still in flight.
+  ///
+  void Reset();
+
+ private:
+  // Events may never be presented (for example, if the framework ignores
+  // them and no frame is scheduled). Only the most recent events are kept in
+  // flight to bound memory usage.
+  static constexpr size_t kMaxEventsInFlight = 512;
+
+  mutable std::mutex mutex_;
+  // Flow ids are handed out in increasing order so the first entry is always
+  // the oldest event in flight.
+  std::map<uint64_t, fml::TimePoint> events_in_flight_;
+  DurationHistogram histogram_;
+
+  Statistics GetStatisticsLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(InputLatencyTracker);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_INPUT_LATENCY_TRACKER_H_
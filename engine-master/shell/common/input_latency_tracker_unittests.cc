@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/input_latency_tracker.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(InputLatencyTrackerTest, RecordsLatencyOfPresentedEvents) {
+  InputLatencyTracker tracker;
+  const auto start = fml::TimePoint::FromEpochDelta(fml::TimeDelta::Zero());
+  for (uint64_t flow_id = 0; flow_id < 10; flow_id++) {
+    tracker.OnEventDispatched(flow_id, start);
+  }
+  for (uint64_t flow_id = 0; flow_id < 10; flow_id++) {
+    tracker.OnEventsPresented(
+        {flow_id}, start + fml::TimeDelta::FromMilliseconds(flow_id + 1));
+  }
+  // Presenting an event twice must not count it twice.
+  tracker.OnEventsPresented({0}, start + fml::TimeDelta::FromSeconds(1));
+
+  auto statistics = tracker.GetStatistics();
+  ASSERT_EQ(statistics.event_count, 10u);
+  ASSERT_EQ(statistics.min, fml::TimeDelta::FromMilliseconds(1));
+  ASSERT_EQ(statistics.max, fml::TimeDelta::FromMilliseconds(10));
+  ASSERT_GE(statistics.p50, fml::TimeDelta::FromMilliseconds(5));
+  ASSERT_LT(statistics.p50, fml::TimeDelta::FromMilliseconds(6));
+  ASSERT_EQ(statistics.p99, fml::TimeDelta::FromMilliseconds(10));
+
+  tracker.Reset();
+  ASSERT_EQ(tracker.GetStatistics().event_count, 0u);
+}
+
+TEST(InputLatencyTrackerTest, IgnoresUnknownEvents) {
+  InputLatencyTracker tracker;
+  const auto now = fml::TimePoint::Now();
+  tracker.OnEventsPresented({42}, now);
+  ASSERT_EQ(tracker.GetStatistics().event_count, 0u);
+
+  // Only a bounded number of events is kept in flight. The oldest events are
+  // dropped first.
+  for (uint64_t flow_id = 0; flow_id < 10000; flow_id++) {
+    tracker.OnEventDispatched(flow_id, now);
+  }
+  tracker.OnEventsPresented({0, 9999}, now);
+  ASSERT_EQ(tracker.GetStatistics().event_count, 1u);
+}
+
+TEST(InputLatencyTrackerTest, GetStatisticsAndResetKeepsEventsInFlight) {
+  InputLatencyTracker tracker;
+  const auto start = fml::TimePoint::FromEpochDelta(fml::TimeDelta::Zero());
+  tracker.OnEventDispatched(0, start);
+  tracker.OnEventDispatched(1, start);
+  tracker.OnEventsPresented({0}, start + fml::TimeDelta::FromMilliseconds(1));
+
+  auto statistics = tracker.GetStatisticsAndReset();
+  ASSERT_EQ(statistics.event_count, 1u);
+  ASSERT_EQ(tracker.GetStatistics().event_count, 0u);
+
+  // An event dispatched before the reset is still counted once presented.
+  tracker.OnEventsPresented({1}, start + fml::TimeDelta::FromMilliseconds(2));
+  statistics = tracker.GetStatistics();
+  ASSERT_EQ(statistics.event_count, 1u);
+  ASSERT_EQ(statistics.max, fml::TimeDelta::FromMilliseconds(2));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -240,15 +240,44 @@ RasterStatus Rasterizer::DoDraw(
   }
 
   FrameTiming timing;
-  timing.Set(FrameTiming::kBuildStart, layer_tree->build_start());
+  // The build phase reported to the framework starts at the vsync.
+  timing.Set(FrameTiming::kBuildStart, layer_tree->vsync_start());
   timing.Set(FrameTiming::kBuildFinish, layer_tree->build_finish());
   timing.Set(FrameTiming::kRasterStart, fml::TimePoint::Now());
 
   PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
   persistent_cache->ResetStoredNewShaders();
+  const size_t raster_cache_population_count =
+      compositor_context_->raster_cache().GetPopulationCount();
 
   RasterStatus raster_status = DrawToSurface(*layer_tree);
+
+  FrameTimingStatistics::Frame frame_statistics;
+  frame_statistics.vsync_start = layer_tree->vsync_start();
+  frame_statistics.build_start = layer_tree->build_start();
+  frame_statistics.build_finish = layer_tree->build_finish();
+  frame_statistics.raster_start = timing.Get(FrameTiming::kRasterStart);
+  frame_statistics.target_time = layer_tree->target_time();
+  frame_statistics.compiled_shaders = persistent_cache->StoredNewShaders();
+  frame_statistics.collected_garbage =
+      layer_tree->collected_garbage_during_build();
+  frame_statistics.populated_raster_cache =
+      compositor_context_->raster_cache().GetPopulationCount() !=
+      raster_cache_population_count;
+
   if (raster_status == RasterStatus::kSuccess) {
+    const auto& pointer_trace_flow_ids = layer_tree->pointer_trace_flow_ids();
+    if (!pointer_trace_flow_ids.empty()) {
+      const auto presentation_time = fml::TimePoint::Now();
+      for (uint64_t trace_flow_id : pointer_trace_flow_ids) {
+        TRACE_FLOW_END("flutter", "PointerEvent", trace_flow_id);
+      }
+      delegate_.OnFramePointerEventsPresented(pointer_trace_flow_ids,
+                                              presentation_time);
+      // The last layer tree may be drawn again (for example, on resize). Those
+      // frames must not count towards the latency of the original events.
+      layer_tree->set_pointer_trace_flow_ids({});
+    }
     last_layer_tree_ = std::move(layer_tree);
   } else if (raster_status == RasterStatus::kResubmit) {
     resubmitted_layer_tree_ = std::move(layer_tree);
@@ -268,6 +297,9 @@ RasterStatus Rasterizer::DoDraw(
   timing.Set(FrameTiming::kRasterFinish, fml::TimePoint::Now());
   delegate_.OnFrameRasterized(timing);
 
+  frame_statistics.raster_finish = timing.Get(FrameTiming::kRasterFinish);
+  delegate_.OnFrameStatisticsRecorded(frame_statistics);
+
   // Pipeline pressure is applied from a couple of places:
   // rasterizer: When there are more items as of the time of Consume.
   // animator (via shell): Frame gets produces every vsync.
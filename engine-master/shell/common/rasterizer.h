@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
@@ -17,6 +18,7 @@
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
+#include "flutter/shell/common/frame_timing_statistics.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/surface.h"
 
@@ -65,6 +67,35 @@ class Rasterizer final : public SnapshotDelegate {
     ///
     virtual void OnFrameRasterized(const FrameTiming& frame_timing) = 0;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate that a frame produced in response to
+    ///             the given pointer events has been submitted to the
+    ///             on-screen surface. This is used to measure input-to-photon
+    ///             latency.
+    ///
+    /// @see        `InputLatencyTracker`
+    ///
+    /// @param[in]  trace_flow_ids     The "PointerEvent" trace flow ids of the
+    ///                                events handled by the frame.
+    /// @param[in]  presentation_time  The time at which the frame was
+    ///                                submitted.
+    ///
+    virtual void OnFramePointerEventsPresented(
+        const std::vector<uint64_t>& trace_flow_ids,
+        fml::TimePoint presentation_time) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate of the detailed timings of a frame
+    ///             that has been rendered, along with the events that may have
+    ///             caused it to be janky.
+    ///
+    /// @see        `FrameTimingStatistics`
+    ///
+    /// @param[in]  frame  The timings and jank causes of the frame.
+    ///
+    virtual void OnFrameStatisticsRecorded(
+        const FrameTimingStatistics::Frame& frame) = 0;
+
     /// Time limit for a smooth frame. See `Engine::GetDisplayRefreshRate`.
     virtual fml::Milliseconds GetFrameBudget() = 0;
   };
@@ -72,6 +103,10 @@ class Rasterizer final : public SnapshotDelegate {
   // TODO(dnfield): remove once embedders have caught up.
   class DummyDelegate : public Delegate {
     void OnFrameRasterized(const FrameTiming&) override {}
+    void OnFramePointerEventsPresented(const std::vector<uint64_t>&,
+                                       fml::TimePoint) override {}
+    void OnFrameStatisticsRecorded(
+        const FrameTimingStatistics::Frame&) override {}
     fml::Milliseconds GetFrameBudget() override {
       return fml::kDefaultFrameBudget;
     }
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/log_settings.h"
@@ -18,6 +19,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/start_up.h"
@@ -32,6 +34,10 @@
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/tonic/common/log.h"
 
+#if defined(OS_POSIX)
+#include <signal.h>
+#endif  // defined(OS_POSIX)
+
 namespace flutter {
 
 constexpr char kSkiaChannel[] = "flutter/skia";
@@ -86,6 +92,9 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   if (!vsync_waiter) {
     return nullptr;
   }
+  if (shell->vsync_scheduler_) {
+    vsync_waiter->SetScheduler(shell->vsync_scheduler_);
+  }
 
   // Create the IO manager on the IO thread. The IO manager must be initialized
   // first because it has state that the other subsystems depend on. It must
@@ -206,6 +215,16 @@ static void PerformInitializationTasks(const Settings& settings) {
       InitSkiaEventTracer(settings.trace_skia);
     }
 
+    fml::tracing::TraceRecorder::SetEnabled(!settings.disable_trace_recorder);
+#if defined(OS_POSIX)
+    if (!settings.disable_trace_recorder &&
+        !settings.trace_recorder_dump_path.empty() &&
+        !fml::tracing::TraceRecorder::InstallDumpSignalHandler(
+            SIGUSR2, settings.trace_recorder_dump_path)) {
+      FML_LOG(ERROR) << "Could not install the trace recorder dump handler.";
+    }
+#endif  // defined(OS_POSIX)
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -297,6 +316,11 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
       settings_(std::move(settings)),
       vm_(std::move(vm)),
       is_gpu_disabled_sync_switch_(new fml::SyncSwitch()),
+      input_latency_tracker_(std::make_unique<InputLatencyTracker>()),
+      frame_timing_statistics_(std::make_unique<FrameTimingStatistics>()),
+      vsync_scheduler_(settings_.enable_adaptive_vsync
+                           ? std::make_shared<AdaptiveVsyncScheduler>()
+                           : nullptr),
       weak_factory_(this),
       weak_factory_gpu_(nullptr) {
   FML_CHECK(vm_) << "Must have access to VM to create a shell.";
@@ -341,6 +365,20 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
           task_runners_.GetUITaskRunner(),
           std::bind(&Shell::OnServiceProtocolGetDisplayRefreshRate, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetInputLatencyExtensionName] = {
+      task_runners_.GetUITaskRunner(),
+      std::bind(&Shell::OnServiceProtocolGetInputLatency, this,
+                std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingStatisticsExtensionName] = {
+          task_runners_.GetUITaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingStatistics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kDumpTraceRecorderExtensionName] = {
+          task_runners_.GetUITaskRunner(),
+          std::bind(&Shell::OnServiceProtocolDumpTraceRecorder, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -765,6 +803,8 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
   TRACE_FLOW_BEGIN("flutter", "PointerEvent", next_pointer_flow_id_);
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+  input_latency_tracker_->OnEventDispatched(next_pointer_flow_id_,
+                                            fml::TimePoint::Now());
   task_runners_.GetUITaskRunner()->PostTask(
       fml::MakeCopyable([engine = weak_engine_, packet = std::move(packet),
                          flow_id = next_pointer_flow_id_]() mutable {
@@ -1118,6 +1158,41 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   }
 }
 
+// |Rasterizer::Delegate|
+void Shell::OnFramePointerEventsPresented(
+    const std::vector<uint64_t>& trace_flow_ids,
+    fml::TimePoint presentation_time) {
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  input_latency_tracker_->OnEventsPresented(trace_flow_ids, presentation_time);
+}
+
+InputLatencyTracker::Statistics Shell::GetInputLatencyStatistics() const {
+  return input_latency_tracker_->GetStatistics();
+}
+
+InputLatencyTracker::Statistics Shell::GetAndResetInputLatencyStatistics() {
+  return input_latency_tracker_->GetStatisticsAndReset();
+}
+
+// |Rasterizer::Delegate|
+void Shell::OnFrameStatisticsRecorded(
+    const FrameTimingStatistics::Frame& frame) {
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  frame_timing_statistics_->RecordFrame(frame);
+  if (vsync_scheduler_) {
+    vsync_scheduler_->RecordFrame(frame.build_finish - frame.build_start,
+                                  frame.raster_finish - frame.raster_start);
+  }
+}
+
+FrameTimingStatistics::Summary Shell::GetFrameTimingStatistics() const {
+  return frame_timing_statistics_->GetSummary();
+}
+
+FrameTimingStatistics::Summary Shell::GetAndResetFrameTimingStatistics() {
+  return frame_timing_statistics_->GetSummaryAndReset();
+}
+
 fml::Milliseconds Shell::GetFrameBudget() {
   if (display_refresh_rate_ > 0) {
     return fml::RefreshRateToFrameBudget(display_refresh_rate_.load());
@@ -1321,6 +1396,103 @@ bool Shell::OnServiceProtocolGetDisplayRefreshRate(
   return true;
 }
 
+// Service protocol handler
+bool Shell::OnServiceProtocolGetInputLatency(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  // Lab runs clear the histogram between scenarios by passing "reset=true".
+  auto reset = params.find("reset");
+  const auto statistics =
+      (reset != params.end() && reset->second == "true")
+          ? input_latency_tracker_->GetStatisticsAndReset()
+          : input_latency_tracker_->GetStatistics();
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "InputLatency", allocator);
+  response.AddMember("count", static_cast<uint64_t>(statistics.event_count),
+                     allocator);
+  response.AddMember("minMicros", statistics.min.ToMicroseconds(), allocator);
+  response.AddMember("meanMicros", statistics.mean.ToMicroseconds(), allocator);
+  response.AddMember("p50Micros", statistics.p50.ToMicroseconds(), allocator);
+  response.AddMember("p90Micros", statistics.p90.ToMicroseconds(), allocator);
+  response.AddMember("p99Micros", statistics.p99.ToMicroseconds(), allocator);
+  response.AddMember("maxMicros", statistics.max.ToMicroseconds(), allocator);
+  return true;
+}
+
+static void AddDistribution(rapidjson::Document& response,
+                            const char* name,
+                            const FrameTimingStatistics::Distribution& value) {
+  auto& allocator = response.GetAllocator();
+  rapidjson::Value distribution(rapidjson::kObjectType);
+  distribution.AddMember("minMicros", value.min.ToMicroseconds(), allocator);
+  distribution.AddMember("meanMicros", value.mean.ToMicroseconds(), allocator);
+  distribution.AddMember("p50Micros", value.p50.ToMicroseconds(), allocator);
+  distribution.AddMember("p90Micros", value.p90.ToMicroseconds(), allocator);
+  distribution.AddMember("p99Micros", value.p99.ToMicroseconds(), allocator);
+  distribution.AddMember("maxMicros", value.max.ToMicroseconds(), allocator);
+  response.AddMember(rapidjson::StringRef(name), distribution, allocator);
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetFrameTimingStatistics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  auto reset = params.find("reset");
+  const auto summary = (reset != params.end() && reset->second == "true")
+                           ? frame_timing_statistics_->GetSummaryAndReset()
+                           : frame_timing_statistics_->GetSummary();
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "FrameTimingStatistics", allocator);
+  response.AddMember("frameCount", static_cast<uint64_t>(summary.frame_count),
+                     allocator);
+  response.AddMember("jankyFrameCount",
+                     static_cast<uint64_t>(summary.janky_frame_count),
+                     allocator);
+
+  rapidjson::Value jank_causes(rapidjson::kObjectType);
+  jank_causes.AddMember(
+      "shaderCompilation",
+      static_cast<uint64_t>(summary.shader_compilation_jank_count), allocator);
+  jank_causes.AddMember(
+      "garbageCollection",
+      static_cast<uint64_t>(summary.garbage_collection_jank_count), allocator);
+  jank_causes.AddMember(
+      "rasterCachePopulation",
+      static_cast<uint64_t>(summary.raster_cache_population_jank_count),
+      allocator);
+  jank_causes.AddMember("unattributed",
+                        static_cast<uint64_t>(summary.unattributed_jank_count),
+                        allocator);
+  response.AddMember("jankCauses", jank_causes, allocator);
+
+  AddDistribution(response, "vsyncDelay", summary.vsync_delay);
+  AddDistribution(response, "build", summary.build);
+  AddDistribution(response, "raster", summary.raster);
+  AddDistribution(response, "present", summary.present);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolDumpTraceRecorder(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  const auto trace = fml::tracing::TraceRecorder::DumpChromeTrace();
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "TraceRecorderDump", allocator);
+  rapidjson::Value trace_value;
+  trace_value.SetString(trace.c_str(), trace.size(), allocator);
+  response.AddMember("trace", trace_value, allocator);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -26,8 +26,11 @@
 #include "flutter/lib/ui/window/platform_message.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/runtime/service_protocol.h"
+#include "flutter/shell/common/adaptive_vsync_scheduler.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_timing_statistics.h"
+#include "flutter/shell/common/input_latency_tracker.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -310,6 +313,43 @@ class Shell final : public PlatformView::Delegate,
   /// @brief     Accessor for the disable GPU SyncSwitch
   std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders and the service protocol to query the
+  ///             input-to-photon latency of the pointer events handled by
+  ///             this shell so far. This call has no threading restrictions.
+  ///
+  /// @return     A snapshot of the pointer event latency histogram.
+  ///
+  InputLatencyTracker::Statistics GetInputLatencyStatistics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like `GetInputLatencyStatistics`, but also clears the
+  ///             histogram. No event presented between the two steps is lost.
+  ///             This call has no threading restrictions.
+  ///
+  /// @return     A snapshot of the pointer event latency histogram.
+  ///
+  InputLatencyTracker::Statistics GetAndResetInputLatencyStatistics();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders and the service protocol to query the
+  ///             timing histograms and jank classification of the frames
+  ///             rasterized by this shell so far. This call has no threading
+  ///             restrictions.
+  ///
+  /// @return     A summary of the frame timing statistics.
+  ///
+  FrameTimingStatistics::Summary GetFrameTimingStatistics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like `GetFrameTimingStatistics`, but also clears the
+  ///             statistics. No frame rasterized between the two steps is
+  ///             lost. This call has no threading restrictions.
+  ///
+  /// @return     A summary of the frame timing statistics.
+  ///
+  FrameTimingStatistics::Summary GetAndResetFrameTimingStatistics();
+
  private:
   using ServiceProtocolHandler =
       std::function<bool(const ServiceProtocol::Handler::ServiceProtocolMap&,
@@ -337,6 +377,10 @@ class Shell final : public PlatformView::Delegate,
       service_protocol_handlers_;
   bool is_setup_ = false;
   uint64_t next_pointer_flow_id_ = 0;
+  std::unique_ptr<InputLatencyTracker> input_latency_tracker_;
+  std::unique_ptr<FrameTimingStatistics> frame_timing_statistics_;
+  // Only set if adaptive vsync scheduling is enabled in the settings.
+  std::shared_ptr<AdaptiveVsyncScheduler> vsync_scheduler_;
 
   bool first_frame_rasterized_ = false;
   std::atomic<bool> waiting_for_first_frame_ = true;
@@ -465,6 +509,15 @@ class Shell final : public PlatformView::Delegate,
   // |Rasterizer::Delegate|
   void OnFrameRasterized(const FrameTiming&) override;
 
+  // |Rasterizer::Delegate|
+  void OnFramePointerEventsPresented(
+      const std::vector<uint64_t>& trace_flow_ids,
+      fml::TimePoint presentation_time) override;
+
+  // |Rasterizer::Delegate|
+  void OnFrameStatisticsRecorded(
+      const FrameTimingStatistics::Frame& frame) override;
+
   // |Rasterizer::Delegate|
   fml::Milliseconds GetFrameBudget() override;
 
@@ -512,6 +565,21 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  bool OnServiceProtocolGetInputLatency(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  bool OnServiceProtocolGetFrameTimingStatistics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  bool OnServiceProtocolDumpTraceRecorder(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   // For accessing the Shell via the GPU thread, necessary for various
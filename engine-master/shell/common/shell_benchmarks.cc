@@ -4,10 +4,15 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/thread.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/gpu/software_frame_pool.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 namespace flutter {
 
@@ -117,4 +122,61 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+static sk_sp<SkPicture> CreateHeadlessScene(const SkISize& size) {
+  SkPictureRecorder recorder;
+  auto canvas = recorder.beginRecording(size.width(), size.height());
+  canvas->clear(SK_ColorWHITE);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  for (int i = 0; i < 100; i++) {
+    paint.setColor(SkColorSetARGB(127, i * 2, 255 - i * 2, 128));
+    canvas->drawCircle(size.width() * (i % 10) / 10.0f,
+                       size.height() * (i / 10) / 10.0f, 80.0f, paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+// Renders frames into a |SoftwareFramePool| as fast as possible, the way the
+// rasterizer does for headless embedders that run without a vsync. Frames are
+// read on a separate thread like an encoder would. The items per second
+// reported by the benchmark are the frames per second.
+static void BM_HeadlessSoftwareFrames(benchmark::State& state,
+                                      size_t buffer_count) {
+  const auto frame_size = SkISize::Make(1280, 720);
+
+  fml::Thread consumer_thread("io.flutter.bench.consumer");
+  auto consumer = consumer_thread.GetTaskRunner();
+
+  SoftwareFramePool pool(
+      buffer_count,
+      [consumer](std::unique_ptr<SoftwareFramePool::Frame> frame) {
+        consumer->PostTask(fml::MakeCopyable([frame = std::move(frame)]() {
+          const auto* pixels = static_cast<const uint8_t*>(frame->GetPixels());
+          uint32_t checksum = 0;
+          for (int row = 0; row < frame->GetSize().height(); row++) {
+            checksum += pixels[row * frame->GetRowBytes()];
+          }
+          benchmark::DoNotOptimize(checksum);
+        }));
+      });
+  GPUSurfaceSoftware surface(&pool, true);
+  auto scene = CreateHeadlessScene(frame_size);
+
+  while (state.KeepRunning()) {
+    auto frame = surface.AcquireFrame(frame_size);
+    FML_CHECK(frame);
+    frame->SkiaCanvas()->drawPicture(scene);
+    FML_CHECK(frame->Submit());
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  fml::AutoResetWaitableEvent latch;
+  consumer->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+BENCHMARK_CAPTURE(BM_HeadlessSoftwareFrames, SingleBuffer, 1);
+BENCHMARK_CAPTURE(BM_HeadlessSoftwareFrames, DoubleBuffered, 2);
+BENCHMARK_CAPTURE(BM_HeadlessSoftwareFrames, TripleBuffered, 3);
+
 }  // namespace flutter
@@ -267,6 +267,12 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
+  settings.disable_trace_recorder =
+      command_line.HasOption(FlagForSwitch(Switch::DisableTraceRecorder));
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceRecorderDumpPath),
+                              &settings.trace_recorder_dump_path);
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
@@ -366,6 +372,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.cache_sksl =
       command_line.HasOption(FlagForSwitch(Switch::CacheSkSL));
 
+  settings.enable_adaptive_vsync =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAdaptiveVsync));
+
   return settings;
 }
 
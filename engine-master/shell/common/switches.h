@@ -136,12 +136,27 @@ DEF_SWITCH(CacheSkSL,
            "should only be used during development phases. The generated SkSLs "
            "can later be used in the release build for shader precompilation "
            "at launch in order to eliminate the shader-compile jank.")
+DEF_SWITCH(EnableAdaptiveVsync,
+           "enable-adaptive-vsync",
+           "Predict the build and raster time of frames from recent history. "
+           "Frames are produced at a lower but steady rate when they cannot "
+           "keep up with the display, and the UI thread starts later in the "
+           "vsync interval when there is enough headroom.")
 DEF_SWITCH(
     TraceSystrace,
     "trace-systrace",
     "Trace to the system tracer (instead of the timeline) on platforms where "
     "such a tracer is available. Currently only supported on Android and "
     "Fuchsia.")
+DEF_SWITCH(DisableTraceRecorder,
+           "disable-trace-recorder",
+           "Disable the always-on recorder that keeps the most recent trace "
+           "events of each thread in memory so that they can be dumped on "
+           "demand.")
+DEF_SWITCH(TraceRecorderDumpPath,
+           "trace-recorder-dump-path",
+           "The path of the file that the trace recorder is dumped to when the "
+           "process receives SIGUSR2. Only supported on POSIX platforms.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -82,15 +82,23 @@ void VsyncWaiter::ScheduleSecondaryCallback(const fml::closure& callback) {
   AwaitVSync();
 }
 
+void VsyncWaiter::SetScheduler(
+    std::shared_ptr<AdaptiveVsyncScheduler> scheduler) {
+  std::scoped_lock lock(callback_mutex_);
+  scheduler_ = std::move(scheduler);
+}
+
 void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
                                fml::TimePoint frame_target_time) {
   Callback callback;
   fml::closure secondary_callback;
+  std::shared_ptr<AdaptiveVsyncScheduler> scheduler;
 
   {
     std::scoped_lock lock(callback_mutex_);
     callback = std::move(callback_);
     secondary_callback = std::move(secondary_callback_);
+    scheduler = scheduler_;
   }
 
   if (!callback && !secondary_callback) {
@@ -101,6 +109,27 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
     return;
   }
 
+  fml::TimePoint build_start_time = frame_start_time;
+  if (callback && scheduler) {
+    const auto decision =
+        scheduler->OnVsync(frame_start_time, frame_target_time);
+    if (decision.skip) {
+      TRACE_EVENT_INSTANT0("flutter", "VsyncSkippedByScheduler");
+      // Request the next vsync on behalf of the animator. This must happen on
+      // the UI thread like all other requests.
+      task_runners_.GetUITaskRunner()->PostTask(
+          [weak_waiter = weak_from_this(), callback = std::move(callback)]() {
+            if (auto waiter = weak_waiter.lock()) {
+              waiter->AsyncWaitForVsync(callback);
+            }
+          });
+      callback = nullptr;
+    } else {
+      build_start_time = decision.build_start_time;
+      frame_target_time = decision.frame_target_time;
+    }
+  }
+
   if (callback) {
     auto flow_identifier = fml::tracing::TraceNonce();
 
@@ -122,7 +151,7 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
           callback(frame_start_time, frame_target_time);
           TRACE_FLOW_END("flutter", kVsyncFlowName, flow_identifier);
         },
-        frame_start_time);
+        build_start_time);
   }
 
   if (secondary_callback) {
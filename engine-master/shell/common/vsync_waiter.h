@@ -11,6 +11,7 @@
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/adaptive_vsync_scheduler.h"
 
 namespace flutter {
 
@@ -30,6 +31,13 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   /// See also |PointerDataDispatcher::ScheduleSecondaryVsyncCallback|.
   void ScheduleSecondaryCallback(const fml::closure& callback);
 
+  /// Use the given scheduler to decide on which vsyncs frames are started and
+  /// when. If no scheduler is set (the default), the callback is invoked on
+  /// the first vsync after it was requested.
+  ///
+  /// See also |AdaptiveVsyncScheduler|.
+  void SetScheduler(std::shared_ptr<AdaptiveVsyncScheduler> scheduler);
+
   static constexpr float kUnknownRefreshRateFPS = 0.0;
 
   // Get the display's maximum refresh rate in the unit of frame per second.
@@ -62,6 +70,8 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   std::mutex secondary_callback_mutex_;
   fml::closure secondary_callback_;
 
+  std::shared_ptr<AdaptiveVsyncScheduler> scheduler_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiter);
 };
 
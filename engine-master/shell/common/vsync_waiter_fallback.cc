@@ -20,8 +20,11 @@ static fml::TimePoint SnapToNextTick(fml::TimePoint value,
 
 }  // namespace
 
-VsyncWaiterFallback::VsyncWaiterFallback(TaskRunners task_runners)
-    : VsyncWaiter(std::move(task_runners)), phase_(fml::TimePoint::Now()) {}
+VsyncWaiterFallback::VsyncWaiterFallback(TaskRunners task_runners,
+                                         bool uncapped)
+    : VsyncWaiter(std::move(task_runners)),
+      phase_(fml::TimePoint::Now()),
+      uncapped_(uncapped) {}
 
 VsyncWaiterFallback::~VsyncWaiterFallback() = default;
 
@@ -30,6 +33,14 @@ void VsyncWaiterFallback::AwaitVSync() {
   constexpr fml::TimeDelta kSingleFrameInterval =
       fml::TimeDelta::FromSecondsF(1.0 / 60.0);
 
+  if (uncapped_) {
+    // Frames still get a regular budget so that the frame timings and idle
+    // notifications remain meaningful.
+    auto now = fml::TimePoint::Now();
+    FireCallback(now, now + kSingleFrameInterval);
+    return;
+  }
+
   auto next =
       SnapToNextTick(fml::TimePoint::Now(), phase_, kSingleFrameInterval);
 
@@ -15,12 +15,16 @@ namespace flutter {
 /// A |VsyncWaiter| that will fire at 60 fps irrespective of the vsync.
 class VsyncWaiterFallback final : public VsyncWaiter {
  public:
-  VsyncWaiterFallback(TaskRunners task_runners);
+  /// If `uncapped` is true, the waiter fires as soon as a frame is requested
+  /// instead. This lets headless embedders render frames as fast as the engine
+  /// can produce them.
+  VsyncWaiterFallback(TaskRunners task_runners, bool uncapped = false);
 
   ~VsyncWaiterFallback() override;
 
  private:
   fml::TimePoint phase_;
+  const bool uncapped_;
 
   // |VsyncWaiter|
   void AwaitVSync() override;
@@ -65,5 +65,17 @@ void ConstantFiringVsyncWaiter::AwaitVSync() {
   });
 }
 
+void SimulatedDisplayVsyncWaiter::AwaitVSync() {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  // The first vsync is at one interval after the epoch so that no frame
+  // starts at the default constructed time point.
+  const size_t vsync_index = ++vsync_count_;
+  const auto frame_start_time =
+      fml::TimePoint::FromEpochDelta(interval_ * vsync_index);
+  task_runners_.GetPlatformTaskRunner()->PostTask([this, frame_start_time]() {
+    FireCallback(frame_start_time, frame_start_time + interval_);
+  });
+}
+
 }  // namespace testing
 }  // namespace flutter
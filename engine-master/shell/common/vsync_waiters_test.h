@@ -56,6 +56,26 @@ class ConstantFiringVsyncWaiter : public VsyncWaiter {
   void AwaitVSync() override;
 };
 
+/// Simulates a display with a fixed refresh interval. Every request is
+/// answered with the next vsync of the display, as if no time passed between
+/// the requests. The timestamps are in the past so that the callbacks run
+/// immediately.
+class SimulatedDisplayVsyncWaiter : public VsyncWaiter {
+ public:
+  SimulatedDisplayVsyncWaiter(TaskRunners task_runners, fml::TimeDelta interval)
+      : VsyncWaiter(std::move(task_runners)), interval_(interval) {}
+
+  /// The number of vsyncs that have fired so far.
+  size_t GetVsyncCount() const { return vsync_count_; }
+
+ protected:
+  void AwaitVSync() override;
+
+ private:
+  const fml::TimeDelta interval_;
+  std::atomic<size_t> vsync_count_ = 0;
+};
+
 }  // namespace testing
 }  // namespace flutter
 
@@ -0,0 +1,164 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/software_frame_pool.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+SoftwareFramePool::Buffers::Buffers(size_t max_count)
+    : max_count_(std::max<size_t>(max_count, 1)) {}
+
+sk_sp<SkSurface> SoftwareFramePool::Buffers::Acquire(const SkISize& size) {
+  std::unique_lock lock(mutex_);
+  bool timed_out = false;
+  while (true) {
+    // A buffer is free once the pool holds the only reference to it. This also
+    // reclaims the buffers of frames that were acquired but never presented.
+    auto is_free = [](const sk_sp<SkSurface>& buffer) {
+      return buffer->unique();
+    };
+
+    // Free buffers of a previous size can never be reused. Dropping them makes
+    // room for buffers of the new size.
+    all_.erase(std::remove_if(all_.begin(), all_.end(),
+                              [&](const sk_sp<SkSurface>& buffer) {
+                                return is_free(buffer) &&
+                                       (buffer->width() != size.width() ||
+                                        buffer->height() != size.height());
+                              }),
+               all_.end());
+
+    // Likewise, free buffers allocated beyond the limit after a timeout are
+    // dropped rather than reused.
+    auto it = all_.begin();
+    while (all_.size() > max_count_ && it != all_.end()) {
+      it = is_free(*it) ? all_.erase(it) : it + 1;
+    }
+
+    auto found = std::find_if(all_.begin(), all_.end(), is_free);
+    if (found != all_.end()) {
+      return *found;
+    }
+
+    if (all_.size() < max_count_ || timed_out) {
+      break;
+    }
+
+    TRACE_EVENT0("flutter", "SoftwareFramePool::WaitForRelease");
+    timed_out = released_.wait_for(lock, kReleaseTimeout) ==
+                std::cv_status::timeout;
+  }
+
+  if (timed_out) {
+    FML_DLOG(WARNING) << "No software frame was released within "
+                      << kReleaseTimeout.count()
+                      << "ms. Allocating a buffer beyond the pool limit.";
+  }
+
+  SkImageInfo info = SkImageInfo::MakeN32(
+      size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+  auto buffer = SkSurface::MakeRaster(info, nullptr);
+
+  if (buffer != nullptr) {
+    all_.push_back(buffer);
+  }
+  return buffer;
+}
+
+void SoftwareFramePool::Buffers::Release(sk_sp<SkSurface> buffer) {
+  {
+    // Drop the reference under the lock so that a concurrent acquisition
+    // either sees the buffer as free or is waiting for this notification.
+    std::scoped_lock lock(mutex_);
+    buffer.reset();
+  }
+  released_.notify_one();
+}
+
+size_t SoftwareFramePool::Buffers::GetAllocatedCount() const {
+  std::scoped_lock lock(mutex_);
+  return all_.size();
+}
+
+SoftwareFramePool::Frame::Frame(std::shared_ptr<Buffers> buffers,
+                                sk_sp<SkSurface> buffer,
+                                SkPixmap pixmap,
+                                uint64_t frame_number)
+    : buffers_(std::move(buffers)),
+      buffer_(std::move(buffer)),
+      pixmap_(pixmap),
+      frame_number_(frame_number) {}
+
+SoftwareFramePool::Frame::~Frame() {
+  buffers_->Release(std::move(buffer_));
+}
+
+const void* SoftwareFramePool::Frame::GetPixels() const {
+  return pixmap_.addr();
+}
+
+SkColorType SoftwareFramePool::Frame::GetColorType() const {
+  return pixmap_.colorType();
+}
+
+size_t SoftwareFramePool::Frame::GetRowBytes() const {
+  return pixmap_.rowBytes();
+}
+
+SkISize SoftwareFramePool::Frame::GetSize() const {
+  return pixmap_.dimensions();
+}
+
+uint64_t SoftwareFramePool::Frame::GetFrameNumber() const {
+  return frame_number_;
+}
+
+SoftwareFramePool::SoftwareFramePool(size_t max_buffer_count,
+                                     FrameCallback on_frame)
+    : buffers_(std::make_shared<Buffers>(max_buffer_count)),
+      on_frame_(std::move(on_frame)) {}
+
+SoftwareFramePool::~SoftwareFramePool() = default;
+
+size_t SoftwareFramePool::GetAllocatedBufferCount() const {
+  return buffers_->GetAllocatedCount();
+}
+
+// |GPUSurfaceSoftwareDelegate|
+sk_sp<SkSurface> SoftwareFramePool::AcquireBackingStore(const SkISize& size) {
+  TRACE_EVENT0("flutter", "SoftwareFramePool::AcquireBackingStore");
+  auto buffer = buffers_->Acquire(size);
+  if (buffer == nullptr) {
+    FML_LOG(ERROR) << "Could not create backing store for software rendering.";
+  }
+  return buffer;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool SoftwareFramePool::PresentBackingStore(sk_sp<SkSurface> backing_store) {
+  SkPixmap pixmap;
+  if (!backing_store->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
+    return false;
+  }
+
+  std::unique_ptr<Frame> frame(
+      new Frame(buffers_, std::move(backing_store), pixmap, frame_count_++));
+  if (on_frame_) {
+    on_frame_(std::move(frame));
+  }
+  return true;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+ExternalViewEmbedder* SoftwareFramePool::GetExternalViewEmbedder() {
+  return nullptr;
+}
+
+}  // namespace flutter
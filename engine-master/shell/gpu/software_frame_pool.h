@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_GPU_SOFTWARE_FRAME_POOL_H_
+#define FLUTTER_SHELL_GPU_SOFTWARE_FRAME_POOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/gpu/gpu_surface_software_delegate.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// A software surface delegate for headless rendering that renders into a
+/// bounded pool of reusable CPU buffers.
+///
+/// Every presented frame is handed to the consumer as a |Frame| that keeps its
+/// buffer out of the pool until the frame is destroyed. This allows consumers
+/// to encode or upload the pixels on their own threads without copying them
+/// while the rasterizer moves on to the next frame in another buffer.
+///
+/// When all buffers are held by consumers, acquiring a backing store blocks
+/// the GPU thread until a frame is released, but for no longer than
+/// `kReleaseTimeout`. After that, a buffer is allocated beyond the limit so
+/// that the rasterizer (and the shell, which tears down the rasterizer before
+/// the surface that owns this pool) is never blocked on a consumer forever.
+/// Such buffers are freed as soon as they are released.
+///
+class SoftwareFramePool final : public GPUSurfaceSoftwareDelegate {
+ private:
+  class Buffers;
+
+ public:
+  static constexpr std::chrono::milliseconds kReleaseTimeout{100};
+
+  //----------------------------------------------------------------------------
+  /// @brief      A rendered frame whose pixels are owned by the pool. The
+  ///             buffer is returned to the pool when the frame is destroyed,
+  ///             which may happen on any thread and after the pool itself has
+  ///             been destroyed.
+  ///
+  class Frame {
+   public:
+    ~Frame();
+
+    /// The pixels in the native 32-bit premultiplied format.
+    const void* GetPixels() const;
+
+    /// The native format of the pixels, either `kRGBA_8888_SkColorType` or
+    /// `kBGRA_8888_SkColorType` depending on the platform.
+    SkColorType GetColorType() const;
+
+    size_t GetRowBytes() const;
+
+    SkISize GetSize() const;
+
+    /// The number of frames presented by the pool before this one.
+    uint64_t GetFrameNumber() const;
+
+   private:
+    friend class SoftwareFramePool;
+
+    std::shared_ptr<Buffers> buffers_;
+    sk_sp<SkSurface> buffer_;
+    SkPixmap pixmap_;
+    uint64_t frame_number_;
+
+    Frame(std::shared_ptr<Buffers> buffers,
+          sk_sp<SkSurface> buffer,
+          SkPixmap pixmap,
+          uint64_t frame_number);
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Frame);
+  };
+
+  using FrameCallback = std::function<void(std::unique_ptr<Frame> frame)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a pool of at most `max_buffer_count` buffers.
+  ///
+  /// @param[in]  max_buffer_count  The maximum number of buffers allocated at
+  ///                               the same time. One buffer is always used by
+  ///                               the rasterizer, so frames are only
+  ///                               pipelined with at least two buffers.
+  /// @param[in]  on_frame          Invoked on the GPU thread with every
+  ///                               presented frame.
+  ///
+  SoftwareFramePool(size_t max_buffer_count, FrameCallback on_frame);
+
+  ~SoftwareFramePool() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of buffers currently allocated, whether they are
+  ///             free, being rendered into, or held by a consumer.
+  ///
+  size_t GetAllocatedBufferCount() const;
+
+  // |GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  ExternalViewEmbedder* GetExternalViewEmbedder() override;
+
+ private:
+  // The buffers are shared with outstanding frames so that frames may outlive
+  // the pool.
+  class Buffers {
+   public:
+    explicit Buffers(size_t max_count);
+
+    sk_sp<SkSurface> Acquire(const SkISize& size);
+
+    void Release(sk_sp<SkSurface> buffer);
+
+    size_t GetAllocatedCount() const;
+
+   private:
+    const size_t max_count_;
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    std::vector<sk_sp<SkSurface>> all_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Buffers);
+  };
+
+  std::shared_ptr<Buffers> buffers_;
+  FrameCallback on_frame_;
+  uint64_t frame_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SoftwareFramePool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_GPU_SOFTWARE_FRAME_POOL_H_
@@ -101,7 +101,9 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, surface_frame_callback, nullptr) ==
+          nullptr) {
     return false;
   }
 
@@ -237,6 +239,10 @@ InferOpenGLPlatformViewCreationCallback(
       });
 }
 
+struct _FlutterSoftwareFrameHandle {
+  std::unique_ptr<flutter::SoftwareFramePool::Frame> frame;
+};
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -249,15 +255,50 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store;
+  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) !=
+      nullptr) {
+    software_present_backing_store =
+        [ptr = software_config->surface_present_callback, user_data](
+            const void* allocation, size_t row_bytes, size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  flutter::SoftwareFramePool::FrameCallback software_present_frame;
+  if (SAFE_ACCESS(software_config, surface_frame_callback, nullptr) !=
+      nullptr) {
+    software_present_frame =
+        [ptr = software_config->surface_frame_callback,
+         user_data](std::unique_ptr<flutter::SoftwareFramePool::Frame> frame) {
+          const size_t width = frame->GetSize().width();
+          const size_t height = frame->GetSize().height();
+          auto handle = new FlutterSoftwareFrameHandle();
+          const FlutterSoftwareFrame software_frame = {
+              sizeof(FlutterSoftwareFrame),  // struct_size
+              frame->GetPixels(),            // allocation
+              frame->GetRowBytes(),          // row_bytes
+              width,                         // width
+              height,                        // height
+              frame->GetFrameNumber(),       // frame_number
+              handle,                        // handle
+              frame->GetColorType() == kRGBA_8888_SkColorType
+                  ? kFlutterSoftwarePixelFormatRGBA8888
+                  : kFlutterSoftwarePixelFormatBGRA8888,  // pixel_format
+          };
+          handle->frame = std::move(frame);
+          ptr(user_data, &software_frame);
+        };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,  // optional
+          software_present_frame,          // optional
+          SAFE_ACCESS(software_config, surface_frame_buffer_count, 0),
       };
 
   return fml::MakeCopyable(
@@ -816,6 +857,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           update_semantics_custom_actions_callback,  //
           platform_message_response_callback,        //
           vsync_callback,                            //
+          SAFE_ACCESS(args, uncapped_frame_rate, false),
       };
 
   auto on_create_platform_view = InferPlatformViewCreationCallback(
@@ -1746,3 +1788,89 @@ FlutterEngineResult FlutterEngineNotifyLowMemoryWarning(
                    kInternalInconsistency,
                    "Could not dispatch the low memory notification message.");
 }
+
+FlutterEngineResult FlutterEngineGetInputLatencyStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterInputLatencyStatistics* statistics,
+    bool reset) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (statistics == nullptr ||
+      statistics->struct_size < sizeof(FlutterInputLatencyStatistics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid input latency statistics struct.");
+  }
+
+  auto& shell = engine->GetShell();
+  const auto latency = reset ? shell.GetAndResetInputLatencyStatistics()
+                             : shell.GetInputLatencyStatistics();
+
+  statistics->event_count = latency.event_count;
+  statistics->min_micros = latency.min.ToMicroseconds();
+  statistics->mean_micros = latency.mean.ToMicroseconds();
+  statistics->p50_micros = latency.p50.ToMicroseconds();
+  statistics->p90_micros = latency.p90.ToMicroseconds();
+  statistics->p99_micros = latency.p99.ToMicroseconds();
+  statistics->max_micros = latency.max.ToMicroseconds();
+  return kSuccess;
+}
+
+static FlutterFrameTimingDistribution ToFrameTimingDistribution(
+    const flutter::FrameTimingStatistics::Distribution& distribution) {
+  FlutterFrameTimingDistribution result = {};
+  result.min_micros = distribution.min.ToMicroseconds();
+  result.mean_micros = distribution.mean.ToMicroseconds();
+  result.p50_micros = distribution.p50.ToMicroseconds();
+  result.p90_micros = distribution.p90.ToMicroseconds();
+  result.p99_micros = distribution.p99.ToMicroseconds();
+  result.max_micros = distribution.max.ToMicroseconds();
+  return result;
+}
+
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterFrameTimingStatistics* statistics,
+    bool reset) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (statistics == nullptr ||
+      statistics->struct_size < sizeof(FlutterFrameTimingStatistics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid frame timing statistics struct.");
+  }
+
+  auto& shell = engine->GetShell();
+  const auto summary = reset ? shell.GetAndResetFrameTimingStatistics()
+                             : shell.GetFrameTimingStatistics();
+
+  statistics->frame_count = summary.frame_count;
+  statistics->janky_frame_count = summary.janky_frame_count;
+  statistics->shader_compilation_jank_count =
+      summary.shader_compilation_jank_count;
+  statistics->garbage_collection_jank_count =
+      summary.garbage_collection_jank_count;
+  statistics->raster_cache_population_jank_count =
+      summary.raster_cache_population_jank_count;
+  statistics->unattributed_jank_count = summary.unattributed_jank_count;
+  statistics->vsync_delay = ToFrameTimingDistribution(summary.vsync_delay);
+  statistics->build = ToFrameTimingDistribution(summary.build);
+  statistics->raster = ToFrameTimingDistribution(summary.raster);
+  statistics->present = ToFrameTimingDistribution(summary.present);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineReleaseSoftwareFrame(
+    FlutterSoftwareFrameHandle* frame) {
+  if (frame == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid frame handle.");
+  }
+
+  delete frame;
+  return kSuccess;
+}
@@ -265,6 +265,39 @@ typedef bool (*SoftwareSurfacePresentCallback)(void* /* user data */,
                                                const void* /* allocation */,
                                                size_t /* row bytes */,
                                                size_t /* height */);
+
+struct _FlutterSoftwareFrameHandle;
+typedef struct _FlutterSoftwareFrameHandle FlutterSoftwareFrameHandle;
+
+/// The byte order of the 32-bit premultiplied pixels of a software frame.
+/// Skia's native format differs between platforms. It is BGRA on most of them.
+typedef enum {
+  /// The bytes of each pixel are red, green, blue and alpha, in that order.
+  kFlutterSoftwarePixelFormatRGBA8888,
+  /// The bytes of each pixel are blue, green, red and alpha, in that order.
+  kFlutterSoftwarePixelFormatBGRA8888,
+} FlutterSoftwarePixelFormat;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareFrame).
+  size_t struct_size;
+  /// The premultiplied pixels of the frame in the `pixel_format` byte order.
+  const void* allocation;
+  size_t row_bytes;
+  size_t width;
+  size_t height;
+  /// The number of frames rendered by the engine before this one.
+  uint64_t frame_number;
+  /// The handle that keeps the allocation alive. It must be released using
+  /// `FlutterEngineReleaseSoftwareFrame`.
+  FlutterSoftwareFrameHandle* handle;
+  /// The byte order of the pixels in `allocation`.
+  FlutterSoftwarePixelFormat pixel_format;
+} FlutterSoftwareFrame;
+
+typedef void (*SoftwareSurfaceFrameCallback)(
+    void* /* user data */,
+    const FlutterSoftwareFrame* /* frame */);
 typedef void* (*ProcResolver)(void* /* user data */, const char* /* name */);
 typedef bool (*TextureFrameCallback)(void* /* user data */,
                                      int64_t /* texture identifier */,
@@ -319,6 +352,21 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Optional. If specified, the engine renders into a pool of buffers and
+  /// hands each finished frame to this callback instead of calling the
+  /// `surface_present_callback`, which may then be NULL. The frame stays valid
+  /// without being copied until it is released using
+  /// `FlutterEngineReleaseSoftwareFrame`, which may happen on any thread. When
+  /// all buffers of the pool are held by the embedder, rendering blocks until
+  /// a frame is released. If no frame is released within 100ms, an extra
+  /// buffer is allocated so that rendering and engine shutdown can proceed.
+  /// The engine will call this method on an internal engine managed thread.
+  SoftwareSurfaceFrameCallback surface_frame_callback;
+  /// The maximum number of buffers in the pool used with the
+  /// `surface_frame_callback`. Since one buffer is being rendered into, this
+  /// should be at least two for frames to be rendered while the embedder
+  /// processes the previous one. Defaults to three if zero.
+  size_t surface_frame_buffer_count;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -934,6 +982,78 @@ typedef struct {
   };
 } FlutterEngineDartObject;
 
+/// A summary of the input-to-photon latency of the pointer events sent to the
+/// engine via `FlutterEngineSendPointerEvent`. The latency of an event is
+/// measured from the time the engine received it to the time the frame that
+/// handled it was submitted to the render surface. All durations are in
+/// microseconds.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterInputLatencyStatistics).
+  size_t struct_size;
+  /// The number of events whose latency was recorded.
+  uint64_t event_count;
+  /// The smallest recorded latency.
+  uint64_t min_micros;
+  /// The mean of all recorded latencies.
+  uint64_t mean_micros;
+  /// The median latency.
+  uint64_t p50_micros;
+  /// The 90th percentile latency.
+  uint64_t p90_micros;
+  /// The 99th percentile latency.
+  uint64_t p99_micros;
+  /// The largest recorded latency.
+  uint64_t max_micros;
+} FlutterInputLatencyStatistics;
+
+/// A summary of the durations of one phase of the frames rendered by the
+/// engine. All durations are in microseconds.
+typedef struct {
+  /// The shortest recorded duration.
+  uint64_t min_micros;
+  /// The mean of all recorded durations.
+  uint64_t mean_micros;
+  /// The median duration.
+  uint64_t p50_micros;
+  /// The 90th percentile duration.
+  uint64_t p90_micros;
+  /// The 99th percentile duration.
+  uint64_t p99_micros;
+  /// The longest recorded duration.
+  uint64_t max_micros;
+} FlutterFrameTimingDistribution;
+
+/// A summary of the timings of the frames rendered by the engine. A frame is
+/// janky if it was not rasterized by the end of the vsync interval it was
+/// produced for. Janky frames are attributed to the events that happened while
+/// they were produced. A single frame may be attributed to multiple causes.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingStatistics).
+  size_t struct_size;
+  /// The number of frames rasterized.
+  uint64_t frame_count;
+  /// The number of frames that missed their vsync.
+  uint64_t janky_frame_count;
+  /// The number of janky frames during which new shaders were compiled.
+  uint64_t shader_compilation_jank_count;
+  /// The number of janky frames during which the root isolate collected
+  /// garbage.
+  uint64_t garbage_collection_jank_count;
+  /// The number of janky frames during which pictures or layers were
+  /// rasterized into the raster cache.
+  uint64_t raster_cache_population_jank_count;
+  /// The number of janky frames that could not be attributed to any cause.
+  uint64_t unattributed_jank_count;
+  /// The time from the vsync to the UI thread starting to build the frame.
+  FlutterFrameTimingDistribution vsync_delay;
+  /// The time taken by the UI thread to build the frame.
+  FlutterFrameTimingDistribution build;
+  /// The time taken by the GPU thread to rasterize the frame.
+  FlutterFrameTimingDistribution raster;
+  /// The time from the vsync to the frame being rasterized.
+  FlutterFrameTimingDistribution present;
+} FlutterFrameTimingStatistics;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterProjectArgs).
   size_t struct_size;
@@ -1114,6 +1234,12 @@ typedef struct {
   /// absence, platforms views in the scene are ignored and Flutter renders to
   /// the root surface as normal.
   const FlutterCompositor* compositor;
+
+  /// If true and no `vsync_callback` is specified, the engine does not wait
+  /// for the next vsync before producing a frame but starts as soon as the
+  /// frame is requested. This is useful for headless embedders that render
+  /// frames in batches, for example to generate screenshots on a server.
+  bool uncapped_frame_rate;
 } FlutterProjectArgs;
 
 //------------------------------------------------------------------------------
@@ -1660,6 +1786,61 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineNotifyLowMemoryWarning(
     FLUTTER_API_SYMBOL(FlutterEngine) engine);
 
+//------------------------------------------------------------------------------
+/// @brief      Gets the input-to-photon latency statistics of all pointer
+///             events sent to the engine since it was launched or since the
+///             statistics were last reset. This call has no threading
+///             restrictions.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[out] statistics  The statistics to fill. The `struct_size` field
+///                         must be set by the caller.
+/// @param[in]  reset       Whether the statistics should be cleared after they
+///                         have been read. This is useful to gate individual
+///                         scenarios of a test run.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetInputLatencyStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterInputLatencyStatistics* statistics,
+    bool reset);
+
+//------------------------------------------------------------------------------
+/// @brief      Gets the timing histograms and jank classification of all frames
+///             rendered by the engine since it was launched or since the
+///             statistics were last reset. This call has no threading
+///             restrictions.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[out] statistics  The statistics to fill. The `struct_size` field
+///                         must be set by the caller.
+/// @param[in]  reset       Whether the statistics should be cleared after they
+///                         have been read.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingStatistics* statistics,
+    bool reset);
+
+//------------------------------------------------------------------------------
+/// @brief      Returns the buffer of a frame delivered to the
+///             `FlutterSoftwareRendererConfig.surface_frame_callback` to the
+///             pool of the engine. The pixels of the frame may not be accessed
+///             after this call. This call has no threading restrictions.
+///
+/// @param[in]  frame  The handle of the frame to release.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineReleaseSoftwareFrame(
+    FlutterSoftwareFrameHandle* frame);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
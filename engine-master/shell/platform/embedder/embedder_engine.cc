@@ -252,4 +252,9 @@ const Shell& EmbedderEngine::GetShell() const {
   return *shell_.get();
 }
 
+Shell& EmbedderEngine::GetShell() {
+  FML_DCHECK(shell_);
+  return *shell_.get();
+}
+
 }  // namespace flutter
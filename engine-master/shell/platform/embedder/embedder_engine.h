@@ -82,6 +82,8 @@ class EmbedderEngine {
 
   const Shell& GetShell() const;
 
+  Shell& GetShell();
+
  private:
   const std::unique_ptr<EmbedderThreadHost> thread_host_;
   TaskRunners task_runners_;
@@ -14,7 +14,15 @@ EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
       external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (software_dispatch_table_.software_present_frame) {
+    constexpr size_t kDefaultFrameBufferCount = 3;
+    const size_t buffer_count =
+        software_dispatch_table_.software_frame_buffer_count > 0
+            ? software_dispatch_table_.software_frame_buffer_count
+            : kDefaultFrameBufferCount;
+    frame_pool_ = std::make_unique<SoftwareFramePool>(
+        buffer_count, software_dispatch_table_.software_present_frame);
+  } else if (!software_dispatch_table_.software_present_backing_store) {
     return;
   }
   valid_ = true;
@@ -57,6 +65,10 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (frame_pool_) {
+    return frame_pool_->AcquireBackingStore(size);
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
     // The old and new surface sizes are the same. Nothing to do here.
@@ -83,6 +95,10 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
+  if (frame_pool_) {
+    return frame_pool_->PresentBackingStore(std::move(backing_store));
+  }
+
   SkPixmap pixmap;
   if (!backing_store->peekPixels(&pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
@@ -7,6 +7,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/gpu/software_frame_pool.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 
@@ -15,9 +16,14 @@ namespace flutter {
 class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
+  // Either |software_present_backing_store| or |software_present_frame| must
+  // be specified. With the latter, frames are rendered into a pool of buffers
+  // and presented without copies.
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;                       // optional
+    SoftwareFramePool::FrameCallback software_present_frame;  // optional
+    size_t software_frame_buffer_count;                       // optional
   };
 
   EmbedderSurfaceSoftware(
@@ -30,6 +36,9 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  // Used instead of |sk_surface_| when frames are presented to the embedder
+  // without copies.
+  std::unique_ptr<SoftwareFramePool> frame_pool_;
   std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
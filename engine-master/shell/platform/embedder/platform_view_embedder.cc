@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
 
+#include "flutter/shell/common/vsync_waiter_fallback.h"
+
 namespace flutter {
 
 PlatformViewEmbedder::PlatformViewEmbedder(
@@ -85,6 +87,10 @@ sk_sp<GrContext> PlatformViewEmbedder::CreateResourceContext() const {
 // |PlatformView|
 std::unique_ptr<VsyncWaiter> PlatformViewEmbedder::CreateVSyncWaiter() {
   if (!platform_dispatch_table_.vsync_callback) {
+    if (platform_dispatch_table_.uncapped_frame_rate) {
+      return std::make_unique<VsyncWaiterFallback>(task_runners_,
+                                                   /*uncapped=*/true);
+    }
     // Superclass implementation creates a timer based fallback.
     return PlatformView::CreateVSyncWaiter();
   }
@@ -33,6 +33,7 @@ class PlatformViewEmbedder final : public PlatformView {
     PlatformMessageResponseCallback
         platform_message_response_callback;             // optional
     VsyncWaiterEmbedder::VsyncCallback vsync_callback;  // optional
+    bool uncapped_frame_rate;                           // optional
   };
 
   // Creates a platform view that sets up an OpenGL rasterizer.
@@ -106,6 +106,21 @@ void EmbedderConfigBuilder::SetOpenGLRendererConfig(SkISize surface_size) {
   context_.SetupOpenGLSurface(surface_size);
 }
 
+void EmbedderConfigBuilder::SetSoftwareFrameCallback(
+    const std::function<void(const FlutterSoftwareFrame*)>& callback,
+    size_t buffer_count) {
+  context_.SetSoftwareFrameCallback(callback);
+  software_renderer_config_.surface_frame_callback =
+      [](void* context, const FlutterSoftwareFrame* frame) {
+        reinterpret_cast<EmbedderTestContext*>(context)->SoftwareFrameCallback(
+            frame);
+      };
+  software_renderer_config_.surface_frame_buffer_count = buffer_count;
+  if (renderer_config_.type == FlutterRendererType::kSoftware) {
+    renderer_config_.software = software_renderer_config_;
+  }
+}
+
 void EmbedderConfigBuilder::SetAssetsPath() {
   project_args_.assets_path = context_.GetAssetsPath().c_str();
 }
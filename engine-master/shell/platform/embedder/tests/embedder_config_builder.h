@@ -47,6 +47,10 @@ class EmbedderConfigBuilder {
 
   void SetOpenGLRendererConfig(SkISize surface_size);
 
+  void SetSoftwareFrameCallback(
+      const std::function<void(const FlutterSoftwareFrame*)>& callback,
+      size_t buffer_count);
+
   void SetAssetsPath();
 
   void SetSnapshots();
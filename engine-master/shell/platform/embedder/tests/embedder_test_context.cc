@@ -134,6 +134,18 @@ void EmbedderTestContext::PlatformMessageCallback(
   }
 }
 
+void EmbedderTestContext::SetSoftwareFrameCallback(
+    const std::function<void(const FlutterSoftwareFrame*)>& callback) {
+  software_frame_callback_ = callback;
+}
+
+void EmbedderTestContext::SoftwareFrameCallback(
+    const FlutterSoftwareFrame* frame) {
+  if (software_frame_callback_) {
+    software_frame_callback_(frame);
+  }
+}
+
 FlutterUpdateSemanticsNodeCallback
 EmbedderTestContext::GetUpdateSemanticsNodeCallbackHook() {
   return [](const FlutterSemanticsNode* semantics_node, void* user_data) {
@@ -59,6 +59,9 @@ class EmbedderTestContext {
   void SetPlatformMessageCallback(
       const std::function<void(const FlutterPlatformMessage*)>& callback);
 
+  void SetSoftwareFrameCallback(
+      const std::function<void(const FlutterSoftwareFrame*)>& callback);
+
   EmbedderTestCompositor& GetCompositor();
 
   std::future<sk_sp<SkImage>> GetNextSceneImage();
@@ -87,6 +90,7 @@ class EmbedderTestContext {
   SemanticsNodeCallback update_semantics_node_callback_;
   SemanticsActionCallback update_semantics_custom_action_callback_;
   std::function<void(const FlutterPlatformMessage*)> platform_message_callback_;
+  std::function<void(const FlutterSoftwareFrame*)> software_frame_callback_;
   std::unique_ptr<TestGLSurface> gl_surface_;
   std::unique_ptr<EmbedderTestCompositor> compositor_;
   NextSceneCallback next_scene_callback_;
@@ -126,6 +130,8 @@ class EmbedderTestContext {
 
   void PlatformMessageCallback(const FlutterPlatformMessage* message);
 
+  void SoftwareFrameCallback(const FlutterSoftwareFrame* frame);
+
   bool SofwarePresent(sk_sp<SkImage> image);
 
   void FireRootSurfacePresentCallbackIfPresent(
@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <mutex>
 #include <string>
 
 #include "embedder.h"
@@ -3823,5 +3824,71 @@ TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   ASSERT_EQ(FlutterEngineNotifyLowMemoryWarning(engine.get()), kSuccess);
 }
 
+TEST_F(EmbedderTest, CanPresentSoftwareFramesFromBufferPool) {
+  auto& context = GetEmbedderContext();
+
+  // Frames keep being presented while the test runs because the frame rate is
+  // uncapped. All of them are kept and only released once the engine is gone.
+  std::mutex frames_mutex;
+  std::vector<FlutterSoftwareFrame> frames;
+  fml::AutoResetWaitableEvent first_frame_latch;
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetSoftwareFrameCallback(
+      [&](const FlutterSoftwareFrame* frame) {
+        std::scoped_lock lock(frames_mutex);
+        frames.push_back(*frame);
+        if (frames.size() == 1) {
+          first_frame_latch.Signal();
+        }
+      },
+      2);
+  builder.GetProjectArgs().uncapped_frame_rate = true;
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  first_frame_latch.Wait();
+  FlutterSoftwareFrame presented_frame;
+  {
+    std::scoped_lock lock(frames_mutex);
+    presented_frame = frames.front();
+  }
+
+  ASSERT_EQ(presented_frame.struct_size, sizeof(FlutterSoftwareFrame));
+  ASSERT_EQ(presented_frame.width, 800u);
+  ASSERT_EQ(presented_frame.height, 600u);
+  ASSERT_GE(presented_frame.row_bytes, 800u * 4);
+  ASSERT_EQ(presented_frame.frame_number, 0u);
+  ASSERT_NE(presented_frame.handle, nullptr);
+
+  // The pixels of the frame remain accessible until it is released. The red
+  // box of the scene starts at (10, 10).
+  const auto* pixels = static_cast<const uint32_t*>(presented_frame.allocation);
+  ASSERT_NE(pixels[20 * (presented_frame.row_bytes / 4) + 20], 0u);
+
+  // Frames are not presented through the regular callback.
+  ASSERT_EQ(context.GetSoftwareSurfacePresentCount(), 0u);
+
+  // Shutting down must not wait for frames still held by the embedder, and
+  // frames may be released after the engine is gone.
+  engine.reset();
+  for (size_t i = 0; i < frames.size(); i++) {
+    ASSERT_EQ(frames[i].frame_number, i);
+    ASSERT_EQ(FlutterEngineReleaseSoftwareFrame(frames[i].handle), kSuccess);
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
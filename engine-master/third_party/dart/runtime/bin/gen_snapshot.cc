@@ -187,6 +187,10 @@ static void PrintUsage() {
 "[--save-obfuscation-map=<map-filename>]                                     \n"
 "<dart-kernel-file>                                                          \n"
 "                                                                            \n"
+"AOT snapshots can be compiled using type feedback recorded by a JIT run of  \n"
+"the application with --save_type_feedback=<filename>: pass the file with    \n"
+"--load_type_feedback=<filename>.                                            \n"
+"                                                                            \n"
 "AOT snapshots can be obfuscated: that is all identifiers will be renamed    \n"
 "during compilation. This mode is enabled with --obfuscate flag. Mapping     \n"
 "between original and obfuscated names can be serialized as a JSON array     \n"
@@ -452,7 +456,8 @@ static void MaybeLoadCode() {
   }
 
   if ((load_type_feedback_filename != NULL) &&
-      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT))) {
+      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT) ||
+       IsSnapshottingForPrecompilation())) {
     uint8_t* buffer = NULL;
     intptr_t size = 0;
     ReadFile(load_type_feedback_filename, &buffer, &size);
@@ -433,4 +433,96 @@ Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
 
+/*
+ * =============
+ * GC Histograms
+ * =============
+ */
+
+#define DART_GC_HISTOGRAM_BUCKETS 32
+
+typedef enum {
+  Dart_GCHistogram_ScavengePause = 0,  // Microsecond
+  Dart_GCHistogram_OldSpacePause,      // Microsecond
+  Dart_GCHistogram_PromotionRate,      // Percent of new space used before GC
+  Dart_GCHistogram_AllocationRate,     // Kilobyte per second in new space
+  Dart_GCHistogram_UsedAfterGC,        // Kilobyte
+} Dart_GCHistogramKind;
+
+/**
+ * A cumulative distribution of samples. Bucket 0 counts the samples equal to
+ * 0 and bucket i > 0 counts the samples in [2^(i-1), 2^i). The last bucket
+ * also counts all larger samples.
+ */
+typedef struct {
+  int64_t count;
+  int64_t sum;
+  int64_t max;
+  int64_t buckets[DART_GC_HISTOGRAM_BUCKETS];
+} Dart_GCHistogram;
+
+/**
+ * Copies a histogram of the garbage collections of an isolate's heap since
+ * the isolate started.
+ *
+ * Unlike metrics, GC histograms are also available in PRODUCT builds. This
+ * function may be called from any thread while the isolate is alive.
+ *
+ * \param isolate The isolate whose heap is queried.
+ * \param kind The histogram to copy.
+ * \param histogram Receives the histogram.
+ *
+ * \return True if the histogram was copied, false if kind is invalid.
+ */
+DART_EXPORT bool Dart_IsolateGCHistogram(Dart_Isolate isolate,
+                                         Dart_GCHistogramKind kind,
+                                         Dart_GCHistogram* histogram);
+
+/*
+ * ==============
+ * Heap Snapshots
+ * ==============
+ */
+
+/**
+ * A callback which receives a chunk of a heap snapshot.
+ *
+ * \param context The context passed to Dart_WriteHeapSnapshot.
+ * \param buffer The chunk's bytes, which are only valid until the callback
+ *   returns. May be NULL if size is 0.
+ * \param size The number of bytes in the chunk.
+ * \param is_last Whether this is the last chunk of the snapshot.
+ */
+typedef void (*Dart_HeapSnapshotWriteChunkCallback)(void* context,
+                                                    uint8_t* buffer,
+                                                    intptr_t size,
+                                                    bool is_last);
+
+/**
+ * Writes a snapshot of the current isolate's heap in the format described in
+ * runtime/vm/service/heap_snapshot.md.
+ *
+ * The snapshot is passed to the callback one chunk of about 1MB at a time as
+ * it is being written, and each chunk is freed when the callback returns, so
+ * the VM never holds more than one chunk of output. The embedder may compress
+ * or stream the chunks to their destination from the callback. Writing the
+ * snapshot still assigns an id to every object in the heap, which takes
+ * memory proportional to the number of objects.
+ *
+ * Requires there to be a current isolate. The callback is invoked on the
+ * current thread while the heap is being iterated, with all other threads of
+ * the isolate stopped at a safepoint. It must not call into the VM or the Dart
+ * API, and must not block on anything that waits for the isolate's mutator
+ * (for example, a task on the isolate's thread), as that would deadlock.
+ *
+ * \param write The callback which receives the chunks.
+ * \param context Passed to the callback.
+ *
+ * \return NULL if the snapshot was written, otherwise an error message which
+ *   must be freed by the caller.
+ */
+DART_EXPORT char* Dart_WriteHeapSnapshot(
+    Dart_HeapSnapshotWriteChunkCallback write,
+    void* context);
+
 #endif  // RUNTIME_INCLUDE_DART_TOOLS_API_H_
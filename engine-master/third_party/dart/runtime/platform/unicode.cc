@@ -7,9 +7,136 @@
 #include "platform/allocation.h"
 #include "platform/globals.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
+
+#if defined(HOST_ARCH_X64)
+#include <emmintrin.h>
+#elif defined(HOST_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
 
 namespace dart {
 
+// The fast paths below look at kBlockSize bytes (or code units) at a time,
+// using SSE2 or NEON where they are part of the baseline instruction set and
+// plain loops, which compilers vectorize where they can, everywhere else.
+static const intptr_t kBlockSize = 16;
+
+// Returns true if the kBlockSize bytes at 'data' are all ASCII.
+static inline bool IsAsciiBlock(const uint8_t* data) {
+#if defined(HOST_ARCH_X64)
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  return _mm_movemask_epi8(block) == 0;
+#elif defined(HOST_ARCH_ARM64)
+  return vmaxvq_u8(vld1q_u8(data)) <= Utf8::kMaxOneByteChar;
+#else
+  uint8_t bits = 0;
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    bits |= data[k];
+  }
+  return bits <= Utf8::kMaxOneByteChar;
+#endif
+}
+
+// Returns the number of UTF-8 trail bytes in the kBlockSize bytes at 'data'.
+static inline intptr_t CountTrailBytes(const uint8_t* data) {
+#if defined(HOST_ARCH_X64)
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  const __m128i is_trail =
+      _mm_cmpeq_epi8(_mm_and_si128(block, _mm_set1_epi8(0xC0)),
+                     _mm_set1_epi8(0x80));
+  return Utils::CountOneBits32(_mm_movemask_epi8(is_trail));
+#elif defined(HOST_ARCH_ARM64)
+  const uint8x16_t is_trail =
+      vceqq_u8(vandq_u8(vld1q_u8(data), vdupq_n_u8(0xC0)), vdupq_n_u8(0x80));
+  return vaddvq_u8(vshrq_n_u8(is_trail, 7));
+#else
+  intptr_t count = 0;
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    count += (data[k] & 0xC0) == 0x80 ? 1 : 0;
+  }
+  return count;
+#endif
+}
+
+// Returns the number of bytes >= 'min' in the kBlockSize bytes at 'data'.
+static inline intptr_t CountBytesAtLeast(const uint8_t* data, uint8_t min) {
+#if defined(HOST_ARCH_X64)
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  const __m128i at_least =
+      _mm_cmpeq_epi8(_mm_max_epu8(block, _mm_set1_epi8(min)), block);
+  return Utils::CountOneBits32(_mm_movemask_epi8(at_least));
+#elif defined(HOST_ARCH_ARM64)
+  const uint8x16_t at_least = vcgeq_u8(vld1q_u8(data), vdupq_n_u8(min));
+  return vaddvq_u8(vshrq_n_u8(at_least, 7));
+#else
+  intptr_t count = 0;
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    count += data[k] >= min ? 1 : 0;
+  }
+  return count;
+#endif
+}
+
+// Widens the kBlockSize ASCII bytes at 'src' to UTF-16 code units.
+static inline void WidenAsciiBlock(const uint8_t* src, uint16_t* dst) {
+#if defined(HOST_ARCH_X64)
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm_unpacklo_epi8(block, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + kBlockSize / 2),
+                   _mm_unpackhi_epi8(block, zero));
+#elif defined(HOST_ARCH_ARM64)
+  const uint8x16_t block = vld1q_u8(src);
+  vst1q_u16(dst, vmovl_u8(vget_low_u8(block)));
+  vst1q_u16(dst + kBlockSize / 2, vmovl_high_u8(block));
+#else
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    dst[k] = src[k];
+  }
+#endif
+}
+
+// Narrows the kBlockSize UTF-16 code units at 'src' to bytes if they are all
+// ASCII. Returns false without writing to 'dst' otherwise.
+static inline bool NarrowAsciiBlock(const uint16_t* src, char* dst) {
+#if defined(HOST_ARCH_X64)
+  const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i hi =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + kBlockSize / 2));
+  const __m128i non_ascii =
+      _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(0xFF80));
+  if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) !=
+      0xFFFF) {
+    return false;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+  return true;
+#elif defined(HOST_ARCH_ARM64)
+  const uint16x8_t lo = vld1q_u16(src);
+  const uint16x8_t hi = vld1q_u16(src + kBlockSize / 2);
+  if (vmaxvq_u16(vorrq_u16(lo, hi)) > Utf8::kMaxOneByteChar) {
+    return false;
+  }
+  vst1q_u8(reinterpret_cast<uint8_t*>(dst),
+           vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+  return true;
+#else
+  uint16_t bits = 0;
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    bits |= src[k];
+  }
+  if (bits > Utf8::kMaxOneByteChar) {
+    return false;
+  }
+  for (intptr_t k = 0; k < kBlockSize; k++) {
+    dst[k] = src[k];
+  }
+  return true;
+#endif
+}
+
 // clang-format off
 const int8_t Utf8::kTrailBytes[256] = {
   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
@@ -48,7 +175,24 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
                              Type* type) {
   intptr_t len = 0;
   Type char_type = kLatin1;
-  for (intptr_t i = 0; i < array_len; i++) {
+  intptr_t i = 0;
+  // Every byte that is not a trail byte starts a code point, which needs a
+  // second code unit if it is supplementary.
+  for (; i + kBlockSize <= array_len; i += kBlockSize) {
+    const uint8_t* block = &utf8_array[i];
+    if (IsAsciiBlock(block)) {
+      len += kBlockSize;
+      continue;
+    }
+    const intptr_t num_supplementary = CountBytesAtLeast(block, 0xF0);
+    len += kBlockSize - CountTrailBytes(block) + num_supplementary;
+    if (num_supplementary > 0) {
+      char_type = kSupplementary;
+    } else if ((char_type == kLatin1) && (CountBytesAtLeast(block, 0xC4) > 0)) {
+      char_type = kBMP;
+    }
+  }
+  for (; i < array_len; i++) {
     uint8_t code_unit = utf8_array[i];
     if (!IsTrailByte(code_unit)) {
       ++len;
@@ -66,30 +210,45 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
   return len;
 }
 
+intptr_t Utf8::AsciiPrefixLength(const uint8_t* utf8_array,
+                                 intptr_t array_len) {
+  intptr_t i = 0;
+  while ((i + kBlockSize <= array_len) && IsAsciiBlock(&utf8_array[i])) {
+    i += kBlockSize;
+  }
+  while ((i < array_len) && (utf8_array[i] <= kMaxOneByteChar)) {
+    i++;
+  }
+  return i;
+}
+
 // Returns true if str is a valid NUL-terminated UTF-8 string.
 bool Utf8::IsValid(const uint8_t* utf8_array, intptr_t array_len) {
   intptr_t i = 0;
   while (i < array_len) {
     uint32_t ch = utf8_array[i] & 0xFF;
+    if (ch <= kMaxOneByteChar) {
+      // Skip over runs of ASCII characters a block at a time.
+      i += AsciiPrefixLength(&utf8_array[i], array_len - i);
+      continue;
+    }
     intptr_t j = 1;
-    if (ch >= 0x80) {
-      int8_t num_trail_bytes = kTrailBytes[ch];
-      bool is_malformed = false;
-      for (; j < num_trail_bytes; ++j) {
-        if ((i + j) < array_len) {
-          uint8_t code_unit = utf8_array[i + j];
-          is_malformed |= !IsTrailByte(code_unit);
-          ch = (ch << 6) + code_unit;
-        } else {
-          return false;
-        }
-      }
-      ch -= kMagicBits[num_trail_bytes];
-      if (!((is_malformed == false) && (j == num_trail_bytes) &&
-            !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+    int8_t num_trail_bytes = kTrailBytes[ch];
+    bool is_malformed = false;
+    for (; j < num_trail_bytes; ++j) {
+      if ((i + j) < array_len) {
+        uint8_t code_unit = utf8_array[i + j];
+        is_malformed |= !IsTrailByte(code_unit);
+        ch = (ch << 6) + code_unit;
+      } else {
         return false;
       }
     }
+    ch -= kMagicBits[num_trail_bytes];
+    if (!((is_malformed == false) && (j == num_trail_bytes) &&
+          !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+      return false;
+    }
     i += j;
   }
   return true;
@@ -107,6 +266,23 @@ intptr_t Utf8::Length(int32_t ch) {
   return 4;
 }
 
+intptr_t Utf8::EncodeAscii(const uint16_t* utf16_array,
+                           intptr_t array_len,
+                           char* dst,
+                           intptr_t len) {
+  const intptr_t limit = Utils::Minimum(array_len, len);
+  intptr_t i = 0;
+  while ((i + kBlockSize <= limit) &&
+         NarrowAsciiBlock(&utf16_array[i], &dst[i])) {
+    i += kBlockSize;
+  }
+  while ((i < limit) && (utf16_array[i] <= kMaxOneByteChar)) {
+    dst[i] = utf16_array[i];
+    i++;
+  }
+  return i;
+}
+
 intptr_t Utf8::Encode(int32_t ch, char* dst) {
   static const int kMask = ~(1 << 6);
   if (ch <= kMaxOneByteChar) {
@@ -199,6 +375,14 @@ bool Utf8::DecodeToLatin1(const uint8_t* utf8_array,
   intptr_t j = 0;
   intptr_t num_bytes;
   for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+    if ((utf8_array[i] <= kMaxOneByteChar) && (i + kBlockSize <= array_len) &&
+        (j + kBlockSize <= len) && IsAsciiBlock(&utf8_array[i])) {
+      // Copy a block of ASCII characters at once.
+      memmove(&dst[j], &utf8_array[i], kBlockSize);
+      num_bytes = kBlockSize;
+      j += kBlockSize - 1;
+      continue;
+    }
     int32_t ch;
     ASSERT(IsLatin1SequenceStart(utf8_array[i]));
     num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
@@ -222,6 +406,14 @@ bool Utf8::DecodeToUTF16(const uint8_t* utf8_array,
   intptr_t j = 0;
   intptr_t num_bytes;
   for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+    if ((utf8_array[i] <= kMaxOneByteChar) && (i + kBlockSize <= array_len) &&
+        (j + kBlockSize <= len) && IsAsciiBlock(&utf8_array[i])) {
+      // Widen a block of ASCII characters at once.
+      WidenAsciiBlock(&utf8_array[i], &dst[j]);
+      num_bytes = kBlockSize;
+      j += kBlockSize - 1;
+      continue;
+    }
     int32_t ch;
     bool is_supplementary = IsSupplementarySequenceStart(utf8_array[i]);
     num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
@@ -59,6 +59,13 @@ class Utf8 : AllStatic {
   static intptr_t Encode(int32_t ch, char* dst);
   static intptr_t Encode(const String& src, char* dst, intptr_t len);
 
+  // Copies the longest prefix of ASCII code units in 'utf16_array' that fits
+  // into 'len' bytes to 'dst'. Returns the number of code units copied.
+  static intptr_t EncodeAscii(const uint16_t* utf16_array,
+                              intptr_t array_len,
+                              char* dst,
+                              intptr_t len);
+
   static intptr_t Decode(const uint8_t* utf8_array,
                          intptr_t array_len,
                          int32_t* ch);
@@ -104,6 +111,11 @@ class Utf8 : AllStatic {
     return (code_unit >= 0xF0);
   }
 
+  // Returns the length of the longest prefix of 'utf8_array' that only
+  // contains ASCII characters.
+  static intptr_t AsciiPrefixLength(const uint8_t* utf8_array,
+                                    intptr_t array_len);
+
   static const int8_t kTrailBytes[];
   static const uint32_t kMagicBits[];
   static const uint32_t kOverlongMinimum[];
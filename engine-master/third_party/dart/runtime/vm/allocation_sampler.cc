@@ -0,0 +1,311 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/allocation_sampler.h"
+
+#include <cmath>
+
+#include "platform/assert.h"
+#include "vm/flags.h"
+#include "vm/heap/heap.h"
+#include "vm/heap/scavenger.h"
+#include "vm/heap/weak_table.h"
+#include "vm/json_stream.h"
+#include "vm/object.h"
+#include "vm/stack_frame.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DEFINE_FLAG(int,
+            allocation_sample_interval,
+            0,
+            "Sample about one allocation per this many bytes and keep the "
+            "stacks of sampled objects while they are alive. 0 disables "
+            "allocation sampling.");
+
+AllocationSampler::AllocationSampler(Heap* heap)
+    : heap_(heap),
+      interval_(0),
+      countdown_(0),
+      counted_(0),
+      counted_top_(0),
+      pending_(false),
+      random_(),
+      samples_(),
+      reclaimed_length_(0) {
+  SetInterval(FLAG_allocation_sample_interval);
+}
+
+AllocationSampler::~AllocationSampler() {
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    free(samples_[i]);
+  }
+}
+
+void AllocationSampler::SetInterval(intptr_t interval) {
+  ASSERT(interval >= 0);
+  interval_ = interval;
+  pending_ = false;
+  counted_ = 0;
+  countdown_ = (interval == 0) ? 0 : NextSampleDistance();
+
+  // Limit the mutator's current TLAB to the new sampling point, or lift the
+  // limit if sampling stops.
+  Thread* thread = Thread::Current();
+  if ((thread != NULL) && (thread->heap() == heap_) &&
+      thread->IsMutatorThread() && thread->HasActiveTLAB()) {
+    counted_top_ = thread->top();
+    LimitTLAB(thread, 0);
+  }
+}
+
+// A TLAB extends to the end of its page unless it is limited.
+static uword TLABPageEnd(Thread* thread) {
+  return NewPage::Of(thread->end() - 1)->end();
+}
+
+intptr_t AllocationSampler::NextSampleDistance() {
+  // Exponentially distributed with a mean of |interval_|, so that sampling
+  // points form a Poisson process over the allocated bytes. The uniform
+  // sample is in (0, 1].
+  const double uniform =
+      (static_cast<double>(random_.NextUInt32()) + 1.0) / 4294967296.0;
+  double distance = -log(uniform) * interval_;
+  // Avoid overflow and bursts of samples.
+  const double max_distance = 32.0 * interval_;
+  if (distance > max_distance) {
+    distance = max_distance;
+  }
+  if (distance < kObjectAlignment) {
+    distance = kObjectAlignment;
+  }
+  return static_cast<intptr_t>(distance);
+}
+
+void AllocationSampler::CountAllocationSlow(Thread* thread, intptr_t size) {
+  if (!thread->IsMutatorThread()) {
+    return;
+  }
+  Count(size);
+}
+
+void AllocationSampler::Count(intptr_t size) {
+  counted_ += size;
+  countdown_ -= size;
+  if (countdown_ <= 0) {
+    pending_ = true;
+  }
+}
+
+void AllocationSampler::CountTLAB(Thread* thread) {
+  ASSERT(thread->HasActiveTLAB());
+  const uword top = thread->top();
+  // A position left from another TLAB, e.g. one acquired while sampling was
+  // disabled, counts nothing.
+  if ((counted_top_ <= top) &&
+      NewPage::Of(thread->end() - 1)->Contains(counted_top_)) {
+    Count(top - counted_top_);
+  }
+  counted_top_ = top;
+}
+
+void AllocationSampler::LimitTLAB(Thread* thread, intptr_t size) {
+  ASSERT(thread->IsMutatorThread());
+  ASSERT(thread->HasActiveTLAB());
+  const uword page_end = TLABPageEnd(thread);
+  if ((interval_ != 0) && !pending_ && (countdown_ <= size)) {
+    // The allocation about to happen crosses the sampling point.
+    pending_ = true;
+  }
+  if ((interval_ == 0) || pending_) {
+    thread->set_end(page_end);
+    return;
+  }
+  const uword limit =
+      thread->top() + Utils::RoundUp(countdown_, kObjectAlignment);
+  thread->set_end(Utils::Minimum(limit, page_end));
+}
+
+void AllocationSampler::StartTLABSlow(Thread* thread, intptr_t size) {
+  if (!thread->IsMutatorThread()) {
+    return;
+  }
+  counted_top_ = thread->top();
+  LimitTLAB(thread, size);
+}
+
+bool AllocationSampler::ReachedTLABLimit(Thread* thread) {
+  if (!thread->HasActiveTLAB()) {
+    return false;
+  }
+  const uword page_end = TLABPageEnd(thread);
+  if (thread->end() == page_end) {
+    return false;
+  }
+  ASSERT(thread->IsMutatorThread());
+  if (interval_ != 0) {
+    CountTLAB(thread);
+    pending_ = true;
+  }
+  thread->set_end(page_end);
+  return true;
+}
+
+void AllocationSampler::EndTLABSlow(Thread* thread) {
+  if (thread->IsMutatorThread() && thread->HasActiveTLAB()) {
+    CountTLAB(thread);
+  }
+}
+
+void AllocationSampler::SampleObject(Thread* thread,
+                                     RawObject* obj,
+                                     intptr_t size) {
+  ASSERT(pending_);
+  ASSERT(thread->IsMutatorThread());
+  if (thread->HasActiveTLAB()) {
+    CountTLAB(thread);
+  }
+  pending_ = false;
+  countdown_ = NextSampleDistance();
+
+  Sample* sample = reinterpret_cast<Sample*>(malloc(sizeof(Sample)));
+  sample->cid = obj->GetClassId();
+  sample->size = size;
+  sample->weight = Utils::Maximum(counted_, size);
+  sample->num_frames = 0;
+  sample->live = false;
+  counted_ = 0;
+
+  DartFrameIterator frames(thread,
+                           StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = frames.NextFrame();
+       (frame != NULL) && (sample->num_frames < kMaxFrames);
+       frame = frames.NextFrame()) {
+    sample->pcs[sample->num_frames++] = frame->pc();
+  }
+
+  if (samples_.length() >= 2 * reclaimed_length_ + 64) {
+    ReclaimDeadSamples();
+  }
+  samples_.Add(sample);
+  heap_->SetWeakEntry(obj, Heap::kAllocationSamples,
+                      reinterpret_cast<intptr_t>(sample));
+
+  if (thread->HasActiveTLAB()) {
+    LimitTLAB(thread, 0);
+  }
+}
+
+void AllocationSampler::ReclaimDeadSamples() {
+  // The weak tables only contain the samples of live objects. They are only
+  // changed by the mutator and at safepoints, so they can be read here.
+  for (intptr_t i = 0; i < 2; i++) {
+    WeakTable* table = heap_->GetWeakTable(i == 0 ? Heap::kNew : Heap::kOld,
+                                           Heap::kAllocationSamples);
+    for (intptr_t j = 0; j < table->size(); j++) {
+      if (table->IsValidEntryAtExclusive(j)) {
+        reinterpret_cast<Sample*>(table->ValueAtExclusive(j))->live = true;
+      }
+    }
+  }
+
+  intptr_t length = 0;
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    Sample* sample = samples_[i];
+    if (sample->live) {
+      sample->live = false;
+      samples_[length++] = sample;
+    } else {
+      free(sample);
+    }
+  }
+  samples_.TruncateTo(length);
+  reclaimed_length_ = length;
+}
+
+intptr_t AllocationSampler::LiveSampleCount() {
+  ReclaimDeadSamples();
+  return samples_.length();
+}
+
+void AllocationSampler::Clear() {
+  heap_->GetWeakTable(Heap::kNew, Heap::kAllocationSamples)->Reset();
+  heap_->GetWeakTable(Heap::kOld, Heap::kAllocationSamples)->Reset();
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    free(samples_[i]);
+  }
+  samples_.Clear();
+  reclaimed_length_ = 0;
+}
+
+// Orders samples by their allocating pc, then by class.
+int AllocationSampler::CompareSites(Sample* const* a, Sample* const* b) {
+  const uword a_pc = ((*a)->num_frames > 0) ? (*a)->pcs[0] : 0;
+  const uword b_pc = ((*b)->num_frames > 0) ? (*b)->pcs[0] : 0;
+  if (a_pc != b_pc) {
+    return (a_pc < b_pc) ? -1 : 1;
+  }
+  if ((*a)->cid != (*b)->cid) {
+    return ((*a)->cid < (*b)->cid) ? -1 : 1;
+  }
+  return 0;
+}
+
+void AllocationSampler::PrintRetainedJSON(JSONStream* stream) {
+  ReclaimDeadSamples();
+  samples_.Sort(CompareSites);
+
+  Isolate* isolate = Isolate::Current();
+  Class& cls = Class::Handle();
+  Code& code = Code::Handle();
+  Function& function = Function::Handle();
+
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_RetainedAllocationSamples");
+  jsobj.AddProperty("interval", interval_);
+  jsobj.AddProperty("sampleCount", samples_.length());
+  JSONArray sites(&jsobj, "sites");
+  intptr_t start = 0;
+  while (start < samples_.length()) {
+    intptr_t end = start + 1;
+    intptr_t bytes = samples_[start]->size;
+    intptr_t estimated_bytes = samples_[start]->weight;
+    while ((end < samples_.length()) &&
+           (CompareSites(&samples_[start], &samples_[end]) == 0)) {
+      bytes += samples_[end]->size;
+      estimated_bytes += samples_[end]->weight;
+      end++;
+    }
+
+    const Sample* sample = samples_[start];
+    JSONObject site(&sites);
+    cls = isolate->class_table()->At(sample->cid);
+    site.AddProperty("class", cls);
+    site.AddProperty("count", end - start);
+    site.AddProperty("bytes", bytes);
+    site.AddProperty("estimatedBytes", estimated_bytes);
+    // The stack of the first sample at this site. Frames whose code has
+    // been collected since are omitted.
+    JSONArray stack(&site, "stack");
+    for (intptr_t i = 0; i < sample->num_frames; i++) {
+      code = Code::LookupCode(sample->pcs[i]);
+      if (code.IsNull()) {
+        code = Code::LookupCodeInVmIsolate(sample->pcs[i]);
+      }
+      if (code.IsNull() || !code.IsFunctionCode()) {
+        continue;
+      }
+      function = code.function();
+      stack.AddValue(function);
+    }
+    start = end;
+  }
+}
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
@@ -0,0 +1,145 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_ALLOCATION_SAMPLER_H_
+#define RUNTIME_VM_ALLOCATION_SAMPLER_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+#include "vm/growable_array.h"
+#include "vm/random.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+class Heap;
+class JSONStream;
+class RawObject;
+class Thread;
+
+// Samples the objects allocated by the mutator of a heap about once every
+// |interval| bytes and keeps the allocation stacks of the sampled objects for
+// as long as the objects are alive.
+//
+// The end of the mutator's TLAB is lowered to the next sampling point, so the
+// inline allocation fast paths of compiled code, stubs and the interpreter
+// fall into the runtime there. Bytes allocated in the TLAB are counted when
+// it is limited, reaches its limit or is abandoned, and old space allocations
+// are counted as they happen. Once the count reaches the sampling point, the
+// next object allocated through Object::Allocate, usually the one crossing
+// it, is sampled and the TLAB is limited again. The distance between sampling
+// points is exponentially distributed with a mean of |interval|, and each
+// sample stands for the bytes counted since the previous one.
+//
+// Sampled objects are keys of a weak table of the heap, which is maintained
+// by the GC like the other weak tables. The records of samples whose objects
+// died are reclaimed lazily.
+//
+// Like the CPU profiler, the sampler is not part of PRODUCT builds, which have
+// no service protocol to enable it or to read its samples. Profile builds run
+// the same optimized AOT code and include it, so production allocation
+// profiles are taken there.
+class AllocationSampler {
+ public:
+  explicit AllocationSampler(Heap* heap);
+  ~AllocationSampler();
+
+  // 0 if sampling is disabled.
+  intptr_t interval() const { return interval_; }
+
+  // Starts sampling about once every |interval| bytes, or stops sampling if
+  // |interval| is 0. Samples taken so far are kept.
+  void SetInterval(intptr_t interval);
+
+  // Counts |size| bytes allocated by |thread| in old space.
+  void CountAllocation(Thread* thread, intptr_t size) {
+    if (interval_ != 0) {
+      CountAllocationSlow(thread, size);
+    }
+  }
+
+  // Called when |thread| acquired a new TLAB to allocate |size| bytes at its
+  // top. Limits the TLAB to the next sampling point.
+  void StartTLAB(Thread* thread, intptr_t size) {
+    if (interval_ != 0) {
+      StartTLABSlow(thread, size);
+    }
+  }
+
+  // Called when an allocation by |thread| did not fit in its TLAB. Returns
+  // true if the TLAB had been limited, in which case the allocation crosses
+  // the sampling point and the TLAB again extends to the end of its page.
+  bool ReachedTLABLimit(Thread* thread);
+
+  // Called before the TLAB of |thread| is abandoned.
+  void EndTLAB(Thread* thread) {
+    if (interval_ != 0) {
+      EndTLABSlow(thread);
+    }
+  }
+
+  // Whether the next object allocated by the mutator should be sampled.
+  bool pending() const { return pending_; }
+
+  // Records a sample for |obj|, which was just allocated by the mutator.
+  // Does not allocate in the Dart heap.
+  void SampleObject(Thread* thread, RawObject* obj, intptr_t size);
+
+  // The number of samples whose objects are still alive.
+  intptr_t LiveSampleCount();
+
+  // Discards all samples.
+  void Clear();
+
+  // Prints the live samples grouped by allocation site and class.
+  void PrintRetainedJSON(JSONStream* stream);
+
+ private:
+  static const intptr_t kMaxFrames = 8;
+
+  struct Sample {
+    intptr_t cid;
+    intptr_t size;
+    // The bytes counted since the previous sample.
+    intptr_t weight;
+    intptr_t num_frames;
+    uword pcs[kMaxFrames];
+    bool live;
+  };
+
+  void CountAllocationSlow(Thread* thread, intptr_t size);
+  void StartTLABSlow(Thread* thread, intptr_t size);
+  void EndTLABSlow(Thread* thread);
+  void Count(intptr_t size);
+  void CountTLAB(Thread* thread);
+  void LimitTLAB(Thread* thread, intptr_t size);
+  intptr_t NextSampleDistance();
+  void ReclaimDeadSamples();
+
+  static int CompareSites(Sample* const* a, Sample* const* b);
+
+  Heap* heap_;
+  intptr_t interval_;
+  // Bytes left until the next sampling point.
+  intptr_t countdown_;
+  // Bytes counted since the last sample.
+  intptr_t counted_;
+  // The top of the mutator's TLAB when its bytes were last counted.
+  uword counted_top_;
+  bool pending_;
+  Random random_;
+
+  MallocGrowableArray<Sample*> samples_;
+  // The number of samples left after the last reclamation.
+  intptr_t reclaimed_length_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSampler);
+};
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_ALLOCATION_SAMPLER_H_
@@ -0,0 +1,87 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/allocation_sampler.h"
+#include "platform/assert.h"
+#include "vm/heap/heap.h"
+#include "vm/json_stream.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+ISOLATE_UNIT_TEST_CASE(AllocationSampler_RetainedSamples) {
+  Heap* heap = thread->heap();
+  AllocationSampler* sampler = heap->allocation_sampler();
+  sampler->Clear();
+  sampler->SetInterval(KB);
+
+  const intptr_t kNumArrays = 100;
+  {
+    HANDLESCOPE(thread);
+    const Array& retained = Array::Handle(Array::New(kNumArrays, Heap::kOld));
+    Array& element = Array::Handle();
+    for (intptr_t i = 0; i < kNumArrays; i++) {
+      // Each array is much larger than the sampling interval, so almost all
+      // of them are sampled.
+      element = Array::New(KB, Heap::kOld);
+      retained.SetAt(i, element);
+    }
+    EXPECT_LT(kNumArrays / 2, sampler->LiveSampleCount());
+
+    JSONStream js;
+    sampler->PrintRetainedJSON(&js);
+    EXPECT_SUBSTRING("\"type\":\"_RetainedAllocationSamples\"", js.ToCString());
+    EXPECT_SUBSTRING("\"estimatedBytes\"", js.ToCString());
+  }
+
+  // The samples of dead objects are dropped.
+  sampler->SetInterval(0);
+  heap->CollectAllGarbage();
+  EXPECT_GT(kNumArrays / 2, sampler->LiveSampleCount());
+
+  sampler->Clear();
+  EXPECT_EQ(0, sampler->LiveSampleCount());
+}
+
+TEST_CASE(AllocationSampler_InlineAllocations) {
+  // The instances of A are allocated by stubs or inline, without going
+  // through Object::Allocate until the sampler limits the TLAB.
+  const char* kScriptChars =
+      "class A {\n"
+      "  var x;\n"
+      "  A(this.x);\n"
+      "}\n"
+      "main() {\n"
+      "  var list = new List(10000);\n"
+      "  for (var i = 0; i < list.length; i++) {\n"
+      "    list[i] = new A(i);\n"
+      "  }\n"
+      "  return list;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  AllocationSampler* sampler = thread->heap()->allocation_sampler();
+  {
+    TransitionNativeToVM transition(thread);
+    sampler->Clear();
+    sampler->SetInterval(KB);
+  }
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  TransitionNativeToVM transition(thread);
+  sampler->SetInterval(0);
+  // About one sample per kilobyte of the instances.
+  EXPECT_LT(20, sampler->LiveSampleCount());
+  JSONStream js;
+  sampler->PrintRetainedJSON(&js);
+  EXPECT_SUBSTRING("\"name\":\"A\"", js.ToCString());
+  sampler->Clear();
+}
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
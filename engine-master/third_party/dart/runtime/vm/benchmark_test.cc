@@ -13,16 +13,35 @@
 
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/unicode.h"
 
 #include "vm/clustered_snapshot.h"
 #include "vm/dart_api_impl.h"
+#include "vm/dart_entry.h"
+#include "vm/heap/weak_table.h"
+#include "vm/program_visitor.h"
+#include "vm/regexp.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_pool.h"
 #include "vm/timer.h"
 
+#if defined(DART_PRECOMPILER)
+#include "vm/compiler/backend/il_test_helper.h"
+#endif
+
 using dart::bin::File;
 
 namespace dart {
 
+DECLARE_FLAG(int, old_gen_allocation_cache);
+DECLARE_FLAG(int, external_snapshot_string_length);
+DECLARE_FLAG(bool, parallel_dedup);
+DECLARE_FLAG(bool, parallel_snapshot_fill);
+#if defined(DART_PRECOMPILER)
+DECLARE_FLAG(bool, loop_versioning);
+#endif
+
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
@@ -59,6 +78,41 @@ BENCHMARK(CorelibCompileAll) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure deduplication of the metadata of all compiled core lib code, as done
+// when writing snapshots.
+//
+static void BenchmarkDedup(Benchmark* benchmark,
+                           Thread* thread,
+                           bool parallel) {
+  SetFlagScope<bool> sfs(&FLAG_parallel_dedup, parallel);
+  bin::Builtin::SetNativeResolver(bin::Builtin::kBuiltinLibrary);
+  bin::Builtin::SetNativeResolver(bin::Builtin::kIOLibrary);
+  bin::Builtin::SetNativeResolver(bin::Builtin::kCLILibrary);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const Error& error =
+      Error::Handle(Library::CompileAll(/*ignore_error=*/true));
+  if (!error.IsNull()) {
+    OS::PrintErr("Unexpected error in CorelibDedup benchmark:\n%s",
+                 error.ToErrorCString());
+  }
+  Timer timer(true, "Dedup of core lib code benchmark");
+  timer.Start();
+  ProgramVisitor::Dedup();
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(CorelibDedup) {
+  BenchmarkDedup(benchmark, thread, false);
+}
+
+BENCHMARK(CorelibDedupParallel) {
+  BenchmarkDedup(benchmark, thread, true);
+}
+
 // This file is created by the target //runtime/bin:dart_kernel_platform_cc
 // which is depended on by run_vm_tests.
 static char* ComputeKernelServicePath(const char* arg) {
@@ -190,7 +244,13 @@ BENCHMARK(GenKernelKernelMaxRSS) {
 //
 // Measure creation of core isolate from a snapshot.
 //
-BENCHMARK(CorelibIsolateStartup) {
+static void BenchmarkIsolateStartup(Benchmark* benchmark,
+                                    Thread* thread,
+                                    bool parallel_fill,
+                                    int external_string_length) {
+  SetFlagScope<bool> sfs(&FLAG_parallel_snapshot_fill, parallel_fill);
+  SetFlagScope<int> sfs2(&FLAG_external_snapshot_string_length,
+                         external_string_length);
   const int kNumIterations = 1000;
   Timer timer(true, "CorelibIsolateStartup");
   Isolate* isolate = thread->isolate();
@@ -205,6 +265,82 @@ BENCHMARK(CorelibIsolateStartup) {
   Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
 }
 
+BENCHMARK(CorelibIsolateStartup) {
+  BenchmarkIsolateStartup(benchmark, thread, false, 0);
+}
+
+BENCHMARK(CorelibIsolateStartupParallelFill) {
+  BenchmarkIsolateStartup(benchmark, thread, true, 0);
+}
+
+BENCHMARK(CorelibIsolateStartupExternalStrings) {
+  BenchmarkIsolateStartup(benchmark, thread, false, 64);
+}
+
+//
+// Measure the resident memory of core isolates created from a snapshot, which
+// --external_snapshot_string_length reduces by leaving large strings in the
+// snapshot buffer.
+//
+static void BenchmarkIsolateStartupRSS(Benchmark* benchmark,
+                                       Thread* thread,
+                                       int external_string_length) {
+  SetFlagScope<int> sfs(&FLAG_external_snapshot_string_length,
+                        external_string_length);
+  const int kNumIsolates = 16;
+  Dart_Isolate isolates[kNumIsolates];
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  const int64_t rss_before = bin::Process::CurrentRSS();
+  for (int i = 0; i < kNumIsolates; i++) {
+    isolates[i] = TestCase::CreateTestIsolate();
+    Dart_ExitIsolate();
+  }
+  benchmark->set_score((bin::Process::CurrentRSS() - rss_before) /
+                       kNumIsolates);
+  for (int i = 0; i < kNumIsolates; i++) {
+    Dart_EnterIsolate(isolates[i]);
+    Dart_ShutdownIsolate();
+  }
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+}
+
+BENCHMARK_MEMORY(CorelibIsolateStartupRSS) {
+  BenchmarkIsolateStartupRSS(benchmark, thread, 0);
+}
+
+BENCHMARK_MEMORY(CorelibIsolateStartupExternalStringsRSS) {
+  BenchmarkIsolateStartupRSS(benchmark, thread, 64);
+}
+
+//
+// Measure spawning an isolate into the isolate group of an existing isolate,
+// which is how Isolate.spawn creates isolates when isolate groups are enabled.
+// This binary runs in JIT mode, where no code is shared with the group's
+// first isolate, so the score is the spawn latency without the shared
+// reverse PC lookup table of the precompiled runtime.
+//
+BENCHMARK(IsolateSpawnInGroup) {
+  const int kNumIterations = 1000;
+  Timer timer(true, "IsolateSpawnInGroup");
+  Isolate* isolate = thread->isolate();
+  IsolateGroup* group = isolate->group();
+  Dart_ExitIsolate();
+  for (int i = 0; i < kNumIterations; i++) {
+    char* error = nullptr;
+    timer.Start();
+    Isolate* spawned =
+        CreateWithinExistingIsolateGroup(group, "spawned", &error);
+    timer.Stop();
+    if (spawned == nullptr) {
+      FATAL1("Failed to spawn an isolate: %s", error);
+    }
+    Dart_ShutdownIsolate();
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+}
+
 //
 // Measure invocation of Dart API functions.
 //
@@ -733,6 +869,304 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+// Measures the pauses of scavenging a chain of new-space arrays that is
+// reachable through the store buffer.
+static void BenchmarkScavenge(Benchmark* benchmark,
+                              Thread* thread,
+                              intptr_t num_tasks) {
+  SetFlagScope<int> sfs(&FLAG_scavenger_tasks, num_tasks);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  const intptr_t kLength = 10000;
+  const intptr_t kLoopCount = 50;
+  Timer timer(true, "Scavenge");
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    HANDLESCOPE(thread);
+    GCTestHelper::CollectNewSpace();
+    const Array& roots = Array::Handle(Array::New(kLength, Heap::kOld));
+    Array& array = Array::Handle();
+    Array& previous = Array::Handle();
+    for (intptr_t j = 0; j < kLength; j++) {
+      array = Array::New(2, Heap::kNew);
+      array.SetAt(0, Smi::Handle(Smi::New(j)));
+      array.SetAt(1, previous);
+      roots.SetAt(j, array);
+      previous = array.raw();
+    }
+    timer.Start();
+    GCTestHelper::CollectNewSpace();
+    timer.Stop();
+  }
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(ScavengeSerial) {
+  BenchmarkScavenge(benchmark, thread, 0);
+}
+
+BENCHMARK(ScavengeParallel) {
+  BenchmarkScavenge(benchmark, thread, 4);
+}
+
+// Measures the rate of allocating small old-space objects, optionally from
+// a block reserved for the allocating thread.
+static void BenchmarkOldSpaceAllocation(Benchmark* benchmark,
+                                        Thread* thread,
+                                        intptr_t cache_size_kb) {
+  SetFlagScope<int> sfs(&FLAG_old_gen_allocation_cache, cache_size_kb);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  const intptr_t kLength = 100000;
+  const intptr_t kLoopCount = 10;
+  Timer timer(true, "OldSpaceAllocation");
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    HANDLESCOPE(thread);
+    GCTestHelper::CollectAllGarbage();
+    const Array& roots = Array::Handle(Array::New(kLength, Heap::kOld));
+    Array& array = Array::Handle();
+    timer.Start();
+    for (intptr_t j = 0; j < kLength; j++) {
+      array = Array::New(2, Heap::kOld);
+      roots.SetAt(j, array);
+    }
+    timer.Stop();
+  }
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(OldSpaceAllocationUncached) {
+  BenchmarkOldSpaceAllocation(benchmark, thread, 0);
+}
+
+BENCHMARK(OldSpaceAllocationCached) {
+  BenchmarkOldSpaceAllocation(benchmark, thread, 16);
+}
+
+class WeakTableLookupTask : public ThreadPool::Task {
+ public:
+  WeakTableLookupTask(WeakTable* table,
+                      intptr_t num_keys,
+                      Monitor* monitor,
+                      intptr_t* num_running)
+      : table_(table),
+        num_keys_(num_keys),
+        monitor_(monitor),
+        num_running_(num_running) {}
+
+  virtual void Run() {
+    intptr_t sum = 0;
+    for (intptr_t round = 0; round < 1000; round++) {
+      for (intptr_t i = 0; i < num_keys_; i++) {
+        sum += table_->GetValue(Key(i));
+      }
+    }
+    RELEASE_ASSERT(sum > 0);
+    MonitorLocker ml(monitor_);
+    (*num_running_)--;
+    ml.Notify();
+  }
+
+  // The table never dereferences its keys.
+  static RawObject* Key(intptr_t i) {
+    return reinterpret_cast<RawObject*>((i + 1) * kObjectAlignment +
+                                        kHeapObjectTag);
+  }
+
+ private:
+  WeakTable* table_;
+  intptr_t num_keys_;
+  Monitor* monitor_;
+  intptr_t* num_running_;
+};
+
+// Measures identity hash style lookups in a weak table from several threads
+// while another thread keeps adding entries.
+BENCHMARK(WeakTableContention) {
+  const intptr_t kNumKeys = 1000;
+  const intptr_t kNumTasks = 4;
+  WeakTable table;
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    table.SetValue(WeakTableLookupTask::Key(i), i + 1);
+  }
+
+  Timer timer(true, "WeakTableContention");
+  timer.Start();
+  Monitor monitor;
+  intptr_t num_running = kNumTasks;
+  for (intptr_t i = 0; i < kNumTasks; i++) {
+    bool result = Dart::thread_pool()->Run<WeakTableLookupTask>(
+        &table, kNumKeys, &monitor, &num_running);
+    ASSERT(result);
+  }
+  for (intptr_t i = kNumKeys; i < 100 * kNumKeys; i++) {
+    table.SetValue(WeakTableLookupTask::Key(i), i + 1);
+  }
+  {
+    MonitorLocker ml(&monitor);
+    while (num_running > 0) {
+      ml.Wait();
+    }
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+#if defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+//
+// Measure AOT code for a loop whose bounds checks are only removed by loop
+// versioning.
+//
+static void BenchmarkLoopVersioning(Benchmark* benchmark,
+                                    Thread* thread,
+                                    bool versioning) {
+  SetFlagScope<bool> sfs(&FLAG_loop_versioning, versioning);
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      int dot(Int32List a, Int32List b) {
+        final n = a.length;
+        int result = 0;
+        for (int i = 0; i < n; i++) {
+          result += a[i] * b[i];
+        }
+        return result;
+      }
+    )";
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const auto& root_library = Library::Handle(LoadTestScript(kScriptChars));
+  const auto& function = Function::Handle(GetFunction(root_library, "dot"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  pipeline.RunPasses({});
+  pipeline.CompileGraphAndAttachFunction();
+
+  const intptr_t kLength = 1000;
+  const intptr_t kLoopCount = 10000;
+  const auto& a =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& b =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& arguments = Array::Handle(Array::New(2));
+  arguments.SetAt(0, a);
+  arguments.SetAt(1, b);
+  auto& result = Object::Handle();
+  Timer timer(true, "Loop versioning benchmark");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    result = DartEntry::InvokeFunction(function, arguments);
+    EXPECT(result.IsInteger());
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(LoopVersioning) {
+  BenchmarkLoopVersioning(benchmark, thread, true);
+}
+
+BENCHMARK(LoopVersioningDisabled) {
+  BenchmarkLoopVersioning(benchmark, thread, false);
+}
+#endif  // defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+//
+// Measure decoding large UTF-8 inputs into strings and encoding them back.
+//
+static void BenchmarkUtf8(Benchmark* benchmark,
+                          Thread* thread,
+                          const char* text) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kInputSize = 1 * MB;
+  const intptr_t kLoopCount = 100;
+  const intptr_t text_length = strlen(text);
+  uint8_t* input = zone.GetZone()->Alloc<uint8_t>(kInputSize);
+  for (intptr_t i = 0; i < kInputSize; i++) {
+    input[i] = text[i % text_length];
+  }
+  // Do not cut the last character in half.
+  const intptr_t input_length = kInputSize - (kInputSize % text_length);
+  char* output = zone.GetZone()->Alloc<char>(input_length);
+  auto& str = String::Handle();
+  Timer timer(true, "UTF-8 benchmark");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    EXPECT(Utf8::IsValid(input, input_length));
+    str = String::FromUTF8(input, input_length);
+    EXPECT_EQ(input_length, Utf8::Encode(str, output, input_length));
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(Utf8Ascii) {
+  BenchmarkUtf8(benchmark, thread, "The quick brown fox jumps over the dog. ");
+}
+
+BENCHMARK(Utf8Latin1) {
+  BenchmarkUtf8(benchmark, thread,
+                "Les na\xC3\xAF"
+                "fs \xC3\xA6githales h\xC3\xA2tifs. ");
+}
+
+BENCHMARK(Utf8CJK) {
+  BenchmarkUtf8(benchmark, thread,
+                "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xA8"
+                "\xE4\xB8\xAD\xE6\x96\x87 mixed text. ");
+}
+
+//
+// Measure interpreted regular expressions that scan a long one-byte subject
+// for a literal or a character class that occurs only at its end.
+//
+static void BenchmarkRegExpScan(Benchmark* benchmark,
+                                Thread* thread,
+                                const char* pattern) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kSubjectSize = 64 * KB;
+  const intptr_t kLoopCount = 1000;
+  const char* kLine = "info: request served in a few milliseconds\n";
+  const char* kLastLine = "ERROR: 404-17\n";
+  const intptr_t line_length = strlen(kLine);
+  const intptr_t last_line_length = strlen(kLastLine);
+  uint8_t* chars = zone.GetZone()->Alloc<uint8_t>(kSubjectSize);
+  for (intptr_t i = 0; i < kSubjectSize - last_line_length; i++) {
+    chars[i] = kLine[i % line_length];
+  }
+  memmove(&chars[kSubjectSize - last_line_length], kLastLine,
+          last_line_length);
+  const auto& subject =
+      String::Handle(OneByteString::New(chars, kSubjectSize, Heap::kOld));
+  const bool old_interpret_irregexp = FLAG_interpret_irregexp;
+  FLAG_interpret_irregexp = true;
+  const auto& regexp = RegExp::Handle(RegExpEngine::CreateRegExp(
+      thread, String::Handle(String::New(pattern)), RegExpFlags()));
+  auto& result = Instance::Handle();
+  Timer timer(true, "RegExp scan benchmark");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    result = BytecodeRegExpMacroAssembler::Interpret(
+        regexp, subject, Object::smi_zero(), /*sticky=*/false,
+        zone.GetZone());
+    EXPECT(!result.IsNull());
+  }
+  timer.Stop();
+  FLAG_interpret_irregexp = old_interpret_irregexp;
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(RegExpScanLiteral) {
+  BenchmarkRegExpScan(benchmark, thread, "ERROR");
+}
+
+BENCHMARK(RegExpScanCharacterClass) {
+  BenchmarkRegExpScan(benchmark, thread, "[0-9]+-[0-9]+");
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
@@ -17,12 +17,14 @@
 #include "vm/flag_list.h"
 #include "vm/heap/heap.h"
 #include "vm/image_snapshot.h"
+#include "vm/lockers.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/program_visitor.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 
@@ -35,32 +37,16 @@ namespace dart {
 static void RelocateCodeObjects(
     bool is_vm,
     GrowableArray<RawCode*>* code_objects,
+    intptr_t hot_code_length,
     GrowableArray<ImageWriterCommand>* image_writer_commands) {
   auto thread = Thread::Current();
   auto isolate = is_vm ? Dart::vm_isolate() : thread->isolate();
 
   WritableCodePages writable_code_pages(thread, isolate);
-  CodeRelocator::Relocate(thread, code_objects, image_writer_commands, is_vm);
+  CodeRelocator::Relocate(thread, code_objects, hot_code_length,
+                          image_writer_commands, is_vm);
 }
 
-class RawCodeKeyValueTrait {
- public:
-  // Typedefs needed for the DirectChainedHashMap template.
-  typedef const RawCode* Key;
-  typedef const RawCode* Value;
-  typedef const RawCode* Pair;
-
-  static Key KeyOf(Pair kv) { return kv; }
-  static Value ValueOf(Pair kv) { return kv; }
-  static inline intptr_t Hashcode(Key key) {
-    return reinterpret_cast<intptr_t>(key);
-  }
-
-  static inline bool IsKeyEqual(Pair pair, Key key) { return pair == key; }
-};
-
-typedef DirectChainedHashMap<RawCodeKeyValueTrait> RawCodeSet;
-
 #endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
 
 static RawObject* AllocateUninitialized(PageSpace* old_space, intptr_t size) {
@@ -203,6 +189,9 @@ class ClassDeserializationCluster : public DeserializationCluster {
   ClassDeserializationCluster() {}
   ~ClassDeserializationCluster() {}
 
+  // Filling registers the classes in the isolate's class table.
+  bool CanReadFillInParallel() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     predefined_start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -1468,6 +1457,9 @@ class CodeDeserializationCluster : public DeserializationCluster {
   CodeDeserializationCluster() {}
   ~CodeDeserializationCluster() {}
 
+  // Initializing the entry points requires a current thread in debug mode.
+  bool CanReadFillInParallel() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -2439,6 +2431,7 @@ class MegamorphicCacheSerializationCluster : public SerializationCluster {
       AutoTraceObjectName(cache, cache->ptr()->target_name_);
       WriteFromTo(cache);
       s->Write<int32_t>(cache->ptr()->filled_entry_count_);
+      s->Write<int32_t>(cache->ptr()->migration_index_);
     }
   }
 
@@ -2470,7 +2463,9 @@ class MegamorphicCacheDeserializationCluster : public DeserializationCluster {
       Deserializer::InitializeHeader(cache, kMegamorphicCacheCid,
                                      MegamorphicCache::InstanceSize());
       ReadFromTo(cache);
+      cache->ptr()->hit_count_ = Smi::New(0);
       cache->ptr()->filled_entry_count_ = d->Read<int32_t>();
+      cache->ptr()->migration_index_ = d->Read<int32_t>();
     }
   }
 
@@ -4010,6 +4005,9 @@ class LinkedHashMapDeserializationCluster : public DeserializationCluster {
   LinkedHashMapDeserializationCluster() {}
   ~LinkedHashMapDeserializationCluster() {}
 
+  // Filling allocates the data arrays.
+  bool CanReadFillInParallel() const { return false; }
+
   void ReadAlloc(Deserializer* d) {
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
@@ -4193,9 +4191,75 @@ class OneByteStringSerializationCluster : public SerializationCluster {
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// External one-byte strings are written in the same format as one-byte
+// strings, but under their own cid so that they are never confused with the
+// read-only strings of snapshots that include code.
+class ExternalOneByteStringSerializationCluster : public SerializationCluster {
+ public:
+  ExternalOneByteStringSerializationCluster()
+      : SerializationCluster("ExternalOneByteString") {}
+  ~ExternalOneByteStringSerializationCluster() {}
+
+  void Trace(Serializer* s, RawObject* object) {
+    RawExternalOneByteString* str =
+        reinterpret_cast<RawExternalOneByteString*>(object);
+    objects_.Add(str);
+  }
+
+  void WriteAlloc(Serializer* s) {
+    s->WriteCid(kExternalOneByteStringCid);
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      RawExternalOneByteString* str = objects_[i];
+      s->AssignRef(str);
+      AutoTraceObject(str);
+      const intptr_t length = Smi::Value(str->ptr()->length_);
+      s->WriteUnsigned(length);
+    }
+  }
+
+  void WriteFill(Serializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      RawExternalOneByteString* str = objects_[i];
+      AutoTraceObject(str);
+      const intptr_t length = Smi::Value(str->ptr()->length_);
+      s->WriteUnsigned(length);
+      s->Write<bool>(str->IsCanonical());
+      intptr_t hash = String::GetCachedHash(str);
+      s->Write<int32_t>(hash);
+      s->WriteBytes(str->ptr()->external_data_, length);
+    }
+  }
+
+ private:
+  GrowableArray<RawExternalOneByteString*> objects_;
+};
+#endif  // !DART_PRECOMPILED_RUNTIME
+
+// Off by default until the CorelibIsolateStartupRSS benchmarks show a saving
+// on real snapshots and all embedders are known to keep the snapshot buffer
+// alive for as long as the isolate group.
+DEFINE_FLAG(int,
+            external_snapshot_string_length,
+            0,
+            "Read one-byte strings of at least this many characters from full "
+            "snapshots as external strings backed by the snapshot buffer "
+            "instead of copying them into the heap. 0 disables.");
+
+// Also reads the strings written by ExternalOneByteStringSerializationCluster.
+//
+// Strings of at least --external_snapshot_string_length characters are not
+// copied: they become external strings whose characters stay in the snapshot
+// buffer, which outlives the isolate. Their pages are only touched when the
+// strings are used, which saves startup time and resident memory for large
+// constant strings that are rarely read.
 class OneByteStringDeserializationCluster : public DeserializationCluster {
  public:
-  OneByteStringDeserializationCluster() {}
+  OneByteStringDeserializationCluster()
+      : external_length_(FLAG_external_snapshot_string_length) {}
   ~OneByteStringDeserializationCluster() {}
 
   void ReadAlloc(Deserializer* d) {
@@ -4204,17 +4268,36 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
     const intptr_t count = d->ReadUnsigned();
     for (intptr_t i = 0; i < count; i++) {
       const intptr_t length = d->ReadUnsigned();
-      d->AssignRef(AllocateUninitialized(old_space,
-                                         OneByteString::InstanceSize(length)));
+      if (IsExternal(length)) {
+        d->AssignRef(AllocateUninitialized(
+            old_space, ExternalOneByteString::InstanceSize()));
+      } else {
+        d->AssignRef(AllocateUninitialized(
+            old_space, OneByteString::InstanceSize(length)));
+      }
     }
     stop_index_ = d->next_index();
   }
 
   void ReadFill(Deserializer* d) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
-      RawOneByteString* str = reinterpret_cast<RawOneByteString*>(d->Ref(id));
       const intptr_t length = d->ReadUnsigned();
       bool is_canonical = d->Read<bool>();
+      if (IsExternal(length)) {
+        RawExternalOneByteString* str =
+            reinterpret_cast<RawExternalOneByteString*>(d->Ref(id));
+        Deserializer::InitializeHeader(str, kExternalOneByteStringCid,
+                                       ExternalOneByteString::InstanceSize(),
+                                       is_canonical);
+        str->ptr()->length_ = Smi::New(length);
+        String::SetCachedHash(str, d->Read<int32_t>());
+        str->ptr()->external_data_ = d->CurrentBufferAddress();
+        str->ptr()->peer_ = NULL;
+        d->Advance(length);
+        // No finalizer / external size 0.
+        continue;
+      }
+      RawOneByteString* str = reinterpret_cast<RawOneByteString*>(d->Ref(id));
       Deserializer::InitializeHeader(str, kOneByteStringCid,
                                      OneByteString::InstanceSize(length),
                                      is_canonical);
@@ -4225,6 +4308,13 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
       }
     }
   }
+
+ private:
+  bool IsExternal(intptr_t length) const {
+    return (external_length_ > 0) && (length >= external_length_);
+  }
+
+  const intptr_t external_length_;
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -4526,6 +4616,8 @@ SerializationCluster* Serializer::NewClusterForClass(intptr_t cid) {
       return new (Z) ArraySerializationCluster(kImmutableArrayCid);
     case kOneByteStringCid:
       return new (Z) OneByteStringSerializationCluster();
+    case kExternalOneByteStringCid:
+      return new (Z) ExternalOneByteStringSerializationCluster();
     case kTwoByteStringCid:
       return new (Z) TwoByteStringSerializationCluster();
     default:
@@ -4746,8 +4838,23 @@ void Serializer::Serialize() {
         static_cast<CodeSerializationCluster*>(clusters_by_cid_[kCodeCid])
             ->discovered_objects();
 
+    // Code which ran when the type feedback was recorded is laid out first,
+    // so it is on as few pages as possible. This is only done for bare
+    // instructions, whose code order table keeps the text order at runtime.
+    intptr_t hot_code_length = 0;
+    if (!vm_) {
+      auto object_store = Isolate::Current()->object_store();
+      const auto& hot_code = Array::Handle(object_store->hot_code());
+      if (FLAG_use_bare_instructions && !hot_code.IsNull()) {
+        hot_code_length =
+            CodeRelocator::MoveHotCodeFirst(hot_code, code_objects);
+      }
+      // The list would otherwise keep all of its code alive.
+      object_store->set_hot_code(Array::null_array());
+    }
+
     GrowableArray<ImageWriterCommand> writer_commands;
-    RelocateCodeObjects(vm_, code_objects, &writer_commands);
+    RelocateCodeObjects(vm_, code_objects, hot_code_length, &writer_commands);
     image_writer_->PrepareForSerialization(&writer_commands);
 
     // We permute the code objects in the [CodeSerializationCluster] so they
@@ -4810,15 +4917,40 @@ void Serializer::Serialize() {
   // We should have assigned a ref to every object we pushed.
   ASSERT((next_ref_index_ - 1) == num_objects);
 
+  // The offsets of the clusters' fill sections from the start of the first
+  // one, followed by the size of all of them, which allows the deserializer
+  // to fill clusters concurrently. They have a fixed size so that they can be
+  // written once the fill sections have been.
+  const intptr_t fill_offsets_position = stream_.Position();
+  const uint32_t placeholder = 0;
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    WriteBytes(reinterpret_cast<const uint8_t*>(&placeholder),
+               sizeof(placeholder));
+  }
+  const intptr_t fill_start = stream_.Position();
+  GrowableArray<uint32_t> fill_offsets(num_clusters + 1);
+
   for (intptr_t cid = 1; cid < num_cids_; cid++) {
     SerializationCluster* cluster = clusters_by_cid_[cid];
     if (cluster != NULL) {
+      fill_offsets.Add(stream_.Position() - fill_start);
       cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
       Write<int32_t>(kSectionMarker);
 #endif
     }
   }
+  fill_offsets.Add(stream_.Position() - fill_start);
+  ASSERT(fill_offsets.length() == num_clusters + 1);
+
+  const intptr_t fill_end = stream_.Position();
+  stream_.SetPosition(fill_offsets_position);
+  for (intptr_t i = 0; i <= num_clusters; i++) {
+    const uint32_t offset = fill_offsets[i];
+    WriteBytes(reinterpret_cast<const uint8_t*>(&offset), sizeof(offset));
+  }
+  ASSERT(stream_.Position() == fill_start);
+  stream_.SetPosition(fill_end);
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_print_snapshot_sizes_verbose) {
@@ -4997,6 +5129,12 @@ void Serializer::WriteIsolateSnapshot(intptr_t num_base_objects,
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+DEFINE_FLAG(bool,
+            parallel_snapshot_fill,
+            false,
+            "Initialize the objects of large snapshot clusters on the thread "
+            "pool.");
+
 Deserializer::Deserializer(Thread* thread,
                            Snapshot::Kind kind,
                            const uint8_t* buffer,
@@ -5021,6 +5159,27 @@ Deserializer::Deserializer(Thread* thread,
   stream_.SetPosition(offset);
 }
 
+Deserializer::Deserializer(Deserializer* parent,
+                           const uint8_t* buffer,
+                           intptr_t section_start,
+                           intptr_t section_end)
+    : ThreadStackResource(nullptr),
+      heap_(parent->heap_),
+      zone_(nullptr),
+      kind_(parent->kind_),
+      stream_(buffer, section_end),
+      image_reader_(parent->image_reader_),
+      num_base_objects_(parent->num_base_objects_),
+      num_objects_(parent->num_objects_),
+      num_clusters_(0),
+      refs_(parent->refs_),
+      next_ref_index_(parent->next_ref_index_),
+      clusters_(nullptr) {
+  // The stream starts at the start of the snapshot rather than the section so
+  // that Align pads to the same positions as the serializer did.
+  stream_.SetPosition(section_start);
+}
+
 Deserializer::~Deserializer() {
   delete[] clusters_;
 }
@@ -5140,6 +5299,7 @@ DeserializationCluster* Deserializer::ReadCluster() {
     case kImmutableArrayCid:
       return new (Z) ArrayDeserializationCluster(kImmutableArrayCid);
     case kOneByteStringCid:
+    case kExternalOneByteStringCid:
       return new (Z) OneByteStringDeserializationCluster();
     case kTwoByteStringCid:
       return new (Z) TwoByteStringDeserializationCluster();
@@ -5304,6 +5464,19 @@ void Deserializer::Deserialize() {
   // We should have completely filled the ref array.
   ASSERT((next_ref_index_ - 1) == num_objects_);
 
+  // See Serializer::Serialize. Like the rest of the snapshot, the offsets are
+  // in the byte order of the target.
+  uint32_t* fill_offsets = zone_->Alloc<uint32_t>(num_clusters_ + 1);
+  ReadBytes(reinterpret_cast<uint8_t*>(fill_offsets),
+            (num_clusters_ + 1) * sizeof(uint32_t));
+  const intptr_t fill_start = stream_.Position();
+
+  if (FLAG_parallel_snapshot_fill) {
+    ReadFillInParallel(fill_start, fill_offsets);
+    stream_.SetPosition(fill_start + fill_offsets[num_clusters_]);
+    return;
+  }
+
   for (intptr_t i = 0; i < num_clusters_; i++) {
     clusters_[i]->ReadFill(this);
 #if defined(DEBUG)
@@ -5311,6 +5484,102 @@ void Deserializer::Deserialize() {
     ASSERT(section_marker == kSectionMarker);
 #endif
   }
+  ASSERT(stream_.Position() == fill_start + fill_offsets[num_clusters_]);
+}
+
+class FillClusterTask : public ThreadPool::Task {
+ public:
+  FillClusterTask(Deserializer* deserializer,
+                  DeserializationCluster* cluster,
+                  const uint8_t* buffer,
+                  intptr_t section_start,
+                  intptr_t section_end,
+                  Monitor* monitor,
+                  intptr_t* num_pending)
+      : deserializer_(deserializer),
+        cluster_(cluster),
+        buffer_(buffer),
+        section_start_(section_start),
+        section_end_(section_end),
+        monitor_(monitor),
+        num_pending_(num_pending) {}
+
+  virtual void Run() {
+    {
+      Deserializer d(deserializer_, buffer_, section_start_, section_end_);
+      cluster_->ReadFill(&d);
+#if defined(DEBUG)
+      int32_t section_marker = d.Read<int32_t>();
+      ASSERT(section_marker == kSectionMarker);
+#endif
+      ASSERT(d.stream_.PendingBytes() == 0);
+    }
+
+    MonitorLocker ml(monitor_);
+    (*num_pending_)--;
+    ml.Notify();
+  }
+
+ private:
+  Deserializer* deserializer_;
+  DeserializationCluster* cluster_;
+  const uint8_t* buffer_;
+  intptr_t section_start_;
+  intptr_t section_end_;
+  Monitor* monitor_;
+  intptr_t* num_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(FillClusterTask);
+};
+
+void Deserializer::ReadFillInParallel(intptr_t fill_start,
+                                      const uint32_t* fill_offsets) {
+  // Clusters this small are filled faster than a task starts.
+  const intptr_t kMinParallelFillObjects = 256;
+
+  ASSERT(stream_.Position() == fill_start);
+  const uint8_t* buffer = CurrentBufferAddress() - fill_start;
+
+  Monitor monitor;
+  intptr_t num_pending = 0;
+  bool* dispatched = zone_->Alloc<bool>(num_clusters_);
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    DeserializationCluster* cluster = clusters_[i];
+    dispatched[i] = false;
+    if (!cluster->CanReadFillInParallel() ||
+        (cluster->num_objects() < kMinParallelFillObjects)) {
+      continue;
+    }
+    {
+      MonitorLocker ml(&monitor);
+      num_pending++;
+    }
+    if (Dart::thread_pool()->Run<FillClusterTask>(
+            this, cluster, buffer, fill_start + fill_offsets[i],
+            fill_start + fill_offsets[i + 1], &monitor, &num_pending)) {
+      dispatched[i] = true;
+    } else {
+      MonitorLocker ml(&monitor);
+      num_pending--;
+    }
+  }
+
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (dispatched[i]) {
+      continue;
+    }
+    stream_.SetPosition(fill_start + fill_offsets[i]);
+    clusters_[i]->ReadFill(this);
+#if defined(DEBUG)
+    int32_t section_marker = Read<int32_t>();
+    ASSERT(section_marker == kSectionMarker);
+#endif
+  }
+
+  MonitorLocker ml(&monitor);
+  while (num_pending > 0) {
+    ml.Wait();
+  }
 }
 
 class HeapLocker : public StackResource {
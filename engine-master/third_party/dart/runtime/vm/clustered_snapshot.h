@@ -46,6 +46,9 @@ class ImageReader;
 // initialization/fill secton is read for each cluster, using the indices into
 // the reference array to fill pointers. At this point, every object has been
 // touched exactly once and in order, making this approach very cache friendly.
+// The fill section is preceded by a table of the offsets of each cluster's
+// part of it, so that clusters can also be filled in parallel (see
+// --parallel_snapshot_fill).
 // Finally, each cluster is given an opportunity to perform some fix-ups that
 // require the graph has been fully loaded, such as rehashing, though most
 // clusters do not require fixups.
@@ -92,6 +95,14 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether ReadFill may run on a helper thread while other clusters are being
+  // filled. Such a ReadFill may only read its own section of the snapshot and
+  // the ref array: the deserializer it is given has no thread, zone or
+  // isolate.
+  virtual bool CanReadFillInParallel() const { return true; }
+
+  intptr_t num_objects() const { return stop_index_ - start_index_; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {}
@@ -573,6 +584,18 @@ class Deserializer : public ThreadStackResource {
   intptr_t code_order_length() const { return code_order_length_; }
 
  private:
+  // A deserializer for the fill section of a single cluster of |parent|'s
+  // snapshot, used on a helper thread. The section is given by its offsets
+  // into |buffer|, the start of |parent|'s snapshot.
+  Deserializer(Deserializer* parent,
+               const uint8_t* buffer,
+               intptr_t section_start,
+               intptr_t section_end);
+
+  // Fills the clusters that allow it on the thread pool and the rest on this
+  // thread.
+  void ReadFillInParallel(intptr_t fill_start, const uint32_t* fill_offsets);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
@@ -585,6 +608,8 @@ class Deserializer : public ThreadStackResource {
   RawArray* refs_;
   intptr_t next_ref_index_;
   DeserializationCluster** clusters_;
+
+  friend class FillClusterTask;
 };
 
 #define ReadFromTo(obj, ...) d->ReadFromTo(obj, ##__VA_ARGS__);
@@ -4,6 +4,7 @@
 
 #include "vm/compilation_trace.h"
 
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/globals.h"
 #include "vm/log.h"
@@ -19,6 +20,8 @@ namespace dart {
 
 DEFINE_FLAG(bool, trace_compilation_trace, false, "Trace compilation trace.");
 
+typedef UnorderedHashMap<FunctionKeyTraits> FunctionFeedbackMap;
+
 CompilationTraceSaver::CompilationTraceSaver(Zone* zone)
     : buf_(zone, 1 * MB),
       func_name_(String::Handle(zone)),
@@ -683,6 +686,15 @@ RawObject* TypeFeedbackLoader::CheckHeader() {
   }
   stream_->Advance(version_len);
 
+  if (FLAG_precompiled_mode) {
+    // The flags only need to match for the deopt ids to match, but the
+    // precompiler does not use the recorded deopt ids.
+    const char* features =
+        reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
+    stream_->Advance(Utils::StrNLen(features, stream_->PendingBytes()) + 1);
+    return Error::null();
+  }
+
   char* expected_features = CompilerFlags();
   ASSERT(expected_features != NULL);
   const intptr_t expected_len = strlen(expected_features);
@@ -731,7 +743,8 @@ RawObject* TypeFeedbackLoader::LoadClasses() {
 RawObject* TypeFeedbackLoader::LoadFields() {
   for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
     cls_ = ReadClassByName();
-    bool skip = cls_.IsNull();
+    // Field guards are not used in AOT.
+    bool skip = cls_.IsNull() || FLAG_precompiled_mode;
 
     intptr_t num_fields = ReadInt();
     if (!skip && (num_fields > 0)) {
@@ -827,6 +840,10 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
     }
   }
 
+  if (FLAG_precompiled_mode) {
+    return RecordCallSites(skip, usage, num_call_sites);
+  }
+
   if (!skip) {
     error_ = Compiler::CompileFunction(thread_, func_);
     if (error_.IsError()) {
@@ -920,6 +937,76 @@ RawObject* TypeFeedbackLoader::LoadFunction() {
   return Error::null();
 }
 
+// Keeps the call sites of |func_| for the precompiler, which compiles the
+// function later.
+RawObject* TypeFeedbackLoader::RecordCallSites(bool skip,
+                                               intptr_t usage,
+                                               intptr_t num_call_sites) {
+  const Array& feedback = Array::Handle(
+      zone_, skip ? Array::null()
+                  : Array::New(AotTypeFeedback::kFirstCallSiteIndex +
+                                   num_call_sites,
+                               Heap::kOld));
+  Array& call_site = Array::Handle(zone_);
+  GrowableArray<intptr_t> entries;
+
+  for (intptr_t i = 0; i < num_call_sites; i++) {
+    ReadInt();  // Deopt id.
+    intptr_t rebind_rule = ReadInt();
+    target_name_ = ReadString();
+    intptr_t num_checked_arguments = ReadInt();
+    intptr_t num_entries = ReadInt();
+
+    entries.Clear();
+    for (intptr_t entry_index = 0; entry_index < num_entries; entry_index++) {
+      intptr_t entry_usage = ReadInt();
+      intptr_t start = entries.length();
+      entries.Add(entry_usage);
+      for (intptr_t argument_index = 0; argument_index < num_checked_arguments;
+           argument_index++) {
+        entries.Add(cid_map_[ReadInt()]);
+      }
+      for (intptr_t j = start + 1; j < entries.length(); j++) {
+        if (entries[j] == kIllegalCid) {
+          entries.TruncateTo(start);
+          break;
+        }
+      }
+    }
+
+    if (skip) {
+      continue;
+    }
+    call_site = Array::New(AotTypeFeedback::kFirstEntryIndex + entries.length(),
+                           Heap::kOld);
+    call_site.SetAt(AotTypeFeedback::kRebindRuleIndex,
+                    Smi::Handle(zone_, Smi::New(rebind_rule)));
+    call_site.SetAt(AotTypeFeedback::kTargetNameIndex, target_name_);
+    call_site.SetAt(AotTypeFeedback::kNumArgsTestedIndex,
+                    Smi::Handle(zone_, Smi::New(num_checked_arguments)));
+    for (intptr_t j = 0; j < entries.length(); j++) {
+      call_site.SetAt(AotTypeFeedback::kFirstEntryIndex + j,
+                      Smi::Handle(zone_, Smi::New(entries[j])));
+    }
+    feedback.SetAt(AotTypeFeedback::kFirstCallSiteIndex + i, call_site);
+  }
+
+  if (!skip) {
+    feedback.SetAt(AotTypeFeedback::kUsageIndex,
+                   Smi::Handle(zone_, Smi::New(usage)));
+    ObjectStore* object_store = thread_->isolate()->object_store();
+    if (object_store->aot_type_feedback() == Array::null()) {
+      object_store->set_aot_type_feedback(Array::Handle(
+          zone_, HashTables::New<FunctionFeedbackMap>(16, Heap::kOld)));
+    }
+    FunctionFeedbackMap map(zone_, object_store->aot_type_feedback());
+    map.UpdateOrInsert(func_, feedback);
+    object_store->set_aot_type_feedback(map.Release());
+  }
+
+  return Error::null();
+}
+
 RawFunction* TypeFeedbackLoader::FindFunction(RawFunction::Kind kind,
                                               intptr_t token_pos) {
   if (cls_name_.Equals(Symbols::TopLevel())) {
@@ -1026,6 +1113,193 @@ RawString* TypeFeedbackLoader::ReadString() {
   return Symbols::New(thread_, cstr, len);
 }
 
+RawArray* AotTypeFeedback::FeedbackOf(Thread* thread,
+                                      const Function& function) {
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (object_store->aot_type_feedback() == Array::null()) {
+    return Array::null();
+  }
+  FunctionFeedbackMap map(thread->zone(), object_store->aot_type_feedback());
+  RawArray* feedback = Array::RawCast(map.GetOrNull(function));
+  map.Release();
+  return feedback;
+}
+
+bool AotTypeFeedback::HasFeedback(const Function& function) {
+  return FeedbackOf(Thread::Current(), function) != Array::null();
+}
+
+intptr_t AotTypeFeedback::UsageOf(const Function& function) {
+  Thread* thread = Thread::Current();
+  const Array& feedback =
+      Array::Handle(thread->zone(), FeedbackOf(thread, function));
+  if (feedback.IsNull()) {
+    return 0;
+  }
+  return Smi::Value(Smi::RawCast(feedback.At(kUsageIndex)));
+}
+
+struct CodeUsage {
+  const Code* code;
+  intptr_t usage;
+};
+
+static int CompareUsage(const CodeUsage* a, const CodeUsage* b) {
+  if (a->usage != b->usage) {
+    return (a->usage > b->usage) ? -1 : 1;
+  }
+  return 0;
+}
+
+RawArray* AotTypeFeedback::CodeByUsage(Thread* thread) {
+  Zone* zone = thread->zone();
+  ObjectStore* object_store = thread->isolate()->object_store();
+  if (object_store->aot_type_feedback() == Array::null()) {
+    return Array::null();
+  }
+
+  GrowableArray<CodeUsage> code_usages;
+  Function& function = Function::Handle(zone);
+  Array& feedback = Array::Handle(zone);
+  {
+    FunctionFeedbackMap map(zone, object_store->aot_type_feedback());
+    FunctionFeedbackMap::Iterator it(&map);
+    while (it.MoveNext()) {
+      const intptr_t entry = it.Current();
+      function ^= map.GetKey(entry);
+      if (!function.HasCode()) {
+        continue;
+      }
+      feedback ^= map.GetPayload(entry, 0);
+      code_usages.Add(
+          {&Code::ZoneHandle(zone, function.CurrentCode()),
+           Smi::Value(Smi::RawCast(feedback.At(kUsageIndex)))});
+    }
+    map.Release();
+  }
+  code_usages.Sort(CompareUsage);
+
+  const Array& result =
+      Array::Handle(zone, Array::New(code_usages.length(), Heap::kOld));
+  for (intptr_t i = 0; i < code_usages.length(); i++) {
+    result.SetAt(i, *code_usages[i].code);
+  }
+  return result.raw();
+}
+
+void AotTypeFeedback::Apply(Thread* thread,
+                            const Function& function,
+                            const GrowableArray<const ICData*>& call_sites,
+                            GrowableArray<intptr_t>* call_counts) {
+  Zone* zone = thread->zone();
+  call_counts->Clear();
+  const Array& feedback = Array::Handle(zone, FeedbackOf(thread, function));
+  if (feedback.IsNull()) {
+    for (intptr_t i = 0; i < call_sites.length(); i++) {
+      call_counts->Add(kNoCallCount);
+    }
+    return;
+  }
+
+  // Match the calls in order to the recorded call sites, skipping the
+  // recorded call sites of calls which were removed or changed. Calls which
+  // were added have no match. Only the next few recorded call sites are
+  // considered, so that an added call whose selector matches a later call
+  // does not skip the recorded call sites in between.
+  Array& recorded = Array::Handle(zone);
+  String& target_name = String::Handle(zone);
+  String& recorded_name = String::Handle(zone);
+  intptr_t next = kFirstCallSiteIndex;
+  for (intptr_t i = 0; i < call_sites.length(); i++) {
+    const ICData& call_site = *call_sites[i];
+    target_name = call_site.target_name();
+    intptr_t call_count = kNoCallCount;
+    const intptr_t end =
+        Utils::Minimum(feedback.Length(), next + kMatchLookahead);
+    for (intptr_t j = next; j < end; j++) {
+      recorded ^= feedback.At(j);
+      if (Matches(recorded, call_site, target_name, &recorded_name)) {
+        call_count = ApplyCallSite(thread, recorded, call_site);
+        next = j + 1;
+        break;
+      }
+    }
+    call_counts->Add(call_count);
+  }
+}
+
+bool AotTypeFeedback::Matches(const Array& recorded,
+                              const ICData& call_site,
+                              const String& target_name,
+                              String* recorded_name) {
+  *recorded_name ^= recorded.At(kTargetNameIndex);
+  return (Smi::Value(Smi::RawCast(recorded.At(kRebindRuleIndex))) ==
+          call_site.rebind_rule()) &&
+         (Smi::Value(Smi::RawCast(recorded.At(kNumArgsTestedIndex))) ==
+          call_site.NumArgsTested()) &&
+         String::EqualsIgnoringPrivateKey(target_name, *recorded_name);
+}
+
+// Returns the total recorded count of the call, which is also the count of
+// the megamorphic calls whose receiver classes are not added.
+intptr_t AotTypeFeedback::ApplyCallSite(Thread* thread,
+                                        const Array& recorded,
+                                        const ICData& call_site) {
+  const intptr_t num_args_tested = call_site.NumArgsTested();
+  const intptr_t entry_length = 1 + num_args_tested;
+  const intptr_t num_entries =
+      (recorded.Length() - kFirstEntryIndex) / entry_length;
+  intptr_t total_count = 0;
+  for (intptr_t i = 0; i < num_entries; i++) {
+    total_count += Smi::Value(
+        Smi::RawCast(recorded.At(kFirstEntryIndex + i * entry_length)));
+  }
+
+  if (call_site.rebind_rule() != ICData::kInstance) {
+    // Only the count is used for static calls.
+    if (call_site.NumberOfChecks() > 0) {
+      call_site.SetCountAt(0, total_count);
+    }
+    return total_count;
+  }
+
+  if ((num_args_tested == 0) || (num_entries == 0) ||
+      (num_entries > FLAG_max_polymorphic_checks) ||
+      !call_site.NumberOfChecksIs(0)) {
+    // Megamorphic calls are left to the dispatch by the call.
+    return total_count;
+  }
+
+  Zone* zone = thread->zone();
+  ClassTable* class_table = thread->isolate()->class_table();
+  const String& target_name = String::Handle(zone, call_site.target_name());
+  const ArgumentsDescriptor args_desc(
+      Array::Handle(zone, call_site.arguments_descriptor()));
+  Class& cls = Class::Handle(zone);
+  Function& target = Function::Handle(zone);
+  GrowableArray<intptr_t> cids(num_args_tested);
+  for (intptr_t i = 0; i < num_entries; i++) {
+    const intptr_t start = kFirstEntryIndex + i * entry_length;
+    const intptr_t count = Smi::Value(Smi::RawCast(recorded.At(start)));
+    cids.Clear();
+    for (intptr_t j = 0; j < num_args_tested; j++) {
+      cids.Add(Smi::Value(Smi::RawCast(recorded.At(start + 1 + j))));
+    }
+    cls = class_table->At(cids[0]);
+    target = Resolver::ResolveDynamicForReceiverClass(cls, target_name,
+                                                      args_desc);
+    if (target.IsNull()) {
+      continue;
+    }
+    if (num_args_tested == 1) {
+      call_site.AddReceiverCheck(cids[0], target, count);
+    } else {
+      call_site.AddCheck(cids, target, count);
+    }
+  }
+  return total_count;
+}
+
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 }  // namespace dart
@@ -102,6 +102,9 @@ class TypeFeedbackLoader : public ValueObject {
   RawObject* LoadClasses();
   RawObject* LoadFields();
   RawObject* LoadFunction();
+  RawObject* RecordCallSites(bool skip,
+                             intptr_t usage,
+                             intptr_t num_call_sites);
   RawFunction* FindFunction(RawFunction::Kind kind, intptr_t token_pos);
 
   RawClass* ReadClassByName();
@@ -131,6 +134,70 @@ class TypeFeedbackLoader : public ValueObject {
   Object& error_;
 };
 
+// Type feedback loaded for AOT compilation. Functions are only compiled later
+// by the precompiler, whose deopt ids differ from the ones of the JIT that
+// recorded the feedback. So the loader keeps the recorded call sites of each
+// function, and they are matched to the calls of the function's flow graph by
+// their order, kind and selector when the graph is built. A call is only
+// matched to one of the next few recorded call sites, so a call added since
+// the feedback was recorded does not consume the records of later calls.
+//
+// The feedback only adds receiver classes and counts to the ICData of the
+// calls. AOT code never relies on ICData being complete, so stale feedback
+// affects the performance of the code but not its behavior.
+class AotTypeFeedback : public AllStatic {
+ public:
+  // Layout of the recorded feedback of a function.
+  enum {
+    kUsageIndex = 0,
+    kFirstCallSiteIndex,
+  };
+
+  // Layout of a recorded call site, followed by its entries. Each entry is the
+  // count and the class ids of the checked arguments.
+  enum {
+    kRebindRuleIndex = 0,
+    kTargetNameIndex,
+    kNumArgsTestedIndex,
+    kFirstEntryIndex,
+  };
+
+  // The count of a call without a recorded call site.
+  static const intptr_t kNoCallCount = -1;
+
+  static bool HasFeedback(const Function& function);
+
+  // The recorded usage of |function|, or 0 if it has no feedback.
+  static intptr_t UsageOf(const Function& function);
+
+  // The code of the functions with feedback, most used first.
+  static RawArray* CodeByUsage(Thread* thread);
+
+  // Adds the recorded feedback of |function| to |call_sites|, the ICData of
+  // the calls in a flow graph of |function| in deopt id order. Sets
+  // |call_counts| to the recorded count of each call, including the calls
+  // whose ICData can't carry it, or to kNoCallCount for calls without a
+  // recorded call site.
+  static void Apply(Thread* thread,
+                    const Function& function,
+                    const GrowableArray<const ICData*>& call_sites,
+                    GrowableArray<intptr_t>* call_counts);
+
+ private:
+  // The number of recorded call sites a call is matched against, starting
+  // with the one after the last match.
+  static const intptr_t kMatchLookahead = 4;
+
+  static RawArray* FeedbackOf(Thread* thread, const Function& function);
+  static bool Matches(const Array& recorded,
+                      const ICData& call_site,
+                      const String& target_name,
+                      String* recorded_name);
+  static intptr_t ApplyCallSite(Thread* thread,
+                                const Array& recorded,
+                                const ICData& call_site);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILATION_TRACE_H_
@@ -0,0 +1,178 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compilation_trace.h"
+
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/dart_api_impl.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER) && !defined(PRODUCT)
+
+static intptr_t ClassId(const Library& lib, const char* name) {
+  const auto& cls = Class::Handle(lib.LookupClass(
+      String::Handle(Symbols::New(Thread::Current(), name))));
+  EXPECT(!cls.IsNull());
+  return cls.id();
+}
+
+// Records type feedback for foo, changes foo and loads the feedback in
+// precompiled mode. The call to g was removed and the call to k was added
+// before the other calls, so matching the calls by position would give k the
+// feedback of f and f the feedback of g.
+ISOLATE_UNIT_TEST_CASE(AotTypeFeedback_AddedAndRemovedCalls) {
+  const char* kScript =
+      R"(
+      class A { f() {} g() {} h() {} k() {} }
+      class B { f() {} g() {} h() {} k() {} }
+      foo(A a, B b) {
+        a.f();
+        b.g();
+        a.h();
+      }
+      main() {
+        foo(new A(), new B());
+      }
+      )";
+  const char* kReloadScript =
+      R"(
+      class A { f() {} g() {} h() {} k() {} }
+      class B { f() {} g() {} h() {} k() {} }
+      foo(A a, B b) {
+        b.k();
+        a.f();
+        a.h();
+      }
+      main() {
+        foo(new A(), new B());
+      }
+      )";
+
+  auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  uint8_t* buffer = nullptr;
+  intptr_t buffer_length = 0;
+  {
+    TransitionVMToNative transition(thread);
+    EXPECT_VALID(Dart_SaveTypeFeedback(&buffer, &buffer_length));
+    Dart_Handle lib = TestCase::ReloadTestScript(kReloadScript);
+    EXPECT_VALID(lib);
+    root_library ^= Api::UnwrapHandle(lib);
+  }
+
+  {
+    SetFlagScope<bool> sfs(&FLAG_precompiled_mode, true);
+    TransitionVMToNative transition(thread);
+    EXPECT_VALID(Dart_LoadTypeFeedback(buffer, buffer_length));
+  }
+
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  EXPECT(AotTypeFeedback::HasFeedback(function));
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({CompilerPass::kComputeSSA});
+
+  // The graph was built outside of precompiled mode, so its calls have no
+  // feedback yet.
+  GrowableArray<const ICData*> call_sites;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsInstanceCall()) {
+        const ICData* ic_data = it.Current()->AsInstanceCall()->ic_data();
+        EXPECT(ic_data->NumberOfChecksIs(0));
+        call_sites.Add(ic_data);
+      }
+    }
+  }
+  EXPECT_EQ(3, call_sites.length());
+  GrowableArray<intptr_t> call_counts;
+  AotTypeFeedback::Apply(thread, function, call_sites, &call_counts);
+
+  const intptr_t a_cid = ClassId(root_library, "A");
+  const ICData& k_call = *call_sites[0];
+  const ICData& f_call = *call_sites[1];
+  const ICData& h_call = *call_sites[2];
+  EXPECT_STREQ("k", String::Handle(k_call.target_name()).ToCString());
+  EXPECT_STREQ("f", String::Handle(f_call.target_name()).ToCString());
+  EXPECT_STREQ("h", String::Handle(h_call.target_name()).ToCString());
+
+  // The added call has no feedback.
+  EXPECT(k_call.NumberOfChecksIs(0));
+  EXPECT_EQ(AotTypeFeedback::kNoCallCount, call_counts[0]);
+
+  // The feedback of the removed call is skipped.
+  EXPECT(f_call.NumberOfChecksIs(1));
+  EXPECT_EQ(a_cid, f_call.GetReceiverClassIdAt(0));
+  EXPECT_EQ(1, call_counts[1]);
+  EXPECT(h_call.NumberOfChecksIs(1));
+  EXPECT_EQ(a_cid, h_call.GetReceiverClassIdAt(0));
+  EXPECT_EQ(1, call_counts[2]);
+}
+
+// A megamorphic call gets no receiver classes from its feedback, but keeps
+// its recorded count so that it is not ranked cold by the inliner.
+ISOLATE_UNIT_TEST_CASE(AotTypeFeedback_MegamorphicCallCount) {
+  const char* kScript =
+      R"(
+      class A { f() {} }
+      class B { f() {} }
+      foo(x) {
+        x.f();
+      }
+      main() {
+        foo(new A());
+        foo(new B());
+        foo(new B());
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  uint8_t* buffer = nullptr;
+  intptr_t buffer_length = 0;
+  {
+    TransitionVMToNative transition(thread);
+    EXPECT_VALID(Dart_SaveTypeFeedback(&buffer, &buffer_length));
+  }
+  {
+    SetFlagScope<bool> sfs(&FLAG_precompiled_mode, true);
+    TransitionVMToNative transition(thread);
+    EXPECT_VALID(Dart_LoadTypeFeedback(buffer, buffer_length));
+  }
+
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({CompilerPass::kComputeSSA});
+
+  GrowableArray<const ICData*> call_sites;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsInstanceCall()) {
+        call_sites.Add(it.Current()->AsInstanceCall()->ic_data());
+      }
+    }
+  }
+  EXPECT_EQ(1, call_sites.length());
+
+  SetFlagScope<int> sfs(&FLAG_max_polymorphic_checks, 1);
+  GrowableArray<intptr_t> call_counts;
+  AotTypeFeedback::Apply(thread, function, call_sites, &call_counts);
+  EXPECT(call_sites[0]->NumberOfChecksIs(0));
+  EXPECT_EQ(3, call_counts[0]);
+}
+
+#endif  // defined(DART_PRECOMPILER) && !defined(PRODUCT)
+
+}  // namespace dart
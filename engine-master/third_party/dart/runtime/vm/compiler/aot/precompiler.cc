@@ -9,6 +9,7 @@
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
@@ -405,6 +406,9 @@ void Precompiler::DoCompileAll() {
       // Clear these before dropping classes as they may hold onto otherwise
       // dead instances of classes we will remove or otherwise unused symbols.
       I->object_store()->set_unique_dynamic_targets(Array::null_array());
+      I->object_store()->set_hot_code(
+          Array::Handle(Z, AotTypeFeedback::CodeByUsage(T)));
+      I->object_store()->set_aot_type_feedback(Array::null_array());
       Class& null_class = Class::Handle(Z);
       Function& null_function = Function::Handle(Z);
       Field& null_field = Field::Handle(Z);
@@ -10,7 +10,9 @@
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/backend/loops.h"
 #include "vm/compiler/compiler_pass.h"
+#include "vm/dart_entry.h"
 #include "vm/object.h"
 #include "vm/unit_test.h"
 
@@ -294,4 +296,57 @@ ISOLATE_UNIT_TEST_CASE(BCEListNamedAndPlainLength) {
   TestScriptJIT(kScriptChars, 2, 0);
 }
 
+#if defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+// Loops with bounds checks that range analysis cannot remove are versioned in
+// AOT code, which adds a copy of the loop without those checks.
+ISOLATE_UNIT_TEST_CASE(BCELoopVersioning) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      int dot(Int32List a, Int32List b) {
+        final n = a.length;
+        int result = 0;
+        for (int i = 0; i < n; i++) {
+          result += a[i] * b[i];
+        }
+        return result;
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(kScriptChars));
+  const auto& function = Function::Handle(GetFunction(root_library, "dot"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  // Only the original loop checks the index into b.
+  EXPECT_EQ(2, flow_graph->GetLoopHierarchy().num_loops());
+  EXPECT_EQ(1, CountBoundChecks(flow_graph));
+  pipeline.CompileGraphAndAttachFunction();
+
+  const intptr_t kLength = 10;
+  const auto& a =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& b =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength));
+  const auto& c =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, kLength - 1));
+  for (intptr_t i = 0; i < kLength; i++) {
+    a.SetInt32(i * sizeof(int32_t), i);
+    b.SetInt32(i * sizeof(int32_t), i + 1);
+  }
+  const auto& arguments = Array::Handle(Array::New(2));
+  arguments.SetAt(0, a);
+  arguments.SetAt(1, b);
+  auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsInteger());
+  EXPECT_EQ(330, Integer::Cast(result).AsInt64Value());
+
+  // The original loop still throws if the index gets out of range.
+  arguments.SetAt(1, c);
+  result = DartEntry::InvokeFunction(function, arguments);
+  EXPECT(result.IsError());
+}
+
+#endif  // defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
 }  // namespace dart
@@ -7,6 +7,7 @@
 #include "vm/compiler/backend/flow_graph.h"
 
 #include "vm/bit_vector.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
@@ -2209,8 +2210,15 @@ bool FlowGraph::Canonicalize() {
   return changed;
 }
 
+static int CompareDeoptIds(TemplateDartCall<0>* const* a,
+                           TemplateDartCall<0>* const* b) {
+  return (*a)->deopt_id() - (*b)->deopt_id();
+}
+
 void FlowGraph::PopulateWithICData(const Function& function) {
-  Zone* zone = Thread::Current()->zone();
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  GrowableArray<TemplateDartCall<0>*> calls;
 
   for (BlockIterator block_it = reverse_postorder_iterator(); !block_it.Done();
        block_it.Advance()) {
@@ -2228,6 +2236,7 @@ void FlowGraph::PopulateWithICData(const Function& function) {
                           call->deopt_id(), call->checked_argument_count(),
                           ICData::kInstance));
           call->set_ic_data(&ic_data);
+          calls.Add(call);
         }
       } else if (instr->IsStaticCall()) {
         StaticCallInstr* call = instr->AsStaticCall();
@@ -2243,10 +2252,30 @@ void FlowGraph::PopulateWithICData(const Function& function) {
                                 num_args_checked, ICData::kStatic));
           ic_data.AddTarget(target);
           call->set_ic_data(&ic_data);
+          calls.Add(call);
         }
       }
     }
   }
+
+  if (FLAG_precompiled_mode && AotTypeFeedback::HasFeedback(function)) {
+    calls.Sort(CompareDeoptIds);
+    GrowableArray<const ICData*> call_sites(calls.length());
+    for (intptr_t i = 0; i < calls.length(); i++) {
+      call_sites.Add(calls[i]->IsInstanceCall()
+                         ? calls[i]->AsInstanceCall()->ic_data()
+                         : calls[i]->AsStaticCall()->ic_data());
+    }
+    GrowableArray<intptr_t> call_counts(calls.length());
+    AotTypeFeedback::Apply(thread, function, call_sites, &call_counts);
+    for (intptr_t i = 0; i < calls.length(); i++) {
+      if (call_counts[i] == AotTypeFeedback::kNoCallCount) {
+        calls[i]->set_lacks_feedback(true);
+      } else if (calls[i]->IsInstanceCall()) {
+        calls[i]->AsInstanceCall()->set_call_count(call_counts[i]);
+      }
+    }
+  }
 }
 
 // Optimize (a << b) & c pattern: if c is a positive Smi or zero, then the
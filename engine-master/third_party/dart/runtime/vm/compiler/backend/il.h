@@ -3615,6 +3615,12 @@ class TemplateDartCall : public TemplateDefinition<kInputCount, Throws> {
         type_args_len(), ArgumentCountWithoutTypeArgs(), argument_names());
   }
 
+  // Whether the call is in a function with AOT type feedback but has no
+  // recorded call site in it, e.g. because it was added since the feedback
+  // was recorded. Its call count is then estimated.
+  bool lacks_feedback() const { return lacks_feedback_; }
+  void set_lacks_feedback(bool value) { lacks_feedback_ = value; }
+
   ADD_EXTRA_INFO_TO_S_EXPRESSION_SUPPORT
 
  private:
@@ -3622,6 +3628,7 @@ class TemplateDartCall : public TemplateDefinition<kInputCount, Throws> {
   const Array& argument_names_;
   PushArgumentsArray* arguments_;
   TokenPosition token_pos_;
+  bool lacks_feedback_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(TemplateDartCall);
 };
@@ -3760,8 +3767,14 @@ class InstanceCallInstr : public TemplateDartCall<0> {
   bool has_unique_selector() const { return has_unique_selector_; }
   void set_has_unique_selector(bool b) { has_unique_selector_ = b; }
 
+  // The count of a call with AOT type feedback whose ICData has no checks to
+  // carry it, e.g. a megamorphic call.
+  void set_call_count(intptr_t count) { call_count_ = count; }
+
   virtual intptr_t CallCount() const {
-    return ic_data() == NULL ? 0 : ic_data()->AggregateCount();
+    return (!HasICData() || ic_data()->NumberOfChecksIs(0))
+               ? call_count_
+               : ic_data()->AggregateCount();
   }
 
   virtual CompileType ComputeType() const;
@@ -3826,6 +3839,7 @@ class InstanceCallInstr : public TemplateDartCall<0> {
   CompileType* result_type_;  // Inferred result type.
   bool has_unique_selector_;
   Code::EntryKind entry_kind_ = Code::EntryKind::kNormal;
+  intptr_t call_count_ = 0;
 
   const AbstractType* receivers_static_type_ = nullptr;
 
@@ -3867,6 +3881,8 @@ class PolymorphicInstanceCallInstr : public TemplateDefinition<0, Throws> {
 
   Value* Receiver() const { return instance_call()->Receiver(); }
 
+  bool lacks_feedback() const { return instance_call()->lacks_feedback(); }
+
   bool HasOnlyDispatcherOrImplicitAccessorTargets() const;
 
   const CallTargets& targets() const { return targets_; }
@@ -4275,6 +4291,7 @@ class StaticCallInstr : public TemplateDartCall<0> {
       new_call->result_type_ = call->result_type();
     }
     new_call->set_entry_kind(call->entry_kind());
+    new_call->set_lacks_feedback(call->lacks_feedback());
     return new_call;
   }
 
@@ -5023,6 +5040,7 @@ class LoadIndexedInstr : public TemplateDefinition<2, NoThrow> {
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
+  CompileType* result_type() const { return result_type_; }
 
   virtual bool ComputeCanDeoptimize() const {
     return GetDeoptId() != DeoptId::kNone;
@@ -8443,6 +8461,11 @@ class SimdOpInstr : public Definition {
     return new SimdOpInstr(KindForMethod(kind), left, right, deopt_id);
   }
 
+  // Create a unary SimdOp instr.
+  static SimdOpInstr* Create(Kind kind, Value* left, intptr_t deopt_id) {
+    return new SimdOpInstr(kind, left, deopt_id);
+  }
+
   // Create a unary SimdOp.
   static SimdOpInstr* Create(MethodRecognizer::Kind kind,
                              Value* left,
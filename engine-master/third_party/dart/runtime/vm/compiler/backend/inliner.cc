@@ -6,6 +6,7 @@
 
 #include "vm/compiler/backend/inliner.h"
 
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/block_scheduler.h"
@@ -340,12 +341,34 @@ class CallSites : public ValueObject {
     }
   }
 
+  // The number of times |call| is executed. Calls without feedback in a
+  // method with AOT type feedback are estimated from their nesting depth and
+  // the recorded |usage| of the method, so that calls added since the
+  // feedback was recorded are not ranked cold.
+  template <typename CallType>
+  static intptr_t CallCount(CallType* call,
+                            intptr_t nesting_depth,
+                            bool use_call_counts,
+                            intptr_t usage) {
+    if (!use_call_counts) {
+      return AotCallCountApproximation(nesting_depth);
+    }
+    if (call->lacks_feedback()) {
+      return Utils::Maximum<intptr_t>(usage, 1) *
+             AotCallCountApproximation(nesting_depth);
+    }
+    return call->CallCount();
+  }
+
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
-  // counts whereas AOT uses a static estimate based on nesting depth.
+  // counts whereas AOT uses a static estimate based on nesting depth, unless
+  // counts were loaded from type feedback for the method.
   void ComputeCallSiteRatio(intptr_t static_call_start_ix,
-                            intptr_t instance_call_start_ix) {
+                            intptr_t instance_call_start_ix,
+                            bool use_call_counts,
+                            intptr_t usage) {
     const intptr_t num_static_calls =
         static_calls_.length() - static_call_start_ix;
     const intptr_t num_instance_calls =
@@ -357,8 +380,7 @@ class CallSites : public ValueObject {
       const InstanceCallInfo& info =
           instance_calls_[i + instance_call_start_ix];
       intptr_t aggregate_count =
-          FLAG_precompiled_mode ? AotCallCountApproximation(info.nesting_depth)
-                                : info.call->CallCount();
+          CallCount(info.call, info.nesting_depth, use_call_counts, usage);
       instance_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -367,8 +389,7 @@ class CallSites : public ValueObject {
     for (intptr_t i = 0; i < num_static_calls; ++i) {
       const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
       intptr_t aggregate_count =
-          FLAG_precompiled_mode ? AotCallCountApproximation(info.nesting_depth)
-                                : info.call->CallCount();
+          CallCount(info.call, info.nesting_depth, use_call_counts, usage);
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -501,7 +522,14 @@ class CallSites : public ValueObject {
         }
       }
     }
-    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix);
+    const bool use_call_counts =
+        !FLAG_precompiled_mode ||
+        AotTypeFeedback::HasFeedback(graph->function());
+    const intptr_t usage = FLAG_precompiled_mode
+                               ? AotTypeFeedback::UsageOf(graph->function())
+                               : 0;
+    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix,
+                         use_call_counts, usage);
   }
 
  private:
@@ -0,0 +1,817 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/compiler_state.h"
+#include "vm/flags.h"
+#include "vm/hash_map.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            true,
+            "Vectorize simple loops over typed data in AOT code.");
+DEFINE_FLAG(bool,
+            trace_loop_vectorization,
+            false,
+            "Trace the loops vectorized by the loop vectorizer.");
+
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+// Size of the vectors processed by one iteration of a vector loop.
+static const intptr_t kVectorSizeInBytes = 16;
+
+// Returns the element size of the typed data with the given class id if
+// loops storing into it can be vectorized, and 0 otherwise.
+static intptr_t VectorizableElementSize(intptr_t cid) {
+  switch (cid) {
+    case kTypedDataInt8ArrayCid:
+    case kTypedDataUint8ArrayCid:
+    case kTypedDataUint8ClampedArrayCid:
+      return 1;
+    case kTypedDataInt16ArrayCid:
+    case kTypedDataUint16ArrayCid:
+      return 2;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+    case kTypedDataFloat32ArrayCid:
+      return 4;
+    case kTypedDataInt64ArrayCid:
+    case kTypedDataUint64ArrayCid:
+    case kTypedDataFloat64ArrayCid:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// A loop of the form
+//
+//   preheader:
+//     goto header
+//   header:
+//     i = phi(initial, i')
+//     [CheckStackOverflow]
+//     if (i < limit) goto body else goto exit
+//   body:
+//     store[i] = f(load1[i], ..., loadN[i], invariants)
+//     i' = i + 1
+//     goto header
+//
+// which is vectorized by entering it through a vector loop that handles
+// the elements from initial on for as long as whole vectors fit below
+// limit. The loop itself then handles the remaining elements:
+//
+//   preheader:
+//     splat invariants
+//     goto vector_header
+//   vector_header:
+//     j = phi(initial, j')
+//     [CheckStackOverflow]
+//     j' = j + lanes
+//     if (j' <= limit) goto vector_body else goto vector_exit
+//   vector_body:
+//     vstore[j] = vf(vload1[j], ..., vloadN[j], splats)
+//     goto vector_header
+//   vector_exit:
+//     goto header
+//   header:
+//     i = phi(j, i')
+//     ...
+class VectorizableLoop : public ZoneAllocated {
+ public:
+  VectorizableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph),
+        zone_(flow_graph->zone()),
+        loop_(loop),
+        header_(nullptr),
+        preheader_(nullptr),
+        preheader_index_(-1),
+        body_(nullptr),
+        phi_(nullptr),
+        initial_(0),
+        limit_(nullptr),
+        check_(nullptr),
+        store_(nullptr),
+        element_size_(0),
+        vector_cid_(kIllegalCid),
+        vector_array_cid_(kIllegalCid),
+        untagged_(false),
+        rounding_ops_(0),
+        visited_(nullptr),
+        tree_(),
+        invariants_(),
+        arrays_(),
+        vectors_(),
+        vector_header_(nullptr),
+        vector_exit_(nullptr) {}
+
+  // Returns true if the loop has the form described above and the vector
+  // loop computes exactly the values that the loop would.
+  bool Analyze();
+
+  // Inserts the vector loop in front of the loop.
+  void Emit();
+
+  // Adjusts the loop header phis after predecessors were recomputed, which
+  // orders them by block id.
+  void Finish();
+
+  BlockEntryInstr* header() const { return header_; }
+  intptr_t element_size() const { return element_size_; }
+
+ private:
+  bool AnalyzeControl();
+  bool AnalyzeHeader();
+  bool AnalyzeBody();
+  bool AnalyzeValue(Definition* def);
+  bool AnalyzeOperation(Definition* def);
+  bool AnalyzeCheck(Instruction* instr);
+  bool IsVectorizableInvariant(Definition* def);
+  bool IsVectorizableArray(Definition* array);
+  bool IsInductionComputation(Instruction* instr);
+
+  bool IsInvariant(Definition* def) {
+    return !loop_->Contains(def->GetBlock());
+  }
+
+  bool IsLoopIndex(Value* index) const {
+    Definition* def = index->definition();
+    return def->OriginalDefinitionIgnoreBoxingAndConstraints() == phi_;
+  }
+
+  // Returns true if the array is the payload address of an object, which
+  // is recomputed in front of every access since objects may move.
+  bool IsBodyAddress(Definition* array) {
+    return array->IsLoadUntagged() && (array->GetBlock() == body_);
+  }
+
+  static bool IsSameArray(Definition* a, Definition* b);
+
+  Definition* EmitLimit(Instruction* pos);
+  Definition* EmitAddress(Definition* array, Instruction* pos);
+  Definition* EmitArray(Definition* array, Instruction** last);
+  Definition* EmitBefore(Instruction* pos, Definition* def);
+  Definition* EmitInt64Op(Token::Kind op,
+                          Definition* left,
+                          Definition* right,
+                          Instruction* pos);
+  ConstantInstr* GetSmiConstant(int64_t value);
+  Definition* Vector(Definition* def);
+
+  FlowGraph* flow_graph_;
+  Zone* zone_;
+  LoopInfo* loop_;
+
+  JoinEntryInstr* header_;
+  BlockEntryInstr* preheader_;
+  intptr_t preheader_index_;
+  TargetEntryInstr* body_;
+  PhiInstr* phi_;
+  int64_t initial_;
+  InductionVar* limit_;
+  CheckStackOverflowInstr* check_;
+  StoreIndexedInstr* store_;
+
+  intptr_t element_size_;
+  intptr_t vector_cid_;
+  intptr_t vector_array_cid_;
+  // Whether the arrays are payload addresses rather than typed data.
+  bool untagged_;
+  // Number of rounding floating point operations in the stored value.
+  intptr_t rounding_ops_;
+
+  // Definitions that are part of the stored value, indexed by SSA temp.
+  BitVector* visited_;
+  // The loop definitions of the stored value in post-order.
+  GrowableArray<Definition*> tree_;
+  // Loop invariants used by the stored value.
+  GrowableArray<Definition*> invariants_;
+  // Arrays loaded by the stored value.
+  GrowableArray<Definition*> arrays_;
+
+  // Mapping from definitions of the stored value to their vector version.
+  DirectChainedHashMap<RawPointerKeyValueTrait<Definition, Definition*>>
+      vectors_;
+  JoinEntryInstr* vector_header_;
+  TargetEntryInstr* vector_exit_;
+
+  DISALLOW_COPY_AND_ASSIGN(VectorizableLoop);
+};
+
+bool VectorizableLoop::Analyze() {
+  // Innermost loop with a single back edge and a single entry.
+  if (loop_->inner() != nullptr || loop_->back_edges().length() != 1) {
+    return false;
+  }
+  header_ = loop_->header()->AsJoinEntry();
+  if (header_ == nullptr || header_->PredecessorCount() != 2 ||
+      header_->InsideTryBlock()) {
+    return false;
+  }
+  preheader_index_ = loop_->Contains(header_->PredecessorAt(0)) ? 1 : 0;
+  preheader_ = header_->PredecessorAt(preheader_index_);
+  if (loop_->Contains(preheader_) ||
+      !loop_->IsBackEdge(header_->PredecessorAt(1 - preheader_index_)) ||
+      !preheader_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  return AnalyzeControl() && AnalyzeHeader() && AnalyzeBody();
+}
+
+bool VectorizableLoop::AnalyzeControl() {
+  // Unit stride control induction from a small constant to an invariant.
+  InductionVar* control = loop_->control();
+  int64_t stride = 0;
+  if (!InductionVar::IsLinear(control, &stride) || stride != 1 ||
+      !InductionVar::IsConstant(control->initial(), &initial_) ||
+      initial_ < 0 || initial_ > kMaxInt32) {
+    return false;
+  }
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  if (branch == nullptr) {
+    return false;
+  }
+  for (auto bound : control->bounds()) {
+    if (bound.branch_ == branch) {
+      limit_ = bound.limit_;
+    }
+  }
+  int64_t end = 0;
+  if (InductionVar::IsConstant(limit_, &end)) {
+    if (!Smi::IsValid(end)) {
+      return false;
+    }
+  } else if (!InductionVar::IsInvariant(limit_) || limit_->mult() != 1 ||
+             !Smi::IsValid(limit_->offset()) ||
+             !IsInvariant(limit_->def()) || !limit_->def()->Type()->IsInt()) {
+    return false;
+  }
+  // The loop has just one body block, which is the back edge.
+  body_ = branch->true_successor();
+  if (!loop_->Contains(body_)) {
+    body_ = branch->false_successor();
+  }
+  return loop_->IsBackEdge(body_) && body_->last_instruction()->IsGoto();
+}
+
+bool VectorizableLoop::AnalyzeHeader() {
+  // The control induction is the only loop carried value.
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    if (phi_ != nullptr) {
+      return false;
+    }
+    phi_ = it.Current();
+  }
+  if (phi_ == nullptr) {
+    return false;
+  }
+  InductionVar* induc = loop_->LookupInduction(phi_);
+  if (induc == nullptr || !induc->IsEqual(loop_->control())) {
+    return false;
+  }
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr != header_->last_instruction() &&
+        !IsInductionComputation(instr) && !AnalyzeCheck(instr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VectorizableLoop::AnalyzeBody() {
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    if (StoreIndexedInstr* store = it.Current()->AsStoreIndexed()) {
+      if (store_ != nullptr) {
+        return false;
+      }
+      store_ = store;
+    }
+  }
+  if (store_ == nullptr) {
+    return false;
+  }
+  element_size_ = VectorizableElementSize(store_->class_id());
+  if (element_size_ == 0 || store_->index_scale() != element_size_ ||
+      !store_->aligned() || !IsLoopIndex(store_->index())) {
+    return false;
+  }
+  switch (store_->class_id()) {
+    case kTypedDataFloat32ArrayCid:
+      vector_cid_ = kFloat32x4Cid;
+      vector_array_cid_ = kTypedDataFloat32x4ArrayCid;
+      break;
+    case kTypedDataFloat64ArrayCid:
+      vector_cid_ = kFloat64x2Cid;
+      vector_array_cid_ = kTypedDataFloat64x2ArrayCid;
+      break;
+    default:
+      vector_cid_ = kInt32x4Cid;
+      vector_array_cid_ = kTypedDataInt32x4ArrayCid;
+      break;
+  }
+  Definition* array = store_->array()->definition();
+  untagged_ = array->representation() == kUntagged;
+  if (!IsVectorizableArray(array)) {
+    return false;
+  }
+
+  visited_ =
+      new (zone_) BitVector(zone_, flow_graph_->current_ssa_temp_index());
+  if (!AnalyzeValue(store_->value()->definition())) {
+    return false;
+  }
+  // Single precision operations on the lanes round like the double precision
+  // operation followed by the rounding store only if there is one of them.
+  if (vector_cid_ == kFloat32x4Cid && rounding_ops_ > 1) {
+    return false;
+  }
+
+  // Everything else in the body is control or overhead of the loop.
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr == store_ || instr->IsGoto() || IsInductionComputation(instr) ||
+        AnalyzeCheck(instr)) {
+      continue;
+    }
+    Definition* def = instr->AsDefinition();
+    if (def != nullptr && def->HasSSATemp() &&
+        visited_->Contains(def->ssa_temp_index())) {
+      continue;
+    }
+    if (def != nullptr && IsBodyAddress(def)) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool VectorizableLoop::AnalyzeValue(Definition* def) {
+  if (!def->HasSSATemp()) {
+    return false;
+  }
+  if (visited_->Contains(def->ssa_temp_index())) {
+    return true;
+  }
+  if (IsInvariant(def)) {
+    if (!IsVectorizableInvariant(def)) {
+      return false;
+    }
+    invariants_.Add(def);
+  } else {
+    if (def->GetBlock() != body_ || def->ComputeCanDeoptimize() ||
+        def->HasUnknownSideEffects() || !AnalyzeOperation(def)) {
+      return false;
+    }
+    tree_.Add(def);
+  }
+  visited_->Add(def->ssa_temp_index());
+  return true;
+}
+
+bool VectorizableLoop::AnalyzeOperation(Definition* def) {
+  if (LoadIndexedInstr* load = def->AsLoadIndexed()) {
+    Definition* array = load->array()->definition();
+    if (load->class_id() != store_->class_id() ||
+        load->index_scale() != element_size_ || !load->aligned() ||
+        !IsLoopIndex(load->index()) ||
+        (array->representation() == kUntagged) != untagged_ ||
+        !IsVectorizableArray(array)) {
+      return false;
+    }
+    for (intptr_t i = 0; i < arrays_.length(); i++) {
+      if (IsSameArray(arrays_[i], array)) {
+        return true;
+      }
+    }
+    arrays_.Add(array);
+    return true;
+  }
+
+  if (vector_cid_ == kInt32x4Cid) {
+    // Operations on the low bits of the elements, which are all the
+    // stores keep.
+    if (BinaryIntegerOpInstr* op = def->AsBinaryIntegerOp()) {
+      switch (op->op_kind()) {
+        case Token::kBIT_AND:
+        case Token::kBIT_OR:
+        case Token::kBIT_XOR:
+          break;
+        case Token::kADD:
+        case Token::kSUB:
+          if (element_size_ != 4) {
+            return false;
+          }
+          break;
+        default:
+          return false;
+      }
+      return AnalyzeValue(op->left()->definition()) &&
+             AnalyzeValue(op->right()->definition());
+    }
+    if (def->IsBox() || def->IsUnbox() || def->IsIntConverter() ||
+        def->IsUnboxedWidthExtender()) {
+      return AnalyzeValue(def->InputAt(0)->definition());
+    }
+    return false;
+  }
+
+  if (BinaryDoubleOpInstr* op = def->AsBinaryDoubleOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kDIV:
+        break;
+      default:
+        return false;
+    }
+    rounding_ops_++;
+    return AnalyzeValue(op->left()->definition()) &&
+           AnalyzeValue(op->right()->definition());
+  }
+  if (UnaryDoubleOpInstr* op = def->AsUnaryDoubleOp()) {
+    return AnalyzeValue(op->value()->definition());
+  }
+  if (def->IsBox() || def->IsUnbox()) {
+    return AnalyzeValue(def->InputAt(0)->definition());
+  }
+  if (def->IsFloatToDouble() || def->IsDoubleToFloat()) {
+    return vector_cid_ == kFloat32x4Cid &&
+           AnalyzeValue(def->InputAt(0)->definition());
+  }
+  return false;
+}
+
+bool VectorizableLoop::AnalyzeCheck(Instruction* instr) {
+  // A single stack overflow check, which is repeated in the vector loop.
+  CheckStackOverflowInstr* check = instr->AsCheckStackOverflow();
+  if (check == nullptr || (check_ != nullptr && check_ != check)) {
+    return false;
+  }
+  if (check->env() != nullptr) {
+    for (Environment::DeepIterator it(check->env()); !it.Done();
+         it.Advance()) {
+      Definition* def = it.CurrentValue()->definition();
+      if (def != phi_ && !IsInvariant(def)) {
+        return false;
+      }
+    }
+  }
+  check_ = check;
+  return true;
+}
+
+bool VectorizableLoop::IsVectorizableInvariant(Definition* def) {
+  if (vector_cid_ == kInt32x4Cid) {
+    return false;
+  }
+  if (ConstantInstr* constant = def->AsConstant()) {
+    if (!constant->value().IsDouble()) {
+      return false;
+    }
+    const double value = Double::Cast(constant->value()).value();
+    return vector_cid_ == kFloat64x2Cid ||
+           static_cast<double>(static_cast<float>(value)) == value;
+  }
+  if (vector_cid_ == kFloat64x2Cid) {
+    return def->Type()->IsDouble();
+  }
+  // Single precision values widened to double.
+  if (LoadIndexedInstr* load = def->AsLoadIndexed()) {
+    return load->class_id() == kTypedDataFloat32ArrayCid;
+  }
+  return def->IsFloatToDouble();
+}
+
+bool VectorizableLoop::IsVectorizableArray(Definition* array) {
+  if (IsInvariant(array)) {
+    return true;
+  }
+  return IsBodyAddress(array) &&
+         IsInvariant(array->AsLoadUntagged()->object()->definition());
+}
+
+bool VectorizableLoop::IsInductionComputation(Instruction* instr) {
+  Definition* def = instr->AsDefinition();
+  return def != nullptr &&
+         (def->IsBinaryIntegerOp() || def->IsUnaryIntegerOp() ||
+          def->IsBox() || def->IsUnbox() || def->IsIntConverter()) &&
+         !def->HasUnknownSideEffects() &&
+         loop_->LookupInduction(def) != nullptr;
+}
+
+bool VectorizableLoop::IsSameArray(Definition* a, Definition* b) {
+  if (a == b) {
+    return true;
+  }
+  LoadUntaggedInstr* load_a = a->AsLoadUntagged();
+  LoadUntaggedInstr* load_b = b->AsLoadUntagged();
+  return load_a != nullptr && load_b != nullptr &&
+         load_a->object()->definition() == load_b->object()->definition() &&
+         load_a->offset() == load_b->offset();
+}
+
+Definition* VectorizableLoop::EmitBefore(Instruction* pos, Definition* def) {
+  flow_graph_->InsertBefore(pos, def, nullptr, FlowGraph::kValue);
+  return def;
+}
+
+Definition* VectorizableLoop::EmitInt64Op(Token::Kind op,
+                                          Definition* left,
+                                          Definition* right,
+                                          Instruction* pos) {
+  return EmitBefore(pos, new (zone_) BinaryInt64OpInstr(
+                             op, new (zone_) Value(left),
+                             new (zone_) Value(right), DeoptId::kNone,
+                             Instruction::kNotSpeculative));
+}
+
+ConstantInstr* VectorizableLoop::GetSmiConstant(int64_t value) {
+  return flow_graph_->GetConstant(Smi::Handle(zone_, Smi::New(value)));
+}
+
+Definition* VectorizableLoop::EmitAddress(Definition* array,
+                                          Instruction* pos) {
+  if (IsBodyAddress(array)) {
+    LoadUntaggedInstr* load = array->AsLoadUntagged();
+    array = EmitBefore(
+        pos, new (zone_) LoadUntaggedInstr(
+                 new (zone_) Value(load->object()->definition()),
+                 load->offset()));
+  }
+  return EmitBefore(pos, new (zone_) IntConverterInstr(
+                             kUntagged, kUnboxedIntPtr,
+                             new (zone_) Value(array), DeoptId::kNone));
+}
+
+Definition* VectorizableLoop::EmitLimit(Instruction* pos) {
+  Definition* limit = nullptr;
+  int64_t end = 0;
+  if (InductionVar::IsConstant(limit_, &end)) {
+    limit = GetSmiConstant(end);
+  } else {
+    limit = limit_->def();
+    if (limit_->offset() != 0) {
+      limit = EmitInt64Op(Token::kADD, limit,
+                          GetSmiConstant(limit_->offset()), pos);
+    }
+  }
+  if (!untagged_) {
+    // Distinct typed data objects never overlap.
+    return limit;
+  }
+
+  // Views of the same buffer may overlap. A vector iteration loads all lanes
+  // before it stores any, so it computes different values than the loop if
+  // an element is stored less than a vector before it is loaded, that is if
+  // 0 < store - load < kVectorSizeInBytes. The sign bit of
+  // (load - store) & (-kVectorSizeInBytes - (load - store)) is set exactly
+  // in that case, and then the limit is set to -1 to skip the vector loop.
+  Definition* store_address = EmitAddress(store_->array()->definition(), pos);
+  Definition* overlap = nullptr;
+  for (intptr_t i = 0; i < arrays_.length(); i++) {
+    if (IsSameArray(arrays_[i], store_->array()->definition())) {
+      continue;
+    }
+    Definition* diff = EmitInt64Op(
+        Token::kSUB, EmitAddress(arrays_[i], pos), store_address, pos);
+    Definition* rest = EmitInt64Op(
+        Token::kSUB, GetSmiConstant(-kVectorSizeInBytes), diff, pos);
+    Definition* mask = EmitInt64Op(Token::kBIT_AND, diff, rest, pos);
+    overlap = (overlap == nullptr)
+                  ? mask
+                  : EmitInt64Op(Token::kBIT_OR, overlap, mask, pos);
+  }
+  if (overlap != nullptr) {
+    Definition* sign = EmitBefore(
+        pos, new (zone_) ShiftInt64OpInstr(
+                 Token::kSHR, new (zone_) Value(overlap),
+                 new (zone_) Value(GetSmiConstant(kBitsPerInt64 - 1)),
+                 DeoptId::kNone));
+    limit = EmitInt64Op(Token::kBIT_OR, limit, sign, pos);
+  }
+  return limit;
+}
+
+Definition* VectorizableLoop::EmitArray(Definition* array,
+                                        Instruction** last) {
+  if (!IsBodyAddress(array)) {
+    return array;
+  }
+  // Recompute the payload address right before the access.
+  LoadUntaggedInstr* load = array->AsLoadUntagged();
+  LoadUntaggedInstr* address = new (zone_) LoadUntaggedInstr(
+      new (zone_) Value(load->object()->definition()), load->offset());
+  *last = flow_graph_->AppendTo(*last, address, nullptr, FlowGraph::kValue);
+  return address;
+}
+
+Definition* VectorizableLoop::Vector(Definition* def) {
+  Definition* vector = vectors_.LookupValue(def);
+  ASSERT(vector != nullptr);
+  return vector;
+}
+
+void VectorizableLoop::Emit() {
+  GotoInstr* entry = preheader_->last_instruction()->AsGoto();
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  const intptr_t lanes = kVectorSizeInBytes / element_size_;
+
+  // Loop invariant parts in the preheader.
+  Definition* limit = EmitLimit(entry);
+  for (intptr_t i = 0; i < invariants_.length(); i++) {
+    Definition* def = invariants_[i];
+    const SimdOpInstr::Kind kind = (vector_cid_ == kFloat32x4Cid)
+                                       ? SimdOpInstr::kFloat32x4Splat
+                                       : SimdOpInstr::kFloat64x2Splat;
+    Definition* splat = EmitBefore(
+        entry, SimdOpInstr::Create(kind, new (zone_) Value(def),
+                                   DeoptId::kNone));
+    vectors_.Insert({def, splat});
+  }
+
+  // Vector loop header. The vector index stays tagged so that no boxing is
+  // needed between recomputed payload addresses and their uses.
+  vector_header_ = new (zone_)
+      JoinEntryInstr(flow_graph_->allocate_block_id(), header_->try_index(),
+                     DeoptId::kNone);
+  TargetEntryInstr* vector_body = new (zone_)
+      TargetEntryInstr(flow_graph_->allocate_block_id(), header_->try_index(),
+                       DeoptId::kNone);
+  vector_exit_ = new (zone_)
+      TargetEntryInstr(flow_graph_->allocate_block_id(), header_->try_index(),
+                       DeoptId::kNone);
+  ConstantInstr* initial = GetSmiConstant(initial_);
+  PhiInstr* index = flow_graph_->AddPhi(vector_header_, initial, initial);
+  Instruction* last = vector_header_;
+  if (check_ != nullptr) {
+    CheckStackOverflowInstr* check = new (zone_) CheckStackOverflowInstr(
+        check_->token_pos(), check_->stack_depth(), check_->loop_depth(),
+        CompilerState::Current().GetNextDeoptId(),
+        CheckStackOverflowInstr::kOsrAndPreemption);
+    last = flow_graph_->AppendTo(last, check, check_->env(),
+                                 FlowGraph::kEffect);
+    if (check->env() != nullptr) {
+      for (Environment::DeepIterator it(check->env()); !it.Done();
+           it.Advance()) {
+        if (it.CurrentValue()->definition() == phi_) {
+          it.CurrentValue()->BindToEnvironment(index);
+        }
+      }
+    }
+  }
+  BinarySmiOpInstr* next = new (zone_)
+      BinarySmiOpInstr(Token::kADD, new (zone_) Value(index),
+                       new (zone_) Value(GetSmiConstant(lanes)),
+                       DeoptId::kNone);
+  next->set_can_overflow(false);
+  last = flow_graph_->AppendTo(last, next, nullptr, FlowGraph::kValue);
+  index->InputAt(1)->BindTo(next);
+  BranchInstr* vector_branch = new (zone_) BranchInstr(
+      new (zone_) RelationalOpInstr(
+          branch->token_pos(), Token::kLTE, new (zone_) Value(next),
+          new (zone_) Value(limit), kMintCid, DeoptId::kNone,
+          Instruction::kNotSpeculative),
+      DeoptId::kNone);
+  flow_graph_->AppendTo(last, vector_branch, nullptr, FlowGraph::kEffect);
+  vector_header_->set_last_instruction(vector_branch);
+  *vector_branch->true_successor_address() = vector_body;
+  *vector_branch->false_successor_address() = vector_exit_;
+
+  // Vector loop body.
+  last = vector_body;
+  for (intptr_t i = 0; i < tree_.length(); i++) {
+    Definition* def = tree_[i];
+    Definition* vector = nullptr;
+    if (LoadIndexedInstr* load = def->AsLoadIndexed()) {
+      Definition* array = EmitArray(load->array()->definition(), &last);
+      vector = new (zone_) LoadIndexedInstr(
+          new (zone_) Value(array), new (zone_) Value(index), element_size_,
+          vector_array_cid_, kAlignedAccess, DeoptId::kNone,
+          load->token_pos());
+    } else if (BinaryDoubleOpInstr* op = def->AsBinaryDoubleOp()) {
+      vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(vector_cid_, op->op_kind()),
+          new (zone_) Value(Vector(op->left()->definition())),
+          new (zone_) Value(Vector(op->right()->definition())),
+          DeoptId::kNone);
+    } else if (BinaryIntegerOpInstr* op = def->AsBinaryIntegerOp()) {
+      vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(vector_cid_, op->op_kind()),
+          new (zone_) Value(Vector(op->left()->definition())),
+          new (zone_) Value(Vector(op->right()->definition())),
+          DeoptId::kNone);
+    } else if (UnaryDoubleOpInstr* op = def->AsUnaryDoubleOp()) {
+      const SimdOpInstr::Kind kind = (vector_cid_ == kFloat32x4Cid)
+                                         ? SimdOpInstr::kFloat32x4Negate
+                                         : SimdOpInstr::kFloat64x2Negate;
+      vector = SimdOpInstr::Create(
+          kind, new (zone_) Value(Vector(op->value()->definition())),
+          DeoptId::kNone);
+    } else {
+      // Conversions between representations of the same lanes.
+      vectors_.Insert({def, Vector(def->InputAt(0)->definition())});
+      continue;
+    }
+    last = flow_graph_->AppendTo(last, vector, nullptr, FlowGraph::kValue);
+    vectors_.Insert({def, vector});
+  }
+  Definition* array = EmitArray(store_->array()->definition(), &last);
+  last = flow_graph_->AppendTo(
+      last,
+      new (zone_) StoreIndexedInstr(
+          new (zone_) Value(array), new (zone_) Value(index),
+          new (zone_) Value(Vector(store_->value()->definition())),
+          kNoStoreBarrier, element_size_, vector_array_cid_, kAlignedAccess,
+          DeoptId::kNone, store_->token_pos(), Instruction::kNotSpeculative),
+      nullptr, FlowGraph::kEffect);
+  GotoInstr* back_edge = new (zone_) GotoInstr(vector_header_, DeoptId::kNone);
+  flow_graph_->AppendTo(last, back_edge, nullptr, FlowGraph::kEffect);
+  vector_body->set_last_instruction(back_edge);
+
+  // The loop continues where the vector loop stopped.
+  GotoInstr* exit = new (zone_) GotoInstr(header_, DeoptId::kNone);
+  flow_graph_->AppendTo(vector_exit_, exit, nullptr, FlowGraph::kEffect);
+  vector_exit_->set_last_instruction(exit);
+  entry->set_successor(vector_header_);
+  phi_->InputAt(preheader_index_)->BindTo(index);
+}
+
+void VectorizableLoop::Finish() {
+  // New blocks have the largest ids, so the preheader stays the first
+  // predecessor of the vector loop header.
+  ASSERT(vector_header_->IndexOfPredecessor(preheader_) == 0);
+  if (header_->IndexOfPredecessor(vector_exit_) == preheader_index_) {
+    return;
+  }
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    Value* input = phi->InputAt(0);
+    phi->SetInputAt(0, phi->InputAt(1));
+    phi->SetInputAt(1, input);
+  }
+}
+
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+void LoopVectorizer::Vectorize(FlowGraph* flow_graph) {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  if (!FLAG_loop_vectorization ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      loop_hierarchy.headers();
+  if (loop_headers.is_empty()) {
+    return;
+  }
+  loop_hierarchy.ComputeInduction();
+
+  // Analyze all loops before any block is added.
+  GrowableArray<VectorizableLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); i++) {
+    VectorizableLoop* loop = new (flow_graph->zone())
+        VectorizableLoop(flow_graph, loop_headers[i]->loop_info());
+    if (loop->Analyze()) {
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return;
+  }
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Emit();
+  }
+
+  flow_graph->DiscoverBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Finish();
+    if (FLAG_trace_loop_vectorization) {
+      THR_Print("Vectorized loop B%" Pd " (%" Pd "-byte elements) in %s\n",
+                loops[i]->header()->block_id(), loops[i]->element_size(),
+                flow_graph->function().ToFullyQualifiedCString());
+    }
+  }
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -0,0 +1,34 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Vectorizes innermost counted loops over typed data that compute every
+// element of one list from the elements at the same index of other lists,
+// like
+//
+//   for (int i = 0; i < n; i++) {
+//     dst[i] = a[i] * b[i] + 2.0;
+//   }
+//
+// The loop is preceded by a vector loop that handles 16 bytes per iteration
+// with SIMD operations, and the original loop handles the remaining elements.
+// Only loops whose vector loop computes exactly the same values are
+// transformed, which excludes floating point reductions (they would be
+// reassociated) and loops whose body has checks, calls or other effects.
+class LoopVectorizer : public AllStatic {
+ public:
+  static void Vectorize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
@@ -0,0 +1,143 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/dart_entry.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+
+// Helper method to count the SIMD operations in a flow graph.
+static intptr_t CountSimdOps(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsSimdOp()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Helper method to compile the function with the given name in AOT mode.
+// Returns the number of SIMD operations in its graph.
+static intptr_t CompileAOT(const Library& root_library,
+                           const char* name,
+                           Function* function) {
+  *function = GetFunction(root_library, name);
+  TestPipeline pipeline(*function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  const intptr_t count = CountSimdOps(flow_graph);
+  pipeline.CompileGraphAndAttachFunction();
+  return count;
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Float64) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void scale(Float64List list) {
+        final n = list.length;
+        for (int i = 0; i < n; i++) {
+          list[i] = list[i] * 3.0;
+        }
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  auto& function = Function::Handle();
+  EXPECT_LT(0, CompileAOT(root_library, "scale", &function));
+
+  // An odd length exercises the scalar loop after the vector loop.
+  const intptr_t kLength = 7;
+  const auto& list = TypedData::Handle(
+      TypedData::New(kTypedDataFloat64ArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    list.SetFloat64(i * sizeof(double), i + 0.5);
+  }
+  const auto& arguments = Array::Handle(Array::New(1));
+  arguments.SetAt(0, list);
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsNull());
+  for (intptr_t i = 0; i < kLength; i++) {
+    EXPECT_EQ((i + 0.5) * 3.0, list.GetFloat64(i * sizeof(double)));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Float32) {
+  // Only the bounds check against the list's own length is removed, so the
+  // loop reads and writes a single list.
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void square(Float32List list) {
+        final n = list.length;
+        for (int i = 0; i < n; i++) {
+          list[i] = list[i] * list[i];
+        }
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  auto& function = Function::Handle();
+  EXPECT_LT(0, CompileAOT(root_library, "square", &function));
+
+  const intptr_t kLength = 11;
+  const auto& list =
+      TypedData::Handle(TypedData::New(kTypedDataFloat32ArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    list.SetFloat32(i * sizeof(float), 1.0f / (i + 1));
+  }
+  const auto& arguments = Array::Handle(Array::New(1));
+  arguments.SetAt(0, list);
+  const auto& result =
+      Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsNull());
+  for (intptr_t i = 0; i < kLength; i++) {
+    const float value = 1.0f / (i + 1);
+    const float expected = value * value;
+    EXPECT_EQ(expected, list.GetFloat32(i * sizeof(float)));
+  }
+}
+
+// Floating point reductions are not vectorized, since adding up the lanes
+// separately would change the result.
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_NoReduction) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      double sum(Float64List list) {
+        final n = list.length;
+        double result = 0.0;
+        for (int i = 0; i < n; i++) {
+          result += list[i];
+        }
+        return result;
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  auto& function = Function::Handle();
+  EXPECT_EQ(0, CompileAOT(root_library, "sum", &function));
+}
+
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
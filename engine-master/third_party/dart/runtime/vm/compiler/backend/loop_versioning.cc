@@ -0,0 +1,691 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_versioning.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/compiler_state.h"
+#include "vm/flags.h"
+#include "vm/hash_map.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_versioning,
+            true,
+            "Version loops to remove bounds checks in AOT code.");
+DEFINE_FLAG(bool,
+            trace_loop_versioning,
+            false,
+            "Trace the loops versioned by loop versioning.");
+
+#if defined(TARGET_ARCH_IS_64_BIT)
+
+// Largest number of instructions of a loop that is copied.
+static const intptr_t kMaxLoopSize = 64;
+
+// A loop of the form
+//
+//   preheader:
+//     goto header
+//   header:
+//     phis
+//     ...
+//     if (i < limit) goto body else goto exit
+//   body:
+//     ...
+//     CheckBound(length, i + offset)
+//     ...
+//     goto header
+//
+// whose header has no effects is versioned by entering it through a copy
+// without the checks if the guard holds:
+//
+//   preheader:
+//     if (guard) goto fast_entry else goto slow_entry
+//   fast_entry:
+//     goto fast_header
+//   fast_header:
+//     fast phis
+//     ...
+//     if (i < limit) goto fast_body else goto fast_exit
+//   fast_body:
+//     ... (without the checks)
+//     goto fast_header
+//   fast_exit:
+//     goto slow_preheader
+//   slow_entry:
+//     goto slow_preheader
+//   slow_preheader:
+//     phis of the initial values and the fast phis
+//     goto header
+//   header:
+//     ...
+//
+// The guard may consist of several tests, which all branch to slow_entry if
+// they fail. After the fast loop the header fails its test at once, so the
+// loop runs no more iterations.
+class VersionableLoop : public ZoneAllocated {
+ public:
+  VersionableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph),
+        zone_(flow_graph->zone()),
+        loop_(loop),
+        header_(nullptr),
+        preheader_(nullptr),
+        preheader_index_(-1),
+        body_(nullptr),
+        branch_(nullptr),
+        initial_(nullptr),
+        limit_(nullptr),
+        size_(0),
+        removed_(),
+        min_offset_(0),
+        lengths_(),
+        max_offsets_(),
+        copies_(),
+        slow_entry_(nullptr),
+        fast_entry_(nullptr),
+        fast_header_(nullptr),
+        slow_preheader_(nullptr) {}
+
+  // Returns true if the loop has the form described above and its copy
+  // can go without some of its bounds checks.
+  bool Analyze();
+
+  // Inserts the guard and the fast loop in front of the loop.
+  void Emit();
+
+  // Adjusts the loop header phis after predecessors were recomputed, which
+  // orders them by block id.
+  void Finish();
+
+  BlockEntryInstr* header() const { return header_; }
+  intptr_t removed_checks() const { return removed_.length(); }
+
+ private:
+  bool AnalyzeControl();
+  bool AnalyzeBlock(BlockEntryInstr* block);
+  void AnalyzeCheck(CheckBoundBase* check);
+  bool IsSmallInvariant(InductionVar* x);
+  bool IsSmiLength(Definition* length);
+  bool CanCopy(Instruction* instr);
+  bool IsRemoved(Instruction* instr) const;
+
+  bool IsInvariant(Definition* def) {
+    return !loop_->Contains(def->GetBlock());
+  }
+
+  BlockEntryInstr* EmitGuard();
+  TargetEntryInstr* EmitTest(BlockEntryInstr* block,
+                             Instruction* last,
+                             Token::Kind kind,
+                             Definition* left,
+                             Definition* right);
+  void EmitGoto(BlockEntryInstr* block,
+                Instruction* last,
+                JoinEntryInstr* target);
+  Instruction* EmitCopies(BlockEntryInstr* block, Instruction* last);
+  Instruction* Copy(Instruction* instr);
+  Definition* CopyDefinition(Definition* def);
+  ComparisonInstr* CopyComparison(ComparisonInstr* comparison);
+  Value* CopyValue(Value* value);
+  intptr_t CopyDeoptId(Instruction* instr);
+  Definition* Map(Definition* def);
+  ConstantInstr* GetSmiConstant(int64_t value);
+
+  TargetEntryInstr* NewTarget() {
+    return new (zone_)
+        TargetEntryInstr(flow_graph_->allocate_block_id(),
+                         header_->try_index(), DeoptId::kNone);
+  }
+
+  JoinEntryInstr* NewJoin() {
+    return new (zone_)
+        JoinEntryInstr(flow_graph_->allocate_block_id(), header_->try_index(),
+                       DeoptId::kNone);
+  }
+
+  FlowGraph* flow_graph_;
+  Zone* zone_;
+  LoopInfo* loop_;
+
+  JoinEntryInstr* header_;
+  BlockEntryInstr* preheader_;
+  intptr_t preheader_index_;
+  TargetEntryInstr* body_;
+  BranchInstr* branch_;
+  InductionVar* initial_;
+  InductionVar* limit_;
+  intptr_t size_;
+
+  // Checks left out of the fast loop.
+  GrowableArray<CheckBoundBase*> removed_;
+  // Smallest offset of their indices from the control induction.
+  int64_t min_offset_;
+  // Their lengths with the largest offset of the indices checked against
+  // each of them.
+  GrowableArray<Definition*> lengths_;
+  GrowableArray<int64_t> max_offsets_;
+
+  // Mapping from definitions of the loop to their copies.
+  DirectChainedHashMap<RawPointerKeyValueTrait<Definition, Definition*>>
+      copies_;
+  JoinEntryInstr* slow_entry_;
+  BlockEntryInstr* fast_entry_;
+  JoinEntryInstr* fast_header_;
+  JoinEntryInstr* slow_preheader_;
+
+  DISALLOW_COPY_AND_ASSIGN(VersionableLoop);
+};
+
+bool VersionableLoop::Analyze() {
+  // Innermost loop with a single back edge and a single entry.
+  if (loop_->inner() != nullptr || loop_->back_edges().length() != 1) {
+    return false;
+  }
+  header_ = loop_->header()->AsJoinEntry();
+  if (header_ == nullptr || header_->PredecessorCount() != 2 ||
+      header_->InsideTryBlock()) {
+    return false;
+  }
+  preheader_index_ = loop_->Contains(header_->PredecessorAt(0)) ? 1 : 0;
+  preheader_ = header_->PredecessorAt(preheader_index_);
+  if (loop_->Contains(preheader_) ||
+      !loop_->IsBackEdge(header_->PredecessorAt(1 - preheader_index_)) ||
+      !preheader_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  if (!AnalyzeControl() || !AnalyzeBlock(header_) || !AnalyzeBlock(body_)) {
+    return false;
+  }
+  // Checks that are redundant without a guard are left to range analysis.
+  return !removed_.is_empty() &&
+         (!lengths_.is_empty() || !InductionVar::IsConstant(initial_));
+}
+
+bool VersionableLoop::AnalyzeControl() {
+  // Unit stride control induction between invariants.
+  InductionVar* control = loop_->control();
+  int64_t stride = 0;
+  if (!InductionVar::IsLinear(control, &stride) || stride != 1) {
+    return false;
+  }
+  initial_ = control->initial();
+  branch_ = header_->last_instruction()->AsBranch();
+  if (!IsSmallInvariant(initial_) || branch_ == nullptr) {
+    return false;
+  }
+  for (auto bound : control->bounds()) {
+    if (bound.branch_ == branch_) {
+      limit_ = bound.limit_;
+    }
+  }
+  if (!IsSmallInvariant(limit_)) {
+    return false;
+  }
+  // The loop has just one body block, which is the back edge.
+  body_ = branch_->true_successor();
+  if (!loop_->Contains(body_)) {
+    body_ = branch_->false_successor();
+  }
+  return loop_->IsBackEdge(body_) && body_->last_instruction()->IsGoto();
+}
+
+bool VersionableLoop::AnalyzeBlock(BlockEntryInstr* block) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* instr = it.Current();
+    if (++size_ > kMaxLoopSize || !CanCopy(instr)) {
+      return false;
+    }
+    if (block == header_) {
+      // The header runs once more after the fast loop.
+      if (instr->IsStoreIndexed()) {
+        return false;
+      }
+    } else if (CheckBoundBase* check = instr->AsCheckBoundBase()) {
+      AnalyzeCheck(check);
+    }
+  }
+  return true;
+}
+
+void VersionableLoop::AnalyzeCheck(CheckBoundBase* check) {
+  Definition* index = check->index()
+                          ->definition()
+                          ->OriginalDefinitionIgnoreBoxingAndConstraints();
+  Definition* length = check->length()->definition();
+  InductionVar* induc = loop_->LookupInduction(index);
+  int64_t stride = 0;
+  int64_t offset = 0;
+  if (!InductionVar::IsLinear(induc, &stride) || stride != 1 ||
+      !loop_->control()->CanComputeDifferenceWith(induc, &offset) ||
+      !Utils::IsInt(32, offset) || !IsInvariant(length) ||
+      !IsSmiLength(length)) {
+    return;
+  }
+  // Checks that fail for the initial value are kept.
+  int64_t initial = 0;
+  if (InductionVar::IsConstant(initial_, &initial) && initial + offset < 0) {
+    return;
+  }
+  int64_t limit = 0;
+  if (length->IsConstant() && InductionVar::IsConstant(limit_, &limit)) {
+    if (limit + offset > Smi::Cast(length->AsConstant()->value()).Value()) {
+      return;
+    }
+  } else {
+    intptr_t i = 0;
+    while (i < lengths_.length() && lengths_[i] != length) {
+      i++;
+    }
+    if (i == lengths_.length()) {
+      lengths_.Add(length);
+      max_offsets_.Add(offset);
+    } else {
+      max_offsets_[i] = Utils::Maximum(max_offsets_[i], offset);
+    }
+  }
+  if (removed_.is_empty() || offset < min_offset_) {
+    min_offset_ = offset;
+  }
+  removed_.Add(check);
+}
+
+bool VersionableLoop::IsSmallInvariant(InductionVar* x) {
+  // Small enough for the guard to be computed without overflow.
+  int64_t value = 0;
+  if (InductionVar::IsConstant(x, &value)) {
+    return Utils::IsInt(32, value);
+  }
+  return InductionVar::IsInvariant(x) && x->mult() == 1 &&
+         Utils::IsInt(32, x->offset()) && IsInvariant(x->def()) &&
+         x->def()->Type()->IsInt();
+}
+
+bool VersionableLoop::IsSmiLength(Definition* length) {
+  if (ConstantInstr* constant = length->AsConstant()) {
+    return constant->value().IsSmi();
+  }
+  return length->OriginalDefinitionIgnoreBoxingAndConstraints()
+             ->Type()
+             ->ToCid() == kSmiCid;
+}
+
+bool VersionableLoop::CanCopy(Instruction* instr) {
+  if (BranchInstr* branch = instr->AsBranch()) {
+    ComparisonInstr* comparison = branch->comparison();
+    return comparison->IsRelationalOp() || comparison->IsEqualityCompare() ||
+           comparison->IsStrictCompare();
+  }
+  return instr->IsGoto() || instr->IsCheckStackOverflow() ||
+         instr->IsGenericCheckBound() || instr->IsCheckArrayBound() ||
+         instr->IsLoadUntagged() || instr->IsLoadField() ||
+         instr->IsLoadIndexed() || instr->IsStoreIndexed() ||
+         instr->IsBinaryIntegerOp() || instr->IsBinaryDoubleOp() ||
+         instr->IsUnaryDoubleOp() || instr->IsBox() || instr->IsUnbox() ||
+         instr->IsIntConverter();
+}
+
+bool VersionableLoop::IsRemoved(Instruction* instr) const {
+  for (intptr_t i = 0; i < removed_.length(); i++) {
+    if (removed_[i] == instr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ConstantInstr* VersionableLoop::GetSmiConstant(int64_t value) {
+  return flow_graph_->GetConstant(Smi::Handle(zone_, Smi::New(value)));
+}
+
+TargetEntryInstr* VersionableLoop::EmitTest(BlockEntryInstr* block,
+                                            Instruction* last,
+                                            Token::Kind kind,
+                                            Definition* left,
+                                            Definition* right) {
+  BranchInstr* test = new (zone_) BranchInstr(
+      new (zone_) RelationalOpInstr(
+          branch_->token_pos(), kind, new (zone_) Value(left),
+          new (zone_) Value(right), kMintCid, DeoptId::kNone,
+          Instruction::kNotSpeculative),
+      DeoptId::kNone);
+  flow_graph_->AppendTo(last, test, nullptr, FlowGraph::kEffect);
+  block->set_last_instruction(test);
+  TargetEntryInstr* pass = NewTarget();
+  TargetEntryInstr* fail = NewTarget();
+  *test->true_successor_address() = pass;
+  *test->false_successor_address() = fail;
+  EmitGoto(fail, fail, slow_entry_);
+  return pass;
+}
+
+void VersionableLoop::EmitGoto(BlockEntryInstr* block,
+                               Instruction* last,
+                               JoinEntryInstr* target) {
+  GotoInstr* jump = new (zone_) GotoInstr(target, DeoptId::kNone);
+  flow_graph_->AppendTo(last, jump, nullptr, FlowGraph::kEffect);
+  block->set_last_instruction(jump);
+}
+
+BlockEntryInstr* VersionableLoop::EmitGuard() {
+  // The tests replace the goto at the end of the preheader. They compare
+  // invariants with constants that are at most 32-bit and Smi lengths, so
+  // no operand overflows.
+  BlockEntryInstr* block = preheader_;
+  Instruction* last = preheader_->last_instruction()->previous();
+  if (!InductionVar::IsConstant(initial_)) {
+    // initial + offset >= 0 for the smallest offset.
+    block = EmitTest(
+        block, last, Token::kGTE, initial_->def(),
+        GetSmiConstant(-(initial_->offset() + min_offset_)));
+    last = block;
+  }
+  for (intptr_t i = 0; i < lengths_.length(); i++) {
+    // limit + offset <= length for the largest offset.
+    int64_t limit = 0;
+    if (InductionVar::IsConstant(limit_, &limit)) {
+      block = EmitTest(block, last, Token::kGTE, lengths_[i],
+                       GetSmiConstant(limit + max_offsets_[i]));
+    } else {
+      Definition* end = lengths_[i];
+      const int64_t offset = limit_->offset() + max_offsets_[i];
+      if (offset != 0) {
+        end = new (zone_) BinaryInt64OpInstr(
+            Token::kSUB, new (zone_) Value(end),
+            new (zone_) Value(GetSmiConstant(offset)), DeoptId::kNone,
+            Instruction::kNotSpeculative);
+        last = flow_graph_->AppendTo(last, end, nullptr, FlowGraph::kValue);
+      }
+      block = EmitTest(block, last, Token::kLTE, limit_->def(), end);
+    }
+    last = block;
+  }
+  return block;
+}
+
+Definition* VersionableLoop::Map(Definition* def) {
+  Definition* copy = copies_.LookupValue(def);
+  return (copy != nullptr) ? copy : def;
+}
+
+Value* VersionableLoop::CopyValue(Value* value) {
+  return new (zone_) Value(Map(value->definition()));
+}
+
+// Copies keep the deopt id of the original, like instructions moved by code
+// motion, since they stand for the same operation of the unoptimized code.
+intptr_t VersionableLoop::CopyDeoptId(Instruction* instr) {
+  if (instr->ComputeCanDeoptimize() || instr->CanBecomeDeoptimizationTarget()) {
+    return instr->deopt_id();
+  }
+  return DeoptId::kNone;
+}
+
+ComparisonInstr* VersionableLoop::CopyComparison(
+    ComparisonInstr* comparison) {
+  const intptr_t deopt_id = CopyDeoptId(comparison);
+  if (RelationalOpInstr* op = comparison->AsRelationalOp()) {
+    return new (zone_) RelationalOpInstr(
+        op->token_pos(), op->kind(), CopyValue(op->left()),
+        CopyValue(op->right()), op->operation_cid(), deopt_id,
+        op->speculative_mode());
+  }
+  if (EqualityCompareInstr* op = comparison->AsEqualityCompare()) {
+    return new (zone_) EqualityCompareInstr(
+        op->token_pos(), op->kind(), CopyValue(op->left()),
+        CopyValue(op->right()), op->operation_cid(), deopt_id,
+        op->speculative_mode());
+  }
+  StrictCompareInstr* op = comparison->AsStrictCompare();
+  return new (zone_) StrictCompareInstr(
+      op->token_pos(), op->kind(), CopyValue(op->left()),
+      CopyValue(op->right()), op->needs_number_check(), deopt_id);
+}
+
+Instruction* VersionableLoop::Copy(Instruction* instr) {
+  if (BranchInstr* branch = instr->AsBranch()) {
+    return new (zone_) BranchInstr(CopyComparison(branch->comparison()),
+                                   CopyDeoptId(branch));
+  }
+  if (CheckStackOverflowInstr* check = instr->AsCheckStackOverflow()) {
+    return new (zone_) CheckStackOverflowInstr(
+        check->token_pos(), check->stack_depth(), check->loop_depth(),
+        CompilerState::Current().GetNextDeoptId(),
+        CheckStackOverflowInstr::kOsrAndPreemption);
+  }
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    return new (zone_) StoreIndexedInstr(
+        CopyValue(store->array()), CopyValue(store->index()),
+        CopyValue(store->value()),
+        store->ShouldEmitStoreBarrier() ? kEmitStoreBarrier : kNoStoreBarrier,
+        store->index_scale(), store->class_id(),
+        store->aligned() ? kAlignedAccess : kUnalignedAccess,
+        CopyDeoptId(store), store->token_pos(), store->speculative_mode());
+  }
+  return CopyDefinition(instr->AsDefinition());
+}
+
+Definition* VersionableLoop::CopyDefinition(Definition* def) {
+  const intptr_t deopt_id = CopyDeoptId(def);
+  Definition* copy = nullptr;
+  if (GenericCheckBoundInstr* check = def->AsGenericCheckBound()) {
+    copy = new (zone_) GenericCheckBoundInstr(
+        CopyValue(check->length()), CopyValue(check->index()), deopt_id);
+  } else if (CheckArrayBoundInstr* check = def->AsCheckArrayBound()) {
+    copy = new (zone_) CheckArrayBoundInstr(
+        CopyValue(check->length()), CopyValue(check->index()), deopt_id);
+  } else if (LoadUntaggedInstr* load = def->AsLoadUntagged()) {
+    copy = new (zone_)
+        LoadUntaggedInstr(CopyValue(load->object()), load->offset());
+  } else if (LoadFieldInstr* load = def->AsLoadField()) {
+    copy = new (zone_) LoadFieldInstr(CopyValue(load->instance()),
+                                      load->slot(), load->token_pos());
+  } else if (LoadIndexedInstr* load = def->AsLoadIndexed()) {
+    copy = new (zone_) LoadIndexedInstr(
+        CopyValue(load->array()), CopyValue(load->index()),
+        load->index_scale(), load->class_id(),
+        load->aligned() ? kAlignedAccess : kUnalignedAccess, deopt_id,
+        load->token_pos(), load->result_type());
+  } else if (BinaryInt64OpInstr* op = def->AsBinaryInt64Op()) {
+    copy = new (zone_) BinaryInt64OpInstr(op->op_kind(), CopyValue(op->left()),
+                                          CopyValue(op->right()), deopt_id,
+                                          op->speculative_mode());
+  } else if (BinaryIntegerOpInstr* op = def->AsBinaryIntegerOp()) {
+    copy = BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), CopyValue(op->left()),
+        CopyValue(op->right()), deopt_id, op->can_overflow(),
+        op->is_truncating(), op->range(), op->speculative_mode());
+  } else if (BinaryDoubleOpInstr* op = def->AsBinaryDoubleOp()) {
+    copy = new (zone_) BinaryDoubleOpInstr(
+        op->op_kind(), CopyValue(op->left()), CopyValue(op->right()),
+        deopt_id, op->token_pos(), op->speculative_mode());
+  } else if (UnaryDoubleOpInstr* op = def->AsUnaryDoubleOp()) {
+    copy = new (zone_) UnaryDoubleOpInstr(
+        op->op_kind(), CopyValue(op->value()), deopt_id,
+        op->speculative_mode());
+  } else if (BoxInstr* box = def->AsBox()) {
+    copy = BoxInstr::Create(box->from_representation(),
+                            CopyValue(box->value()));
+  } else if (UnboxInstr* unbox = def->AsUnbox()) {
+    copy = UnboxInstr::Create(unbox->representation(),
+                              CopyValue(unbox->value()), deopt_id,
+                              unbox->speculative_mode());
+    UnboxIntegerInstr* unbox_int = unbox->AsUnboxInteger();
+    if (unbox_int != nullptr && unbox_int->is_truncating()) {
+      copy->AsUnboxInteger()->mark_truncating();
+    }
+  } else {
+    IntConverterInstr* conv = def->AsIntConverter();
+    copy = new (zone_) IntConverterInstr(conv->from(), conv->to(),
+                                         CopyValue(conv->value()), deopt_id);
+    if (conv->is_truncating()) {
+      copy->AsIntConverter()->mark_truncating();
+    }
+  }
+  if (def->range() != nullptr) {
+    copy->set_range(*def->range());
+  }
+  copy->UpdateType(*def->Type());
+  return copy;
+}
+
+Instruction* VersionableLoop::EmitCopies(BlockEntryInstr* block,
+                                         Instruction* last) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr == block->last_instruction()) {
+      break;
+    }
+    if (IsRemoved(instr)) {
+      // Uses of the checked index refer to the index itself.
+      CheckBoundBase* check = instr->AsCheckBoundBase();
+      copies_.Insert({check, Map(check->index()->definition())});
+      continue;
+    }
+    Instruction* copy = Copy(instr);
+    Definition* def = instr->AsDefinition();
+    last = flow_graph_->AppendTo(
+        last, copy, instr->env(),
+        (def != nullptr) ? FlowGraph::kValue : FlowGraph::kEffect);
+    if (def != nullptr) {
+      copies_.Insert({def, copy->AsDefinition()});
+    }
+    if (copy->env() != nullptr) {
+      for (Environment::DeepIterator env_it(copy->env()); !env_it.Done();
+           env_it.Advance()) {
+        Value* value = env_it.CurrentValue();
+        Definition* mapped = Map(value->definition());
+        if (mapped != value->definition()) {
+          value->BindToEnvironment(mapped);
+        }
+      }
+    }
+  }
+  return last;
+}
+
+void VersionableLoop::Emit() {
+  // Guard in the preheader. The blocks are numbered so that the first
+  // predecessor of each new join is the one that comes first in the code.
+  slow_entry_ = NewJoin();
+  fast_entry_ = EmitGuard();
+  fast_header_ = NewJoin();
+  TargetEntryInstr* fast_body = NewTarget();
+  TargetEntryInstr* fast_exit = NewTarget();
+  slow_preheader_ = NewJoin();
+  EmitGoto(fast_entry_, fast_entry_, fast_header_);
+  EmitGoto(slow_entry_, slow_entry_, slow_preheader_);
+
+  // Fast loop header.
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    Definition* initial = phi->InputAt(preheader_index_)->definition();
+    PhiInstr* copy = flow_graph_->AddPhi(fast_header_, initial, initial);
+    copy->set_representation(phi->representation());
+    copies_.Insert({phi, copy});
+  }
+  Instruction* last = EmitCopies(header_, fast_header_);
+  BranchInstr* fast_branch = Copy(branch_)->AsBranch();
+  flow_graph_->AppendTo(last, fast_branch, nullptr, FlowGraph::kEffect);
+  fast_header_->set_last_instruction(fast_branch);
+  if (branch_->true_successor() == body_) {
+    *fast_branch->true_successor_address() = fast_body;
+    *fast_branch->false_successor_address() = fast_exit;
+  } else {
+    *fast_branch->true_successor_address() = fast_exit;
+    *fast_branch->false_successor_address() = fast_body;
+  }
+
+  // Fast loop body.
+  last = EmitCopies(body_, fast_body);
+  EmitGoto(fast_body, last, fast_header_);
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    Definition* next = phi->InputAt(1 - preheader_index_)->definition();
+    Map(phi)->AsPhi()->InputAt(1)->BindTo(Map(next));
+  }
+
+  // The loop continues where the fast loop stopped, or starts over if the
+  // guard failed.
+  EmitGoto(fast_exit, fast_exit, slow_preheader_);
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    PhiInstr* start = flow_graph_->AddPhi(
+        slow_preheader_, phi->InputAt(preheader_index_)->definition(),
+        Map(phi));
+    start->set_representation(phi->representation());
+    phi->InputAt(preheader_index_)->BindTo(start);
+  }
+  EmitGoto(slow_preheader_, slow_preheader_, header_);
+}
+
+void VersionableLoop::Finish() {
+  ASSERT(fast_header_->IndexOfPredecessor(fast_entry_) == 0);
+  ASSERT(slow_preheader_->IndexOfPredecessor(slow_entry_) == 0);
+  if (header_->IndexOfPredecessor(slow_preheader_) == preheader_index_) {
+    return;
+  }
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    Value* input = phi->InputAt(0);
+    phi->SetInputAt(0, phi->InputAt(1));
+    phi->SetInputAt(1, input);
+  }
+}
+
+#endif  // defined(TARGET_ARCH_IS_64_BIT)
+
+void LoopVersioning::Version(FlowGraph* flow_graph) {
+#if defined(TARGET_ARCH_IS_64_BIT)
+  if (!FLAG_loop_versioning) {
+    return;
+  }
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      loop_hierarchy.headers();
+  if (loop_headers.is_empty()) {
+    return;
+  }
+  loop_hierarchy.ComputeInduction();
+
+  // Analyze all loops before any block is added.
+  GrowableArray<VersionableLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); i++) {
+    VersionableLoop* loop = new (flow_graph->zone())
+        VersionableLoop(flow_graph, loop_headers[i]->loop_info());
+    if (loop->Analyze()) {
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return;
+  }
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Emit();
+  }
+
+  flow_graph->DiscoverBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Finish();
+    if (FLAG_trace_loop_versioning) {
+      THR_Print("Versioned loop B%" Pd " (%" Pd " checks removed) in %s\n",
+                loops[i]->header()->block_id(), loops[i]->removed_checks(),
+                flow_graph->function().ToFullyQualifiedCString());
+    }
+  }
+#endif  // defined(TARGET_ARCH_IS_64_BIT)
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -0,0 +1,34 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VERSIONING_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VERSIONING_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Versions innermost counted loops whose bounds checks range analysis could
+// not remove, like
+//
+//   for (int i = 0; i < n; i++) {
+//     sum += list[i];
+//   }
+//
+// where n is unrelated to list.length. A copy of the loop without those
+// checks is entered if a single test in front of the loop shows that all of
+// their indices are in range, that is if 0 <= initial + offset and
+// limit + offset <= length for the index i + offset of each check. The
+// original loop handles the remaining iterations, which are all of them if
+// the test fails and none otherwise.
+class LoopVersioning : public AllStatic {
+ public:
+  static void Version(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VERSIONING_H_
@@ -15,6 +15,8 @@
 #include "vm/compiler/backend/il_serializer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
+#include "vm/compiler/backend/loop_versioning.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -335,6 +337,12 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(AllocationSinking_Sink);
   INVOKE_PASS(EliminateDeadPhis);
   INVOKE_PASS(DCE);
+#if defined(DART_PRECOMPILER)
+  if (mode == kAOT) {
+    INVOKE_PASS(VersionLoops);
+    INVOKE_PASS(VectorizeLoops);
+  }
+#endif
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(SelectRepresentations);
   INVOKE_PASS(Canonicalize);
@@ -420,6 +428,10 @@ COMPILER_PASS(OptimisticallySpecializeSmiPhis, {
   licm.OptimisticallySpecializeSmiPhis();
 });
 
+COMPILER_PASS(VectorizeLoops, { LoopVectorizer::Vectorize(flow_graph); });
+
+COMPILER_PASS(VersionLoops, { LoopVersioning::Version(flow_graph); });
+
 COMPILER_PASS(WidenSmiToInt32, {
   // Where beneficial convert Smi operations into Int32 operations.
   // Only meanigful for 32bit platforms right now.
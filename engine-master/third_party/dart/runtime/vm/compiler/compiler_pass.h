@@ -48,6 +48,8 @@ namespace dart {
   V(TryCatchOptimization)                                                      \
   V(TryOptimizePatterns)                                                       \
   V(TypePropagation)                                                           \
+  V(VectorizeLoops)                                                            \
+  V(VersionLoops)                                                              \
   V(WidenSmiToInt32)                                                           \
   V(WriteBarrierElimination)
 
@@ -5,6 +5,7 @@
 #include "vm/compiler/relocation.h"
 
 #include "vm/code_patcher.h"
+#include "vm/elf.h"
 #include "vm/heap/pages.h"
 #include "vm/instructions.h"
 #include "vm/object_store.h"
@@ -27,11 +28,16 @@ const intptr_t kTrampolineSize = Utils::RoundUp(
     kOffsetInTrampoline + PcRelativeTrampolineJumpPattern::kLengthInBytes,
     kObjectAlignment);
 
+// Cold code starts on a new page of the text image.
+const intptr_t kColdCodeAlignment = Elf::kPageSize;
+
 CodeRelocator::CodeRelocator(Thread* thread,
                              GrowableArray<RawCode*>* code_objects,
+                             intptr_t hot_code_length,
                              GrowableArray<ImageWriterCommand>* commands)
     : StackResource(thread),
       code_objects_(code_objects),
+      hot_code_length_(hot_code_length),
       commands_(commands),
       kind_type_and_offset_(Smi::Handle(thread->zone())),
       target_(Object::Handle(thread->zone())),
@@ -50,8 +56,19 @@ void CodeRelocator::Relocate(bool is_vm_isolate) {
   //
   FindInstructionAndCallLimits();
 
+  // The padding before the cold code is accounted for like an instructions
+  // object when deciding whether calls need trampolines.
+  if (hot_code_length_ > 0) {
+    max_instructions_size_ =
+        Utils::Maximum(max_instructions_size_, kColdCodeAlignment);
+  }
+
   // Emit all instructions and do relocations on the way.
   for (intptr_t i = 0; i < code_objects_->length(); ++i) {
+    if ((i > 0) && (i == hot_code_length_)) {
+      AddPaddingToText(kColdCodeAlignment);
+    }
+
     current_caller = (*code_objects_)[i];
 
     const intptr_t code_text_offset = next_text_offset_;
@@ -102,6 +119,36 @@ void CodeRelocator::Relocate(bool is_vm_isolate) {
   }
 }
 
+intptr_t CodeRelocator::MoveHotCodeFirst(
+    const Array& hot_code,
+    GrowableArray<RawCode*>* code_objects) {
+  RawCodeSet discovered;
+  for (RawCode* code : *code_objects) {
+    discovered.Insert(code);
+  }
+
+  GrowableArray<RawCode*> code_order(code_objects->length());
+  RawCodeSet moved;
+  for (intptr_t i = 0; i < hot_code.Length(); i++) {
+    RawCode* code = Code::RawCast(hot_code.At(i));
+    if (discovered.HasKey(code) && !moved.HasKey(code)) {
+      moved.Insert(code);
+      code_order.Add(code);
+    }
+  }
+  const intptr_t hot_code_length = code_order.length();
+  for (RawCode* code : *code_objects) {
+    if (!moved.HasKey(code)) {
+      code_order.Add(code);
+    }
+  }
+  ASSERT(code_order.length() == code_objects->length());
+  for (intptr_t i = 0; i < code_objects->length(); ++i) {
+    (*code_objects)[i] = code_order[i];
+  }
+  return hot_code_length;
+}
+
 void CodeRelocator::FindInstructionAndCallLimits() {
   Zone* zone = Thread::Current()->zone();
   auto& current_caller = Code::Handle(zone);
@@ -421,6 +468,33 @@ static void MarkAsFreeListElement(uint8_t* trampoline_bytes,
   *header_word = tags;
 }
 
+// Pads the text so the next instructions start at an offset from the start of
+// the image which is a multiple of [alignment].
+void CodeRelocator::AddPaddingToText(intptr_t alignment) {
+  const intptr_t image_offset = Image::kHeaderSize + next_text_offset_;
+  const intptr_t padding_length =
+      Utils::RoundUp(image_offset, alignment) - image_offset;
+  if (padding_length == 0) {
+    return;
+  }
+
+  // Like trampolines, the padding is disguised as FreeListElement objects.
+  // They are small enough for their size to be encoded in the header.
+  const intptr_t max_element_length = Utils::RoundDown(
+      RawObject::SizeTag::kMaxSizeTag / 2, kObjectAlignment);
+  auto padding_bytes = new uint8_t[padding_length];
+  memset(padding_bytes, 0x00, padding_length);
+  for (intptr_t offset = 0; offset < padding_length;
+       offset += max_element_length) {
+    MarkAsFreeListElement(
+        padding_bytes + offset,
+        Utils::Minimum(max_element_length, padding_length - offset));
+  }
+  commands_->Add(
+      ImageWriterCommand(next_text_offset_, padding_bytes, padding_length));
+  next_text_offset_ += padding_length;
+}
+
 void CodeRelocator::BuildTrampolinesForAlmostOutOfRangeCalls() {
   while (!all_unresolved_calls_.IsEmpty()) {
     UnresolvedCall* unresolved_call = all_unresolved_calls_.First();
@@ -124,6 +124,24 @@ using TrampolinesMap = DirectChainedHashMap<
 using InstructionsUnresolvedCalls = DirectChainedHashMap<
     InstructionsMapTraits<SameDestinationUnresolvedCallsList*, nullptr>>;
 
+class RawCodeKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const RawCode* Key;
+  typedef const RawCode* Value;
+  typedef const RawCode* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv; }
+  static inline intptr_t Hashcode(Key key) {
+    return reinterpret_cast<intptr_t>(key);
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) { return pair == key; }
+};
+
+typedef DirectChainedHashMap<RawCodeKeyValueTrait> RawCodeSet;
+
 // Relocates the given code objects by patching the instructions with the
 // correct pc offsets.
 //
@@ -136,17 +154,29 @@ class CodeRelocator : public StackResource {
   //
   // Populates the image writer command array which must be used later to write
   // the ".text" segment.
+  //
+  // If [hot_code_length] is not 0, the instructions of the remaining code
+  // objects start on a new page after the ones of the first [hot_code_length]
+  // code objects.
   static void Relocate(Thread* thread,
                        GrowableArray<RawCode*>* code_objects,
+                       intptr_t hot_code_length,
                        GrowableArray<ImageWriterCommand>* commands,
                        bool is_vm_isolate) {
-    CodeRelocator relocator(thread, code_objects, commands);
+    CodeRelocator relocator(thread, code_objects, hot_code_length, commands);
     relocator.Relocate(is_vm_isolate);
   }
 
+  // Moves the code in [hot_code] to the front of [code_objects], in that
+  // order, and returns the number of code objects moved. Code which is not in
+  // [code_objects] is ignored.
+  static intptr_t MoveHotCodeFirst(const Array& hot_code,
+                                   GrowableArray<RawCode*>* code_objects);
+
  private:
   CodeRelocator(Thread* thread,
                 GrowableArray<RawCode*>* code_objects,
+                intptr_t hot_code_length,
                 GrowableArray<ImageWriterCommand>* commands);
 
   void Relocate(bool is_vm_isolate);
@@ -162,6 +192,7 @@ class CodeRelocator : public StackResource {
   void AddTrampolineToText(RawInstructions* destination,
                            uint8_t* trampoline_bytes,
                            intptr_t trampoline_length);
+  void AddPaddingToText(intptr_t alignment);
 
   void EnqueueUnresolvedCall(UnresolvedCall* unresolved_call);
   void EnqueueUnresolvedTrampoline(UnresolvedTrampoline* unresolved_trampoline);
@@ -186,6 +217,7 @@ class CodeRelocator : public StackResource {
   NoSafepointScope no_savepoint_scope_;
 
   const GrowableArray<RawCode*>* code_objects_;
+  const intptr_t hot_code_length_;
   GrowableArray<ImageWriterCommand>* commands_;
 
   // The size of largest instructions object in bytes.
@@ -0,0 +1,66 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/relocation.h"
+
+#include "vm/elf.h"
+#include "vm/image_snapshot.h"
+#include "vm/object.h"
+#include "vm/stub_code.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+
+ISOLATE_UNIT_TEST_CASE(CodeRelocator_MoveHotCodeFirst) {
+  GrowableArray<RawCode*> code_objects;
+  code_objects.Add(StubCode::CallToRuntime().raw());
+  code_objects.Add(StubCode::FixCallersTarget().raw());
+  code_objects.Add(StubCode::AllocateArray().raw());
+
+  // The hot code is ordered by usage and may include code which is not
+  // written, which is ignored.
+  const auto& hot_code = Array::Handle(Array::New(3));
+  hot_code.SetAt(0, StubCode::AllocateArray());
+  hot_code.SetAt(1, StubCode::InvokeDartCode());
+  hot_code.SetAt(2, StubCode::FixCallersTarget());
+
+  EXPECT_EQ(2, CodeRelocator::MoveHotCodeFirst(hot_code, &code_objects));
+  EXPECT_EQ(3, code_objects.length());
+  EXPECT(code_objects[0] == StubCode::AllocateArray().raw());
+  EXPECT(code_objects[1] == StubCode::FixCallersTarget().raw());
+  EXPECT(code_objects[2] == StubCode::CallToRuntime().raw());
+}
+
+ISOLATE_UNIT_TEST_CASE(CodeRelocator_ColdCodeStartsOnNewPage) {
+  GrowableArray<RawCode*> code_objects;
+  code_objects.Add(StubCode::CallToRuntime().raw());
+  code_objects.Add(StubCode::FixCallersTarget().raw());
+  code_objects.Add(StubCode::AllocateArray().raw());
+
+  GrowableArray<ImageWriterCommand> commands;
+  CodeRelocator::Relocate(thread, &code_objects, /*hot_code_length=*/1,
+                          &commands, /*is_vm_isolate=*/true);
+
+  // The hot code comes first, followed by padding up to the next page and
+  // then the cold code.
+  EXPECT_EQ(4, commands.length());
+  EXPECT_EQ(ImageWriterCommand::InsertInstructionOfCode, commands[0].op);
+  EXPECT(commands[0].insert_instruction_of_code.code == code_objects[0]);
+  EXPECT_EQ(0, commands[0].expected_offset);
+  EXPECT_EQ(ImageWriterCommand::InsertBytesOfTrampoline, commands[1].op);
+  EXPECT_EQ(ImageWriterCommand::InsertInstructionOfCode, commands[2].op);
+  EXPECT(commands[2].insert_instruction_of_code.code == code_objects[1]);
+  EXPECT_EQ(0, (Image::kHeaderSize + commands[2].expected_offset) %
+                   Elf::kPageSize);
+  EXPECT_EQ(ImageWriterCommand::InsertInstructionOfCode, commands[3].op);
+  EXPECT(commands[3].insert_instruction_of_code.code == code_objects[2]);
+
+  delete[] commands[1].insert_trampoline_bytes.buffer;
+}
+
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+
+}  // namespace dart
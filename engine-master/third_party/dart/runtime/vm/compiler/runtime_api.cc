@@ -448,6 +448,9 @@ word ICData::EntryPointIndexFor(word num_args) {
 const word MegamorphicCache::kSpreadFactor =
     dart::MegamorphicCache::kSpreadFactor;
 
+const word MegamorphicCache::kEntryLength =
+    dart::MegamorphicCache::kEntryLength;
+
 word Context::InstanceSize(word n) {
   return TranslateOffsetInWords(dart::Context::InstanceSize(n));
 }
@@ -449,9 +449,11 @@ class ICData : public AllStatic {
 class MegamorphicCache : public AllStatic {
  public:
   static const word kSpreadFactor;
+  static const word kEntryLength;
   static word mask_offset();
   static word buckets_offset();
   static word arguments_descriptor_offset();
+  static word hit_count_offset();
 };
 
 class SingleTargetCache : public AllStatic {
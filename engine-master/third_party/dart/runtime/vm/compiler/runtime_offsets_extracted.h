@@ -155,6 +155,8 @@ static constexpr dart::compiler::target::word
     MegamorphicCache_arguments_descriptor_offset = 16;
 static constexpr dart::compiler::target::word MegamorphicCache_buckets_offset =
     4;
+static constexpr dart::compiler::target::word
+    MegamorphicCache_hit_count_offset = 24;
 static constexpr dart::compiler::target::word MegamorphicCache_mask_offset = 8;
 static constexpr dart::compiler::target::word Mint_value_offset = 8;
 static constexpr dart::compiler::target::word NativeArguments_argc_tag_offset =
@@ -528,6 +530,8 @@ static constexpr dart::compiler::target::word
     MegamorphicCache_arguments_descriptor_offset = 32;
 static constexpr dart::compiler::target::word MegamorphicCache_buckets_offset =
     8;
+static constexpr dart::compiler::target::word
+    MegamorphicCache_hit_count_offset = 48;
 static constexpr dart::compiler::target::word MegamorphicCache_mask_offset = 16;
 static constexpr dart::compiler::target::word Mint_value_offset = 8;
 static constexpr dart::compiler::target::word NativeArguments_argc_tag_offset =
@@ -901,6 +905,8 @@ static constexpr dart::compiler::target::word
     MegamorphicCache_arguments_descriptor_offset = 16;
 static constexpr dart::compiler::target::word MegamorphicCache_buckets_offset =
     4;
+static constexpr dart::compiler::target::word
+    MegamorphicCache_hit_count_offset = 24;
 static constexpr dart::compiler::target::word MegamorphicCache_mask_offset = 8;
 static constexpr dart::compiler::target::word Mint_value_offset = 8;
 static constexpr dart::compiler::target::word NativeArguments_argc_tag_offset =
@@ -1270,6 +1276,8 @@ static constexpr dart::compiler::target::word
     MegamorphicCache_arguments_descriptor_offset = 32;
 static constexpr dart::compiler::target::word MegamorphicCache_buckets_offset =
     8;
+static constexpr dart::compiler::target::word
+    MegamorphicCache_hit_count_offset = 48;
 static constexpr dart::compiler::target::word MegamorphicCache_mask_offset = 16;
 static constexpr dart::compiler::target::word Mint_value_offset = 8;
 static constexpr dart::compiler::target::word NativeArguments_argc_tag_offset =
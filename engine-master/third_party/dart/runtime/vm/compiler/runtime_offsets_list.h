@@ -121,6 +121,7 @@
   FIELD(MarkingStackBlock, top_offset)                                         \
   FIELD(MegamorphicCache, arguments_descriptor_offset)                         \
   FIELD(MegamorphicCache, buckets_offset)                                      \
+  FIELD(MegamorphicCache, hit_count_offset)                                    \
   FIELD(MegamorphicCache, mask_offset)                                         \
   FIELD(Mint, value_offset)                                                    \
   FIELD(NativeArguments, argc_tag_offset)                                      \
@@ -3235,7 +3235,12 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ LoadTaggedClassIdMayBeSmi(R0, R0);
   // R0: receiver cid as Smi.
   __ ldr(R2, FieldAddress(R9, target::MegamorphicCache::buckets_offset()));
-  __ ldr(R1, FieldAddress(R9, target::MegamorphicCache::mask_offset()));
+  // The mask is derived from the length of the buckets rather than loaded, so
+  // that it matches them while the cache grows on another thread.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ ldr(R1, FieldAddress(R2, target::Array::length_offset()));
+  __ mov(R1, Operand(R1, ASR, 1));
+  __ sub(R1, R1, Operand(target::ToRawSmi(1)));
   // R2: cache buckets array.
   // R1: mask as a smi.
 
@@ -3255,6 +3260,11 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ ldr(R6, FieldAddress(IP, base));
   __ cmp(R6, Operand(R0));
   __ b(&probe_failed, NE);
+  if (FLAG_dump_megamorphic_stats) {
+    __ ldr(R6, FieldAddress(R9, target::MegamorphicCache::hit_count_offset()));
+    __ add(R6, R6, Operand(target::ToRawSmi(1)));
+    __ str(R6, FieldAddress(R9, target::MegamorphicCache::hit_count_offset()));
+  }
 
   Label load_target;
   __ Bind(&load_target);
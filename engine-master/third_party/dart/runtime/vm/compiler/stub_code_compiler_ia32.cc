@@ -2684,8 +2684,13 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
-  __ movl(EBX, FieldAddress(ECX, target::MegamorphicCache::mask_offset()));
   __ movl(EDI, FieldAddress(ECX, target::MegamorphicCache::buckets_offset()));
+  // The mask is derived from the length of the buckets rather than loaded, so
+  // that it matches them while the cache grows on another thread.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ movl(EBX, FieldAddress(EDI, target::Array::length_offset()));
+  __ sarl(EBX, Immediate(1));
+  __ subl(EBX, Immediate(target::ToRawSmi(1)));
   // EDI: cache buckets array.
   // EBX: mask as a smi.
 
@@ -2707,6 +2712,10 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   // EDX is smi tagged, but table entries are two words, so TIMES_4.
   __ cmpl(EAX, FieldAddress(EDI, EDX, TIMES_4, base));
   __ j(NOT_EQUAL, &probe_failed, Assembler::kNearJump);
+  if (FLAG_dump_megamorphic_stats) {
+    __ IncrementSmiField(
+        FieldAddress(ECX, target::MegamorphicCache::hit_count_offset()), 1);
+  }
 
   Label load_target;
   __ Bind(&load_target);
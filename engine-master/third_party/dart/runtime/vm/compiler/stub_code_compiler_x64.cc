@@ -3309,8 +3309,13 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
-  __ movq(R9, FieldAddress(RBX, target::MegamorphicCache::mask_offset()));
   __ movq(RDI, FieldAddress(RBX, target::MegamorphicCache::buckets_offset()));
+  // The mask is derived from the length of the buckets rather than loaded, so
+  // that it matches them while the cache grows on another thread.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ movq(R9, FieldAddress(RDI, target::Array::length_offset()));
+  __ sarq(R9, Immediate(1));
+  __ subq(R9, Immediate(target::ToRawSmi(1)));
   // R9: mask as a smi.
   // RDI: cache buckets array.
 
@@ -3332,6 +3337,10 @@ void StubCodeCompiler::GenerateMegamorphicCallStub(Assembler* assembler) {
   Label probe_failed;
   __ cmpq(RAX, FieldAddress(RDI, RCX, TIMES_8, base));
   __ j(NOT_EQUAL, &probe_failed, Assembler::kNearJump);
+  if (FLAG_dump_megamorphic_stats) {
+    __ IncrementSmiField(
+        FieldAddress(RBX, target::MegamorphicCache::hit_count_offset()), 1);
+  }
 
   Label load_target;
   __ Bind(&load_target);
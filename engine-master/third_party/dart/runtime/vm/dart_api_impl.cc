@@ -40,6 +40,7 @@
 #include "vm/native_entry.h"
 #include "vm/native_symbol.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
@@ -1092,6 +1093,60 @@ VM_METRIC_LIST(VM_METRIC_API);
 ISOLATE_METRIC_LIST(ISOLATE_METRIC_API);
 #endif  // !defined(PRODUCT)
 
+COMPILE_ASSERT(DART_GC_HISTOGRAM_BUCKETS == Histogram::kNumBuckets);
+COMPILE_ASSERT(static_cast<int>(Dart_GCHistogram_ScavengePause) ==
+               Heap::kScavengePauseHistogram);
+COMPILE_ASSERT(static_cast<int>(Dart_GCHistogram_OldSpacePause) ==
+               Heap::kOldSpacePauseHistogram);
+COMPILE_ASSERT(static_cast<int>(Dart_GCHistogram_PromotionRate) ==
+               Heap::kPromotionRateHistogram);
+COMPILE_ASSERT(static_cast<int>(Dart_GCHistogram_AllocationRate) ==
+               Heap::kAllocationRateHistogram);
+COMPILE_ASSERT(static_cast<int>(Dart_GCHistogram_UsedAfterGC) ==
+               Heap::kUsedAfterGCHistogram);
+
+DART_EXPORT bool Dart_IsolateGCHistogram(Dart_Isolate isolate,
+                                         Dart_GCHistogramKind kind,
+                                         Dart_GCHistogram* histogram) {
+  if (isolate == NULL) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", CURRENT_FUNC);
+  }
+  if (histogram == NULL) {
+    FATAL1("%s expects argument 'histogram' to be non-null.", CURRENT_FUNC);
+  }
+  if ((kind < 0) ||
+      (static_cast<intptr_t>(kind) >= Heap::kNumGCHistograms)) {
+    return false;
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  const Histogram& source =
+      iso->heap()->gc_histogram(static_cast<Heap::GCHistogram>(kind));
+  histogram->count = source.count();
+  histogram->sum = source.sum();
+  histogram->max = source.max();
+  for (intptr_t i = 0; i < Histogram::kNumBuckets; i++) {
+    histogram->buckets[i] = source.bucket(i);
+  }
+  return true;
+}
+
+DART_EXPORT char* Dart_WriteHeapSnapshot(
+    Dart_HeapSnapshotWriteChunkCallback write,
+    void* context) {
+#if defined(PRODUCT)
+  return strdup("Dart_WriteHeapSnapshot is not supported in PRODUCT mode.");
+#else
+  if (write == NULL) {
+    return strdup("Dart_WriteHeapSnapshot expects a non-null callback.");
+  }
+  DARTSCOPE(Thread::Current());
+  CallbackHeapSnapshotWriter callback_writer(T, write, context);
+  HeapSnapshotWriter writer(T, &callback_writer);
+  writer.Write();
+  return NULL;
+#endif  // defined(PRODUCT)
+}
+
 // --- Isolates ---
 
 static Dart_Isolate CreateIsolate(IsolateGroup* group,
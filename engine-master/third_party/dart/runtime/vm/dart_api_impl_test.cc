@@ -7947,6 +7947,43 @@ TEST_CASE(DartAPI_InvokeVMServiceMethod) {
   EXPECT(result == Dart_True());
 }
 
+struct HeapSnapshotChunks {
+  intptr_t num_chunks;
+  intptr_t num_last_chunks;
+  intptr_t total_size;
+  bool has_magic;
+  bool last_seen_before_end;
+};
+
+static void WriteHeapSnapshotChunk(void* context,
+                                   uint8_t* buffer,
+                                   intptr_t size,
+                                   bool is_last) {
+  HeapSnapshotChunks* chunks = reinterpret_cast<HeapSnapshotChunks*>(context);
+  if (chunks->num_last_chunks > 0) {
+    chunks->last_seen_before_end = true;
+  }
+  if (chunks->num_chunks == 0) {
+    chunks->has_magic = (size >= 8) && (memcmp(buffer, "dartheap", 8) == 0);
+  }
+  chunks->num_chunks++;
+  chunks->total_size += size;
+  if (is_last) {
+    chunks->num_last_chunks++;
+  }
+}
+
+TEST_CASE(DartAPI_WriteHeapSnapshot) {
+  HeapSnapshotChunks chunks = {0, 0, 0, false, false};
+  char* error = Dart_WriteHeapSnapshot(WriteHeapSnapshotChunk, &chunks);
+  EXPECT(error == NULL);
+  EXPECT(chunks.has_magic);
+  EXPECT_EQ(1, chunks.num_last_chunks);
+  EXPECT(!chunks.last_seen_before_end);
+  EXPECT_LT(0, chunks.num_chunks);
+  EXPECT_LT(8, chunks.total_size);
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
@@ -173,6 +173,9 @@ constexpr bool kDartUseBackgroundCompilation = true;
   R(profiler_native_memory, false, bool, false,                                \
     "Enable native memory statistic collection.")                              \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(scavenger_tasks, int, 0,                                                   \
+    "The number of tasks to spawn during new gen GC scavenging (0 means "      \
+    "perform all scavenging on main thread).")                                 \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(strong_non_nullable_type_checks, bool, false,                              \
@@ -97,6 +97,22 @@ class ForwardPointersVisitor : public ObjectPointerVisitor {
     }
   }
 
+  virtual void VisitTypedDataViewPointers(RawTypedDataView* view,
+                                          RawObject** first,
+                                          RawObject** last) {
+    RawObject* old_backing = view->ptr()->typed_data_;
+    VisitPointers(first, last);
+    RawObject* new_backing = view->ptr()->typed_data_;
+
+    // The inner pointer of a view on internal typed data has to follow its
+    // backing store. Targets of forwarding corpses are fully initialized, so
+    // the class id of the new backing store can be read.
+    if ((old_backing != new_backing) &&
+        RawObject::IsTypedDataClassId(new_backing->GetClassIdMayBeSmi())) {
+      view->RecomputeDataFieldForInternalTypedData();
+    }
+  }
+
   void VisitingObject(RawObject* obj) {
     visiting_object_ = obj;
     if ((obj != NULL) && obj->IsOldObject() && obj->IsRemembered()) {
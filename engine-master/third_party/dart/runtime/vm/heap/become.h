@@ -86,11 +86,13 @@ class Become : public AllStatic {
   // (used for morphic instances during reload).
   static void MakeDummyObject(const Instance& instance);
 
- private:
   // Update any references pointing to forwarding objects to point the
-  // forwarding objects' targets.
+  // forwarding objects' targets. Weak table entries have to be forwarded by
+  // the caller (see Heap::ForwardWeakEntries).
   static void FollowForwardingPointers(Thread* thread);
 
+ private:
+
   static void CrashDump(RawObject* before_obj, RawObject* after_obj);
 };
 
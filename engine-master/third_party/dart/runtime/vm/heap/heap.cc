@@ -41,6 +41,11 @@ Heap::Heap(Isolate* isolate,
       old_space_(this, max_old_gen_words),
       barrier_(),
       barrier_done_(),
+      last_scavenge_micros_(0),
+      new_used_after_scavenge_in_words_(0),
+#ifndef PRODUCT
+      allocation_sampler_(this),
+#endif
       read_only_(false),
       gc_new_space_in_progress_(false),
       gc_old_space_in_progress_(false),
@@ -60,23 +65,9 @@ Heap::~Heap() {
   }
 }
 
-void Heap::MakeTLABIterable(Thread* thread) {
-  uword start = thread->top();
-  uword end = thread->end();
-  ASSERT(end >= start);
-  intptr_t size = end - start;
-  ASSERT(Utils::IsAligned(size, kObjectAlignment));
-  if (size >= kObjectAlignment) {
-    // ForwardingCorpse(forwarding to default null) will work as filler.
-    ForwardingCorpse::AsForwarder(start, size);
-    ASSERT(RawObject::FromAddr(start)->HeapSize() == size);
-  }
-}
-
 void Heap::AbandonRemainingTLAB(Thread* thread) {
-  MakeTLABIterable(thread);
-  thread->set_top(0);
-  thread->set_end(0);
+  NOT_IN_PRODUCT(allocation_sampler_.EndTLAB(thread));
+  new_space_.AbandonRemainingTLAB(thread);
 }
 
 uword Heap::AllocateNew(intptr_t size) {
@@ -88,22 +79,25 @@ uword Heap::AllocateNew(intptr_t size) {
     return addr;
   }
 
-  intptr_t tlab_size = GetTLABSize();
-  if ((tlab_size > 0) && (size > tlab_size)) {
-    return AllocateOld(size, HeapPage::kData);
+#if !defined(PRODUCT)
+  // The allocation sampler may have limited the TLAB, so that inline
+  // allocations also reach the runtime at a sampling point.
+  if (allocation_sampler_.ReachedTLABLimit(thread)) {
+    addr = new_space_.TryAllocateInTLAB(thread, size);
+    if (addr != 0) {
+      return addr;
+    }
   }
+#endif  // !defined(PRODUCT)
 
+  // Continue in the rest of another page.
   AbandonRemainingTLAB(thread);
-  if (tlab_size > 0) {
-    uword tlab_top = new_space_.TryAllocateNewTLAB(thread, tlab_size);
-    if (tlab_top != 0) {
-      addr = new_space_.TryAllocateInTLAB(thread, size);
-      if (addr != 0) {  // but "leftover" TLAB could end smaller than tlab_size
-        return addr;
-      }
-      // Abandon "leftover" TLAB as well so we can start from scratch.
-      AbandonRemainingTLAB(thread);
-    }
+  uword tlab_top = new_space_.TryAllocateNewTLAB(thread, size);
+  if (tlab_top != 0) {
+    NOT_IN_PRODUCT(allocation_sampler_.StartTLAB(thread, size));
+    addr = new_space_.TryAllocateInTLAB(thread, size);
+    ASSERT(addr != 0);
+    return addr;
   }
 
   ASSERT(!thread->HasActiveTLAB());
@@ -113,8 +107,9 @@ uword Heap::AllocateNew(intptr_t size) {
   // memory with other threads being released after the collection.
   CollectGarbage(kNew);
 
-  uword tlab_top = new_space_.TryAllocateNewTLAB(thread, tlab_size);
+  tlab_top = new_space_.TryAllocateNewTLAB(thread, size);
   if (tlab_top != 0) {
+    NOT_IN_PRODUCT(allocation_sampler_.StartTLAB(thread, size));
     addr = new_space_.TryAllocateInTLAB(thread, size);
     // It is possible a GC doesn't clear enough space.
     // In that case, we must fall through and allocate into old space.
@@ -128,13 +123,16 @@ uword Heap::AllocateNew(intptr_t size) {
 uword Heap::AllocateOld(intptr_t size, HeapPage::PageType type) {
   ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
   CollectForDebugging();
-  uword addr = old_space_.TryAllocate(size, type);
+  Thread* thread = Thread::Current();
+  NOT_IN_PRODUCT(allocation_sampler_.CountAllocation(thread, size));
+  uword addr = (type == HeapPage::kData)
+                   ? old_space_.TryAllocateDataCached(thread, size)
+                   : old_space_.TryAllocate(size, type);
   if (addr != 0) {
     return addr;
   }
   // If we are in the process of running a sweep, wait for the sweeper to free
   // memory.
-  Thread* thread = Thread::Current();
   if (old_space_.GrowthControlState()) {
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
@@ -422,6 +420,9 @@ void Heap::NotifyIdle(int64_t deadline) {
   if (new_space_.ShouldPerformIdleScavenge(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectNewSpaceGarbage(thread, kIdle);
+    // Return the pages freed by the scavenge to the OS. The next scavenge
+    // maps new pages as the space fills.
+    NewPage::TrimCache(0);
   }
   // Because we use a deadline instead of a timeout, we automatically take any
   // time used up by a scavenge into account when deciding if we can complete
@@ -450,6 +451,10 @@ void Heap::NotifyIdle(int64_t deadline) {
     // the only place that checks the old space allocation limit.
     // Compare the tail end of Heap::CollectNewSpaceGarbage.
     CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);  // Blocks for O(heap)
+  } else if (old_space_.ShouldPerformIdleEvacuation(deadline)) {
+    // Only right after a mark-sweep, so that the objects moved are live.
+    TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
+    EvacuateOldSpacePages(thread, deadline);
   } else {
     CheckStartConcurrentMarking(thread, kIdle);  // Blocks for up to O(roots)
   }
@@ -457,6 +462,7 @@ void Heap::NotifyIdle(int64_t deadline) {
 
 void Heap::NotifyLowMemory() {
   CollectMostGarbage(kLowMemory);
+  NewPage::TrimCache(0);
 }
 
 void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
@@ -543,6 +549,20 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
   }
 }
 
+void Heap::EvacuateOldSpacePages(Thread* thread, int64_t deadline) {
+  if (thread->isolate() == Dart::vm_isolate()) {
+    return;  // See CollectOldSpaceGarbage.
+  }
+  if (BeginOldSpaceGC(thread)) {
+    RecordBeforeGC(kEvacuate, kIdle);
+    VMTagScope tagScope(thread, VMTag::kGCIdleTagId);
+    old_space_.EvacuateSparsePages(deadline);
+    RecordAfterGC(kEvacuate);
+    PrintStats();
+    EndOldSpaceGC();
+  }
+}
+
 void Heap::CollectGarbage(GCType type, GCReason reason) {
   Thread* thread = Thread::Current();
   switch (type) {
@@ -756,9 +776,6 @@ bool Heap::Verify(MarkExpectation mark_expectation) const {
 bool Heap::VerifyGC(MarkExpectation mark_expectation) const {
   StackZone stack_zone(Thread::Current());
 
-  // Change the new space's top_ with the more up-to-date thread's view of top_
-  new_space_.MakeNewSpaceIterable();
-
   ObjectSet* allocated_set =
       CreateAllocatedObjectSet(stack_zone.GetZone(), mark_expectation);
   VerifyPointersVisitor visitor(isolate(), allocated_set);
@@ -825,6 +842,8 @@ const char* Heap::GCTypeToString(GCType type) {
       return "MarkSweep";
     case kMarkCompact:
       return "MarkCompact";
+    case kEvacuate:
+      return "Evacuate";
     default:
       UNREACHABLE();
       return "";
@@ -905,8 +924,8 @@ void Heap::ForwardWeakEntries(RawObject* before_object,
     }
   }
 
-  // We only come here during hot reload, in which case we assume that none of
-  // the isolates is in the middle of sending messages.
+  // We only come here during hot reload or an idle evacuation, in which case we
+  // assume that none of the isolates is in the middle of sending messages.
   RELEASE_ASSERT(isolate()->forward_table_new() == nullptr);
   RELEASE_ASSERT(isolate()->forward_table_old() == nullptr);
 }
@@ -945,12 +964,39 @@ void Heap::PrintMemoryUsageJSON(JSONObject* jsobj) const {
   jsobj->AddProperty64("heapCapacity", TotalCapacityInWords() * kWordSize);
   jsobj->AddProperty64("externalUsage", TotalExternalInWords() * kWordSize);
 }
+
+void Heap::PrintGCHistogramsJSON(JSONStream* stream) const {
+  static const char* const kNames[kNumGCHistograms] = {
+      "scavengePause", "oldSpacePause", "promotionRate", "allocationRate",
+      "usedAfterGC",
+  };
+  static const char* const kUnits[kNumGCHistograms] = {
+      "microseconds", "microseconds", "percent", "kilobytesPerSecond",
+      "kilobytes",
+  };
+  JSONObject obj(stream);
+  obj.AddProperty("type", "_GCHistograms");
+  for (intptr_t i = 0; i < kNumGCHistograms; i++) {
+    const Histogram& histogram = gc_histograms_[i];
+    JSONObject entry(&obj, kNames[i]);
+    entry.AddProperty("unit", kUnits[i]);
+    entry.AddProperty64("count", histogram.count());
+    entry.AddProperty64("sum", histogram.sum());
+    entry.AddProperty64("max", histogram.max());
+    // The lower bound of bucket i > 0 is 2^(i-1).
+    JSONArray buckets(&entry, "buckets");
+    for (intptr_t j = 0; j < Histogram::kNumBuckets; j++) {
+      buckets.AddValue64(histogram.bucket(j));
+    }
+  }
+}
 #endif  // PRODUCT
 
 void Heap::RecordBeforeGC(GCType type, GCReason reason) {
   ASSERT((type == kScavenge && gc_new_space_in_progress_) ||
          (type == kMarkSweep && gc_old_space_in_progress_) ||
-         (type == kMarkCompact && gc_old_space_in_progress_));
+         (type == kMarkCompact && gc_old_space_in_progress_) ||
+         (type == kEvacuate && gc_old_space_in_progress_));
   stats_.num_++;
   stats_.type_ = type;
   stats_.reason_ = reason;
@@ -975,9 +1021,11 @@ void Heap::RecordAfterGC(GCType type) {
   }
   stats_.after_.new_ = new_space_.GetCurrentUsage();
   stats_.after_.old_ = old_space_.GetCurrentUsage();
+  RecordGCHistograms(delta);
   ASSERT((type == kScavenge && gc_new_space_in_progress_) ||
          (type == kMarkSweep && gc_old_space_in_progress_) ||
-         (type == kMarkCompact && gc_old_space_in_progress_));
+         (type == kMarkCompact && gc_old_space_in_progress_) ||
+         (type == kEvacuate && gc_old_space_in_progress_));
 #ifndef PRODUCT
   if (FLAG_support_service && Service::gc_stream.enabled() &&
       !Isolate::IsVMInternalIsolate(isolate())) {
@@ -988,6 +1036,36 @@ void Heap::RecordAfterGC(GCType type) {
 #endif  // !PRODUCT
 }
 
+void Heap::RecordGCHistograms(int64_t pause_micros) {
+  if (stats_.type_ == kScavenge) {
+    gc_histograms_[kScavengePauseHistogram].Add(pause_micros);
+    const intptr_t used_before = stats_.before_.new_.used_in_words;
+    if (used_before > 0) {
+      // Promotion is the only way the old space grows during a scavenge.
+      const intptr_t promoted = Utils::Maximum<intptr_t>(
+          0, stats_.after_.old_.used_in_words -
+                 stats_.before_.old_.used_in_words);
+      gc_histograms_[kPromotionRateHistogram].Add(promoted * 100 /
+                                                  used_before);
+    }
+    const int64_t interval = stats_.before_.micros_ - last_scavenge_micros_;
+    if ((last_scavenge_micros_ > 0) && (interval > 0)) {
+      const intptr_t allocated = Utils::Maximum<intptr_t>(
+          0, used_before - new_used_after_scavenge_in_words_);
+      gc_histograms_[kAllocationRateHistogram].Add(
+          static_cast<int64_t>(RoundWordsToKB(allocated)) *
+          kMicrosecondsPerSecond / interval);
+    }
+    last_scavenge_micros_ = stats_.after_.micros_;
+    new_used_after_scavenge_in_words_ = stats_.after_.new_.used_in_words;
+  } else {
+    gc_histograms_[kOldSpacePauseHistogram].Add(pause_micros);
+  }
+  gc_histograms_[kUsedAfterGCHistogram].Add(
+      RoundWordsToKB(stats_.after_.new_.used_in_words +
+                     stats_.after_.old_.used_in_words));
+}
+
 void Heap::PrintStats() {
 #if !defined(PRODUCT)
   if (!FLAG_verbose_gc) return;
@@ -11,12 +11,14 @@
 
 #include "platform/assert.h"
 #include "vm/allocation.h"
+#include "vm/allocation_sampler.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/scavenger.h"
 #include "vm/heap/spaces.h"
 #include "vm/heap/weak_table.h"
+#include "vm/histogram.h"
 #include "vm/isolate.h"
 
 namespace dart {
@@ -44,6 +46,7 @@ class Heap {
 #endif
     kCanonicalHashes,
     kObjectIds,
+    kAllocationSamples,
     kNumWeakSelectors
   };
 
@@ -51,6 +54,7 @@ class Heap {
     kScavenge,
     kMarkSweep,
     kMarkCompact,
+    kEvacuate,  // Moves the objects off sparse old-space pages when idle.
   };
 
   enum GCReason {
@@ -248,14 +252,6 @@ class Heap {
     ASSERT(space == kOld);
     return old_weak_tables_[selector];
   }
-  void SetWeakTable(Space space, WeakSelector selector, WeakTable* value) {
-    if (space == kNew) {
-      new_weak_tables_[selector] = value;
-    } else {
-      ASSERT(space == kOld);
-      old_weak_tables_[selector] = value;
-    }
-  }
 
   void ForwardWeakEntries(RawObject* before_object, RawObject* after_object);
   void ForwardWeakTables(ObjectPointerVisitor* visitor);
@@ -273,6 +269,21 @@ class Heap {
 
   void UpdateGlobalMaxUsed();
 
+  // Cumulative distributions over all collections of this heap.
+  enum GCHistogram {
+    kScavengePauseHistogram = 0,  // Microseconds.
+    kOldSpacePauseHistogram,      // Microseconds.
+    kPromotionRateHistogram,   // Percent of the new space used before a GC.
+    kAllocationRateHistogram,  // Kilobytes per second in new space.
+    kUsedAfterGCHistogram,     // Kilobytes.
+    kNumGCHistograms,
+  };
+
+  const Histogram& gc_histogram(GCHistogram kind) const {
+    ASSERT((kind >= 0) && (kind < kNumGCHistograms));
+    return gc_histograms_[kind];
+  }
+
   static bool IsAllocatableInNewSpace(intptr_t size) {
     return size <= kNewAllocatableSize;
   }
@@ -285,6 +296,10 @@ class Heap {
   void PrintMemoryUsageJSON(JSONStream* stream) const;
   void PrintMemoryUsageJSON(JSONObject* jsobj) const;
 
+  void PrintGCHistogramsJSON(JSONStream* stream) const;
+
+  AllocationSampler* allocation_sampler() { return &allocation_sampler_; }
+
   // The heap map contains the sizes and class ids for the objects in each page.
   void PrintHeapMapToJSONStream(Isolate* isolate, JSONStream* stream) {
     old_space_.PrintHeapMapToJSONStream(isolate, stream);
@@ -300,15 +315,9 @@ class Heap {
     old_space_.SetupImagePage(pointer, size, is_executable);
   }
 
+  // Must fit into a new page.
   static const intptr_t kNewAllocatableSize = 256 * KB;
 
-  intptr_t GetTLABSize() {
-    // Inspired by V8 tlab size. More than threshold for old space allocation,
-    // less then minimal(initial) new semi-space.
-    const intptr_t size = 512 * KB;
-    return Utils::RoundDown(size, kObjectAlignment);
-  }
-  void MakeTLABIterable(Thread* thread);
   void AbandonRemainingTLAB(Thread* thread);
   Space SpaceForExternal(intptr_t size) const;
 
@@ -369,11 +378,13 @@ class Heap {
   // Helper functions for garbage collection.
   void CollectNewSpaceGarbage(Thread* thread, GCReason reason);
   void CollectOldSpaceGarbage(Thread* thread, GCType type, GCReason reason);
+  void EvacuateOldSpacePages(Thread* thread, int64_t deadline);
   void EvacuateNewSpace(Thread* thread, GCReason reason);
 
   // GC stats collection.
   void RecordBeforeGC(GCType type, GCReason reason);
   void RecordAfterGC(GCType type);
+  void RecordGCHistograms(int64_t pause_micros);
   void PrintStats();
   void PrintStatsToTimeline(TimelineEventScope* event, GCReason reason);
 
@@ -402,6 +413,14 @@ class Heap {
 
   // GC stats collection.
   GCStats stats_;
+  Histogram gc_histograms_[kNumGCHistograms];
+  // For the allocation rate between scavenges.
+  int64_t last_scavenge_micros_;
+  intptr_t new_used_after_scavenge_in_words_;
+
+#ifndef PRODUCT
+  AllocationSampler allocation_sampler_;
+#endif
 
   // This heap is in read-only mode: No allocation is allowed.
   bool read_only_;
@@ -15,6 +15,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, idle_evacuation);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -345,6 +347,118 @@ ISOLATE_UNIT_TEST_CASE(BecomeForwardRememberedObject) {
   EXPECT(before_obj.raw() == after_obj.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(EvacuateSparsePages) {
+  SetFlagScope<bool> sfs(&FLAG_idle_evacuation, true);
+  Heap* heap = thread->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->CollectAllGarbage();
+
+  // Fill several pages, but keep only every 16th array alive. A view on typed
+  // data that is allocated among the arrays keeps an inner pointer into it.
+  const intptr_t kNumArrays = 4 * kPageSize / Array::InstanceSize(4);
+  const intptr_t kStride = 16;
+  const Array& survivors =
+      Array::Handle(Array::New(kNumArrays / kStride, Heap::kOld));
+  Array& array = Array::Handle();
+  TypedData& data = TypedData::Handle();
+  TypedDataView& view = TypedDataView::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    array = Array::New(4, Heap::kOld);
+    array.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % kStride) == 0) {
+      survivors.SetAt(i / kStride, array);
+    }
+    if (i == kNumArrays / 2) {
+      data = TypedData::New(kTypedDataUint8ArrayCid, 16, Heap::kOld);
+      data.SetUint8(3, 42);
+      view = TypedDataView::New(kTypedDataUint8ArrayViewCid, data, 2, 4,
+                                Heap::kOld);
+    }
+  }
+  array = Array::null();
+  heap->CollectAllGarbage();
+
+  const int64_t capacity_before = old_space->CapacityInWords();
+  RawTypedData* data_before = data.raw();
+  old_space->EvacuateSparsePages(kMaxInt64);
+
+  EXPECT_LT(old_space->CapacityInWords(), capacity_before);
+  EXPECT(data.raw() != data_before);
+  EXPECT_EQ(data.DataAddr(3), view.DataAddr(1));
+  EXPECT_EQ(42, *reinterpret_cast<uint8_t*>(view.DataAddr(1)));
+  for (intptr_t i = 0; i < survivors.Length(); i++) {
+    array ^= survivors.At(i);
+    EXPECT_EQ(i * kStride, Smi::Value(Smi::RawCast(array.At(0))));
+  }
+
+  // Until the next mark-sweep, the objects left may have become garbage.
+  EXPECT(!old_space->ShouldPerformIdleEvacuation(kMaxInt64));
+
+  // The evacuated heap is consistent.
+  GCTestHelper::CollectAllGarbage();
+  EXPECT_EQ(42, *reinterpret_cast<uint8_t*>(view.DataAddr(1)));
+}
+
+ISOLATE_UNIT_TEST_CASE(OldSpaceAllocationCache) {
+  Heap* heap = thread->heap();
+  heap->CollectAllGarbage();
+
+  // The first allocations may be served directly by the freelist until it
+  // has a block that is large enough for the cache.
+  Array& array = Array::Handle();
+  for (intptr_t i = 0; (i < 10) && (thread->old_space_end() == 0); i++) {
+    array = Array::New(1, Heap::kOld);
+  }
+  EXPECT(thread->old_space_top() < thread->old_space_end());
+
+  // Consecutive allocations are adjacent, and the rest of the block remains
+  // iterable.
+  const uword top = thread->old_space_top();
+  array = Array::New(1, Heap::kOld);
+  EXPECT_EQ(top, RawObject::ToAddr(array.raw()));
+  EXPECT_EQ(top + array.raw()->HeapSize(), thread->old_space_top());
+  EXPECT(heap->Verify());
+
+  // The block is returned when collecting.
+  GCTestHelper::CollectAllGarbage();
+  EXPECT_EQ(static_cast<uword>(0), thread->old_space_top());
+  EXPECT_EQ(static_cast<uword>(0), thread->old_space_end());
+  EXPECT_EQ(1, array.Length());
+}
+
+ISOLATE_UNIT_TEST_CASE(GCHistograms) {
+  Heap* heap = thread->heap();
+  const Histogram& scavenge_pauses =
+      heap->gc_histogram(Heap::kScavengePauseHistogram);
+  const Histogram& old_space_pauses =
+      heap->gc_histogram(Heap::kOldSpacePauseHistogram);
+  const Histogram& used_after_gc =
+      heap->gc_histogram(Heap::kUsedAfterGCHistogram);
+  const Histogram& allocation_rates =
+      heap->gc_histogram(Heap::kAllocationRateHistogram);
+
+  heap->CollectGarbage(Heap::kScavenge, Heap::kDebugging);
+  const int64_t scavenges = scavenge_pauses.count();
+  const int64_t old_space_collections = old_space_pauses.count();
+  const int64_t collections = used_after_gc.count();
+  EXPECT_LT(0, scavenges);
+
+  // The allocation rate is measured between two scavenges.
+  const int64_t allocation_rate_samples = allocation_rates.count();
+  for (intptr_t i = 0; i < 1000; i++) {
+    Array::Handle(Array::New(10, Heap::kNew));
+  }
+  heap->CollectGarbage(Heap::kScavenge, Heap::kDebugging);
+  EXPECT_EQ(scavenges + 1, scavenge_pauses.count());
+  EXPECT_EQ(allocation_rate_samples + 1, allocation_rates.count());
+  EXPECT_LT(0, allocation_rates.max());
+
+  heap->CollectGarbage(Heap::kMarkSweep, Heap::kDebugging);
+  EXPECT_EQ(old_space_collections + 1, old_space_pauses.count());
+  EXPECT_EQ(collections + 2, used_after_gc.count());
+  EXPECT_LT(0, used_after_gc.max());
+}
+
 ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_DeadOldToNew) {
   Isolate* isolate = Isolate::Current();
   Heap* heap = isolate->heap();
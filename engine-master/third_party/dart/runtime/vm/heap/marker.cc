@@ -511,6 +511,7 @@ void GCMarker::ProcessWeakTables(PageSpace* page_space) {
         }
       }
     }
+    table->FreeOldDataExclusive();
   }
 }
 
@@ -17,6 +17,7 @@
 #include "vm/object.h"
 #include "vm/object_set.h"
 #include "vm/os_thread.h"
+#include "vm/thread_registry.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -42,6 +43,19 @@ DEFINE_FLAG(bool,
             false,
             "Print free list statistics after a GC");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(bool,
+            idle_evacuation,
+            false,
+            "Evacuate sparse old gen pages when idle and fragmented");
+DEFINE_FLAG(int,
+            idle_evacuation_threshold,
+            50,
+            "The maximum percentage of a page in use for it to be evacuated");
+DEFINE_FLAG(int,
+            old_gen_allocation_cache,
+            16,
+            "The size in KB of the old gen block reserved by each thread for "
+            "its allocations (0 disables it)");
 
 HeapPage* HeapPage::Allocate(intptr_t size_in_words,
                              PageType type,
@@ -247,6 +261,9 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
       gc_time_micros_(0),
       collections_(0),
       mark_words_per_micro_(kConservativeInitialMarkSpeed),
+      evacuated_bytes_(0),
+      evacuated_pages_(0),
+      swept_since_evacuation_(false),
       enable_concurrent_mark_(FLAG_concurrent_mark) {
   // We aren't holding the lock but no one can reference us yet.
   UpdateMaxCapacityLocked();
@@ -655,6 +672,66 @@ void PageSpace::AbandonBumpAllocation() {
   }
 }
 
+uword PageSpace::TryAllocateDataInNewCache(Thread* thread, intptr_t size) {
+  const intptr_t cache_size = FLAG_old_gen_allocation_cache * KB;
+  // Objects that would use up a good part of a block are not worth caching.
+  if ((heap_ == NULL) || (thread->heap() != heap_) ||
+      (size > (cache_size >> 2))) {
+    return TryAllocate(size, HeapPage::kData);
+  }
+  FreeList* freelist = &freelist_[HeapPage::kData];
+  MutexLocker ml(freelist->mutex());
+  AbandonAllocationCacheLocked(thread);
+  FreeListElement* block = freelist->TryAllocateLargeLocked(cache_size);
+  if (block == NULL) {
+    // Fall back to the size-segregated lists or a fresh page, which leaves
+    // a large block for the next refill.
+    return TryAllocateDataLocked(size, kControlGrowth);
+  }
+  const uword top = reinterpret_cast<uword>(block);
+  const intptr_t block_size = block->HeapSize();
+  if (block_size > cache_size) {
+    freelist->FreeLocked(top + cache_size, block_size - cache_size);
+  }
+  usage_.used_in_words += (cache_size >> kWordSizeLog2);
+  thread->set_old_space_top(top + size);
+  thread->set_old_space_end(top + cache_size);
+  FreeListElement::AsElement(top + size, cache_size - size);
+  return top;
+}
+
+void PageSpace::AbandonAllocationCacheLocked(Thread* thread) {
+  const uword top = thread->old_space_top();
+  const uword end = thread->old_space_end();
+  if (top < end) {
+    freelist_[HeapPage::kData].FreeLocked(top, end - top);
+    usage_.used_in_words -= ((end - top) >> kWordSizeLog2);
+  }
+  thread->set_old_space_top(0);
+  thread->set_old_space_end(0);
+}
+
+void PageSpace::AbandonAllocationCache(Thread* thread) {
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  AbandonAllocationCacheLocked(thread);
+}
+
+void PageSpace::AbandonAllocationCaches(Isolate* isolate) {
+  ASSERT(Thread::Current()->IsAtSafepoint());
+  MonitorLocker ml(isolate->threads_lock(), false);
+  Thread* current = isolate->thread_registry()->active_list();
+  while (current != NULL) {
+    if (current->isolate() == isolate) {
+      AbandonAllocationCache(current);
+    }
+    current = current->next();
+  }
+  Thread* mutator_thread = isolate->mutator_thread();
+  if (mutator_thread != NULL) {
+    AbandonAllocationCache(mutator_thread);
+  }
+}
+
 void PageSpace::AbandonMarkingForShutdown() {
   delete marker_;
   marker_ = NULL;
@@ -766,7 +843,8 @@ void PageSpace::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
 }
 
 void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
-  ASSERT(Thread::Current()->IsAtSafepoint());
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kScavengerTask));
   for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
     page->VisitRememberedCards(visitor);
   }
@@ -809,6 +887,10 @@ void PageSpace::WriteProtect(bool read_only) {
   if (read_only) {
     // Avoid MakeIterable trying to write to the heap.
     AbandonBumpAllocation();
+    Thread* thread = Thread::Current();
+    if ((thread != NULL) && (thread->heap() == heap_)) {
+      AbandonAllocationCache(thread);
+    }
   }
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     if (!it.page()->is_image_page()) {
@@ -833,6 +915,16 @@ void PageSpace::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
+  const int64_t capacity_in_words = CapacityInWords();
+  if (capacity_in_words > 0) {
+    space.AddProperty("fragmentation",
+                      1.0 - static_cast<double>(UsedInWords()) /
+                                static_cast<double>(capacity_in_words));
+  } else {
+    space.AddProperty("fragmentation", 0.0);
+  }
+  space.AddProperty64("evacuatedBytes", evacuated_bytes_);
+  space.AddProperty("evacuatedPages", evacuated_pages_);
   if (collections() > 0) {
     int64_t run_time = isolate->UptimeMicros();
     run_time = Utils::Maximum(run_time, static_cast<int64_t>(0));
@@ -954,15 +1046,7 @@ bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   // middle of deciding whether to perform an idle GC.
   NoSafepointScope no_safepoint;
 
-  // Discount two pages to account for the newest data and code pages, whose
-  // partial use doesn't indicate fragmentation.
-  const intptr_t excess_in_words =
-      usage_.capacity_in_words - usage_.used_in_words - 2 * kPageSizeInWords;
-  const double excess_ratio = static_cast<double>(excess_in_words) /
-                              static_cast<double>(usage_.capacity_in_words);
-  const bool fragmented = excess_ratio > 0.05;
-
-  if (!fragmented &&
+  if (!IsFragmented() &&
       !page_space_controller_.NeedsIdleGarbageCollection(usage_)) {
     return false;
   }
@@ -989,6 +1073,259 @@ bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   return estimated_mark_compact_completion <= deadline;
 }
 
+bool PageSpace::ShouldPerformIdleEvacuation(int64_t deadline) {
+  if (!FLAG_idle_evacuation) {
+    return false;
+  }
+
+  // To make a consistent decision, we should not yield for a safepoint in the
+  // middle of deciding whether to perform an idle evacuation.
+  NoSafepointScope no_safepoint;
+
+  if (!swept_since_evacuation_ || !IsFragmented()) {
+    // Without a recent mark-sweep most of the objects on sparse pages may be
+    // garbage, which is better left to the next mark-sweep than copied.
+    return false;
+  }
+
+  {
+    MonitorLocker locker(tasks_lock());
+    if ((tasks() > 0) || (phase() != kDone)) {
+      // Objects cannot move while the concurrent marker or sweeper is running.
+      return false;
+    }
+  }
+
+  return OS::GetCurrentMonotonicMicros() + EstimatedEvacuationMicros() <=
+         deadline;
+}
+
+bool PageSpace::IsFragmented() const {
+  // Discount two pages to account for the newest data and code pages, whose
+  // partial use doesn't indicate fragmentation.
+  const intptr_t excess_in_words =
+      usage_.capacity_in_words - usage_.used_in_words - 2 * kPageSizeInWords;
+  const double excess_ratio = static_cast<double>(excess_in_words) /
+                              static_cast<double>(usage_.capacity_in_words);
+  return excess_ratio > 0.05;
+}
+
+int64_t PageSpace::EstimatedForwardingMicros() const {
+  // Assuming that forwarding the pointers of every object in the heap takes as
+  // long as marking it.
+  return (UsedInWords() + heap_->new_space()->UsedInWords()) /
+         mark_words_per_micro_;
+}
+
+int64_t PageSpace::EstimatedEvacuationMicros() const {
+  // Besides forwarding, an evacuation walks every page twice: once to count
+  // its used bytes and once to rebuild its part of the freelist. Assuming a
+  // walk takes as long as marking, and that moving objects fits in the rest.
+  return EstimatedForwardingMicros() +
+         (2 * CapacityInWords()) / mark_words_per_micro_;
+}
+
+static int CompareUsedInBytes(HeapPage* const* a, HeapPage* const* b) {
+  if ((*a)->used_in_bytes() < (*b)->used_in_bytes()) {
+    return -1;
+  } else if ((*a)->used_in_bytes() > (*b)->used_in_bytes()) {
+    return 1;
+  }
+  return 0;
+}
+
+static intptr_t CountUsedInBytes(HeapPage* page) {
+  intptr_t used_in_bytes = 0;
+  uword current = page->object_start();
+  const uword end = page->object_end();
+  while (current < end) {
+    RawObject* raw_obj = RawObject::FromAddr(current);
+    const intptr_t size = raw_obj->HeapSize();
+    if (!raw_obj->IsFreeListElement()) {
+      used_in_bytes += size;
+    }
+    current += size;
+  }
+  return used_in_bytes;
+}
+
+void PageSpace::EvacuateSparsePages(int64_t deadline) {
+  Thread* thread = Thread::Current();
+
+  {
+    MonitorLocker locker(tasks_lock());
+    if ((tasks() > 0) || (phase() != kDone)) {
+      // Raced with the start of a concurrent mark; try again when next idle.
+      return;
+    }
+    set_tasks(1);
+  }
+
+  {
+    SafepointOperationScope safepoint_scope(thread);
+    EvacuateSparsePagesAtSafepoint(deadline);
+  }
+
+  {
+    MonitorLocker ml(tasks_lock());
+    set_tasks(tasks() - 1);
+    ml.NotifyAll();
+  }
+}
+
+void PageSpace::EvacuateSparsePagesAtSafepoint(int64_t deadline) {
+  Thread* thread = Thread::Current();
+  ASSERT(thread->IsAtSafepoint());
+  TIMELINE_FUNCTION_GC_DURATION(thread, "EvacuateSparsePages");
+
+  NoSafepointScope no_safepoints;
+
+  if (FLAG_verify_before_gc) {
+    OS::PrintErr("Verifying before evacuating...");
+    heap_->VerifyGC(kForbidMarked);
+    OS::PrintErr(" done.\n");
+  }
+
+  // Rebuild the data freelist from the pages that are not candidates for
+  // evacuation, so that evacuated objects never move to another candidate.
+  AbandonAllocationCaches(heap_->isolate());
+  AbandonBumpAllocation();
+  freelist_[HeapPage::kData].Reset();
+
+  const int64_t evacuated_bytes_before = evacuated_bytes_;
+  MallocGrowableArray<HeapPage*> candidates;
+  {
+    MutexLocker ml(freelist_[HeapPage::kData].mutex());
+    for (HeapPage* page = pages_; page != NULL; page = page->next()) {
+      const intptr_t used_in_bytes = CountUsedInBytes(page);
+      page->set_used_in_bytes(used_in_bytes);
+      const intptr_t size = page->object_end() - page->object_start();
+      if (used_in_bytes * 100 <= size * FLAG_idle_evacuation_threshold) {
+        candidates.Add(page);
+      } else {
+        FreeUnusedSpaceLocked(page);
+      }
+    }
+    candidates.Sort(CompareUsedInBytes);
+
+    // Leave time to rebuild the freelist of the candidates left over and to
+    // forward the pointers to the moved objects.
+    intptr_t candidate_words = 0;
+    for (intptr_t i = 0; i < candidates.length(); i++) {
+      candidate_words +=
+          (candidates[i]->object_end() - candidates[i]->object_start()) >>
+          kWordSizeLog2;
+    }
+    const int64_t evacuation_deadline =
+        deadline - EstimatedForwardingMicros() -
+        candidate_words / mark_words_per_micro_;
+
+    // Evacuate the sparsest pages first. Empty pages cost nothing to evacuate,
+    // so they are always released.
+    intptr_t num_evacuated = 0;
+    while (num_evacuated < candidates.length()) {
+      HeapPage* page = candidates[num_evacuated];
+      if ((page->used_in_bytes() != 0) &&
+          (OS::GetCurrentMonotonicMicros() >= evacuation_deadline)) {
+        break;
+      }
+      if (!EvacuatePageLocked(page)) {
+        break;  // Out of memory. The page keeps its remaining objects.
+      }
+      num_evacuated++;
+    }
+    for (intptr_t i = num_evacuated; i < candidates.length(); i++) {
+      FreeUnusedSpaceLocked(candidates[i]);
+    }
+  }
+
+  if (evacuated_bytes_ != evacuated_bytes_before) {
+    Become::FollowForwardingPointers(thread);
+  }
+
+  // Only evacuated pages are empty now: every other page kept or received an
+  // object.
+  HeapPage* prev_page = NULL;
+  HeapPage* page = pages_;
+  while (page != NULL) {
+    HeapPage* next_page = page->next();
+    if (page->used_in_bytes() == 0) {
+      FreePage(page, prev_page);
+      evacuated_pages_++;
+    } else {
+      prev_page = page;
+    }
+    page = next_page;
+  }
+
+  if (FLAG_verify_after_gc) {
+    OS::PrintErr("Verifying after evacuating...");
+    heap_->VerifyGC(kForbidMarked);
+    OS::PrintErr(" done.\n");
+  }
+
+  swept_since_evacuation_ = false;
+}
+
+// Moves the objects on 'page' to the data freelist or fresh pages and leaves
+// forwarding corpses behind. Returns false if the heap cannot grow.
+bool PageSpace::EvacuatePageLocked(HeapPage* page) {
+  DEBUG_ASSERT(freelist_[HeapPage::kData].mutex()->IsOwnedByCurrentThread());
+  uword current = page->object_start();
+  const uword end = page->object_end();
+  while (current < end) {
+    RawObject* old_obj = RawObject::FromAddr(current);
+    const intptr_t size = old_obj->HeapSize();
+    // Forwarding corpses left by an earlier become are unreachable.
+    if (!old_obj->IsFreeListElement() && !old_obj->IsForwardingCorpse()) {
+      const uword new_addr = TryAllocateDataLocked(size, kForceGrowth);
+      if (new_addr == 0) {
+        return false;
+      }
+      // The object is moved, not allocated.
+      usage_.used_in_words -= (size >> kWordSizeLog2);
+
+      memmove(reinterpret_cast<void*>(new_addr),
+              reinterpret_cast<void*>(current), size);
+      RawObject* new_obj = RawObject::FromAddr(new_addr);
+      if (RawObject::IsTypedDataClassId(new_obj->GetClassId())) {
+        reinterpret_cast<RawTypedData*>(new_obj)->RecomputeDataField();
+      }
+      HeapPage* new_page = HeapPage::Of(new_obj);
+      new_page->set_used_in_bytes(new_page->used_in_bytes() + size);
+
+      heap_->ForwardWeakEntries(old_obj, new_obj);
+      ForwardingCorpse::AsForwarder(current, size)->set_target(new_obj);
+      evacuated_bytes_ += size;
+    }
+    current += size;
+  }
+  page->set_used_in_bytes(0);
+  return true;
+}
+
+// Adds the free space on 'page' to the data freelist, coalescing adjacent
+// freelist elements.
+void PageSpace::FreeUnusedSpaceLocked(HeapPage* page) {
+  FreeList* freelist = &freelist_[HeapPage::kData];
+  uword current = page->object_start();
+  const uword end = page->object_end();
+  while (current < end) {
+    RawObject* raw_obj = RawObject::FromAddr(current);
+    if (!raw_obj->IsFreeListElement()) {
+      current += raw_obj->HeapSize();
+      continue;
+    }
+    uword free_end = current + raw_obj->HeapSize();
+    while ((free_end < end) &&
+           RawObject::FromAddr(free_end)->IsFreeListElement()) {
+      free_end += RawObject::FromAddr(free_end)->HeapSize();
+    }
+    freelist->FreeLocked(current, free_end - current);
+    current = free_end;
+  }
+}
+
 void PageSpace::CollectGarbage(bool compact, bool finalize) {
   if (!finalize) {
 #if defined(TARGET_ARCH_IA32)
@@ -1088,6 +1425,10 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
     return;
   }
 
+  // The usage is recomputed from the marked objects, so the blocks reserved
+  // by threads must be returned before marking rather than with the bump
+  // allocation block below.
+  AbandonAllocationCaches(isolate);
   marker_->MarkObjects(this);
   usage_.used_in_words = marker_->marked_words() + allocated_black_in_words_;
   allocated_black_in_words_ = 0;
@@ -1155,6 +1496,9 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
     mid3 = OS::GetCurrentMonotonicMicros();
   }
 
+  // Compacted pages are not fragmented, swept pages become candidates for the
+  // next idle evacuation.
+  swept_since_evacuation_ = !compact;
   if (compact) {
     Compact(thread);
     set_phase(kDone);
@@ -1303,6 +1647,11 @@ uword PageSpace::TryAllocatePromoLocked(intptr_t size) {
   return TryAllocateDataLocked(size, PageSpace::kForceGrowth);
 }
 
+void PageSpace::UnallocatePromoLocked(uword addr, intptr_t size) {
+  freelist_[HeapPage::kData].FreeLocked(addr, size);
+  usage_.used_in_words = usage_.used_in_words - (size >> kWordSizeLog2);
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a HeapPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). HeapPage
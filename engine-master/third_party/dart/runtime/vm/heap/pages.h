@@ -284,6 +284,29 @@ class PageSpace {
                                is_locked);
   }
 
+  // Allocates a data object from the block reserved for 'thread', which is
+  // refilled in bulk from the freelist, so that most allocations need not
+  // take the freelist lock. The unused part of the block is kept formatted
+  // as a FreeListElement, but is not in any freelist.
+  uword TryAllocateDataCached(Thread* thread, intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    const uword top = thread->old_space_top();
+    const intptr_t remaining = thread->old_space_end() - top;
+    if (remaining < size) {
+      return TryAllocateDataInNewCache(thread, size);
+    }
+    thread->set_old_space_top(top + size);
+    if (remaining > size) {
+      FreeListElement::AsElement(top + size, remaining - size);
+    }
+    return top;
+  }
+
+  // Return the unused part of the block reserved for 'thread' (or for all
+  // threads of 'isolate') to the freelist.
+  void AbandonAllocationCache(Thread* thread);
+  void AbandonAllocationCaches(Isolate* isolate);
+
   bool NeedsGarbageCollection() const {
     return page_space_controller_.NeedsGarbageCollection(usage_);
   }
@@ -360,6 +383,14 @@ class PageSpace {
 
   bool ShouldStartIdleMarkSweep(int64_t deadline);
   bool ShouldPerformIdleMarkCompact(int64_t deadline);
+  bool ShouldPerformIdleEvacuation(int64_t deadline);
+
+  // Moves the objects off the sparsest data pages and releases those pages,
+  // evacuating as many pages as can be done before 'deadline'. Unlike a
+  // mark-compact, this does not mark the heap, so it moves every object that
+  // survived the last sweep. It should therefore only run right after a
+  // mark-sweep, see ShouldPerformIdleEvacuation.
+  void EvacuateSparsePages(int64_t deadline);
 
   void AddGCTime(int64_t micros) { gc_time_micros_ += micros; }
 
@@ -414,6 +445,8 @@ class PageSpace {
   uword TryAllocateDataBumpLocked(intptr_t size);
   // Prefer small freelist blocks, then chip away at the bump block.
   uword TryAllocatePromoLocked(intptr_t size);
+  // Return the unused part of memory from TryAllocatePromoLocked.
+  void UnallocatePromoLocked(uword addr, intptr_t size);
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
@@ -453,6 +486,8 @@ class PageSpace {
                             GrowthPolicy growth_policy,
                             bool is_protected,
                             bool is_locked);
+  uword TryAllocateDataInNewCache(Thread* thread, intptr_t size);
+  void AbandonAllocationCacheLocked(Thread* thread);
   uword TryAllocateInFreshPage(intptr_t size,
                                HeapPage::PageType type,
                                GrowthPolicy growth_policy,
@@ -474,6 +509,13 @@ class PageSpace {
   void ConcurrentSweep(Isolate* isolate);
   void Compact(Thread* thread);
 
+  bool IsFragmented() const;
+  int64_t EstimatedForwardingMicros() const;
+  int64_t EstimatedEvacuationMicros() const;
+  void EvacuateSparsePagesAtSafepoint(int64_t deadline);
+  bool EvacuatePageLocked(HeapPage* page);
+  void FreeUnusedSpaceLocked(HeapPage* page);
+
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
   bool CanIncreaseCapacityInWordsLocked(intptr_t increase_in_words) {
@@ -529,6 +571,14 @@ class PageSpace {
   intptr_t collections_;
   intptr_t mark_words_per_micro_;
 
+  // Totals over all idle evacuations.
+  int64_t evacuated_bytes_;
+  intptr_t evacuated_pages_;
+  // Whether a mark-sweep has completed since the last idle evacuation or
+  // compaction. Only then are the objects left on the data pages known to
+  // have been live recently, rather than garbage that accumulated since.
+  bool swept_since_evacuation_;
+
   bool enable_concurrent_mark_;
 
   friend class ExclusivePageIterator;
@@ -175,6 +175,19 @@ class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
 
 typedef MarkingStack::Block MarkingStackBlock;
 
+// Objects promoted by the scavenger whose slots still need to be visited.
+// Shares its block size (and the cache of empty blocks) with the marking
+// stack.
+class PromotionStack : public BlockStack<kMarkingStackBlockSize> {
+ public:
+  // Adds and transfers ownership of the block to the buffer.
+  void PushBlock(Block* block) {
+    BlockStack<Block::kSize>::PushBlockImpl(block);
+  }
+};
+
+typedef PromotionStack::Block PromotionStackBlock;
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_HEAP_POINTER_BLOCK_H_
@@ -7,6 +7,7 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/heap/become.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
@@ -17,6 +18,8 @@
 #include "vm/object_id_ring.h"
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
@@ -33,6 +36,11 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(int,
+            new_gen_shrink_garbage_threshold,
+            98,
+            "Shrink new gen by the growth factor when at least this "
+            "percentage is garbage.");
 
 // Scavenger uses RawObject::kMarkBit to distinguish forwarded and non-forwarded
 // objects. The kMarkBit does not intersect with the target address because of
@@ -85,19 +93,41 @@ static inline void objcpy(void* dst, const void* src, size_t size) {
   } while (size > 0);
 }
 
-class ScavengerVisitor : public ObjectPointerVisitor {
+// Each task of a parallel scavenge copies into its own pages of the to space
+// and promotes into its own buffer carved out of the old space, so that most
+// copies and promotions need no synchronization with the other tasks. Larger
+// objects are promoted one by one.
+static const intptr_t kPromotionBufferSize = 32 * KB;
+static const intptr_t kMaxBufferedObjectSize = 4 * KB;
+
+template <bool parallel>
+class ScavengerVisitorBase : public ObjectPointerVisitor {
  public:
-  explicit ScavengerVisitor(Isolate* isolate,
-                            Scavenger* scavenger,
-                            SemiSpace* from)
+  explicit ScavengerVisitorBase(Isolate* isolate,
+                                Scavenger* scavenger,
+                                SemiSpace* from,
+                                PromotionStack* promotion_stack)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
         scavenger_(scavenger),
         from_(from),
         heap_(scavenger->heap_),
         page_space_(scavenger->heap_->old_space()),
+        promotion_stack_(promotion_stack),
+        promoted_block_(NULL),
+        copy_page_(NULL),
+        copy_top_(0),
+        copy_end_(0),
+        scan_(0),
+        promotion_top_(0),
+        promotion_end_(0),
+        delayed_weak_properties_(NULL),
         bytes_promoted_(0),
-        visiting_old_object_(NULL) {}
+        visiting_old_object_(NULL) {
+    promoted_block_ = promotion_stack_->PopEmptyBlock();
+  }
+
+  ~ScavengerVisitorBase() { ASSERT(promoted_block_ == NULL); }
 
   virtual void VisitTypedDataViewPointers(RawTypedDataView* view,
                                           RawObject** first,
@@ -154,9 +184,164 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     }
   }
 
-  intptr_t bytes_promoted() const { return bytes_promoted_; }
+  // Visits the old objects remembered in a block of the store buffer and
+  // returns the emptied block to the isolate's store buffer.
+  intptr_t VisitStoreBufferBlock(StoreBufferBlock* block) {
+    // Generated code appends to store buffers; tell MemorySanitizer.
+    MSAN_UNPOISON(block, sizeof(*block));
+    intptr_t count = block->Count();
+    while (!block->IsEmpty()) {
+      RawObject* raw_object = block->Pop();
+      ASSERT(!raw_object->IsForwardingCorpse());
+      ASSERT(raw_object->IsRemembered());
+      raw_object->ClearRememberedBit();
+      VisitingOldObject(raw_object);
+      raw_object->VisitPointersNonvirtual(this);
+    }
+    block->Reset();
+    // Return the emptied block for recycling (no need to check threshold).
+    thread_->isolate()->store_buffer()->PushBlock(
+        block, StoreBuffer::kIgnoreThreshold);
+    VisitingOldObject(NULL);
+    return count;
+  }
+
+  // Visits the promoted objects of this visitor or, if it has none left, of
+  // another task. Returns false if there are none.
+  bool ProcessPromotedObjects() {
+    if (promoted_block_->IsEmpty()) {
+      PromotionStackBlock* block = promotion_stack_->PopNonEmptyBlock();
+      if (block == NULL) {
+        return false;
+      }
+      promotion_stack_->PushBlock(promoted_block_);
+      promoted_block_ = block;
+    }
+    while (!promoted_block_->IsEmpty()) {
+      RawObject* raw_object = promoted_block_->Pop();
+      ASSERT(!raw_object->IsRemembered());
+      VisitingOldObject(raw_object);
+      raw_object->VisitPointersNonvirtual(this);
+      if (raw_object->IsMarked()) {
+        // Complete our promise from ScavengePointer. Note that marker cannot
+        // visit this object until it pops a block from the mark stack, which
+        // involves a memory fence from the mutex, so even on architectures
+        // with a relaxed memory model, the marker will see the fully
+        // forwarded contents of this object.
+        thread_->MarkingStackAddObject(raw_object);
+      }
+    }
+    VisitingOldObject(NULL);
+    return true;
+  }
+
+  // The following methods are only used by the tasks of a parallel scavenge.
+  // Each task copies the objects it discovers into its own pages and scans
+  // them there. Promoted objects are published on the shared promotion
+  // stack, from which idle tasks steal work.
+
+  // Visits the slots of copied and promoted objects until this task runs out
+  // of work.
+  void ProcessToSpace() {
+    ASSERT(parallel);
+    while (true) {
+      if (scan_ < copy_top_) {
+        // Advance before visiting: the visit may retire the copy page.
+        RawObject* raw_obj = RawObject::FromAddr(scan_);
+        scan_ += raw_obj->HeapSize();
+        ProcessCopiedObject(raw_obj);
+      } else if (!unscanned_.is_empty()) {
+        const ScanRange range = unscanned_.RemoveLast();
+        uword cur = range.start;
+        while (cur < range.end) {
+          RawObject* raw_obj = RawObject::FromAddr(cur);
+          cur += raw_obj->HeapSize();
+          ProcessCopiedObject(raw_obj);
+        }
+      } else if (!ProcessPromotedObjects()) {
+        return;
+      }
+    }
+  }
+
+  // Visits the weak properties whose keys have been reached by any task since
+  // they were discovered. Returns whether this produced more work.
+  bool ProcessPendingWeakProperties() {
+    ASSERT(parallel);
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      // Promoted weak properties are not enqueued. So we can guarantee that
+      // we do not need to think about store barriers here.
+      ASSERT(cur_weak->IsNewObject());
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      ASSERT(raw_key->IsHeapObject());
+      ASSERT(raw_key->IsNewObject());
+      cur_weak->ptr()->next_ = 0;
+      if (IsForwarding(ReadHeader(RawObject::ToAddr(raw_key)))) {
+        cur_weak->VisitPointersNonvirtual(this);
+      } else {
+        EnqueueWeakProperty(cur_weak);
+      }
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    return HasWork();
+  }
+
+  bool HasWork() const {
+    // Visiting a weak property may also have filled and published a block of
+    // promoted objects.
+    return (scan_ < copy_top_) || !unscanned_.is_empty() ||
+           !promoted_block_->IsEmpty() || !promotion_stack_->IsEmpty();
+  }
+
+  // Returns the unused parts of the buffers and hands the weak properties
+  // with unreachable keys and the promoted bytes over to the scavenger.
+  void Finalize() {
+    ASSERT(!HasWork());
+    if (parallel) {
+      {
+        MutexLocker ml(&scavenger_->space_lock_);
+        RetireCopyPage();
+      }
+      if (promotion_top_ < promotion_end_) {
+        page_space_->AcquireDataLock();
+        page_space_->UnallocatePromoLocked(promotion_top_,
+                                           promotion_end_ - promotion_top_);
+        page_space_->ReleaseDataLock();
+      }
+      promotion_top_ = promotion_end_ = 0;
+    }
+    promotion_stack_->PushBlock(promoted_block_);
+    promoted_block_ = NULL;
+
+    MutexLocker ml(&scavenger_->work_lock_);
+    while (delayed_weak_properties_ != NULL) {
+      RawWeakProperty* cur_weak = delayed_weak_properties_;
+      delayed_weak_properties_ =
+          reinterpret_cast<RawWeakProperty*>(cur_weak->ptr()->next_);
+      cur_weak->ptr()->next_ = 0;
+      scavenger_->EnqueueWeakProperty(cur_weak);
+    }
+    scavenger_->bytes_promoted_ += bytes_promoted_;
+  }
 
  private:
+  struct ScanRange {
+    uword start;
+    uword end;
+  };
+
+  static uword ReadHeader(uword addr) {
+    if (parallel) {
+      // Acquire the contents of the copy if another task forwarded the object.
+      return reinterpret_cast<std::atomic<uword>*>(addr)->load(
+          std::memory_order_acquire);
+    }
+    return *reinterpret_cast<uword*>(addr);
+  }
+
   void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
     ASSERT(obj->IsHeapObject());
     // If the newly written object is not a new object, drop it immediately.
@@ -181,15 +366,17 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     ASSERT(from_->Contains(raw_addr));
     // Read the header word of the object and determine if the object has
     // already been copied.
-    uword header = *reinterpret_cast<uword*>(raw_addr);
+    uword header = ReadHeader(raw_addr);
     uword new_addr = 0;
     if (IsForwarding(header)) {
       // Get the new location of the object.
       new_addr = ForwardedAddr(header);
+    } else if (parallel) {
+      new_addr = CopyParallel(raw_obj, header);
     } else {
       intptr_t size = raw_obj->HeapSize();
       // Check whether object should be promoted.
-      if (scavenger_->survivor_end_ <= raw_addr) {
+      if (!NewPage::Of(raw_addr)->IsSurvivor(raw_addr)) {
         // Not a survivor of a previous scavenge. Just copy the object into the
         // to space.
         new_addr = scavenger_->AllocateGC(size);
@@ -204,7 +391,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
         if (new_addr != 0) {
           // If promotion succeeded then we need to remember it so that it can
           // be traversed later.
-          scavenger_->PushToPromotedStack(new_addr);
+          PushPromoted(RawObject::FromAddr(new_addr));
           bytes_promoted_ += size;
         } else {
           // Promotion did not succeed. Copy into the to space instead.
@@ -218,27 +405,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       // Copy the object to the new location.
       objcpy(reinterpret_cast<void*>(new_addr),
              reinterpret_cast<void*>(raw_addr), size);
-
-      RawObject* new_obj = RawObject::FromAddr(new_addr);
-      if (new_obj->IsOldObject()) {
-        // Promoted: update age/barrier tags.
-        uint32_t tags = new_obj->ptr()->tags_;
-        tags = RawObject::OldBit::update(true, tags);
-        tags = RawObject::OldAndNotRememberedBit::update(true, tags);
-        tags = RawObject::NewBit::update(false, tags);
-        // Setting the forwarding pointer below will make this tenured object
-        // visible to the concurrent marker, but we haven't visited its slots
-        // yet. We mark the object here to prevent the concurrent marker from
-        // adding it to the mark stack and visiting its unprocessed slots. We
-        // push it to the mark stack after forwarding its slots.
-        tags =
-            RawObject::OldAndNotMarkedBit::update(!thread_->is_marking(), tags);
-        new_obj->ptr()->tags_ = tags;
-      }
-
-      if (RawObject::IsTypedDataClassId(new_obj->GetClassId())) {
-        reinterpret_cast<RawTypedData*>(new_obj)->RecomputeDataField();
-      }
+      InitializeCopy(RawObject::FromAddr(new_addr), header);
 
       // Remember forwarding address.
       ForwardTo(raw_addr, new_addr);
@@ -261,18 +428,213 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     }
   }
 
+  // Decodes the tags from |header|, the header word read from the original
+  // object, rather than reading the copy back.
+  void InitializeCopy(RawObject* new_obj, uword header) {
+    uint32_t tags = static_cast<uint32_t>(header);
+    if (new_obj->IsOldObject()) {
+      // Promoted: update age/barrier tags.
+      tags = RawObject::OldBit::update(true, tags);
+      tags = RawObject::OldAndNotRememberedBit::update(true, tags);
+      tags = RawObject::NewBit::update(false, tags);
+      // Setting the forwarding pointer below will make this tenured object
+      // visible to the concurrent marker, but we haven't visited its slots
+      // yet. We mark the object here to prevent the concurrent marker from
+      // adding it to the mark stack and visiting its unprocessed slots. We
+      // push it to the mark stack after forwarding its slots.
+      tags =
+          RawObject::OldAndNotMarkedBit::update(!thread_->is_marking(), tags);
+      new_obj->ptr()->tags_ = tags;
+    }
+
+    if (RawObject::IsTypedDataClassId(RawObject::ClassIdTag::decode(tags))) {
+      reinterpret_cast<RawTypedData*>(new_obj)->RecomputeDataField();
+    }
+  }
+
+  // Copies or promotes an object that other tasks may be copying at the same
+  // time. Only the task that installs the forwarding pointer keeps its copy.
+  uword CopyParallel(RawObject* raw_obj, uword header) {
+    uword raw_addr = RawObject::ToAddr(raw_obj);
+    // The header may be replaced by a forwarding pointer at any time, so the
+    // size is computed from the tags we have read.
+    intptr_t size = raw_obj->HeapSize(static_cast<uint32_t>(header));
+    uword new_addr = 0;
+    if (!NewPage::Of(raw_addr)->IsSurvivor(raw_addr)) {
+      // Not a survivor of a previous scavenge. Copy the object into the to
+      // space.
+      new_addr = TryAllocateCopy(size);
+    }
+    if (new_addr == 0) {
+      new_addr = TryAllocatePromotion(size);
+      if (new_addr == 0) {
+        // Promotion did not succeed. Copy into the to space instead.
+        scavenger_->failed_to_promote_ = true;
+        new_addr = TryAllocateCopy(size);
+        if (new_addr == 0) {
+          OUT_OF_MEMORY();
+        }
+      }
+    }
+    objcpy(reinterpret_cast<void*>(new_addr),
+           reinterpret_cast<void*>(raw_addr), size);
+    RawObject* new_obj = RawObject::FromAddr(new_addr);
+    InitializeCopy(new_obj, header);
+
+    // Make the copy visible to the tasks that read the forwarding pointer.
+    uword forwarding = new_addr | kForwarded;
+    if (!reinterpret_cast<std::atomic<uword>*>(raw_addr)
+             ->compare_exchange_strong(header, forwarding,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+      // Another task won the race. Discard our copy and use theirs.
+      UndoAllocation(new_addr, size);
+      return ForwardedAddr(header);
+    }
+
+    if (new_obj->IsOldObject()) {
+      bytes_promoted_ += size;
+      PushPromoted(new_obj);
+    }
+    return new_addr;
+  }
+
+  void PushPromoted(RawObject* raw_obj) {
+    promoted_block_->Push(raw_obj);
+    if (promoted_block_->IsFull()) {
+      promotion_stack_->PushBlock(promoted_block_);
+      promoted_block_ = promotion_stack_->PopEmptyBlock();
+    }
+  }
+
+  uword TryAllocateCopy(intptr_t size) {
+    if (UNLIKELY(static_cast<intptr_t>(copy_end_ - copy_top_) < size)) {
+      MutexLocker ml(&scavenger_->space_lock_);
+      RetireCopyPage();
+      // Like the serial scavenger, the tasks may grow the to space beyond its
+      // capacity to hold all survivors.
+      NewPage* page = scavenger_->to_->TryAllocatePage(true);
+      if (page == NULL) {
+        return 0;
+      }
+      copy_page_ = page;
+      scan_ = copy_top_ = page->object_start();
+      copy_end_ = page->end();
+    }
+    uword result = copy_top_;
+    copy_top_ += size;
+    return result;
+  }
+
+  // Leaves the remaining objects of the copy page to be scanned later and
+  // records how far the page has been filled.
+  void RetireCopyPage() {
+    DEBUG_ASSERT(scavenger_->space_lock_.IsOwnedByCurrentThread());
+    if (copy_page_ == NULL) {
+      return;
+    }
+    if (scan_ < copy_top_) {
+      unscanned_.Add({scan_, copy_top_});
+    }
+    copy_page_->set_top(copy_top_);
+    copy_page_ = NULL;
+    scan_ = copy_top_ = copy_end_ = 0;
+  }
+
+  uword TryAllocatePromotion(intptr_t size) {
+    uword result = 0;
+    if (UNLIKELY(size > kMaxBufferedObjectSize)) {
+      page_space_->AcquireDataLock();
+      result = page_space_->TryAllocatePromoLocked(size);
+      page_space_->ReleaseDataLock();
+      return result;
+    }
+    if (UNLIKELY(static_cast<intptr_t>(promotion_end_ - promotion_top_) <
+                 size)) {
+      page_space_->AcquireDataLock();
+      if (promotion_top_ < promotion_end_) {
+        page_space_->UnallocatePromoLocked(promotion_top_,
+                                           promotion_end_ - promotion_top_);
+      }
+      promotion_top_ =
+          page_space_->TryAllocatePromoLocked(kPromotionBufferSize);
+      page_space_->ReleaseDataLock();
+      if (promotion_top_ == 0) {
+        promotion_end_ = 0;
+        return 0;
+      }
+      promotion_end_ = promotion_top_ + kPromotionBufferSize;
+    }
+    result = promotion_top_;
+    promotion_top_ += size;
+    return result;
+  }
+
+  void UndoAllocation(uword addr, intptr_t size) {
+    // Buffered allocations are undone by moving the top back.
+    if (RawObject::FromAddr(addr)->IsNewObject()) {
+      ASSERT(addr + size == copy_top_);
+      copy_top_ = addr;
+    } else if (size <= kMaxBufferedObjectSize) {
+      ASSERT(addr + size == promotion_top_);
+      promotion_top_ = addr;
+    } else {
+      page_space_->AcquireDataLock();
+      page_space_->UnallocatePromoLocked(addr, size);
+      page_space_->ReleaseDataLock();
+    }
+  }
+
+  void ProcessCopiedObject(RawObject* raw_obj) {
+    if (raw_obj->GetClassId() == kWeakPropertyCid) {
+      ProcessWeakProperty(reinterpret_cast<RawWeakProperty*>(raw_obj));
+    } else {
+      raw_obj->VisitPointersNonvirtual(this);
+    }
+  }
+
+  void EnqueueWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(raw_weak->IsNewObject());
+    ASSERT(raw_weak->ptr()->next_ == 0);
+    raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = raw_weak;
+  }
+
+  void ProcessWeakProperty(RawWeakProperty* raw_weak) {
+    // The fate of the weak property is determined by its key.
+    RawObject* raw_key = raw_weak->ptr()->key_;
+    if (raw_key->IsHeapObject() && raw_key->IsNewObject() &&
+        !IsForwarding(ReadHeader(RawObject::ToAddr(raw_key)))) {
+      // Key is white.  Enqueue the weak property.
+      EnqueueWeakProperty(raw_weak);
+      return;
+    }
+    // Key is gray or black.  Make the weak property black.
+    raw_weak->VisitPointersNonvirtual(this);
+  }
+
   Thread* thread_;
   Scavenger* scavenger_;
   SemiSpace* from_;
   Heap* heap_;
   PageSpace* page_space_;
+  PromotionStack* promotion_stack_;
+  PromotionStackBlock* promoted_block_;
+  NewPage* copy_page_;
+  uword copy_top_;
+  uword copy_end_;
+  // The next object to scan in the copy page.
+  uword scan_;
+  MallocGrowableArray<ScanRange> unscanned_;
+  uword promotion_top_;
+  uword promotion_end_;
   RawWeakProperty* delayed_weak_properties_;
   intptr_t bytes_promoted_;
   RawObject* visiting_old_object_;
 
   friend class Scavenger;
 
-  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitor);
+  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitorBase);
 };
 
 class ScavengerWeakVisitor : public HandleVisitor {
@@ -324,94 +686,196 @@ class VerifyStoreBufferPointerVisitor : public ObjectPointerVisitor {
   DISALLOW_COPY_AND_ASSIGN(VerifyStoreBufferPointerVisitor);
 };
 
-SemiSpace::SemiSpace(VirtualMemory* reserved)
-    : reserved_(reserved), region_(NULL, 0) {
-  if (reserved != NULL) {
-    region_ = MemoryRegion(reserved_->address(), reserved_->size());
+// Pages freed by a scavenge are cached for the to space of the next one,
+// which saves mapping and faulting in fresh memory. The capacity of the cache
+// matches the default maximum size of a semi-space.
+static const intptr_t kPageCacheCapacity = 32;
+static Mutex* page_cache_mutex = NULL;
+static VirtualMemory* page_cache[kPageCacheCapacity] = {NULL};
+static intptr_t page_cache_size = 0;
+
+void NewPage::Init() {
+  if (page_cache_mutex == NULL) {
+    page_cache_mutex = new Mutex();
   }
+  ASSERT(page_cache_mutex != NULL);
 }
 
-SemiSpace::~SemiSpace() {
-  delete reserved_;
+void NewPage::Cleanup() {
+  TrimCache(0);
 }
 
-Mutex* SemiSpace::mutex_ = NULL;
-SemiSpace* SemiSpace::cache_ = NULL;
-
-void SemiSpace::Init() {
-  if (mutex_ == NULL) {
-    mutex_ = new Mutex();
+NewPage* NewPage::Allocate() {
+  VirtualMemory* memory = NULL;
+  {
+    MutexLocker ml(page_cache_mutex);
+    if (page_cache_size > 0) {
+      memory = page_cache[--page_cache_size];
+    }
   }
-  ASSERT(mutex_ != NULL);
-}
+  if (memory != NULL) {
+#if defined(DEBUG)
+    memory->Protect(VirtualMemory::kReadWrite);
+#endif
+  } else {
+    const bool kExecutable = false;
+    memory = VirtualMemory::AllocateAligned(kNewPageSize, kNewPageSize,
+                                            kExecutable,
+                                            Heap::RegionName(Heap::kNew));
+    if (memory == NULL) {
+      return NULL;
+    }
+#if defined(DEBUG)
+    memset(memory->address(), Heap::kZapByte, kNewPageSize);
+#endif
+  }
+  // Initialized by generated code.
+  MSAN_UNPOISON(memory->address(), kNewPageSize);
 
-void SemiSpace::Cleanup() {
-  MutexLocker locker(mutex_);
-  delete cache_;
-  cache_ = NULL;
+  NewPage* result = reinterpret_cast<NewPage*>(memory->address());
+  result->memory_ = memory;
+  result->next_ = NULL;
+  result->owner_ = NULL;
+  result->top_ = result->object_start();
+  result->survivor_end_ = result->object_start();
+
+  LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
+
+  return result;
 }
 
-SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
-  SemiSpace* result = nullptr;
+void NewPage::Deallocate() {
+  ASSERT(owner_ == NULL);
+  LSAN_UNREGISTER_ROOT_REGION(this, sizeof(*this));
+
+  // The header of this page is gone once the memory is zapped.
+  VirtualMemory* memory = memory_;
+#if defined(DEBUG)
+  memset(memory->address(), Heap::kZapByte, kNewPageSize);
+#endif
+  MSAN_POISON(memory->address(), kNewPageSize);
   {
-    MutexLocker locker(mutex_);
-    // TODO(koda): Cache one entry per size.
-    if (cache_ != nullptr && cache_->size_in_words() == size_in_words) {
-      result = cache_;
-      cache_ = nullptr;
+    MutexLocker ml(page_cache_mutex);
+    if (page_cache_size < kPageCacheCapacity) {
+#if defined(DEBUG)
+      memory->Protect(VirtualMemory::kNoAccess);
+#endif
+      page_cache[page_cache_size++] = memory;
+      memory = NULL;
     }
   }
-  if (result != nullptr) {
-#ifdef DEBUG
-    result->reserved_->Protect(VirtualMemory::kReadWrite);
-#endif
-    // Initialized by generated code.
-    MSAN_UNPOISON(result->reserved_->address(), size_in_words << kWordSizeLog2);
-    return result;
+  delete memory;
+}
+
+void NewPage::TrimCache(intptr_t max_pages) {
+  ASSERT(max_pages >= 0);
+  while (true) {
+    VirtualMemory* memory = NULL;
+    {
+      MutexLocker ml(page_cache_mutex);
+      if (page_cache_size <= max_pages) {
+        return;
+      }
+      memory = page_cache[--page_cache_size];
+    }
+    delete memory;
   }
+}
 
-  if (size_in_words == 0) {
-    return new SemiSpace(nullptr);
-  } else {
-    intptr_t size_in_bytes = size_in_words << kWordSizeLog2;
-    const bool kExecutable = false;
-    VirtualMemory* memory =
-        VirtualMemory::Allocate(size_in_bytes, kExecutable, name);
-    if (memory == nullptr) {
-      // TODO(koda): If cache_ is not empty, we could try to delete it.
-      return nullptr;
+intptr_t NewPage::CachedPages() {
+  MutexLocker ml(page_cache_mutex);
+  return page_cache_size;
+}
+
+void NewPage::VisitObjects(ObjectVisitor* visitor) const {
+  uword addr = object_start();
+  uword end_addr = object_end();
+  while (addr < end_addr) {
+    RawObject* raw_obj = RawObject::FromAddr(addr);
+    visitor->VisitObject(raw_obj);
+    addr += raw_obj->HeapSize();
+  }
+  ASSERT(addr == end_addr);
+}
+
+void NewPage::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
+  uword addr = object_start();
+  uword end_addr = object_end();
+  while (addr < end_addr) {
+    RawObject* raw_obj = RawObject::FromAddr(addr);
+    addr += raw_obj->VisitPointers(visitor);
+  }
+  ASSERT(addr == end_addr);
+}
+
+RawObject* NewPage::FindObject(FindObjectVisitor* visitor) const {
+  uword addr = object_start();
+  uword end_addr = object_end();
+  if (visitor->VisitRange(addr, end_addr)) {
+    while (addr < end_addr) {
+      RawObject* raw_obj = RawObject::FromAddr(addr);
+      uword next = addr + raw_obj->HeapSize();
+      if (visitor->VisitRange(addr, next) && raw_obj->FindObject(visitor)) {
+        return raw_obj;  // Found object, return it.
+      }
+      addr = next;
     }
-#if defined(DEBUG)
-    memset(memory->address(), Heap::kZapByte, size_in_bytes);
-#endif  // defined(DEBUG)
-    // Initialized by generated code.
-    MSAN_UNPOISON(memory->address(), size_in_bytes);
-    return new SemiSpace(memory);
+    ASSERT(addr == end_addr);
   }
+  return Object::null();
 }
 
-void SemiSpace::Delete() {
-  if (reserved_ != nullptr) {
-    const intptr_t size_in_bytes = size_in_words() << kWordSizeLog2;
-#ifdef DEBUG
-    memset(reserved_->address(), Heap::kZapByte, size_in_bytes);
-    reserved_->Protect(VirtualMemory::kNoAccess);
-#endif
-    MSAN_POISON(reserved_->address(), size_in_bytes);
+void NewPage::WriteProtect(bool read_only) {
+  memory_->Protect(read_only ? VirtualMemory::kReadOnly
+                             : VirtualMemory::kReadWrite);
+}
+
+SemiSpace::SemiSpace(intptr_t max_capacity_in_words)
+    : capacity_in_words_(0),
+      max_capacity_in_words_(max_capacity_in_words),
+      head_(NULL),
+      tail_(NULL) {}
+
+SemiSpace::~SemiSpace() {
+  NewPage* page = head_;
+  while (page != NULL) {
+    NewPage* next = page->next();
+    page->Deallocate();
+    page = next;
   }
-  SemiSpace* old_cache = nullptr;
-  {
-    MutexLocker locker(mutex_);
-    old_cache = cache_;
-    cache_ = this;
+}
+
+NewPage* SemiSpace::TryAllocatePage(bool grow_beyond_capacity) {
+  if (!grow_beyond_capacity &&
+      (capacity_in_words_ + kNewPageSizeInWords > max_capacity_in_words_)) {
+    return NULL;
+  }
+  NewPage* page = NewPage::Allocate();
+  if (page == NULL) {
+    return NULL;
+  }
+  capacity_in_words_ += kNewPageSizeInWords;
+  if (head_ == NULL) {
+    head_ = page;
+  } else {
+    tail_->set_next(page);
+  }
+  tail_ = page;
+  return page;
+}
+
+bool SemiSpace::Contains(uword addr) const {
+  for (NewPage* page = head_; page != NULL; page = page->next()) {
+    if (page->Contains(addr)) {
+      return true;
+    }
   }
-  delete old_cache;
+  return false;
 }
 
 void SemiSpace::WriteProtect(bool read_only) {
-  if (reserved_ != NULL) {
-    reserved_->Protect(read_only ? VirtualMemory::kReadOnly
-                                 : VirtualMemory::kReadWrite);
+  for (NewPage* page = head_; page != NULL; page = page->next()) {
+    page->WriteProtect(read_only);
   }
 }
 
@@ -425,7 +889,12 @@ Scavenger::Scavenger(Heap* heap,
                      intptr_t max_semi_capacity_in_words,
                      uword object_alignment)
     : heap_(heap),
-      max_semi_capacity_in_words_(max_semi_capacity_in_words),
+      scan_page_(NULL),
+      resolved_top_(0),
+      early_tenure_(false),
+      max_semi_capacity_in_words_(
+          Utils::RoundUp(max_semi_capacity_in_words, kNewPageSizeInWords)),
+      initial_semi_capacity_in_words_(0),
       object_alignment_(object_alignment),
       scavenging_(false),
       delayed_weak_properties_(NULL),
@@ -434,26 +903,24 @@ Scavenger::Scavenger(Heap* heap,
       scavenge_words_per_micro_(kConservativeInitialScavengeSpeed),
       idle_scavenge_threshold_in_words_(0),
       external_size_(0),
-      failed_to_promote_(false) {
+      failed_to_promote_(false),
+      root_slices_not_started_(0),
+      store_buffer_entries_(0),
+      pending_store_buffer_blocks_(NULL),
+      bytes_promoted_(0) {
   // Verify assumptions about the first word in objects which the scavenger is
   // going to use for forwarding pointers.
   ASSERT(Object::tags_offset() == 0);
+  // Objects are allocated at the alignment of new pages.
+  ASSERT(object_alignment == kNewObjectAlignmentOffset);
 
-  // Set initial semi space size in words.
+  // Set initial semi space size in words. Pages are only allocated as the
+  // space is used.
   const intptr_t initial_semi_capacity_in_words = Utils::Minimum(
-      max_semi_capacity_in_words, FLAG_new_gen_semi_initial_size * MBInWords);
-
-  const char* name = Heap::RegionName(Heap::kNew);
-  to_ = SemiSpace::New(initial_semi_capacity_in_words, name);
-  if (to_ == NULL) {
-    OUT_OF_MEMORY();
-  }
-  // Setup local fields.
-  top_ = FirstObjectStart();
-  resolved_top_ = top_;
-  end_ = to_->end();
-
-  survivor_end_ = FirstObjectStart();
+      max_semi_capacity_in_words_, FLAG_new_gen_semi_initial_size * MBInWords);
+  initial_semi_capacity_in_words_ =
+      Utils::RoundUp(initial_semi_capacity_in_words, kNewPageSizeInWords);
+  to_ = new SemiSpace(initial_semi_capacity_in_words_);
   idle_scavenge_threshold_in_words_ = initial_semi_capacity_in_words;
 
   UpdateMaxHeapCapacity();
@@ -462,7 +929,7 @@ Scavenger::Scavenger(Heap* heap,
 
 Scavenger::~Scavenger() {
   ASSERT(!scavenging_);
-  to_->Delete();
+  delete to_;
 }
 
 intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
@@ -471,8 +938,18 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   }
   double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
   if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
-    return Utils::Minimum(max_semi_capacity_in_words_,
-                          old_size_in_words * FLAG_new_gen_growth_factor);
+    // The to space only maps pages as it fills, so growing is cheap.
+    return Utils::Minimum(
+        max_semi_capacity_in_words_,
+        Utils::RoundUp(old_size_in_words * FLAG_new_gen_growth_factor,
+                       kNewPageSizeInWords));
+  } else if (garbage >= (FLAG_new_gen_shrink_garbage_threshold / 100.0)) {
+    // Almost nothing survived, so a smaller space would have done. The gap
+    // between the thresholds keeps the shrunk space from growing right back.
+    return Utils::Maximum(
+        initial_semi_capacity_in_words_,
+        Utils::RoundUp(old_size_in_words / FLAG_new_gen_growth_factor,
+                       kNewPageSizeInWords));
   } else {
     return old_size_in_words;
   }
@@ -483,20 +960,12 @@ SemiSpace* Scavenger::Prologue(Isolate* isolate) {
   AbandonTLABs(isolate);
 
   // Flip the two semi-spaces so that to_ is always the space for allocating
-  // objects.
+  // objects. The new to space starts out without pages.
   SemiSpace* from = to_;
-
-  const char* name = Heap::RegionName(Heap::kNew);
-  to_ = SemiSpace::New(NewSizeInWords(from->size_in_words()), name);
-  if (to_ == NULL) {
-    // TODO(koda): We could try to recover (collect old space, wait for another
-    // isolate to finish scavenge, etc.).
-    OUT_OF_MEMORY();
-  }
+  to_ = new SemiSpace(NewSizeInWords(from->max_capacity_in_words()));
   UpdateMaxHeapCapacity();
-  top_ = FirstObjectStart();
-  resolved_top_ = top_;
-  end_ = to_->end();
+  scan_page_ = NULL;
+  resolved_top_ = 0;
 
   return from;
 }
@@ -516,13 +985,12 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
     avg_frac += 0.5 * stats_history_.Get(1).PromoCandidatesSuccessFraction();
     avg_frac /= 1.0 + 0.5;  // Normalize.
   }
-  if (avg_frac < (FLAG_early_tenuring_threshold / 100.0)) {
-    // Remember the limit to which objects have been copied.
-    survivor_end_ = top_;
-  } else {
-    // Move survivor end to the end of the to_ space, making all surviving
-    // objects candidates for promotion next time.
-    survivor_end_ = end_;
+  // Remember the limit to which objects have been copied. With early
+  // tenuring, move the survivor end to the end of each page instead, making
+  // all surviving objects candidates for promotion next time.
+  early_tenure_ = avg_frac >= (FLAG_early_tenuring_threshold / 100.0);
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    page->set_survivor_end(early_tenure_ ? page->end() : page->top());
   }
 
   // Update estimate of scavenger speed. This statistic assumes survivorship
@@ -576,7 +1044,7 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
     }
   }
 #endif  // defined(DEBUG)
-  from->Delete();
+  delete from;
   UpdateMaxHeapUsage();
   if (heap_ != NULL) {
     heap_->UpdateGlobalMaxUsed();
@@ -600,32 +1068,17 @@ bool Scavenger::ShouldPerformIdleScavenge(int64_t deadline) {
 }
 
 void Scavenger::IterateStoreBuffers(Isolate* isolate,
-                                    ScavengerVisitor* visitor) {
+                                    SerialScavengerVisitor* visitor) {
   // Iterating through the store buffers.
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
   StoreBufferBlock* pending = isolate->store_buffer()->Blocks();
   intptr_t total_count = 0;
   while (pending != NULL) {
     StoreBufferBlock* next = pending->next();
-    // Generated code appends to store buffers; tell MemorySanitizer.
-    MSAN_UNPOISON(pending, sizeof(*pending));
-    intptr_t count = pending->Count();
-    total_count += count;
-    while (!pending->IsEmpty()) {
-      RawObject* raw_object = pending->Pop();
-      ASSERT(!raw_object->IsForwardingCorpse());
-      ASSERT(raw_object->IsRemembered());
-      raw_object->ClearRememberedBit();
-      visitor->VisitingOldObject(raw_object);
-      raw_object->VisitPointersNonvirtual(visitor);
-    }
-    pending->Reset();
-    // Return the emptied block for recycling (no need to check threshold).
-    isolate->store_buffer()->PushBlock(pending, StoreBuffer::kIgnoreThreshold);
+    total_count += visitor->VisitStoreBufferBlock(pending);
     pending = next;
   }
 
-  visitor->VisitingOldObject(NULL);
   heap_->old_space()->VisitRememberedCards(visitor);
 
   heap_->RecordData(kStoreBufferEntries, total_count);
@@ -636,7 +1089,7 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
 }
 
 void Scavenger::IterateObjectIdTable(Isolate* isolate,
-                                     ScavengerVisitor* visitor) {
+                                     ObjectPointerVisitor* visitor) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
     return;
@@ -645,7 +1098,8 @@ void Scavenger::IterateObjectIdTable(Isolate* isolate,
 #endif  // !PRODUCT
 }
 
-void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
+void Scavenger::IterateRoots(Isolate* isolate,
+                             SerialScavengerVisitor* visitor) {
 #ifdef SUPPORT_TIMELINE
   Thread* thread = Thread::Current();
 #endif
@@ -668,6 +1122,213 @@ void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
   heap_->RecordTime(kDummyScavengeTime, 0);
 }
 
+enum RootSlices {
+  kIsolate = 0,
+  kObjectIdRing = 1,
+  kRememberedCards = 2,
+  kNumRootSlices = 3,
+};
+
+void Scavenger::IterateRoots(Isolate* isolate,
+                             ParallelScavengerVisitor* visitor) {
+  for (;;) {
+    intptr_t task = root_slices_not_started_.fetch_sub(1) - 1;
+    if (task < 0) {
+      break;  // No more tasks.
+    }
+
+    switch (task) {
+      case kIsolate: {
+        TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessRoots");
+        isolate->VisitObjectPointers(visitor,
+                                     ValidationPolicy::kDontValidateFrames);
+        break;
+      }
+      case kObjectIdRing:
+        IterateObjectIdTable(isolate, visitor);
+        break;
+      case kRememberedCards:
+        heap_->old_space()->VisitRememberedCards(visitor);
+        break;
+      default:
+        FATAL1("%" Pd, task);
+        UNREACHABLE();
+    }
+  }
+
+  // The blocks of the store buffer are handed out one at a time, so that the
+  // remembered set is split among all tasks.
+  TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessRememberedSet");
+  for (;;) {
+    StoreBufferBlock* block;
+    {
+      MutexLocker ml(&work_lock_);
+      block = pending_store_buffer_blocks_;
+      if (block == NULL) {
+        break;
+      }
+      pending_store_buffer_blocks_ = block->next();
+    }
+    store_buffer_entries_ += visitor->VisitStoreBufferBlock(block);
+  }
+}
+
+class ParallelScavengerTask : public ThreadPool::Task {
+ public:
+  ParallelScavengerTask(Scavenger* scavenger,
+                        Isolate* isolate,
+                        SemiSpace* from,
+                        PromotionStack* promotion_stack,
+                        ThreadBarrier* barrier,
+                        RelaxedAtomic<uintptr_t>* num_busy)
+      : scavenger_(scavenger),
+        isolate_(isolate),
+        from_(from),
+        promotion_stack_(promotion_stack),
+        barrier_(barrier),
+        num_busy_(num_busy) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kScavengerTask, true);
+    ASSERT(result);
+    {
+      TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ParallelScavenge");
+      ParallelScavengerVisitor visitor(isolate_, scavenger_, from_,
+                                       promotion_stack_);
+
+      // Phase 1: Iterate over roots and scavenge the reachable objects.
+      scavenger_->IterateRoots(isolate_, &visitor);
+
+      bool more_to_scavenge = false;
+      do {
+        do {
+          visitor.ProcessToSpace();
+
+          // I can't find more work right now. If no other task is busy,
+          // then there will never be more work (NB: 1 is *before* decrement).
+          if (num_busy_->fetch_sub(1u) == 1) break;
+
+          // Wait for some work to appear.
+          while (promotion_stack_->IsEmpty() && num_busy_->load() > 0) {
+          }
+
+          // If no tasks are busy, there will never be more work.
+          if (num_busy_->load() == 0) break;
+
+          // I saw some work; get busy and compete for it.
+          num_busy_->fetch_add(1u);
+        } while (true);
+        // Wait for all scavengers to stop.
+        barrier_->Sync();
+#if defined(DEBUG)
+        ASSERT(num_busy_->load() == 0);
+        // Caveat: must not allow any task to continue past the barrier
+        // before we checked num_busy, otherwise one of them might rush
+        // ahead and increment it.
+        barrier_->Sync();
+#endif
+        // Check if we have any pending properties with reachable keys.
+        // Those might have been copied by another task.
+        more_to_scavenge = visitor.ProcessPendingWeakProperties();
+        if (more_to_scavenge) {
+          // We have more work to do. Notify others.
+          num_busy_->fetch_add(1u);
+        }
+
+        // Wait for all other tasks to finish processing their pending
+        // weak properties and decide if they need to continue scavenging.
+        // Caveat: we need two barriers here to make this decision in lock step
+        // between all tasks and the main thread.
+        barrier_->Sync();
+        if (!more_to_scavenge && (num_busy_->load() > 0)) {
+          // All tasks continue to scavenge as long as any single task has
+          // some work to do.
+          num_busy_->fetch_add(1u);
+          more_to_scavenge = true;
+        }
+        barrier_->Sync();
+      } while (more_to_scavenge);
+
+      // Phase 2: Return unused buffers and hand over the results.
+      visitor.Finalize();
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  Scavenger* scavenger_;
+  Isolate* isolate_;
+  SemiSpace* from_;
+  PromotionStack* promotion_stack_;
+  ThreadBarrier* barrier_;
+  RelaxedAtomic<uintptr_t>* num_busy_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
+};
+
+void Scavenger::ParallelScavenge(Isolate* isolate,
+                                 SemiSpace* from,
+                                 intptr_t num_tasks) {
+  int64_t start = OS::GetCurrentMonotonicMicros();
+  // Grab the deduplication sets out of the isolate's consolidated store buffer
+  // before any task starts to fill new blocks.
+  pending_store_buffer_blocks_ = isolate->store_buffer()->Blocks();
+  store_buffer_entries_ = 0;
+  root_slices_not_started_ = kNumRootSlices;
+  {
+    PromotionStack promotion_stack;
+    ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                          heap_->barrier_done());
+    // Used to coordinate draining among tasks; all start out as 'busy'.
+    RelaxedAtomic<uintptr_t> num_busy(num_tasks);
+    for (intptr_t i = 0; i < num_tasks; ++i) {
+      bool result = Dart::thread_pool()->Run<ParallelScavengerTask>(
+          this, isolate, from, &promotion_stack, &barrier, &num_busy);
+      ASSERT(result);
+    }
+    bool more_to_scavenge = false;
+    do {
+      // Wait for all tasks to stop.
+      barrier.Sync();
+#if defined(DEBUG)
+      ASSERT(num_busy.load() == 0);
+      // Caveat: must not allow any task to continue past the barrier
+      // before we checked num_busy, otherwise one of them might rush
+      // ahead and increment it.
+      barrier.Sync();
+#endif
+
+      // Wait for all tasks to go through weak properties and verify
+      // that there are no more objects to scavenge.
+      // Note: we need to have two barriers here because we want all tasks
+      // and main thread to make decisions in lock step.
+      barrier.Sync();
+      more_to_scavenge = num_busy.load() > 0;
+      barrier.Sync();
+    } while (more_to_scavenge);
+
+    // Phase 2: The tasks finalize their results before exiting. The barrier
+    // waits for all of them when it goes out of scope.
+    barrier.Exit();
+  }
+  ASSERT(pending_store_buffer_blocks_ == NULL);
+  int64_t end = OS::GetCurrentMonotonicMicros();
+
+  heap_->RecordData(kStoreBufferEntries, store_buffer_entries_);
+  heap_->RecordData(kDataUnused1, 0);
+  heap_->RecordData(kDataUnused2, 0);
+  heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
+  // Roots, the remembered set and the to space are processed together.
+  heap_->RecordTime(kVisitIsolateRoots, 0);
+  heap_->RecordTime(kIterateStoreBuffers, 0);
+  heap_->RecordTime(kProcessToSpace, end - start);
+  heap_->RecordTime(kDummyScavengeTime, 0);
+}
+
 bool Scavenger::IsUnreachable(RawObject** p) {
   RawObject* raw_obj = *p;
   if (!raw_obj->IsHeapObject()) {
@@ -693,12 +1354,18 @@ void Scavenger::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
   isolate->VisitWeakPersistentHandles(visitor);
 }
 
-void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
-  Thread* thread = Thread::Current();
-
-  // Iterate until all work has been drained.
-  while ((resolved_top_ < top_) || PromotedStackHasMore()) {
-    while (resolved_top_ < top_) {
+void Scavenger::ScanToSpace(SerialScavengerVisitor* visitor) {
+  // The serial scavenger only allocates into the last page, so the pages are
+  // scanned in order.
+  if (scan_page_ == NULL) {
+    scan_page_ = to_->head();
+    if (scan_page_ == NULL) {
+      return;
+    }
+    resolved_top_ = scan_page_->object_start();
+  }
+  while (true) {
+    while (resolved_top_ < scan_page_->top()) {
       RawObject* raw_obj = RawObject::FromAddr(resolved_top_);
       intptr_t class_id = raw_obj->GetClassId();
       intptr_t size;
@@ -710,27 +1377,28 @@ void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
       }
       resolved_top_ += size;
     }
-    {
-      // Visit all the promoted objects and update/scavenge their internal
-      // pointers. Potentially this adds more objects to the to space.
-      while (PromotedStackHasMore()) {
-        RawObject* raw_object = RawObject::FromAddr(PopFromPromotedStack());
-        // Resolve or copy all objects referred to by the current object. This
-        // can potentially push more objects on this stack as well as add more
-        // objects to be resolved in the to space.
-        ASSERT(!raw_object->IsRemembered());
-        visitor->VisitingOldObject(raw_object);
-        raw_object->VisitPointersNonvirtual(visitor);
-        if (raw_object->IsMarked()) {
-          // Complete our promise from ScavengePointer. Note that marker cannot
-          // visit this object until it pops a block from the mark stack, which
-          // involves a memory fence from the mutex, so even on architectures
-          // with a relaxed memory model, the marker will see the fully
-          // forwarded contents of this object.
-          thread->MarkingStackAddObject(raw_object);
-        }
-      }
-      visitor->VisitingOldObject(NULL);
+    if (scan_page_->next() == NULL) {
+      return;
+    }
+    scan_page_ = scan_page_->next();
+    resolved_top_ = scan_page_->object_start();
+  }
+}
+
+bool Scavenger::HasUnscannedObjects() const {
+  if (scan_page_ == NULL) {
+    return to_->head() != NULL;
+  }
+  return (scan_page_ != to_->tail()) || (resolved_top_ < scan_page_->top());
+}
+
+void Scavenger::ProcessToSpace(SerialScavengerVisitor* visitor) {
+  // Iterate until all work has been drained.
+  while (HasUnscannedObjects() || visitor->HasWork()) {
+    ScanToSpace(visitor);
+    // Visit all the promoted objects and update/scavenge their internal
+    // pointers. Potentially this adds more objects to the to space.
+    while (visitor->ProcessPromotedObjects()) {
     }
     {
       // Finished this round of scavenging. Process the pending weak properties
@@ -776,8 +1444,8 @@ void Scavenger::UpdateMaxHeapCapacity() {
   ASSERT(heap_ != NULL);
   Isolate* isolate = heap_->isolate();
   ASSERT(isolate != NULL);
-  isolate->GetHeapNewCapacityMaxMetric()->SetValue(to_->size_in_words() *
-                                                   kWordSize);
+  isolate->GetHeapNewCapacityMaxMetric()->SetValue(
+      to_->max_capacity_in_words() * kWordSize);
 #endif  // !defined(PRODUCT)
 }
 
@@ -810,7 +1478,7 @@ void Scavenger::EnqueueWeakProperty(RawWeakProperty* raw_weak) {
 }
 
 uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
-                                     ScavengerVisitor* visitor) {
+                                     SerialScavengerVisitor* visitor) {
   // The fate of the weak property is determined by its key.
   RawObject* raw_key = raw_weak->ptr()->key_;
   if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
@@ -827,8 +1495,9 @@ uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
 }
 
 void Scavenger::ProcessWeakReferences() {
-  auto rehash_weak_table = [](WeakTable* table, WeakTable* replacement_new,
-                              WeakTable* replacement_old) {
+  // Update the weak tables in place now that we know which objects survive
+  // this cycle.
+  auto rehash_weak_table = [](WeakTable* table, WeakTable* table_old) {
     intptr_t size = table->size();
     for (intptr_t i = 0; i < size; i++) {
       if (table->IsValidEntryAtExclusive(i)) {
@@ -840,28 +1509,22 @@ void Scavenger::ProcessWeakReferences() {
           // The object has survived.  Preserve its record.
           uword new_addr = ForwardedAddr(header);
           raw_obj = RawObject::FromAddr(new_addr);
-          auto replacement =
-              raw_obj->IsNewObject() ? replacement_new : replacement_old;
-          replacement->SetValueExclusive(raw_obj, table->ValueAtExclusive(i));
+          if (raw_obj->IsNewObject()) {
+            table->ForwardObjectAtExclusive(i, raw_obj);
+            continue;
+          }
+          table_old->SetValueExclusive(raw_obj, table->ValueAtExclusive(i));
         }
+        table->InvalidateAtExclusive(i);
       }
     }
+    table->RehashExclusive();
   };
 
-  // Rehash the weak tables now that we know which objects survive this cycle.
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
     const auto selector = static_cast<Heap::WeakSelector>(sel);
-    auto table = heap_->GetWeakTable(Heap::kNew, selector);
-    auto table_old = heap_->GetWeakTable(Heap::kOld, selector);
-
-    // Create a new weak table for the new-space.
-    auto table_new = WeakTable::NewFrom(table);
-    rehash_weak_table(table, table_new, table_old);
-    heap_->SetWeakTable(Heap::kNew, selector, table_new);
-
-    // Remove the old table as it has been replaced with the newly allocated
-    // table above.
-    delete table;
+    rehash_weak_table(heap_->GetWeakTable(Heap::kNew, selector),
+                      heap_->GetWeakTable(Heap::kOld, selector));
   }
 
   // Each isolate might have a weak table used for fast snapshot writing (i.e.
@@ -869,9 +1532,7 @@ void Scavenger::ProcessWeakReferences() {
   auto isolate = heap_->isolate();
   auto table = isolate->forward_table_new();
   if (table != NULL) {
-    auto replacement = WeakTable::NewFrom(table);
-    rehash_weak_table(table, replacement, isolate->forward_table_old());
-    isolate->set_forward_table_new(replacement);
+    rehash_weak_table(table, isolate->forward_table_old());
   }
 
   // The queued weak properties at this point do not refer to reachable keys,
@@ -901,31 +1562,6 @@ void Scavenger::ProcessWeakReferences() {
   }
 }
 
-void Scavenger::MakeNewSpaceIterable() const {
-  ASSERT(Thread::Current()->IsAtSafepoint() ||
-         (Thread::Current()->task_kind() == Thread::kMarkerTask) ||
-         (Thread::Current()->task_kind() == Thread::kCompactorTask));
-  Isolate* isolate = heap_->isolate();
-  MonitorLocker ml(isolate->threads_lock(), false);
-  Thread* current = heap_->isolate()->thread_registry()->active_list();
-  while (current != NULL) {
-    // NOTE: During the transition period all isolates within an isolate group
-    // share the thread registry, but have their own heap.
-    // So we explicitly filter those threads which belong to the isolate of
-    // interest (once we have a shared heap this needs to change).
-    if (current->isolate() == isolate) {
-      if (current->HasActiveTLAB()) {
-        heap_->MakeTLABIterable(current);
-      }
-    }
-    current = current->next();
-  }
-  Thread* mutator_thread = isolate->mutator_thread();
-  if (mutator_thread != NULL) {
-    heap_->MakeTLABIterable(mutator_thread);
-  }
-}
-
 void Scavenger::AbandonTLABs(Isolate* isolate) {
   ASSERT(Thread::Current()->IsAtSafepoint());
   MonitorLocker ml(isolate->threads_lock(), false);
@@ -946,78 +1582,97 @@ void Scavenger::AbandonTLABs(Isolate* isolate) {
   }
 }
 
+void Scavenger::AbandonRemainingTLAB(Thread* thread) {
+  if (!thread->HasActiveTLAB()) {
+    return;
+  }
+  // The TLAB always extends to the end of the page.
+  NewPage* page = NewPage::Of(thread->end() - 1);
+  MutexLocker ml(&space_lock_);
+  ASSERT(page->owner() == thread);
+  page->Release();
+}
+
+int64_t Scavenger::UsedInWords() const {
+  MutexLocker ml(&space_lock_);
+  int64_t used_in_words = 0;
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    const uword used_end = (page->owner() != NULL) ? page->end() : page->top();
+    used_in_words += (used_end - page->object_start()) >> kWordSizeLog2;
+  }
+  return used_in_words;
+}
+
 void Scavenger::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
   ASSERT(Thread::Current()->IsAtSafepoint() ||
          (Thread::Current()->task_kind() == Thread::kMarkerTask) ||
          (Thread::Current()->task_kind() == Thread::kCompactorTask));
-  MakeNewSpaceIterable();
-  uword cur = FirstObjectStart();
-  while (cur < top_) {
-    RawObject* raw_obj = RawObject::FromAddr(cur);
-    cur += raw_obj->VisitPointers(visitor);
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    page->VisitObjectPointers(visitor);
   }
 }
 
 void Scavenger::VisitObjects(ObjectVisitor* visitor) const {
   ASSERT(Thread::Current()->IsAtSafepoint() ||
          (Thread::Current()->task_kind() == Thread::kMarkerTask));
-  MakeNewSpaceIterable();
-  uword cur = FirstObjectStart();
-  while (cur < top_) {
-    RawObject* raw_obj = RawObject::FromAddr(cur);
-    visitor->VisitObject(raw_obj);
-    cur += raw_obj->HeapSize();
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    page->VisitObjects(visitor);
   }
 }
 
 void Scavenger::AddRegionsToObjectSet(ObjectSet* set) const {
-  set->AddRegion(to_->start(), to_->end());
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    set->AddRegion(page->start(), page->end());
+  }
 }
 
 RawObject* Scavenger::FindObject(FindObjectVisitor* visitor) const {
   ASSERT(!scavenging_);
-  MakeNewSpaceIterable();
-  uword cur = FirstObjectStart();
-  if (visitor->VisitRange(cur, top_)) {
-    while (cur < top_) {
-      RawObject* raw_obj = RawObject::FromAddr(cur);
-      uword next = cur + raw_obj->HeapSize();
-      if (visitor->VisitRange(cur, next) && raw_obj->FindObject(visitor)) {
-        return raw_obj;  // Found object, return it.
-      }
-      cur = next;
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    RawObject* raw_obj = page->FindObject(visitor);
+    if (raw_obj != Object::null()) {
+      return raw_obj;
     }
-    ASSERT(cur == top_);
   }
   return Object::null();
 }
 
-uword Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t size) {
-  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+uword Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
+  ASSERT(Utils::IsAligned(min_size, kObjectAlignment));
   ASSERT(heap_ != Dart::vm_isolate()->heap());
   ASSERT(!scavenging_);
   MutexLocker ml(&space_lock_);
-  uword result = top_;
-  intptr_t remaining = end_ - top_;
-  if (remaining < size) {
-    // Grab whatever is remaining
-    size = remaining;
-  } else {
-    // Reduce TLAB size so we land at even TLAB size for future TLABs.
-    intptr_t survived_size = UsedInWords() * kWordSize;
-    size -= survived_size % size;
+  // Prefer the rest of a page no other thread is using, such as the pages
+  // survivors were copied to, over growing the to space.
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    if ((page->owner() == NULL) &&
+        (static_cast<intptr_t>(page->end() - page->top()) >= min_size)) {
+      page->Acquire(thread);
+      return thread->top();
+    }
   }
-  size = Utils::RoundDown(size, kObjectAlignment);
-  if (size == 0) {
+  NewPage* page = to_->TryAllocatePage(false);
+  if (page == NULL) {
     return 0;
   }
-  ASSERT(to_->Contains(result));
-  ASSERT((result & kObjectAlignmentMask) == object_alignment_);
-  top_ += size;
-  ASSERT(to_->Contains(top_) || (top_ == to_->end()));
-  ASSERT(result < top_);
-  thread->set_top(result);
-  thread->set_end(top_);
+  if (early_tenure_) {
+    page->set_survivor_end(page->end());
+  }
+  page->Acquire(thread);
+  return thread->top();
+}
+
+uword Scavenger::AllocateGCInNewPage(intptr_t size) {
+  // The survivors must fit into the to space even if they exceed its
+  // capacity.
+  NewPage* page = to_->TryAllocatePage(true);
+  if (page == NULL) {
+    // TODO(koda): We could try to recover (collect old space, wait for another
+    // isolate to finish scavenge, etc.).
+    OUT_OF_MEMORY();
+  }
+  uword result = page->TryAllocateGC(size);
+  ASSERT(result != 0);
   return result;
 }
 
@@ -1055,21 +1710,37 @@ void Scavenger::Scavenge() {
 
   // Prepare for a scavenge.
   SpaceUsage usage_before = GetCurrentUsage();
-  intptr_t promo_candidate_words =
-      (survivor_end_ - FirstObjectStart()) / kWordSize;
   SemiSpace* from = Prologue(isolate);
+  intptr_t promo_candidate_words = 0;
+  for (NewPage* page = from->head(); page != NULL; page = page->next()) {
+    promo_candidate_words +=
+        (Utils::Minimum(page->survivor_end(), page->top()) -
+         page->object_start()) /
+        kWordSize;
+  }
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
   {
     StackZone zone(thread);
-    // Setup the visitor and run the scavenge.
-    ScavengerVisitor visitor(isolate, this, from);
-    page_space->AcquireDataLock();
-    IterateRoots(isolate, &visitor);
-    int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
-    {
-      TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessToSpace");
-      ProcessToSpace(&visitor);
+    const intptr_t num_tasks = FLAG_scavenger_tasks;
+    bytes_promoted_ = 0;
+    if (num_tasks == 0) {
+      // Setup the visitor and run the scavenge on the main thread.
+      PromotionStack promotion_stack;
+      SerialScavengerVisitor visitor(isolate, this, from, &promotion_stack);
+      page_space->AcquireDataLock();
+      IterateRoots(isolate, &visitor);
+      int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
+      {
+        TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessToSpace");
+        ProcessToSpace(&visitor);
+      }
+      heap_->RecordTime(kProcessToSpace,
+                        OS::GetCurrentMonotonicMicros() - iterate_roots);
+      visitor.Finalize();
+    } else {
+      // The tasks take the data lock whenever they need more old space.
+      ParallelScavenge(isolate, from, num_tasks);
     }
     int64_t process_to_space = OS::GetCurrentMonotonicMicros();
     {
@@ -1078,15 +1749,16 @@ void Scavenger::Scavenge() {
       IterateWeakRoots(isolate, &weak_visitor);
     }
     ProcessWeakReferences();
-    page_space->ReleaseDataLock();
+    if (num_tasks == 0) {
+      page_space->ReleaseDataLock();
+    }
 
     // Scavenge finished. Run accounting.
     int64_t end = OS::GetCurrentMonotonicMicros();
-    heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
     heap_->RecordTime(kIterateWeaks, end - process_to_space);
-    stats_history_.Add(ScavengeStats(
-        start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-        visitor.bytes_promoted() >> kWordSizeLog2));
+    stats_history_.Add(ScavengeStats(start, end, usage_before,
+                                     GetCurrentUsage(), promo_candidate_words,
+                                     bytes_promoted_ >> kWordSizeLog2));
   }
   Epilogue(isolate, from);
 
@@ -1157,8 +1829,11 @@ void Scavenger::Evacuate() {
   // causing the assertion below to fail.
   SafepointOperationScope scope(Thread::Current());
 
-  // Forces the next scavenge to promote all the objects in the new space.
-  survivor_end_ = top_;
+  // Forces the next scavenge to promote all the objects in the new space,
+  // including those in TLABs.
+  for (NewPage* page = to_->head(); page != NULL; page = page->next()) {
+    page->set_survivor_end(page->end());
+  }
 
   Scavenge();
 
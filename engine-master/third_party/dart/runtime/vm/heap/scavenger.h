@@ -10,6 +10,7 @@
 #include "vm/dart.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
+#include "vm/heap/pointer_block.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
 #include "vm/raw_object.h"
@@ -24,45 +25,154 @@ class Heap;
 class Isolate;
 class JSONObject;
 class ObjectSet;
-class ScavengerVisitor;
-
-// Wrapper around VirtualMemory that adds caching and handles the empty case.
-class SemiSpace {
+template <bool parallel>
+class ScavengerVisitorBase;
+typedef ScavengerVisitorBase<false> SerialScavengerVisitor;
+typedef ScavengerVisitorBase<true> ParallelScavengerVisitor;
+
+static const intptr_t kNewPageSize = 512 * KB;
+static const intptr_t kNewPageSizeInWords = kNewPageSize / kWordSize;
+static const intptr_t kNewPageMask = ~(kNewPageSize - 1);
+
+// A page of the new generation. Pages are aligned to their size, so the page
+// of a new object can be found from its address. The scavenger allocates
+// into pages that are not owned by a thread, while an owned page provides
+// the TLAB of its owner.
+class NewPage {
  public:
   static void Init();
   static void Cleanup();
 
-  // Get a space of the given size. Returns NULL on out of memory. If size is 0,
-  // returns an empty space: pointer(), start() and end() all return NULL.
-  // The name parameter may be NULL. If non-NULL it is ued to give the OS a name
-  // for the underlying virtual memory region.
-  static SemiSpace* New(intptr_t size_in_words, const char* name);
+  // Returns NULL on OOM.
+  static NewPage* Allocate();
+
+  // Returns the memory of this page to the cache of free pages, or to the OS
+  // if the cache is full. The page becomes inaccessible.
+  void Deallocate();
+
+  // Returns the cached free pages to the OS until at most |max_pages| are
+  // left.
+  static void TrimCache(intptr_t max_pages);
+  static intptr_t CachedPages();
+
+  NewPage* next() const { return next_; }
+  void set_next(NewPage* next) { next_ = next; }
+
+  uword start() const { return memory_->start(); }
+  uword end() const { return memory_->end(); }
+  bool Contains(uword addr) const { return memory_->Contains(addr); }
+
+  uword object_start() const { return start() + ObjectStartOffset(); }
+  // The owner's top is only stable while the owner is at a safepoint.
+  uword object_end() const { return owner_ != NULL ? owner_->top() : top_; }
+
+  uword top() const { return top_; }
+  void set_top(uword value) {
+    ASSERT(owner_ == NULL);
+    ASSERT((value >= object_start()) && (value <= end()));
+    top_ = value;
+  }
+
+  Thread* owner() const { return owner_; }
+
+  // Hands the unused rest of this page to |thread| as its TLAB.
+  void Acquire(Thread* thread) {
+    ASSERT(owner_ == NULL);
+    ASSERT(!thread->HasActiveTLAB());
+    owner_ = thread;
+    thread->set_top(top_);
+    thread->set_end(end());
+  }
 
-  // Hand back an unused space.
-  void Delete();
+  // Takes the TLAB back from the owner of this page.
+  void Release() {
+    ASSERT(owner_ != NULL);
+    top_ = owner_->top();
+    owner_->set_top(0);
+    owner_->set_end(0);
+    owner_ = NULL;
+  }
 
-  void* pointer() const { return region_.pointer(); }
-  uword start() const { return region_.start(); }
-  uword end() const { return region_.end(); }
-  intptr_t size_in_words() const {
-    return static_cast<intptr_t>(region_.size()) >> kWordSizeLog2;
+  uword TryAllocateGC(intptr_t size) {
+    ASSERT(owner_ == NULL);
+    uword result = top_;
+    if (static_cast<intptr_t>(end() - result) < size) {
+      return 0;
+    }
+    top_ = result + size;
+    return result;
   }
-  bool Contains(uword address) const { return region_.Contains(address); }
 
-  // Set write protection mode for this space. The space must not be protected
-  // when Delete is called.
-  // TODO(koda): Remember protection mode in VirtualMemory and assert this.
+  // Objects below this address have survived a scavenge.
+  bool IsSurvivor(uword raw_addr) const { return raw_addr < survivor_end_; }
+  uword survivor_end() const { return survivor_end_; }
+  void set_survivor_end(uword value) { survivor_end_ = value; }
+
+  void VisitObjects(ObjectVisitor* visitor) const;
+  void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
+
+  RawObject* FindObject(FindObjectVisitor* visitor) const;
+
   void WriteProtect(bool read_only);
 
+  static intptr_t ObjectStartOffset() {
+    return Utils::RoundUp(sizeof(NewPage), kObjectAlignment) +
+           kNewObjectAlignmentOffset;
+  }
+
+  static NewPage* Of(RawObject* obj) {
+    ASSERT(obj->IsHeapObject());
+    ASSERT(obj->IsNewObject());
+    return Of(RawObject::ToAddr(obj));
+  }
+
+  static NewPage* Of(uword addr) {
+    return reinterpret_cast<NewPage*>(addr & kNewPageMask);
+  }
+
  private:
-  explicit SemiSpace(VirtualMemory* reserved);
+  VirtualMemory* memory_;
+  NewPage* next_;
+  // The thread using the rest of this page as its TLAB, if any.
+  Thread* owner_;
+  uword top_;
+  uword survivor_end_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(NewPage);
+};
+
+// A list of new pages. The to space grows by a page at a time as the
+// mutator allocates, up to its maximum capacity.
+class SemiSpace {
+ public:
+  explicit SemiSpace(intptr_t max_capacity_in_words);
+  // Deallocates all pages.
   ~SemiSpace();
 
-  VirtualMemory* reserved_;  // NULL for an empty space.
-  MemoryRegion region_;
+  // Adds a page to this space. Fails if that would exceed the maximum
+  // capacity, unless |grow_beyond_capacity| is set, or on OOM. The caller
+  // must prevent concurrent modifications of the page list.
+  NewPage* TryAllocatePage(bool grow_beyond_capacity);
+
+  bool Contains(uword addr) const;
+
+  NewPage* head() const { return head_; }
+  NewPage* tail() const { return tail_; }
+
+  intptr_t capacity_in_words() const { return capacity_in_words_; }
+  intptr_t max_capacity_in_words() const { return max_capacity_in_words_; }
 
-  static SemiSpace* cache_;
-  static Mutex* mutex_;
+  void WriteProtect(bool read_only);
+
+ private:
+  // The size of the allocated pages.
+  intptr_t capacity_in_words_;
+  intptr_t max_capacity_in_words_;
+  NewPage* head_;
+  NewPage* tail_;
+
+  DISALLOW_COPY_AND_ASSIGN(SemiSpace);
 };
 
 // Statistics for a particular scavenge.
@@ -127,22 +237,21 @@ class Scavenger {
 
   RawObject* FindObject(FindObjectVisitor* visitor) const;
 
-  uword TryAllocateNewTLAB(Thread* thread, intptr_t size);
+  // Hands a page with at least |min_size| bytes left to |thread| as its TLAB.
+  // Returns 0 if the to space has reached its capacity.
+  uword TryAllocateNewTLAB(Thread* thread, intptr_t min_size);
+  void AbandonRemainingTLAB(Thread* thread);
 
   uword AllocateGC(intptr_t size) {
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
     ASSERT(heap_ != Dart::vm_isolate()->heap());
     ASSERT(scavenging_);
-    uword result = top_;
-    intptr_t remaining = end_ - top_;
-
-    // This allocation happens only in GC and only when copying objects to
-    // the new to_ space. It must succeed.
-    ASSERT(size <= remaining);
-    ASSERT(to_->Contains(result));
+    NewPage* page = to_->tail();
+    uword result = (page != NULL) ? page->TryAllocateGC(size) : 0;
+    if (result == 0) {
+      result = AllocateGCInNewPage(size);
+    }
     ASSERT((result & kObjectAlignmentMask) == object_alignment_);
-    top_ += size;
-    ASSERT((to_->Contains(top_)) || (top_ == to_->end()));
     return result;
   }
 
@@ -156,10 +265,9 @@ class Scavenger {
     if (remaining < size) {
       return 0;
     }
-    ASSERT(to_->Contains(result));
+    ASSERT(NewPage::Of(result)->owner() == thread);
     ASSERT((result & kObjectAlignmentMask) == object_alignment_);
     top += size;
-    ASSERT((to_->Contains(top)) || (top == to_->end()));
     thread->set_top(top);
     return result;
   }
@@ -170,19 +278,9 @@ class Scavenger {
   // Promote all live objects.
   void Evacuate();
 
-  uword top() { return top_; }
-  uword end() { return end_; }
-
-  void set_top(uword value) { top_ = value; }
-  void set_end(uword value) {
-    ASSERT(to_->end() == value);
-    end_ = value;
-  }
-
-  int64_t UsedInWords() const {
-    return (top_ - FirstObjectStart()) >> kWordSizeLog2;
-  }
-  int64_t CapacityInWords() const { return to_->size_in_words(); }
+  // The TLABs of threads count as used in full.
+  int64_t UsedInWords() const;
+  int64_t CapacityInWords() const { return to_->max_capacity_in_words(); }
   int64_t ExternalInWords() const { return external_size_ >> kWordSizeLog2; }
   SpaceUsage GetCurrentUsage() const {
     SpaceUsage usage;
@@ -216,7 +314,6 @@ class Scavenger {
   void AllocateExternal(intptr_t cid, intptr_t size);
   void FreeExternal(intptr_t size);
 
-  void MakeNewSpaceIterable() const;
   int64_t FreeSpaceInWords(Isolate* isolate) const;
   void AbandonTLABs(Isolate* isolate);
 
@@ -237,44 +334,27 @@ class Scavenger {
     kToKBAfterStoreBuffer = 3
   };
 
-  uword FirstObjectStart() const { return to_->start() | object_alignment_; }
+  uword AllocateGCInNewPage(intptr_t size);
   SemiSpace* Prologue(Isolate* isolate);
-  void IterateStoreBuffers(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateObjectIdTable(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateRoots(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakProperties(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakReferences(Isolate* isolate, ScavengerVisitor* visitor);
+  void IterateStoreBuffers(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateObjectIdTable(Isolate* isolate, ObjectPointerVisitor* visitor);
+  void IterateRoots(Isolate* isolate, SerialScavengerVisitor* visitor);
+  // Called by each task of a parallel scavenge to claim a share of the roots.
+  void IterateRoots(Isolate* isolate, ParallelScavengerVisitor* visitor);
   void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
-  void ProcessToSpace(ScavengerVisitor* visitor);
+  void ProcessToSpace(SerialScavengerVisitor* visitor);
+  void ScanToSpace(SerialScavengerVisitor* visitor);
+  bool HasUnscannedObjects() const;
+  // Scavenges the roots and the to space with FLAG_scavenger_tasks helper
+  // tasks.
+  void ParallelScavenge(Isolate* isolate, SemiSpace* from, intptr_t num_tasks);
   void EnqueueWeakProperty(RawWeakProperty* raw_weak);
   uword ProcessWeakProperty(RawWeakProperty* raw_weak,
-                            ScavengerVisitor* visitor);
+                            SerialScavengerVisitor* visitor);
   void Epilogue(Isolate* isolate, SemiSpace* from);
 
   bool IsUnreachable(RawObject** p);
 
-  // During a scavenge we need to remember the promoted objects.
-  // This is implemented as a stack of objects at the end of the to space. As
-  // object sizes are always greater than sizeof(uword) and promoted objects do
-  // not consume space in the to space they leave enough room for this stack.
-  void PushToPromotedStack(uword addr) {
-    ASSERT(scavenging_);
-    end_ -= sizeof(addr);
-    ASSERT(end_ > top_);
-    *reinterpret_cast<uword*>(end_) = addr;
-  }
-  uword PopFromPromotedStack() {
-    ASSERT(scavenging_);
-    uword result = *reinterpret_cast<uword*>(end_);
-    end_ += sizeof(result);
-    ASSERT(end_ <= to_->end());
-    return result;
-  }
-  bool PromotedStackHasMore() const {
-    ASSERT(scavenging_);
-    return end_ < to_->end();
-  }
-
   void UpdateMaxHeapCapacity();
   void UpdateMaxHeapUsage();
 
@@ -282,21 +362,21 @@ class Scavenger {
 
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
 
-  uword top_;
-  uword end_;
-
   SemiSpace* to_;
 
   Heap* heap_;
 
-  // A pointer to the first unscanned object.  Scanning completes when
-  // this value meets the allocation top.
+  // The page and address of the first object not yet scanned by the serial
+  // scavenger. Scanning completes when they meet the allocation top.
+  NewPage* scan_page_;
   uword resolved_top_;
 
-  // Objects below this address have survived a scavenge.
-  uword survivor_end_;
+  // Whether all objects that survive the next scavenge are promoted.
+  bool early_tenure_;
 
   intptr_t max_semi_capacity_in_words_;
+  // The new space does not shrink below its initial capacity.
+  intptr_t initial_semi_capacity_in_words_;
 
   // All object are aligned to this value.
   uword object_alignment_;
@@ -318,13 +398,25 @@ class Scavenger {
   // The total size of external data associated with objects in this scavenger.
   intptr_t external_size_;
 
-  bool failed_to_promote_;
+  RelaxedAtomic<bool> failed_to_promote_;
+
+  // Protects the pages of the to space and their owners during the allocation
+  // of new TLABs and of the copy pages of parallel scavenger tasks.
+  mutable Mutex space_lock_;
 
-  // Protects new space during the allocation of new TLABs
-  Mutex space_lock_;
+  // State shared by the tasks of a parallel scavenge.
+  RelaxedAtomic<intptr_t> root_slices_not_started_;
+  RelaxedAtomic<intptr_t> store_buffer_entries_;
+  // Protects the store buffer blocks not yet claimed by a task and the
+  // results handed over by the tasks.
+  Mutex work_lock_;
+  StoreBufferBlock* pending_store_buffer_blocks_;
+  intptr_t bytes_promoted_;
 
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
+  friend class ParallelScavengerTask;
 
   DISALLOW_COPY_AND_ASSIGN(Scavenger);
 };
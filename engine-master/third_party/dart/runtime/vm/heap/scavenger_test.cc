@@ -4,6 +4,8 @@
 
 #include "vm/heap/scavenger.h"
 #include "platform/assert.h"
+#include "vm/heap/heap.h"
+#include "vm/object.h"
 #include "vm/unit_test.h"
 #include "vm/visitor.h"
 
@@ -35,4 +37,127 @@ class FailingFindObjectVisitor : public FindObjectVisitor {
   }
 };
 
+// Allocates a chain of new-space arrays, each holding its index and its
+// predecessor. The arrays are remembered in |roots|, an old-space array, so
+// they are reached through the store buffer.
+static void AllocateArrayChain(const Array& roots) {
+  Array& array = Array::Handle();
+  Array& previous = Array::Handle();
+  for (intptr_t i = 0; i < roots.Length(); i++) {
+    array = Array::New(2, Heap::kNew);
+    array.SetAt(0, Smi::Handle(Smi::New(i)));
+    array.SetAt(1, previous);
+    roots.SetAt(i, array);
+    previous = array.raw();
+  }
+}
+
+static void ExpectArrayChain(const Array& roots) {
+  Array& array = Array::Handle();
+  for (intptr_t i = 0; i < roots.Length(); i++) {
+    array ^= roots.At(i);
+    EXPECT_EQ(Smi::New(i), array.At(0));
+    EXPECT_EQ(i == 0 ? Object::null() : roots.At(i - 1), array.At(1));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(ParallelScavenge_PreservesObjects) {
+  SetFlagScope<int> sfs(&FLAG_scavenger_tasks, 4);
+  Heap* heap = thread->heap();
+  GCTestHelper::CollectNewSpace();
+
+  const intptr_t kLength = 10000;
+  const Array& roots = Array::Handle(Array::New(kLength, Heap::kOld));
+  AllocateArrayChain(roots);
+
+  const Smi& value = Smi::Handle(Smi::New(42));
+  const WeakProperty& live_weak =
+      WeakProperty::Handle(WeakProperty::New(Heap::kNew));
+  live_weak.set_key(Object::Handle(roots.At(kLength - 1)));
+  live_weak.set_value(value);
+  const WeakProperty& dead_weak =
+      WeakProperty::Handle(WeakProperty::New(Heap::kNew));
+  {
+    HANDLESCOPE(thread);
+    dead_weak.set_key(Array::Handle(Array::New(1, Heap::kNew)));
+    dead_weak.set_value(value);
+  }
+
+  // The first scavenge copies the objects within new space, the second one
+  // promotes them.
+  GCTestHelper::CollectNewSpace();
+  EXPECT(Object::Handle(roots.At(0)).IsNew());
+  ExpectArrayChain(roots);
+  GCTestHelper::CollectNewSpace();
+  EXPECT(Object::Handle(roots.At(0)).IsOld());
+  ExpectArrayChain(roots);
+
+  EXPECT_EQ(roots.At(kLength - 1), live_weak.key());
+  EXPECT_EQ(value.raw(), live_weak.value());
+  EXPECT_EQ(Object::null(), dead_weak.key());
+  EXPECT_EQ(Object::null(), dead_weak.value());
+  EXPECT(heap->Verify());
+}
+
+ISOLATE_UNIT_TEST_CASE(NewPages_MutatorContinuesInSurvivorPage) {
+  GCTestHelper::CollectNewSpace();
+  const Array& survivor = Array::Handle(Array::New(1, Heap::kNew));
+  uword addr = RawObject::ToAddr(survivor.raw());
+  EXPECT(NewPage::Of(survivor.raw())->Contains(addr));
+  // The mutator allocates into the page it owns.
+  EXPECT_EQ(thread, NewPage::Of(survivor.raw())->owner());
+
+  GCTestHelper::CollectNewSpace();
+  EXPECT(survivor.IsNew());
+  addr = RawObject::ToAddr(survivor.raw());
+  NewPage* page = NewPage::Of(survivor.raw());
+  EXPECT(page->IsSurvivor(addr));
+  EXPECT(page->owner() == NULL);
+
+  // Instead of growing the new space, the mutator continues in the rest of
+  // the page the survivor was copied to.
+  const Array& next = Array::Handle(Array::New(1, Heap::kNew));
+  EXPECT_EQ(page, NewPage::Of(next.raw()));
+  EXPECT_EQ(thread, page->owner());
+  EXPECT(RawObject::ToAddr(next.raw()) > addr);
+}
+
+ISOLATE_UNIT_TEST_CASE(NewPages_ReleasedOnLowMemory) {
+  Heap* heap = thread->heap();
+  {
+    HANDLESCOPE(thread);
+    const Array& roots = Array::Handle(Array::New(10000, Heap::kOld));
+    AllocateArrayChain(roots);
+  }
+  // The pages of the from space are cached for the next scavenge.
+  GCTestHelper::CollectNewSpace();
+  EXPECT(NewPage::CachedPages() > 0);
+
+  heap->NotifyLowMemory();
+  EXPECT_EQ(0, NewPage::CachedPages());
+  EXPECT(heap->Verify());
+}
+
+ISOLATE_UNIT_TEST_CASE(NewSpace_ShrinksAfterLowSurvival) {
+  Scavenger* new_space = thread->heap()->new_space();
+  const int64_t initial_capacity = Utils::RoundUp(
+      FLAG_new_gen_semi_initial_size * MBInWords, kNewPageSizeInWords);
+  {
+    HANDLESCOPE(thread);
+    // Survivors filling much of the new space make it grow.
+    const Array& roots = Array::Handle(Array::New(30000, Heap::kOld));
+    AllocateArrayChain(roots);
+    GCTestHelper::CollectNewSpace();
+    GCTestHelper::CollectNewSpace();
+    EXPECT_LT(initial_capacity, new_space->CapacityInWords());
+  }
+  // Once the chain is dead, scavenges in which nothing survives shrink it
+  // back. The old-space roots would keep the chain alive until marked.
+  GCTestHelper::CollectAllGarbage();
+  for (intptr_t i = 0; i < 10; i++) {
+    GCTestHelper::CollectNewSpace();
+  }
+  EXPECT_EQ(initial_capacity, new_space->CapacityInWords());
+}
+
 }  // namespace dart
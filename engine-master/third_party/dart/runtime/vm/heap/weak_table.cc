@@ -29,7 +29,9 @@ intptr_t WeakTable::SizeFor(intptr_t count, intptr_t size) {
   return result;
 }
 
-void WeakTable::SetValueExclusive(RawObject* key, intptr_t val) {
+void WeakTable::SetValueLocked(RawObject* key,
+                               intptr_t val,
+                               bool reuse_deleted) {
   intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
   intptr_t empty_idx = -1;
@@ -39,8 +41,10 @@ void WeakTable::SetValueExclusive(RawObject* key, intptr_t val) {
     if (obj == key) {
       SetValueAt(idx, val);
       return;
-    } else if ((empty_idx < 0) &&
+    } else if (reuse_deleted && (empty_idx < 0) &&
                (reinterpret_cast<intptr_t>(obj) == kDeletedEntry)) {
+      // A concurrent lookup could still be reading the value of the deleted
+      // entry, so slots are only reused with exclusive access.
       empty_idx = idx;  // Insert at this location if not found.
     }
     idx = (idx + 1) & mask;
@@ -61,9 +65,9 @@ void WeakTable::SetValueExclusive(RawObject* key, intptr_t val) {
   }
 
   ASSERT(!IsValidEntryAtExclusive(idx));
-  // Set the key and value.
-  SetObjectAt(idx, key);
+  // Set the value and then the key, which publishes the entry.
   SetValueAt(idx, val);
+  SetObjectAt(idx, key);
   // Update the counts.
   set_used(used() + 1);
   set_count(count() + 1);
@@ -75,34 +79,52 @@ void WeakTable::SetValueExclusive(RawObject* key, intptr_t val) {
 }
 
 void WeakTable::Reset() {
-  intptr_t* old_data = data_;
+  MutexLocker ml(&mutex_);
+  old_data_.Add(data());
   used_ = 0;
   count_ = 0;
-  size_ = kMinSize;
-  free(old_data);
-  data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
+  data_.store(AllocateData(kMinSize), std::memory_order_release);
 }
 
 void WeakTable::Forward(ObjectPointerVisitor* visitor) {
   if (used_ == 0) return;
 
-  for (intptr_t i = 0; i < size_; i++) {
+  const intptr_t size = this->size();
+  for (intptr_t i = 0; i < size; i++) {
     if (IsValidEntryAtExclusive(i)) {
       visitor->VisitPointer(ObjectPointerAt(i));
     }
   }
 
-  Rehash();
+  RehashExclusive();
+}
+
+void WeakTable::RehashExclusive() {
+  if ((count() == 0) && (size() == kMinSize)) {
+    // Most tables are empty, so avoid allocating a new backing store for them.
+    if (used_ > 0) {
+      memset(data(), 0, kMinSize * kEntrySize * kWordSize);
+      used_ = 0;
+    }
+  } else {
+    Rehash();
+  }
+  FreeOldDataExclusive();
+}
+
+void WeakTable::FreeOldDataExclusive() {
+  while (old_data_.length() > 0) {
+    FreeData(old_data_.RemoveLast());
+  }
 }
 
 void WeakTable::Rehash() {
   intptr_t old_size = size();
-  intptr_t* old_data = data_;
+  intptr_t* old_data = data();
 
   intptr_t new_size = SizeFor(count(), size());
   ASSERT(Utils::IsPowerOfTwo(new_size));
-  intptr_t* new_data =
-      reinterpret_cast<intptr_t*>(calloc(new_size, kEntrySize * kWordSize));
+  intptr_t* new_data = AllocateData(new_size);
 
   intptr_t mask = new_size - 1;
   set_used(0);
@@ -126,10 +148,10 @@ void WeakTable::Rehash() {
   // We should only have used valid entries.
   ASSERT(used() == count());
 
-  // Switch to using the newly allocated backing store.
-  size_ = new_size;
-  data_ = new_data;
-  free(old_data);
+  // Switch to using the newly allocated backing store. Concurrent lookups may
+  // still be reading the old one.
+  data_.store(new_data, std::memory_order_release);
+  old_data_.Add(old_data);
 }
 
 }  // namespace dart
@@ -5,9 +5,12 @@
 #ifndef RUNTIME_VM_HEAP_WEAK_TABLE_H_
 #define RUNTIME_VM_HEAP_WEAK_TABLE_H_
 
+#include <atomic>
+
 #include "vm/globals.h"
 
 #include "platform/assert.h"
+#include "platform/growable_array.h"
 #include "vm/lockers.h"
 #include "vm/raw_object.h"
 
@@ -15,10 +18,7 @@ namespace dart {
 
 class WeakTable {
  public:
-  WeakTable() : size_(kMinSize), used_(0), count_(0) {
-    ASSERT(Utils::IsPowerOfTwo(size_));
-    data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
-  }
+  WeakTable() : WeakTable(kMinSize) {}
   explicit WeakTable(intptr_t size) : used_(0), count_(0) {
     ASSERT(size >= 0);
     ASSERT(Utils::IsPowerOfTwo(kMinSize));
@@ -32,33 +32,47 @@ class WeakTable {
     if (size > kMaxSize) {
       size = kMaxSize;
     }
-    size_ = size;
-    ASSERT(Utils::IsPowerOfTwo(size_));
-    data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
+    ASSERT(Utils::IsPowerOfTwo(size));
+    data_ = AllocateData(size);
   }
 
-  ~WeakTable() { free(data_); }
-
-  static WeakTable* NewFrom(WeakTable* original) {
-    return new WeakTable(SizeFor(original->count(), original->size()));
+  ~WeakTable() {
+    FreeData(data());
+    FreeOldDataExclusive();
   }
 
-  intptr_t size() const { return size_; }
+  intptr_t size() const { return SizeOf(data()); }
   intptr_t used() const { return used_; }
   intptr_t count() const { return count_; }
 
-  // The following methods can be called concurrently and are guarded by a lock.
+  // The following methods can be called concurrently. Lookups do not take a
+  // lock: entries are only published after their value has been written, and
+  // a concurrent update never reuses the slot of a deleted entry. A backing
+  // store that is replaced while there might be concurrent readers is kept
+  // alive until FreeOldDataExclusive is called.
 
-  intptr_t GetValue(RawObject* key) {
-    MutexLocker ml(&mutex_);
-    return GetValueExclusive(key);
+  intptr_t GetValue(RawObject* key) const {
+    const intptr_t* data = data_.load(std::memory_order_acquire);
+    const intptr_t mask = SizeOf(data) - 1;
+    intptr_t idx = Hash(key) & mask;
+    RawObject* obj = LoadObjectAt(data, idx);
+    while (obj != NULL) {
+      if (obj == key) {
+        return LoadValueAt(data, idx);
+      }
+      idx = (idx + 1) & mask;
+      obj = LoadObjectAt(data, idx);
+    }
+    return 0;
   }
 
   void SetValue(RawObject* key, intptr_t val) {
     MutexLocker ml(&mutex_);
-    return SetValueExclusive(key, val);
+    SetValueLocked(key, val, /*reuse_deleted=*/false);
   }
 
+  void Reset();
+
   // The following "exclusive" methods must only be called from call sites
   // which are known to have exclusive access to the weak table.
   //
@@ -67,10 +81,10 @@ class WeakTable {
   bool IsValidEntryAtExclusive(intptr_t i) const {
     ASSERT((ValueAtExclusive(i) == 0 &&
             (ObjectAtExclusive(i) == NULL ||
-             data_[ObjectIndex(i)] == kDeletedEntry)) ||
+             data()[ObjectIndex(i)] == kDeletedEntry)) ||
            (ValueAtExclusive(i) != 0 && ObjectAtExclusive(i) != NULL &&
-            data_[ObjectIndex(i)] != kDeletedEntry));
-    return (data_[ValueIndex(i)] != 0);
+            data()[ObjectIndex(i)] != kDeletedEntry));
+    return (data()[ValueIndex(i)] != 0);
   }
 
   void InvalidateAtExclusive(intptr_t i) {
@@ -81,16 +95,25 @@ class WeakTable {
   RawObject* ObjectAtExclusive(intptr_t i) const {
     ASSERT(i >= 0);
     ASSERT(i < size());
-    return reinterpret_cast<RawObject*>(data_[ObjectIndex(i)]);
+    return reinterpret_cast<RawObject*>(data()[ObjectIndex(i)]);
   }
 
   intptr_t ValueAtExclusive(intptr_t i) const {
     ASSERT(i >= 0);
     ASSERT(i < size());
-    return data_[ValueIndex(i)];
+    return data()[ValueIndex(i)];
+  }
+
+  // Replaces the key of a valid entry with the new location of the object.
+  // The table must be rehashed before it is used again.
+  void ForwardObjectAtExclusive(intptr_t i, RawObject* key) {
+    ASSERT(IsValidEntryAtExclusive(i));
+    SetObjectAt(i, key);
   }
 
-  void SetValueExclusive(RawObject* key, intptr_t val);
+  void SetValueExclusive(RawObject* key, intptr_t val) {
+    SetValueLocked(key, val, /*reuse_deleted=*/true);
+  }
 
   intptr_t GetValueExclusive(RawObject* key) const {
     intptr_t mask = size() - 1;
@@ -128,7 +151,13 @@ class WeakTable {
 
   void Forward(ObjectPointerVisitor* visitor);
 
-  void Reset();
+  // Drops the deleted entries and moves the valid ones to their hash location
+  // in a backing store sized for the current count.
+  void RehashExclusive();
+
+  // Frees the backing stores that were replaced while there might have been
+  // concurrent readers.
+  void FreeOldDataExclusive();
 
  private:
   enum {
@@ -147,7 +176,20 @@ class WeakTable {
   }
   intptr_t limit() const { return LimitFor(size()); }
 
-  intptr_t index(intptr_t i) const { return i * kEntrySize; }
+  // A backing store holds its size in the word preceding the entries, so that
+  // lock-free readers always see a consistent size and data.
+  static intptr_t* AllocateData(intptr_t size) {
+    intptr_t* block = reinterpret_cast<intptr_t*>(
+        calloc(1 + size * kEntrySize, kWordSize));
+    block[0] = size;
+    return block + 1;
+  }
+  static void FreeData(intptr_t* data) { free(data - 1); }
+  static intptr_t SizeOf(const intptr_t* data) { return data[-1]; }
+
+  intptr_t* data() const { return data_.load(std::memory_order_relaxed); }
+
+  static intptr_t index(intptr_t i) { return i * kEntrySize; }
 
   void set_used(intptr_t val) {
     ASSERT(val <= limit());
@@ -160,20 +202,33 @@ class WeakTable {
     count_ = val;
   }
 
-  intptr_t ObjectIndex(intptr_t i) const { return index(i) + kObjectOffset; }
+  static intptr_t ObjectIndex(intptr_t i) { return index(i) + kObjectOffset; }
+
+  static intptr_t ValueIndex(intptr_t i) { return index(i) + kValueOffset; }
 
-  intptr_t ValueIndex(intptr_t i) const { return index(i) + kValueOffset; }
+  static RawObject* LoadObjectAt(const intptr_t* data, intptr_t i) {
+    return reinterpret_cast<RawObject*>(
+        reinterpret_cast<const std::atomic<intptr_t>*>(&data[ObjectIndex(i)])
+            ->load(std::memory_order_acquire));
+  }
+
+  static intptr_t LoadValueAt(const intptr_t* data, intptr_t i) {
+    return reinterpret_cast<const std::atomic<intptr_t>*>(&data[ValueIndex(i)])
+        ->load(std::memory_order_relaxed);
+  }
 
   RawObject** ObjectPointerAt(intptr_t i) const {
     ASSERT(i >= 0);
     ASSERT(i < size());
-    return reinterpret_cast<RawObject**>(&data_[ObjectIndex(i)]);
+    return reinterpret_cast<RawObject**>(&data()[ObjectIndex(i)]);
   }
 
   void SetObjectAt(intptr_t i, RawObject* key) {
     ASSERT(i >= 0);
     ASSERT(i < size());
-    data_[ObjectIndex(i)] = reinterpret_cast<intptr_t>(key);
+    // Publishes the value of a new entry to lock-free readers.
+    reinterpret_cast<std::atomic<intptr_t>*>(&data()[ObjectIndex(i)])
+        ->store(reinterpret_cast<intptr_t>(key), std::memory_order_release);
   }
 
   void SetValueAt(intptr_t i, intptr_t val) {
@@ -181,12 +236,15 @@ class WeakTable {
     ASSERT(i < size());
     // Setting a value of 0 is equivalent to invalidating the entry.
     if (val == 0) {
-      data_[ObjectIndex(i)] = kDeletedEntry;
+      SetObjectAt(i, reinterpret_cast<RawObject*>(kDeletedEntry));
       set_count(count() - 1);
     }
-    data_[ValueIndex(i)] = val;
+    reinterpret_cast<std::atomic<intptr_t>*>(&data()[ValueIndex(i)])
+        ->store(val, std::memory_order_relaxed);
   }
 
+  void SetValueLocked(RawObject* key, intptr_t val, bool reuse_deleted);
+
   void Rehash();
 
   static intptr_t Hash(RawObject* key) {
@@ -195,15 +253,17 @@ class WeakTable {
 
   Mutex mutex_;
 
-  // data_ contains size_ tuples of key/value.
-  intptr_t* data_;
-  // size_ keeps the number of entries in data_. used_ maintains the number of
+  // data_ contains size() tuples of key/value. It is only replaced with the
+  // mutex held or with exclusive access. used_ maintains the number of
   // non-NULL entries and will trigger rehashing if needed. count_ stores the
-  // number valid entries, and will determine the size_ after rehashing.
-  intptr_t size_;
+  // number valid entries, and will determine the size() after rehashing.
+  std::atomic<intptr_t*> data_;
   intptr_t used_;
   intptr_t count_;
 
+  // Backing stores that might still be read by concurrent lookups.
+  MallocGrowableArray<intptr_t*> old_data_;
+
   DISALLOW_COPY_AND_ASSIGN(WeakTable);
 };
 
@@ -0,0 +1,124 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/assert.h"
+#include "vm/dart.h"
+#include "vm/heap/weak_table.h"
+#include "vm/lockers.h"
+#include "vm/thread_pool.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+// The table never dereferences its keys.
+static RawObject* Key(intptr_t i) {
+  return reinterpret_cast<RawObject*>((i + 1) * kObjectAlignment +
+                                      kHeapObjectTag);
+}
+
+VM_UNIT_TEST_CASE(WeakTable_SetGetRemove) {
+  WeakTable table;
+  const intptr_t kNumKeys = 1000;
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    table.SetValue(Key(i), i + 1);
+  }
+  EXPECT_EQ(kNumKeys, table.count());
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    EXPECT_EQ(i + 1, table.GetValue(Key(i)));
+  }
+  EXPECT_EQ(0, table.GetValue(Key(kNumKeys)));
+
+  // Deleted entries are only reused with exclusive access.
+  table.SetValue(Key(0), 0);
+  EXPECT_EQ(0, table.GetValue(Key(0)));
+  EXPECT_EQ(kNumKeys - 1, table.count());
+  EXPECT_EQ(kNumKeys, table.used());
+  table.SetValue(Key(0), 42);
+  EXPECT_EQ(42, table.GetValue(Key(0)));
+  EXPECT_EQ(kNumKeys + 1, table.used());
+
+  EXPECT_EQ(42, table.RemoveValueExclusive(Key(0)));
+  table.RehashExclusive();
+  EXPECT_EQ(kNumKeys - 1, table.count());
+  EXPECT_EQ(kNumKeys - 1, table.used());
+  EXPECT_EQ(0, table.GetValue(Key(0)));
+  EXPECT_EQ(kNumKeys, table.GetValue(Key(kNumKeys - 1)));
+
+  table.Reset();
+  EXPECT_EQ(0, table.count());
+  EXPECT_EQ(0, table.GetValue(Key(1)));
+}
+
+class WeakTableReaderTask : public ThreadPool::Task {
+ public:
+  WeakTableReaderTask(WeakTable* table,
+                      intptr_t num_keys,
+                      Monitor* monitor,
+                      intptr_t* num_running,
+                      intptr_t* num_errors)
+      : table_(table),
+        num_keys_(num_keys),
+        monitor_(monitor),
+        num_running_(num_running),
+        num_errors_(num_errors) {}
+
+  virtual void Run() {
+    intptr_t errors = 0;
+    for (intptr_t round = 0; round < 100; round++) {
+      for (intptr_t i = 0; i < num_keys_; i++) {
+        if (table_->GetValue(Key(i)) != i + 1) {
+          errors++;
+        }
+      }
+    }
+    MonitorLocker ml(monitor_);
+    *num_errors_ += errors;
+    (*num_running_)--;
+    ml.Notify();
+  }
+
+ private:
+  WeakTable* table_;
+  intptr_t num_keys_;
+  Monitor* monitor_;
+  intptr_t* num_running_;
+  intptr_t* num_errors_;
+};
+
+VM_UNIT_TEST_CASE(WeakTable_ConcurrentLookups) {
+  WeakTable table;
+  const intptr_t kNumKeys = 1000;
+  const intptr_t kNumTasks = 4;
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    table.SetValue(Key(i), i + 1);
+  }
+
+  Monitor monitor;
+  intptr_t num_running = kNumTasks;
+  intptr_t num_errors = 0;
+  for (intptr_t i = 0; i < kNumTasks; i++) {
+    bool result = Dart::thread_pool()->Run<WeakTableReaderTask>(
+        &table, kNumKeys, &monitor, &num_running, &num_errors);
+    EXPECT(result);
+  }
+
+  // Grow the table while it is being read.
+  for (intptr_t i = kNumKeys; i < 100 * kNumKeys; i++) {
+    table.SetValue(Key(i), i + 1);
+  }
+
+  {
+    MonitorLocker ml(&monitor);
+    while (num_running > 0) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(0, num_errors);
+  table.FreeOldDataExclusive();
+  for (intptr_t i = 0; i < 100 * kNumKeys; i++) {
+    EXPECT_EQ(i + 1, table.GetValue(Key(i)));
+  }
+}
+
+}  // namespace dart
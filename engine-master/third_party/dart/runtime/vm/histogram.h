@@ -0,0 +1,63 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HISTOGRAM_H_
+#define RUNTIME_VM_HISTOGRAM_H_
+
+#include "platform/assert.h"
+#include "platform/atomic.h"
+#include "platform/utils.h"
+
+namespace dart {
+
+// Cumulative distribution of non-negative samples in buckets of exponentially
+// increasing width: bucket 0 counts the samples equal to 0 and bucket i > 0
+// the samples in [2^(i-1), 2^i). The last bucket also counts all larger
+// samples. Samples are added by one thread at a time, but the histogram may
+// be read concurrently.
+class Histogram {
+ public:
+  static const intptr_t kNumBuckets = 32;
+
+  Histogram() : count_(0), sum_(0), max_(0) {}
+
+  void Add(int64_t value) {
+    ASSERT(value >= 0);
+    const intptr_t index =
+        Utils::Minimum<intptr_t>(Utils::BitLength(value), kNumBuckets - 1);
+    buckets_[index].fetch_add(1);
+    count_.fetch_add(1);
+    sum_.fetch_add(value);
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  int64_t count() const { return count_; }
+  int64_t sum() const { return sum_; }
+  int64_t max() const { return max_; }
+
+  int64_t bucket(intptr_t i) const {
+    ASSERT((i >= 0) && (i < kNumBuckets));
+    return buckets_[i];
+  }
+
+  // The smallest sample counted by bucket i.
+  static int64_t BucketLowerBound(intptr_t i) {
+    ASSERT((i >= 0) && (i < kNumBuckets));
+    return (i == 0) ? 0 : (static_cast<int64_t>(1) << (i - 1));
+  }
+
+ private:
+  RelaxedAtomic<int64_t> count_;
+  RelaxedAtomic<int64_t> sum_;
+  RelaxedAtomic<int64_t> max_;
+  RelaxedAtomic<int64_t> buckets_[kNumBuckets];
+
+  DISALLOW_COPY_AND_ASSIGN(Histogram);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HISTOGRAM_H_
@@ -0,0 +1,37 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/histogram.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+TEST_CASE(Histogram) {
+  Histogram histogram;
+  EXPECT_EQ(0, histogram.count());
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(5);
+  histogram.Add(7);
+  histogram.Add(8);
+  EXPECT_EQ(5, histogram.count());
+  EXPECT_EQ(21, histogram.sum());
+  EXPECT_EQ(8, histogram.max());
+  EXPECT_EQ(1, histogram.bucket(0));
+  EXPECT_EQ(1, histogram.bucket(1));
+  EXPECT_EQ(0, histogram.bucket(2));
+  EXPECT_EQ(2, histogram.bucket(3));
+  EXPECT_EQ(1, histogram.bucket(4));
+  EXPECT_EQ(4, Histogram::BucketLowerBound(3));
+  EXPECT_EQ(8, Histogram::BucketLowerBound(4));
+
+  // Large samples are counted in the last bucket.
+  const int64_t kLarge = static_cast<int64_t>(1) << 40;
+  histogram.Add(kLarge);
+  EXPECT_EQ(1, histogram.bucket(Histogram::kNumBuckets - 1));
+  EXPECT_EQ(kLarge, histogram.max());
+}
+
+}  // namespace dart
@@ -109,7 +109,7 @@ typedef DirectChainedHashMap<ObjectOffsetTrait> ObjectOffsetMap;
 // For now this supports
 //
 //   * emitting the instructions of a [Code] object
-//   * emitting a trampoline of a certain size
+//   * emitting a trampoline or padding of a certain size
 //
 struct ImageWriterCommand {
   enum Opcode {
@@ -210,6 +210,16 @@ IsolateGroup::IsolateGroup(std::unique_ptr<IsolateGroupSource> source,
 
 IsolateGroup::~IsolateGroup() {}
 
+const ReversePcLookupTable* IsolateGroup::GetOrBuildReversePcLookupTable(
+    const Array& code_order_table) {
+  MutexLocker ml(&reverse_pc_lookup_table_mutex_);
+  if (reverse_pc_lookup_table_ == nullptr) {
+    reverse_pc_lookup_table_.reset(new ReversePcLookupTable(code_order_table));
+  }
+  ASSERT(reverse_pc_lookup_table_->length() == code_order_table.Length());
+  return reverse_pc_lookup_table_.get();
+}
+
 void IsolateGroup::RegisterIsolate(Isolate* isolate) {
   //加锁
   WriteRwLocker wl(ThreadState::Current(), isolates_rwlock_.get());
@@ -3331,6 +3341,7 @@ void Isolate::UnscheduleThread(Thread* thread,
   thread->ClearReusableHandles();
   if (!is_mutator) {
     thread->heap()->AbandonRemainingTLAB(thread);
+    thread->heap()->old_space()->AbandonAllocationCache(thread);
   }
 
   if (is_mutator) {
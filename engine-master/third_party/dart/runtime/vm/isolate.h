@@ -79,6 +79,7 @@ class RawFloat32x4;
 class RawInt32x4;
 class RawUserTag;
 class ReversePcLookupCache;
+class ReversePcLookupTable;
 class RwLock;
 class SafepointHandler;
 class SampleBuffer;
@@ -368,6 +369,12 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
   uint64_t id() { return id_; }
 
+  // Returns the table the isolates of this group use to look up code by PC,
+  // building it from the given `code_order_table` of the first isolate that
+  // asks for it.
+  const ReversePcLookupTable* GetOrBuildReversePcLookupTable(
+      const Array& code_order_table);
+
   static void Init();
   static void Cleanup();
 
@@ -398,6 +405,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   std::unique_ptr<ThreadRegistry> thread_registry_;
   std::unique_ptr<SafepointHandler> safepoint_handler_;
 
+  Mutex reverse_pc_lookup_table_mutex_;
+  std::unique_ptr<ReversePcLookupTable> reverse_pc_lookup_table_;
+
   static RwLock* isolate_groups_rwlock_;
   static IntrusiveDList<IsolateGroup>* isolate_groups_;
 
@@ -605,6 +615,15 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
     return &constant_canonicalization_mutex_;
   }
   Mutex* megamorphic_mutex() { return &megamorphic_mutex_; }
+  RelaxedAtomic<intptr_t>* megamorphic_table_hits() {
+    return &megamorphic_table_hits_;
+  }
+  RelaxedAtomic<intptr_t>* megamorphic_table_misses() {
+    return &megamorphic_table_misses_;
+  }
+  RelaxedAtomic<intptr_t>* megamorphic_cache_misses() {
+    return &megamorphic_cache_misses_;
+  }
 
   Mutex* kernel_data_lib_cache_mutex() { return &kernel_data_lib_cache_mutex_; }
   Mutex* kernel_data_class_cache_mutex() {
@@ -1252,7 +1271,11 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   Mutex type_canonicalization_mutex_;      // Protects type canonicalization.
   Mutex constant_canonicalization_mutex_;  // Protects const canonicalization.
   Mutex megamorphic_mutex_;  // Protects the table of megamorphic caches and
-                             // their entries.
+                             // insertion of their entries.
+  // Statistics printed by MegamorphicCacheTable::PrintSizes.
+  RelaxedAtomic<intptr_t> megamorphic_table_hits_ = 0;
+  RelaxedAtomic<intptr_t> megamorphic_table_misses_ = 0;
+  RelaxedAtomic<intptr_t> megamorphic_cache_misses_ = 0;
   Mutex kernel_data_lib_cache_mutex_;
   Mutex kernel_data_class_cache_mutex_;
   Mutex kernel_constants_mutex_;
@@ -1325,6 +1348,7 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   friend class HeapSnapshotWriter;  // VisitObjectPointers
   friend class Scavenger;           // VisitObjectPointers
   friend class HeapIterationScope;  // VisitObjectPointers
+  friend class PageSpace;           // threads_lock
   friend class ServiceIsolate;
   friend class Thread;
   friend class Timeline;
@@ -5,8 +5,11 @@
 #include "vm/isolate.h"
 #include "include/dart_api.h"
 #include "platform/assert.h"
+#include "vm/dart_api_impl.h"
 #include "vm/globals.h"
 #include "vm/lockers.h"
+#include "vm/reverse_pc_lookup_cache.h"
+#include "vm/stub_code.h"
 #include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
 #include "vm/unit_test.h"
@@ -124,6 +127,43 @@ const intptr_t InterruptChecker::kIterations = 10;
 // happens *after* the interrupt is observed. Without this synchronization, the
 // compiler and/or CPU could reorder operations to make the tasks observe the
 // round update *before* the interrupt is set.
+// The reverse PC lookup table is built by the first isolate of a group and
+// reused by isolates spawned into the group later.
+TEST_CASE(IsolateGroup_SharesReversePcLookupTable) {
+  Isolate* isolate = thread->isolate();
+  IsolateGroup* group = isolate->group();
+  const ReversePcLookupTable* table = nullptr;
+  {
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    const Array& code_order_table = Array::Handle(Array::New(1));
+    code_order_table.SetAt(0, StubCode::CallToRuntime());
+    table = group->GetOrBuildReversePcLookupTable(code_order_table);
+    EXPECT_EQ(1, table->length());
+    EXPECT_EQ(StubCode::CallToRuntime().PayloadStart(),
+              table->first_absolute_pc());
+  }
+
+  Dart_ExitIsolate();
+  char* error = nullptr;
+  Isolate* spawned =
+      CreateWithinExistingIsolateGroup(group, "spawned", &error);
+  EXPECT(spawned != nullptr);
+  EXPECT(spawned->group() == group);
+  {
+    Thread* spawned_thread = Thread::Current();
+    TransitionNativeToVM transition(spawned_thread);
+    StackZone zone(spawned_thread);
+    HANDLESCOPE(spawned_thread);
+    const Array& code_order_table = Array::Handle(Array::New(1));
+    code_order_table.SetAt(0, StubCode::CallToRuntime());
+    EXPECT_EQ(table, group->GetOrBuildReversePcLookupTable(code_order_table));
+  }
+  Dart_ShutdownIsolate();
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+}
+
 TEST_CASE(StackLimitInterrupts) {
   Isolate* isolate = thread->isolate();
   ThreadBarrier barrier(InterruptChecker::kTaskCount + 1,
@@ -34,11 +34,13 @@ RawMegamorphicCache* MegamorphicCacheTable::Lookup(Thread* thread,
       cache ^= table.At(i);
       if ((cache.target_name() == name.raw()) &&
           (cache.arguments_descriptor() == descriptor.raw())) {
+        isolate->megamorphic_table_hits()->fetch_add(1);
         return cache.raw();
       }
     }
   }
 
+  isolate->megamorphic_table_misses()->fetch_add(1);
   cache = MegamorphicCache::New(name, descriptor);
   table.Add(cache, Heap::kOld);
   return cache.raw();
@@ -116,6 +118,7 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
       isolate->object_store()->megamorphic_cache_table());
   if (table.IsNull()) return;
   intptr_t max_size = 0;
+  intptr_t hit_count = 0;
   for (intptr_t i = 0; i < table.Length(); i++) {
     cache ^= table.At(i);
     buckets = cache.buckets();
@@ -124,9 +127,21 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
     if (buckets.Length() > max_size) {
       max_size = buckets.Length();
     }
+    buckets = cache.old_buckets();
+    if (!buckets.IsNull()) {
+      size += Array::InstanceSize(buckets.Length());
+    }
+    hit_count += cache.hit_count();
   }
   OS::PrintErr("%" Pd " megamorphic caches using %" Pd "KB.\n", table.Length(),
                size / 1024);
+  OS::PrintErr("Megamorphic cache table: %" Pd " hits, %" Pd " misses.\n",
+               isolate->megamorphic_table_hits()->load(),
+               isolate->megamorphic_table_misses()->load());
+  OS::PrintErr("Megamorphic cache hits in the call stub: %" Pd ".\n",
+               hit_count);
+  OS::PrintErr("Megamorphic cache misses handled by the runtime: %" Pd ".\n",
+               isolate->megamorphic_cache_misses()->load());
 
   intptr_t* probe_counts = new intptr_t[max_size];
   intptr_t entry_count = 0;
@@ -2430,6 +2430,12 @@ RawObject* Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
     std::atomic_thread_fence(std::memory_order_release);
     heap->old_space()->AllocateBlack(size);
   }
+#ifndef PRODUCT
+  AllocationSampler* sampler = heap->allocation_sampler();
+  if (UNLIKELY(sampler->pending()) && thread->IsMutatorThread()) {
+    sampler->SampleObject(thread, raw_obj, size);
+  }
+#endif  // !PRODUCT
   return raw_obj;
 }
 
@@ -15929,16 +15935,18 @@ const char* ContextScope::ToCString() const {
 }
 
 RawArray* MegamorphicCache::buckets() const {
-  return raw_ptr()->buckets_;
+  return LoadPointer<RawArray*, std::memory_order_acquire>(
+      &raw_ptr()->buckets_);
 }
 
 void MegamorphicCache::set_buckets(const Array& buckets) const {
-  StorePointer(&raw_ptr()->buckets_, buckets.raw());
+  StorePointer<RawArray*, std::memory_order_release>(&raw_ptr()->buckets_,
+                                                     buckets.raw());
 }
 
-// Class IDs in the table are smi-tagged, so we use a smi-tagged mask
-// and target class ID to avoid untagging (on each iteration of the
-// test loop) in generated code.
+// The mask always matches buckets() while the megamorphic mutex is held.
+// Generated code and Lookup do not take the mutex, so they derive the mask
+// from the length of the buckets they loaded instead.
 intptr_t MegamorphicCache::mask() const {
   return Smi::Value(raw_ptr()->mask_);
 }
@@ -15963,6 +15971,24 @@ void MegamorphicCache::set_arguments_descriptor(const Array& value) const {
   StorePointer(&raw_ptr()->args_descriptor_, value.raw());
 }
 
+RawArray* MegamorphicCache::old_buckets() const {
+  return LoadPointer<RawArray*, std::memory_order_acquire>(
+      &raw_ptr()->old_buckets_);
+}
+
+void MegamorphicCache::set_old_buckets(const Array& old_buckets) const {
+  StorePointer<RawArray*, std::memory_order_release>(&raw_ptr()->old_buckets_,
+                                                     old_buckets.raw());
+}
+
+void MegamorphicCache::set_migration_index(intptr_t index) const {
+  StoreNonPointer(&raw_ptr()->migration_index_, index);
+}
+
+intptr_t MegamorphicCache::hit_count() const {
+  return Smi::Value(raw_ptr()->hit_count_);
+}
+
 RawMegamorphicCache* MegamorphicCache::New() {
   MegamorphicCache& result = MegamorphicCache::Handle();
   {
@@ -15973,6 +15999,8 @@ RawMegamorphicCache* MegamorphicCache::New() {
     result ^= raw;
   }
   result.set_filled_entry_count(0);
+  result.set_migration_index(0);
+  result.StoreSmi(&result.raw_ptr()->hit_count_, Smi::New(0));
   return result.raw();
 }
 
@@ -15999,13 +16027,61 @@ RawMegamorphicCache* MegamorphicCache::New(const String& target_name,
   result.set_target_name(target_name);
   result.set_arguments_descriptor(arguments_descriptor);
   result.set_filled_entry_count(0);
+  result.set_migration_index(0);
+  result.StoreSmi(&result.raw_ptr()->hit_count_, Smi::New(0));
   return result.raw();
 }
 
 void MegamorphicCache::Insert(const Smi& class_id, const Object& target) const {
-  SafepointMutexLocker ml(Isolate::Current()->megamorphic_mutex());
-  EnsureCapacityLocked();
-  InsertLocked(class_id, target);
+  Isolate* isolate = Isolate::Current();
+  isolate->megamorphic_cache_misses()->fetch_add(1);
+  SafepointMutexLocker ml(isolate->megamorphic_mutex());
+  // Another thread may have inserted the class id since this miss.
+  if (LookupEntry(Array::Handle(buckets()), class_id) == Object::null()) {
+    const Array& old = Array::Handle(old_buckets());
+    if (old.IsNull() || (LookupEntry(old, class_id) == Object::null())) {
+      EnsureCapacityLocked();
+      InsertLocked(class_id, target);
+    } else {
+      // Not migrated yet, so it is already counted.
+      InsertEntry(Array::Handle(buckets()), mask(), class_id, target);
+    }
+  }
+  MigrateEntriesLocked(kMigrationBatchSize);
+}
+
+RawObject* MegamorphicCache::Lookup(const Smi& class_id) const {
+  // The old buckets are published before the buckets that replace them, so
+  // entries which are not migrated yet are found in them. A lookup racing
+  // with the end of a migration may miss, in which case the caller inserts
+  // the entry, which finds it under the mutex.
+  RawObject* target = LookupEntry(Array::Handle(buckets()), class_id);
+  if (target != Object::null()) {
+    return target;
+  }
+  const Array& old = Array::Handle(old_buckets());
+  return old.IsNull() ? Object::null() : LookupEntry(old, class_id);
+}
+
+RawObject* MegamorphicCache::LookupEntry(const Array& array,
+                                         const Smi& class_id) {
+  // The buckets are loaded once and their entries only ever change from empty
+  // to filled, so the mask is derived from their length rather than loaded
+  // separately.
+  const intptr_t id_mask = (array.Length() / kEntryLength) - 1;
+  const intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
+  intptr_t i = index;
+  do {
+    RawObject* probe_cid = GetClassId(array, i);
+    if (probe_cid == class_id.raw()) {
+      return GetTargetFunction(array, i);
+    }
+    if (probe_cid == smi_illegal_cid().raw()) {
+      return Object::null();
+    }
+    i = (i + 1) & id_mask;
+  } while (i != index);
+  return Object::null();
 }
 
 void MegamorphicCache::EnsureCapacityLocked() const {
@@ -16013,29 +16089,56 @@ void MegamorphicCache::EnsureCapacityLocked() const {
   intptr_t old_capacity = mask() + 1;
   double load_limit = kLoadFactor * static_cast<double>(old_capacity);
   if (static_cast<double>(filled_entry_count() + 1) > load_limit) {
-    const Array& old_buckets = Array::Handle(buckets());
+    // Only one generation of old buckets is kept.
+    MigrateEntriesLocked(old_capacity);
+    ASSERT(old_buckets() == Array::null());
+
     intptr_t new_capacity = old_capacity * 2;
     const Array& new_buckets =
         Array::Handle(Array::New(kEntryLength * new_capacity));
-
-    auto& target =
+    const auto& target =
         Object::Handle(MegamorphicCacheTable::miss_handler(Isolate::Current()));
     for (intptr_t i = 0; i < new_capacity; ++i) {
       SetEntry(new_buckets, i, smi_illegal_cid(), target);
     }
+
+    // The entries are not rehashed here. Each following insertion migrates a
+    // batch of them instead, and until then lookups find them in the old
+    // buckets. The old buckets are published first, so that a lookup which
+    // sees the new buckets also sees them.
+    set_old_buckets(Array::Handle(buckets()));
+    set_migration_index(0);
     set_buckets(new_buckets);
     set_mask(new_capacity - 1);
-    set_filled_entry_count(0);
-
-    // Rehash the valid entries.
-    Smi& class_id = Smi::Handle();
-    for (intptr_t i = 0; i < old_capacity; ++i) {
-      class_id ^= GetClassId(old_buckets, i);
-      if (class_id.Value() != kIllegalCid) {
-        target = GetTargetFunction(old_buckets, i);
-        InsertLocked(class_id, target);
-      }
-    }
+  }
+}
+
+void MegamorphicCache::MigrateEntriesLocked(intptr_t count) const {
+  ASSERT(Isolate::Current()->megamorphic_mutex()->IsOwnedByCurrentThread());
+  const Array& old = Array::Handle(old_buckets());
+  if (old.IsNull()) {
+    return;
+  }
+  const Array& new_buckets = Array::Handle(buckets());
+  const intptr_t old_capacity = old.Length() / kEntryLength;
+  const intptr_t end =
+      Utils::Minimum(migration_index() + count, old_capacity);
+  Smi& class_id = Smi::Handle();
+  Object& target = Object::Handle();
+  for (intptr_t i = migration_index(); i < end; ++i) {
+    class_id ^= GetClassId(old, i);
+    // Entries may have been moved ahead of the batch by a miss.
+    if ((class_id.Value() != kIllegalCid) &&
+        (LookupEntry(new_buckets, class_id) == Object::null())) {
+      target = GetTargetFunction(old, i);
+      InsertEntry(new_buckets, mask(), class_id, target);
+    }
+  }
+  if (end == old_capacity) {
+    set_old_buckets(Object::null_array());
+    set_migration_index(0);
+  } else {
+    set_migration_index(end);
   }
 }
 
@@ -16045,17 +16148,22 @@ void MegamorphicCache::InsertLocked(const Smi& class_id,
   ASSERT(Thread::Current()->IsMutatorThread());
   ASSERT(static_cast<double>(filled_entry_count() + 1) <=
          (kLoadFactor * static_cast<double>(mask() + 1)));
-  const Array& backing_array = Array::Handle(buckets());
-  intptr_t id_mask = mask();
-  intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
+  InsertEntry(Array::Handle(buckets()), mask(), class_id, target);
+  set_filled_entry_count(filled_entry_count() + 1);
+}
+
+void MegamorphicCache::InsertEntry(const Array& array,
+                                   intptr_t mask,
+                                   const Smi& class_id,
+                                   const Object& target) {
+  intptr_t index = (class_id.Value() * kSpreadFactor) & mask;
   intptr_t i = index;
   do {
-    if (Smi::Value(Smi::RawCast(GetClassId(backing_array, i))) == kIllegalCid) {
-      SetEntry(backing_array, i, class_id, target);
-      set_filled_entry_count(filled_entry_count() + 1);
+    if (Smi::Value(Smi::RawCast(GetClassId(array, i))) == kIllegalCid) {
+      SetEntry(array, i, class_id, target);
       return;
     }
-    i = (i + 1) & id_mask;
+    i = (i + 1) & mask;
   } while (i != index);
   UNREACHABLE();
 }
@@ -16067,12 +16175,20 @@ const char* MegamorphicCache::ToCString() const {
 }
 
 void MegamorphicCache::SwitchToBareInstructions() {
+  SwitchToBareInstructions(Array::Handle(buckets()));
+  const Array& old = Array::Handle(old_buckets());
+  if (!old.IsNull()) {
+    SwitchToBareInstructions(old);
+  }
+}
+
+void MegamorphicCache::SwitchToBareInstructions(const Array& array) {
   NoSafepointScope no_safepoint_scope;
 
-  intptr_t capacity = mask() + 1;
+  intptr_t capacity = array.Length() / kEntryLength;
   for (intptr_t i = 0; i < capacity; ++i) {
     const intptr_t target_index = i * kEntryLength + kTargetFunctionIndex;
-    RawObject** slot = &Array::DataOf(buckets())[target_index];
+    RawObject** slot = &Array::DataOf(array.raw())[target_index];
     const intptr_t cid = (*slot)->GetClassIdMayBeSmi();
     if (cid == kFunctionCid) {
       RawCode* code = Function::CurrentCodeOf(Function::RawCast(*slot));
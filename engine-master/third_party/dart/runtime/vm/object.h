@@ -6201,6 +6201,10 @@ class MegamorphicCache : public Object {
   static const intptr_t kInitialCapacity = 16;
   static const intptr_t kSpreadFactor = 7;
   static const double kLoadFactor;
+  // The number of entries of the old buckets migrated by each insertion while
+  // the cache grows. At the load factor of 0.5 this finishes the migration
+  // well before the cache needs to grow again.
+  static const intptr_t kMigrationBatchSize = 8;
 
   enum EntryType {
     kClassIdIndex,
@@ -6221,6 +6225,14 @@ class MegamorphicCache : public Object {
   intptr_t filled_entry_count() const;
   void set_filled_entry_count(intptr_t num) const;
 
+  // The buckets the cache grew out of, while their entries are migrated to
+  // buckets(). Null when the cache is not growing.
+  RawArray* old_buckets() const;
+
+  // The number of lookups that hit in the megamorphic call stub. Only counted
+  // if the stub was generated with --dump_megamorphic_stats.
+  intptr_t hit_count() const;
+
   static intptr_t buckets_offset() {
     return OFFSET_OF(RawMegamorphicCache, buckets_);
   }
@@ -6230,12 +6242,21 @@ class MegamorphicCache : public Object {
   static intptr_t arguments_descriptor_offset() {
     return OFFSET_OF(RawMegamorphicCache, args_descriptor_);
   }
+  static intptr_t hit_count_offset() {
+    return OFFSET_OF(RawMegamorphicCache, hit_count_);
+  }
 
   static RawMegamorphicCache* New(const String& target_name,
                                   const Array& arguments_descriptor);
 
   void Insert(const Smi& class_id, const Object& target) const;
 
+  // Returns the target cached for [class_id], or null if there is none. Does
+  // not take Isolate::megamorphic_mutex(), so it may run concurrently with
+  // Insert on another thread. Entries which are not yet migrated after growth
+  // are found in the old buckets.
+  RawObject* Lookup(const Smi& class_id) const;
+
   void SwitchToBareInstructions();
 
   static intptr_t InstanceSize() {
@@ -6253,10 +6274,21 @@ class MegamorphicCache : public Object {
 
   void set_target_name(const String& value) const;
   void set_arguments_descriptor(const Array& value) const;
+  void set_old_buckets(const Array& old_buckets) const;
+  intptr_t migration_index() const { return raw_ptr()->migration_index_; }
+  void set_migration_index(intptr_t index) const;
 
   // The caller must hold Isolate::megamorphic_mutex().
   void EnsureCapacityLocked() const;
   void InsertLocked(const Smi& class_id, const Object& target) const;
+  void MigrateEntriesLocked(intptr_t count) const;
+
+  static RawObject* LookupEntry(const Array& array, const Smi& class_id);
+  static void InsertEntry(const Array& array,
+                          intptr_t mask,
+                          const Smi& class_id,
+                          const Object& target);
+  static void SwitchToBareInstructions(const Array& array);
 
   static inline void SetEntry(const Array& array,
                               intptr_t index,
@@ -8266,6 +8298,7 @@ class OneByteString : public AllStatic {
   friend class SnapshotReader;
   friend class StringHasher;
   friend class Utf8;
+  friend class IrregexpInterpreter;
 };
 
 class TwoByteString : public AllStatic {
@@ -8388,6 +8421,8 @@ class TwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
+  friend class IrregexpInterpreter;
 };
 
 class ExternalOneByteString : public AllStatic {
@@ -8479,6 +8514,7 @@ class ExternalOneByteString : public AllStatic {
   friend class SnapshotReader;
   friend class Symbols;
   friend class Utf8;
+  friend class IrregexpInterpreter;
 };
 
 class ExternalTwoByteString : public AllStatic {
@@ -8565,6 +8601,8 @@ class ExternalTwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
+  friend class IrregexpInterpreter;
 };
 
 // Class Bool implements Dart core class bool.
@@ -10320,7 +10358,8 @@ void MegamorphicCache::SetEntry(const Array& array,
                                 const Smi& class_id,
                                 const Object& target) {
   ASSERT(target.IsFunction() || target.IsSmi());
-  array.SetAt((index * kEntryLength) + kClassIdIndex, class_id);
+  // The class id is stored last, with release semantics, so that a concurrent
+  // Lookup that finds it also finds its target.
 #if defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_precompiled_mode && FLAG_use_bare_instructions) {
     if (target.IsFunction()) {
@@ -10328,15 +10367,17 @@ void MegamorphicCache::SetEntry(const Array& array,
       const auto& entry_point = Smi::Handle(
           Smi::FromAlignedAddress(Code::EntryPointOf(function.CurrentCode())));
       array.SetAt((index * kEntryLength) + kTargetFunctionIndex, entry_point);
+      array.SetAtRelease((index * kEntryLength) + kClassIdIndex, class_id);
       return;
     }
   }
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
   array.SetAt((index * kEntryLength) + kTargetFunctionIndex, target);
+  array.SetAtRelease((index * kEntryLength) + kClassIdIndex, class_id);
 }
 
 RawObject* MegamorphicCache::GetClassId(const Array& array, intptr_t index) {
-  return array.At((index * kEntryLength) + kClassIdIndex);
+  return array.AtAcquire((index * kEntryLength) + kClassIdIndex);
 }
 
 RawObject* MegamorphicCache::GetTargetFunction(const Array& array,
@@ -519,29 +519,14 @@ intptr_t ObjectGraph::InboundReferences(Object* obj, const Array& references) {
   return visitor.length();
 }
 
-void HeapSnapshotWriter::EnsureAvailable(intptr_t needed) {
-  intptr_t available = capacity_ - size_;
-  if (available >= needed) {
-    return;
-  }
-
-  if (buffer_ != nullptr) {
-    Flush();
-  }
-  ASSERT(buffer_ == nullptr);
-
-  intptr_t chunk_size = kPreferredChunkSize;
-  if (chunk_size < needed + kMetadataReservation) {
-    chunk_size = needed + kMetadataReservation;
-  }
-  buffer_ = reinterpret_cast<uint8_t*>(malloc(chunk_size));
-  size_ = kMetadataReservation;
-  capacity_ = chunk_size;
-}
-
-void HeapSnapshotWriter::Flush(bool last) {
-  if (size_ == 0 && !last) {
-    return;
+void VmServiceHeapSnapshotChunkedWriter::WriteChunk(uint8_t* buffer,
+                                                    intptr_t size,
+                                                    bool last) {
+  if (buffer == nullptr) {
+    // An empty last chunk still needs room for the metadata.
+    ASSERT(last && size == 0);
+    buffer = reinterpret_cast<uint8_t*>(malloc(kMetadataReservation));
+    size = kMetadataReservation;
   }
 
   JSONStream js;
@@ -565,7 +550,43 @@ void HeapSnapshotWriter::Flush(bool last) {
 
   Service::SendEventWithData(Service::heapsnapshot_stream.id(), "HeapSnapshot",
                              kMetadataReservation, js.buffer()->buf(),
-                             js.buffer()->length(), buffer_, size_);
+                             js.buffer()->length(), buffer, size);
+}
+
+void CallbackHeapSnapshotWriter::WriteChunk(uint8_t* buffer,
+                                            intptr_t size,
+                                            bool last) {
+  callback_(context_, buffer, size, last);
+  free(buffer);
+}
+
+void HeapSnapshotWriter::EnsureAvailable(intptr_t needed) {
+  intptr_t available = capacity_ - size_;
+  if (available >= needed) {
+    return;
+  }
+
+  if (buffer_ != nullptr) {
+    Flush();
+  }
+  ASSERT(buffer_ == nullptr);
+
+  const intptr_t reservation = writer_->ReserveChunkPrefixSize();
+  intptr_t chunk_size = kPreferredChunkSize;
+  if (chunk_size < needed + reservation) {
+    chunk_size = needed + reservation;
+  }
+  buffer_ = reinterpret_cast<uint8_t*>(malloc(chunk_size));
+  size_ = reservation;
+  capacity_ = chunk_size;
+}
+
+void HeapSnapshotWriter::Flush(bool last) {
+  if (buffer_ == nullptr && !last) {
+    return;
+  }
+
+  writer_->WriteChunk(buffer_, size_, last);
   buffer_ = nullptr;
   size_ = 0;
   capacity_ = 0;
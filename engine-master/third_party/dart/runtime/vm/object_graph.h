@@ -7,6 +7,8 @@
 
 #include <memory>
 
+#include "include/dart_tools_api.h"
+
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
 #include "vm/thread_stack_resource.h"
@@ -115,11 +117,67 @@ class ObjectGraph : public ThreadStackResource {
   DISALLOW_IMPLICIT_CONSTRUCTORS(ObjectGraph);
 };
 
+// Receives a heap snapshot in chunks while it is being written.
+class ChunkedWriter : public ThreadStackResource {
+ public:
+  explicit ChunkedWriter(Thread* thread) : ThreadStackResource(thread) {}
+  virtual ~ChunkedWriter() {}
+
+  // The number of bytes left free at the start of each chunk for metadata.
+  virtual intptr_t ReserveChunkPrefixSize() { return 0; }
+
+  // Takes ownership of [buffer], which was allocated with malloc. The chunk's
+  // data follows the reserved prefix and ends at [size]. The last chunk may
+  // be empty, in which case [buffer] is null.
+  virtual void WriteChunk(uint8_t* buffer, intptr_t size, bool last) = 0;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ChunkedWriter);
+};
+
+// Sends the chunks as events on the service protocol's heap snapshot stream.
+// The events are queued for the service isolate without flow control, so
+// every chunk of the snapshot may be live at once.
+class VmServiceHeapSnapshotChunkedWriter : public ChunkedWriter {
+ public:
+  explicit VmServiceHeapSnapshotChunkedWriter(Thread* thread)
+      : ChunkedWriter(thread) {}
+
+  virtual intptr_t ReserveChunkPrefixSize() { return kMetadataReservation; }
+  virtual void WriteChunk(uint8_t* buffer, intptr_t size, bool last);
+
+ private:
+  static const intptr_t kMetadataReservation = 512;
+
+  DISALLOW_COPY_AND_ASSIGN(VmServiceHeapSnapshotChunkedWriter);
+};
+
+// Passes the chunks to an embedder callback. Each chunk is freed as soon as
+// the callback returns, so the memory used for the output is bounded by the
+// chunk size. The object ids assigned by HeapSnapshotWriter are not bounded
+// and grow with the number of objects in the heap.
+class CallbackHeapSnapshotWriter : public ChunkedWriter {
+ public:
+  CallbackHeapSnapshotWriter(Thread* thread,
+                             Dart_HeapSnapshotWriteChunkCallback callback,
+                             void* context)
+      : ChunkedWriter(thread), callback_(callback), context_(context) {}
+
+  virtual void WriteChunk(uint8_t* buffer, intptr_t size, bool last);
+
+ private:
+  Dart_HeapSnapshotWriteChunkCallback callback_;
+  void* context_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallbackHeapSnapshotWriter);
+};
+
 // Generates a dump of the heap, whose format is described in
 // runtime/vm/service/heap_snapshot.md.
 class HeapSnapshotWriter : public ThreadStackResource {
  public:
-  explicit HeapSnapshotWriter(Thread* thread) : ThreadStackResource(thread) {}
+  HeapSnapshotWriter(Thread* thread, ChunkedWriter* writer)
+      : ThreadStackResource(thread), writer_(writer) {}
 
   void WriteSigned(int64_t value) {
     EnsureAvailable((sizeof(value) * kBitsPerByte) / 7 + 1);
@@ -185,12 +243,12 @@ class HeapSnapshotWriter : public ThreadStackResource {
   void Write();
 
  private:
-  static const intptr_t kMetadataReservation = 512;
   static const intptr_t kPreferredChunkSize = MB;
 
   void EnsureAvailable(intptr_t needed);
   void Flush(bool last = false);
 
+  ChunkedWriter* writer_;
   uint8_t* buffer_ = nullptr;
   intptr_t size_ = 0;
   intptr_t capacity_ = 0;
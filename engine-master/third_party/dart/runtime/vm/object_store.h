@@ -148,6 +148,8 @@ class ObjectPointerVisitor;
   R_(Function, megamorphic_miss_function)                                      \
   RW(Array, code_order_table)                                                  \
   RW(Array, obfuscation_map)                                                   \
+  RW(Array, aot_type_feedback)                                                 \
+  RW(Array, hot_code)                                                          \
   RW(Class, ffi_pointer_class)                                                 \
   RW(Class, ffi_native_type_class)                                             \
   RW(Class, ffi_struct_class)                                                  \
@@ -3005,6 +3005,56 @@ ISOLATE_UNIT_TEST_CASE(SubtypeTestCache) {
   EXPECT_EQ(Bool::True().raw(), test_result.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(MegamorphicCache) {
+  const String& target_name = String::Handle(Symbols::New(thread, "Thun"));
+  const intptr_t kTypeArgsLen = 0;
+  const intptr_t kNumArgs = 1;
+  const Array& args_descriptor = Array::Handle(
+      ArgumentsDescriptor::New(kTypeArgsLen, kNumArgs, Object::null_array()));
+  const MegamorphicCache& cache = MegamorphicCache::Handle(
+      MegamorphicCache::New(target_name, args_descriptor));
+  EXPECT_EQ(0, cache.filled_entry_count());
+  EXPECT_EQ(MegamorphicCache::kInitialCapacity - 1, cache.mask());
+  EXPECT_EQ(0, cache.hit_count());
+
+  // Enough entries to grow the cache several times.
+  const intptr_t kNumEntries = 100;
+  const Function& target = Function::Handle(GetDummyTarget("Thun"));
+  const Smi& first_class_id = Smi::Handle(Smi::New(kNumPredefinedCids));
+  Smi& class_id = Smi::Handle();
+  intptr_t num_growths = 0;
+  intptr_t capacity = cache.mask() + 1;
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    class_id = Smi::New(kNumPredefinedCids + i);
+    EXPECT(cache.Lookup(class_id) == Object::null());
+    cache.Insert(class_id, target);
+    EXPECT_EQ(target.raw(), cache.Lookup(class_id));
+    if (cache.mask() + 1 != capacity) {
+      // The entries are migrated by later insertions, and are found in the
+      // old buckets meanwhile.
+      num_growths++;
+      capacity = cache.mask() + 1;
+      EXPECT(cache.old_buckets() != Array::null());
+    }
+    EXPECT_EQ(target.raw(), cache.Lookup(first_class_id));
+  }
+  EXPECT_EQ(kNumEntries, cache.filled_entry_count());
+  EXPECT_LE(2 * kNumEntries, cache.mask() + 1);
+  EXPECT_LE(3, num_growths);
+
+  // Earlier entries survive growth, and inserting one again does not add a
+  // second entry.
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    class_id = Smi::New(kNumPredefinedCids + i);
+    EXPECT_EQ(target.raw(), cache.Lookup(class_id));
+  }
+  class_id = Smi::New(kNumPredefinedCids);
+  cache.Insert(class_id, target);
+  EXPECT_EQ(kNumEntries, cache.filled_entry_count());
+  class_id = Smi::New(kNumPredefinedCids + kNumEntries);
+  EXPECT(cache.Lookup(class_id) == Object::null());
+}
+
 ISOLATE_UNIT_TEST_CASE(FieldTests) {
   const String& f = String::Handle(String::New("oneField"));
   const String& getter_f = String::Handle(Field::GetterName(f));
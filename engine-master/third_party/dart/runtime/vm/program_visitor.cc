@@ -5,14 +5,26 @@
 #include "vm/program_visitor.h"
 
 #include "vm/code_patcher.h"
+#include "vm/dart.h"
 #include "vm/deopt_instructions.h"
+#include "vm/flags.h"
 #include "vm/hash_map.h"
+#include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/symbols.h"
+#include "vm/thread_pool.h"
 
 namespace dart {
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DEFINE_FLAG(bool,
+            parallel_dedup,
+            false,
+            "Run the independent deduplication passes of snapshot writing on "
+            "the thread pool.");
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 void ProgramVisitor::VisitClasses(ClassVisitor* visitor) {
   Thread* thread = Thread::Current();
   Isolate* isolate = thread->isolate();
@@ -196,6 +208,8 @@ void ProgramVisitor::ShareMegamorphicBuckets() {
     cache.set_buckets(buckets);
     cache.set_mask(capacity - 1);
     cache.set_filled_entry_count(0);
+    cache.set_old_buckets(Object::null_array());
+    cache.set_migration_index(0);
   }
 }
 
@@ -1108,6 +1122,91 @@ void ProgramVisitor::DedupInstructionsWithSameMetadata() {
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+class DedupPassTask : public ThreadPool::Task {
+ public:
+  DedupPassTask(Isolate* isolate,
+                void (*pass)(),
+                Monitor* monitor,
+                intptr_t* num_pending)
+      : isolate_(isolate),
+        pass_(pass),
+        monitor_(monitor),
+        num_pending_(num_pending) {}
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateAsHelper(isolate_, Thread::kCompilerTask,
+                                               /*bypass_safepoint=*/true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      StackZone stack_zone(thread);
+      HANDLESCOPE(thread);
+      pass_();
+    }
+    Thread::ExitIsolateAsHelper(/*bypass_safepoint=*/true);
+
+    MonitorLocker ml(monitor_);
+    (*num_pending_)--;
+    ml.Notify();
+  }
+
+ private:
+  Isolate* isolate_;
+  void (*pass_)();
+  Monitor* monitor_;
+  intptr_t* num_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(DedupPassTask);
+};
+
+// Each of these passes replaces a different field of Code and Bytecode
+// objects with a canonical copy. They neither allocate nor read the fields
+// replaced by the other passes, so their result does not depend on how they
+// interleave.
+void ProgramVisitor::DedupMetadataInParallel(Thread* thread) {
+  void (*passes[])() = {
+    &DedupPcDescriptors,
+    &DedupDeoptEntries,
+#if defined(DART_PRECOMPILER)
+    &DedupCatchEntryMovesMaps,
+#endif
+    &DedupCodeSourceMaps,
+  };
+  const intptr_t num_passes = sizeof(passes) / sizeof(passes[0]);
+
+  // The helpers bypass safepoints. Nothing allocates until they are done, so
+  // no GC can start. If concurrent marking is in progress, the helpers get
+  // marking stacks when they enter the isolate, but finalizing the marking
+  // would not wait for them to flush those, so marking has to finish first.
+  thread->heap()->WaitForMarkerTasks(thread);
+
+  Monitor monitor;
+  intptr_t num_pending = 0;
+  // The last pass runs on this thread.
+  for (intptr_t i = 0; i < num_passes - 1; i++) {
+    {
+      MonitorLocker ml(&monitor);
+      num_pending++;
+    }
+    if (!Dart::thread_pool()->Run<DedupPassTask>(thread->isolate(), passes[i],
+                                                 &monitor, &num_pending)) {
+      {
+        MonitorLocker ml(&monitor);
+        num_pending--;
+      }
+      passes[i]();
+    }
+  }
+  passes[num_passes - 1]();
+
+  MonitorLocker ml(&monitor);
+  while (num_pending > 0) {
+    ml.Wait();
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 void ProgramVisitor::Dedup() {
 #if !defined(DART_PRECOMPILED_RUNTIME)
   Thread* thread = Thread::Current();
@@ -1117,12 +1216,17 @@ void ProgramVisitor::Dedup() {
   BindStaticCalls();
   ShareMegamorphicBuckets();
   NormalizeAndDedupCompressedStackMaps();
-  DedupPcDescriptors();
-  NOT_IN_PRECOMPILED(DedupDeoptEntries());
+  if (FLAG_parallel_dedup) {
+    DedupMetadataInParallel(thread);
+  } else {
+    DedupPcDescriptors();
+    NOT_IN_PRECOMPILED(DedupDeoptEntries());
 #if defined(DART_PRECOMPILER)
-  DedupCatchEntryMovesMaps();
+    DedupCatchEntryMovesMaps();
 #endif
-  DedupCodeSourceMaps();
+    DedupCodeSourceMaps();
+  }
+  // Deduplicates the deopt tables, so it has to run after DedupDeoptEntries.
   DedupLists();
 
 #if defined(PRODUCT)
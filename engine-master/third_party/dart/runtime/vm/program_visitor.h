@@ -11,6 +11,7 @@ namespace dart {
 
 class Function;
 class Class;
+class Thread;
 
 template <typename T>
 class Visitor : public ValueObject {
@@ -40,6 +41,9 @@ class ProgramVisitor : public AllStatic {
   static void DedupCatchEntryMovesMaps();
 #endif
   static void DedupCodeSourceMaps();
+  // Runs the passes above that only replace metadata of Code objects
+  // concurrently on the thread pool.
+  static void DedupMetadataInParallel(Thread* thread);
   static void DedupLists();
   static void DedupInstructions();
   static void DedupInstructionsWithSameMetadata();
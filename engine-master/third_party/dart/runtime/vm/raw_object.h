@@ -450,6 +450,20 @@ class RawObject {
     return result;
   }
 
+  // As above, but using previously loaded tags. This is used by the parallel
+  // scavenger, which may find the header word replaced by a forwarding
+  // pointer at any time.
+  intptr_t HeapSize(uint32_t tags) const {
+    ASSERT(IsHeapObject());
+    intptr_t result = SizeTag::decode(tags);
+    if (result != 0) {
+      return result;
+    }
+    result = HeapSizeFromClass(tags);
+    ASSERT(result > SizeTag::kMaxSizeTag);
+    return result;
+  }
+
   bool Contains(uword addr) const {
     intptr_t this_size = HeapSize();
     uword this_addr = RawObject::ToAddr(this);
@@ -569,7 +583,8 @@ class RawObject {
   intptr_t VisitPointersPredefined(ObjectPointerVisitor* visitor,
                                    intptr_t class_id);
 
-  intptr_t HeapSizeFromClass() const;
+  intptr_t HeapSizeFromClass() const { return HeapSizeFromClass(ptr()->tags_); }
+  intptr_t HeapSizeFromClass(uint32_t tags) const;
 
   void SetClassId(intptr_t new_cid) {
     ptr()->tags_.UpdateUnsynchronized<ClassIdTag>(new_cid);
@@ -725,7 +740,8 @@ class RawObject {
   friend class OneByteString;  // StoreSmi
   friend class RawInstance;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ImageReader;  // tags_ check
   friend class ImageWriter;
   friend class AssemblyImageWriter;
@@ -1973,10 +1989,15 @@ class RawMegamorphicCache : public RawObject {
   RawSmi* mask_;
   RawString* target_name_;     // Name of target function.
   RawArray* args_descriptor_;  // Arguments descriptor.
-  VISIT_TO(RawObject*, args_descriptor_)
-  RawObject** to_snapshot(Snapshot::Kind kind) { return to(); }
+  RawArray* old_buckets_;      // Buckets still being migrated after growth.
+  RawSmi* hit_count_;          // Only counted with --dump_megamorphic_stats.
+  VISIT_TO(RawObject*, hit_count_)
+  RawObject** to_snapshot(Snapshot::Kind kind) {
+    return reinterpret_cast<RawObject**>(&ptr()->old_buckets_);
+  }
 
   int32_t filled_entry_count_;
+  int32_t migration_index_;  // Next entry of old_buckets_ to migrate.
 };
 
 class RawSubtypeTestCache : public RawObject {
@@ -2420,8 +2441,10 @@ class RawTypedDataView : public RawTypedDataBase {
   friend class ObjectPoolDeserializationCluster;
   friend class ObjectPoolSerializationCluster;
   friend class RawObjectPool;
+  friend class ForwardPointersVisitor;  // typed_data_
   friend class GCCompactor;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class SnapshotReader;
 };
 
@@ -2431,6 +2454,7 @@ class RawExternalOneByteString : public RawString {
   const uint8_t* external_data_;
   void* peer_;
   friend class Api;
+  friend class OneByteStringDeserializationCluster;
   friend class String;
 };
 
@@ -2711,7 +2735,8 @@ class RawWeakProperty : public RawInstance {
   template <bool>
   friend class MarkingVisitorBase;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
 };
 
 // MirrorReferences are used by mirrors to hold reflectees that are VM
@@ -126,6 +126,8 @@ namespace dart {
   F(MegamorphicCache, mask_)                                                   \
   F(MegamorphicCache, target_name_)                                            \
   F(MegamorphicCache, args_descriptor_)                                        \
+  F(MegamorphicCache, old_buckets_)                                            \
+  F(MegamorphicCache, hit_count_)                                              \
   F(SubtypeTestCache, cache_)                                                  \
   F(ApiError, message_)                                                        \
   F(LanguageError, previous_error_)                                            \
@@ -1444,7 +1444,9 @@ void RawTypedData::WriteTo(SnapshotWriter* writer,
   // Write out the serialization header value for this object.
   writer->WriteInlinedObjectHeader(object_id);
 
-  if ((kind == Snapshot::kMessage) &&
+  // Canonical typed data is written as internal, since it has to be
+  // canonicalized again when read.
+  if ((kind == Snapshot::kMessage) && !IsCanonical() &&
       (static_cast<uint64_t>(bytes) >= FLAG_externalize_typed_data_threshold)) {
     // Write as external.
     writer->WriteIndexedObject(external_cid);
@@ -2960,18 +2960,10 @@ void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
   }
 
   if (found_single_character) {
-    BlockLabel cont, again;
-    masm->BindBlock(&again);
-    masm->LoadCurrentCharacter(max_lookahead, &cont, true);
-    if (max_char_ > kSize) {
-      masm->CheckCharacterAfterAnd(single_character,
-                                   RegExpMacroAssembler::kTableMask, &cont);
-    } else {
-      masm->CheckCharacter(single_character, &cont);
-    }
-    masm->AdvanceCurrentPosition(lookahead_width);
-    masm->GoTo(&again);
-    masm->BindBlock(&cont);
+    const unsigned mask =
+        max_char_ > kSize ? RegExpMacroAssembler::kTableMask : 0xFFFFFFFF;
+    masm->SkipUntilCharacterAfterAnd(max_lookahead, lookahead_width,
+                                     single_character, mask);
     return;
   }
 
@@ -2982,17 +2974,7 @@ void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
       GetSkipTable(min_lookahead, max_lookahead, boolean_skip_table);
   ASSERT(skip_distance != 0);
 
-  BlockLabel cont, again;
-
-  masm->BindBlock(&again);
-  masm->CheckPreemption(/*is_backtrack=*/false);
-  masm->LoadCurrentCharacter(max_lookahead, &cont, true);
-  masm->CheckBitInTable(boolean_skip_table, &cont);
-  masm->AdvanceCurrentPosition(skip_distance);
-  masm->GoTo(&again);
-  masm->BindBlock(&cont);
-
-  return;
+  masm->SkipUntilBitInTable(max_lookahead, skip_distance, boolean_skip_table);
 }
 
 /* Code generation for choice nodes.
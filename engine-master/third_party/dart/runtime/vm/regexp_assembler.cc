@@ -126,4 +126,30 @@ void RegExpMacroAssembler::CheckNotInSurrogatePair(intptr_t cp_offset,
   BindBlock(&ok);
 }
 
+void RegExpMacroAssembler::SkipUntilCharacterAfterAnd(intptr_t cp_offset,
+                                                      intptr_t advance_by,
+                                                      unsigned c,
+                                                      unsigned mask) {
+  BlockLabel cont, again;
+  BindBlock(&again);
+  LoadCurrentCharacter(cp_offset, &cont, true);
+  CheckCharacterAfterAnd(c, mask, &cont);
+  AdvanceCurrentPosition(advance_by);
+  GoTo(&again);
+  BindBlock(&cont);
+}
+
+void RegExpMacroAssembler::SkipUntilBitInTable(intptr_t cp_offset,
+                                               intptr_t advance_by,
+                                               const TypedData& table) {
+  BlockLabel cont, again;
+  BindBlock(&again);
+  CheckPreemption(/*is_backtrack=*/false);
+  LoadCurrentCharacter(cp_offset, &cont, true);
+  CheckBitInTable(table, &cont);
+  AdvanceCurrentPosition(advance_by);
+  GoTo(&again);
+  BindBlock(&cont);
+}
+
 }  // namespace dart
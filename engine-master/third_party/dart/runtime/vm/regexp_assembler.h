@@ -232,6 +232,20 @@ class RegExpMacroAssembler : public ZoneAllocated {
   // Check that we are not in the middle of a surrogate pair.
   void CheckNotInSurrogatePair(intptr_t cp_offset, BlockLabel* on_failure);
 
+  // Advances the current position by advance_by until the character at
+  // cp_offset from it is c after and-ing it with mask, or is past the end of
+  // the input. Clobbers the current character.
+  virtual void SkipUntilCharacterAfterAnd(intptr_t cp_offset,
+                                          intptr_t advance_by,
+                                          unsigned c,
+                                          unsigned mask);
+  // Advances the current position by advance_by until the character at
+  // cp_offset from it has its bit set in the table (see CheckBitInTable), or
+  // is past the end of the input. Clobbers the current character.
+  virtual void SkipUntilBitInTable(intptr_t cp_offset,
+                                   intptr_t advance_by,
+                                   const TypedData& table);
+
   // Controls the generation of large inlined constants in the code.
   void set_slow_safe(bool ssc) { slow_safe_compiler_ = ssc; }
   bool slow_safe() { return slow_safe_compiler_; }
@@ -326,6 +326,34 @@ void BytecodeRegExpMacroAssembler::CheckBitInTable(const TypedData& table,
                                                    BlockLabel* on_bit_set) {
   Emit(BC_CHECK_BIT_IN_TABLE, 0);
   EmitOrLink(on_bit_set);
+  EmitTable(table);
+}
+
+void BytecodeRegExpMacroAssembler::SkipUntilCharacterAfterAnd(
+    intptr_t cp_offset,
+    intptr_t advance_by,
+    unsigned c,
+    unsigned mask) {
+  ASSERT(cp_offset >= kMinCPOffset);
+  ASSERT(cp_offset <= kMaxCPOffset);
+  Emit(BC_SKIP_UNTIL_CHAR, cp_offset);
+  Emit32(advance_by);
+  Emit32(c);
+  Emit32(mask);
+}
+
+void BytecodeRegExpMacroAssembler::SkipUntilBitInTable(
+    intptr_t cp_offset,
+    intptr_t advance_by,
+    const TypedData& table) {
+  ASSERT(cp_offset >= kMinCPOffset);
+  ASSERT(cp_offset <= kMaxCPOffset);
+  Emit(BC_SKIP_UNTIL_BIT_IN_TABLE, cp_offset);
+  Emit32(advance_by);
+  EmitTable(table);
+}
+
+void BytecodeRegExpMacroAssembler::EmitTable(const TypedData& table) {
   for (int i = 0; i < kTableSize; i += kBitsPerByte) {
     int byte = 0;
     for (int j = 0; j < kBitsPerByte; j++) {
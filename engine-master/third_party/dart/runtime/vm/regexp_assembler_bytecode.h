@@ -78,6 +78,13 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
                                         uint16_t to,
                                         BlockLabel* on_not_in_range);
   virtual void CheckBitInTable(const TypedData& table, BlockLabel* on_bit_set);
+  virtual void SkipUntilCharacterAfterAnd(intptr_t cp_offset,
+                                          intptr_t advance_by,
+                                          unsigned c,
+                                          unsigned mask);
+  virtual void SkipUntilBitInTable(intptr_t cp_offset,
+                                   intptr_t advance_by,
+                                   const TypedData& table);
   virtual void CheckNotBackReference(intptr_t start_reg,
                                      bool read_backward,
                                      BlockLabel* on_no_match);
@@ -121,6 +128,8 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
   inline void Emit16(uint32_t x);
   inline void Emit8(uint32_t x);
   inline void Emit(uint32_t bc, uint32_t arg);
+  // Emits the 128 bits of a table used by CheckBitInTable.
+  void EmitTable(const TypedData& table);
   // Bytecode buffer.
   intptr_t length();
 
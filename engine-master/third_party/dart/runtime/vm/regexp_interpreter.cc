@@ -7,6 +7,7 @@
 #include "vm/regexp_interpreter.h"
 
 #include "platform/unicode.h"
+#include "platform/utils.h"
 #include "vm/object.h"
 #include "vm/regexp_assembler.h"
 #include "vm/regexp_bytecodes.h"
@@ -121,6 +122,42 @@ static int32_t Load16Aligned(const uint8_t* pc) {
   return *reinterpret_cast<const uint16_t*>(pc);
 }
 
+// Returns the first position in [from, length) whose character masked with
+// [mask] equals [c], or [length] if there is none. Boyer-Moore skip loops
+// usually look for a single character masked with kTableMask, so memchr does
+// not apply; instead eight characters are tested at a time by finding a zero
+// byte in their masked xor with [c].
+static intptr_t FindCharacterAfterAnd(const uint8_t* data,
+                                      intptr_t from,
+                                      intptr_t length,
+                                      uint32_t c,
+                                      uint32_t mask) {
+  if (c > 0xFF || (c & ~mask) != 0) {
+    return length;
+  }
+  const uint64_t kOnes = 0x0101010101010101ULL;
+  const uint64_t kLowBits = 0x7F7F7F7F7F7F7F7FULL;
+  const uint64_t wide_mask = (mask & 0xFF) * kOnes;
+  const uint64_t wide_c = c * kOnes;
+  intptr_t pos = from;
+  for (; pos + 8 <= length; pos += 8) {
+    const uint64_t word = ReadUnaligned(
+        reinterpret_cast<const uint64_t*>(data + pos));
+    const uint64_t diff = (word & wide_mask) ^ wide_c;
+    // The high bit of each byte is set iff that byte of diff is zero.
+    const uint64_t zero = ~(((diff & kLowBits) + kLowBits) | diff | kLowBits);
+    if (zero != 0) {
+      return pos + (Utils::CountTrailingZeros64(zero) >> kBitsPerByteLog2);
+    }
+  }
+  for (; pos < length; pos++) {
+    if ((data[pos] & mask) == c) {
+      return pos;
+    }
+  }
+  return length;
+}
+
 // A simple abstraction over the backtracking stack used by the interpreter.
 // This backtracking stack does not grow automatically, but it ensures that the
 // the memory held by the stack is released or remembered in a cache if the
@@ -146,6 +183,7 @@ class BacktrackStack {
 template <typename Char>
 static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
                                                     const String& subject,
+                                                    const Char* data,
                                                     int32_t* registers,
                                                     intptr_t current,
                                                     uint32_t current_char,
@@ -616,6 +654,46 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
         pc += BC_SET_CURRENT_POSITION_FROM_END_LENGTH;
         break;
       }
+      BYTECODE(SKIP_UNTIL_CHAR) {
+        const int32_t cp_offset = insn >> BYTECODE_SHIFT;
+        const int32_t advance_by = Load32Aligned(pc + 4);
+        const uint32_t c = Load32Aligned(pc + 8);
+        const uint32_t mask = Load32Aligned(pc + 12);
+        intptr_t pos = current + cp_offset;
+        if (sizeof(Char) == 1 && advance_by == 1 && pos >= 0 &&
+            pos < subject_length) {
+          pos = FindCharacterAfterAnd(reinterpret_cast<const uint8_t*>(data),
+                                      pos, subject_length, c, mask);
+          current = pos - cp_offset;
+          current_char = data[pos < subject_length ? pos : subject_length - 1];
+        } else {
+          while (pos >= 0 && pos < subject_length) {
+            current_char = data[pos];
+            if ((current_char & mask) == c) break;
+            current += advance_by;
+            pos += advance_by;
+          }
+        }
+        pc += BC_SKIP_UNTIL_CHAR_LENGTH;
+        break;
+      }
+      BYTECODE(SKIP_UNTIL_BIT_IN_TABLE) {
+        const int32_t cp_offset = insn >> BYTECODE_SHIFT;
+        const int32_t advance_by = Load32Aligned(pc + 4);
+        const uint8_t* table = pc + 8;
+        const int mask = RegExpMacroAssembler::kTableMask;
+        intptr_t pos = current + cp_offset;
+        while (pos >= 0 && pos < subject_length) {
+          current_char = data[pos];
+          uint8_t b = table[(current_char & mask) >> kBitsPerByteLog2];
+          int bit = (current_char & (kBitsPerByte - 1));
+          if ((b & (1 << bit)) != 0) break;
+          current += advance_by;
+          pos += advance_by;
+        }
+        pc += BC_SKIP_UNTIL_BIT_IN_TABLE_LENGTH;
+        break;
+      }
       default:
         UNREACHABLE();
         break;
@@ -638,11 +716,17 @@ IrregexpInterpreter::IrregexpResult IrregexpInterpreter::Match(
   }
 
   if (subject.IsOneByteString() || subject.IsExternalOneByteString()) {
-    return RawMatch<uint8_t>(code_base, subject, registers, start_position,
-                             previous_char, zone);
+    const uint8_t* data = subject.IsOneByteString()
+                              ? OneByteString::DataStart(subject)
+                              : ExternalOneByteString::DataStart(subject);
+    return RawMatch<uint8_t>(code_base, subject, data, registers,
+                             start_position, previous_char, zone);
   } else if (subject.IsTwoByteString() || subject.IsExternalTwoByteString()) {
-    return RawMatch<uint16_t>(code_base, subject, registers, start_position,
-                              previous_char, zone);
+    const uint16_t* data = subject.IsTwoByteString()
+                               ? TwoByteString::DataStart(subject)
+                               : ExternalTwoByteString::DataStart(subject);
+    return RawMatch<uint16_t>(code_base, subject, data, registers,
+                              start_position, previous_char, zone);
   } else {
     UNREACHABLE();
     return IrregexpInterpreter::RE_FAILURE;
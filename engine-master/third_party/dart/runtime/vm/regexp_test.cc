@@ -7,6 +7,7 @@
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/regexp.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/regexp_assembler_ir.h"
 #include "vm/unit_test.h"
 
@@ -110,4 +111,75 @@ ISOLATE_UNIT_TEST_CASE(RegExp_ExternalTwoByteString) {
   EXPECT_EQ(3, smi_2.Value());
 }
 
+static RawInstance* InterpretMatch(const String& pat, const String& str) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  const bool old_interpret_irregexp = FLAG_interpret_irregexp;
+  FLAG_interpret_irregexp = true;
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  const Smi& idx = Object::smi_zero();
+  RawInstance* result = BytecodeRegExpMacroAssembler::Interpret(
+      regexp, str, idx, /*sticky=*/false, zone);
+  FLAG_interpret_irregexp = old_interpret_irregexp;
+  return result;
+}
+
+// Helper method to check the match of [pat] in the one-byte and two-byte
+// versions of [chars] against the expected bounds, or no match if
+// [expected_start] is negative.
+static void ExpectInterpretedMatch(const char* pat,
+                                   const uint8_t* chars,
+                                   intptr_t len,
+                                   intptr_t expected_start,
+                                   intptr_t expected_end) {
+  uint16_t* two_byte_chars = Thread::Current()->zone()->Alloc<uint16_t>(len);
+  for (intptr_t i = 0; i < len; i++) {
+    two_byte_chars[i] = chars[i];
+  }
+  const String& pattern = String::Handle(String::New(pat));
+  const String& one_byte =
+      String::Handle(OneByteString::New(chars, len, Heap::kNew));
+  const String& two_byte =
+      String::Handle(TwoByteString::New(two_byte_chars, len, Heap::kNew));
+  const String* subjects[] = {&one_byte, &two_byte};
+  Instance& res = Instance::Handle();
+  for (const String* subject : subjects) {
+    res = InterpretMatch(pattern, *subject);
+    if (expected_start < 0) {
+      EXPECT(res.IsNull());
+    } else {
+      EXPECT(res.IsTypedData());
+      EXPECT_EQ(expected_start, TypedData::Cast(res).GetInt32(0));
+      EXPECT_EQ(expected_end, TypedData::Cast(res).GetInt32(sizeof(int32_t)));
+    }
+  }
+}
+
+// The Boyer-Moore lookahead of these patterns skips over the long prefix of
+// the subject without a match with a single bytecode.
+ISOLATE_UNIT_TEST_CASE(RegExp_InterpreterSkipLoops) {
+  const intptr_t kLength = 1000;
+  uint8_t chars[kLength];
+  for (intptr_t i = 0; i < kLength; i++) {
+    chars[i] = 'a' + (i % 26);
+  }
+  ExpectInterpretedMatch("ERROR", chars, kLength, -1, -1);
+  ExpectInterpretedMatch("[0-9]+-[0-9]+", chars, kLength, -1, -1);
+
+  // Characters that only equal the literal modulo the table size must not
+  // stop the scan.
+  chars[100] = 'E' | 0x80;
+  chars[300] = 'E';
+  memmove(&chars[700], "ERROR", 5);
+  ExpectInterpretedMatch("ERROR", chars, kLength, 700, 705);
+
+  memmove(&chars[900], "12-345", 6);
+  ExpectInterpretedMatch("[0-9]+-[0-9]+", chars, kLength, 900, 906);
+
+  // A match that ends at the last character.
+  memmove(&chars[kLength - 5], "WARN!", 5);
+  ExpectInterpretedMatch("WARN!", chars, kLength, kLength - 5, kLength);
+}
+
 }  // namespace dart
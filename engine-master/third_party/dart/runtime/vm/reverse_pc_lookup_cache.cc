@@ -8,8 +8,6 @@
 
 namespace dart {
 
-#if defined(DART_PRECOMPILED_RUNTIME)
-
 static uword BeginPcFromCode(const RawCode* code) {
   auto instr = Code::InstructionsOf(code);
   return Instructions::PayloadStart(instr);
@@ -20,34 +18,39 @@ static uword EndPcFromCode(const RawCode* code) {
   return Instructions::PayloadStart(instr) + Instructions::Size(instr);
 }
 
+ReversePcLookupTable::ReversePcLookupTable(const Array& code_order_table) {
+  NoSafepointScope no_safepoint_scope;
+
+  length_ = code_order_table.Length();
+  first_absolute_pc_ =
+      BeginPcFromCode(reinterpret_cast<RawCode*>(code_order_table.At(0)));
+  last_absolute_pc_ = EndPcFromCode(
+      reinterpret_cast<RawCode*>(code_order_table.At(length_ - 1)));
+
+  auto pc_array = new uint32_t[length_];
+  for (intptr_t i = 0; i < length_; i++) {
+    const auto end_pc =
+        EndPcFromCode(reinterpret_cast<RawCode*>(code_order_table.At(i)));
+    pc_array[i] = end_pc - first_absolute_pc_;
+  }
+#if defined(DEBUG)
+  for (intptr_t i = 1; i < length_; i++) {
+    ASSERT(pc_array[i - 1] <= pc_array[i]);
+  }
+#endif  // defined(DEBUG)
+  pc_array_ = pc_array;
+}
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+
 void ReversePcLookupCache::BuildAndAttachToIsolate(Isolate* isolate) {
   auto object_store = isolate->object_store();
   auto& array = Array::Handle(object_store->code_order_table());
   if (!array.IsNull()) {
-    const intptr_t length = array.Length();
-    {
-      NoSafepointScope no_safepoint_scope;
-
-      const uword begin =
-          BeginPcFromCode(reinterpret_cast<RawCode*>(array.At(0)));
-      const uword end =
-          EndPcFromCode(reinterpret_cast<RawCode*>(array.At(length - 1)));
-
-      auto pc_array = new uint32_t[length];
-      for (intptr_t i = 0; i < length; i++) {
-        const auto end_pc =
-            EndPcFromCode(reinterpret_cast<RawCode*>(array.At(i)));
-        pc_array[i] = end_pc - begin;
-      }
-#if defined(DEBUG)
-      for (intptr_t i = 1; i < length; i++) {
-        ASSERT(pc_array[i - 1] <= pc_array[i]);
-      }
-#endif  // defined(DEBUG)
-      auto cache =
-          new ReversePcLookupCache(isolate, pc_array, length, begin, end);
-      isolate->set_reverse_pc_lookup_cache(cache);
-    }
+    const ReversePcLookupTable* table =
+        isolate->group()->GetOrBuildReversePcLookupTable(array);
+    isolate->set_reverse_pc_lookup_cache(
+        new ReversePcLookupCache(isolate, table));
   }
 }
 
@@ -14,6 +14,29 @@ namespace dart {
 
 class Isolate;
 
+// The pc_array of a [ReversePcLookupCache], which is owned by the isolate
+// group. Only the precompiled runtime builds code_order_tables, but the table
+// is available in all modes so that its sharing can be tested.
+class ReversePcLookupTable {
+ public:
+  // Builds the table for the given `code_order_table`.
+  explicit ReversePcLookupTable(const Array& code_order_table);
+  ~ReversePcLookupTable() { delete[] pc_array_; }
+
+  const uint32_t* pc_array() const { return pc_array_; }
+  intptr_t length() const { return length_; }
+  uword first_absolute_pc() const { return first_absolute_pc_; }
+  uword last_absolute_pc() const { return last_absolute_pc_; }
+
+ private:
+  uint32_t* pc_array_;
+  intptr_t length_;
+  uword first_absolute_pc_;
+  uword last_absolute_pc_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReversePcLookupTable);
+};
+
 #if defined(DART_PRECOMPILED_RUNTIME)
 
 // A cache for looking up a Code object based on pc (currently the cache is
@@ -40,20 +63,21 @@ class Isolate;
 // The lookup will then do a binary search in pc_array. The index can then be
 // used in the `code_order_table` of the object store.
 //
+// All isolates of an isolate group are loaded from the same snapshot, so
+// their `code_order_table`s list code for the same instructions in the same
+// order. The pc_array is therefore built once per isolate group (see
+// [ReversePcLookupTable]) and shared by the caches of its isolates.
+//
 // WARNING: This class cannot do memory allocation or handle allocation!
 class ReversePcLookupCache {
  public:
-  ReversePcLookupCache(Isolate* isolate,
-                       uint32_t* pc_array,
-                       intptr_t length,
-                       uword first_absolute_pc,
-                       uword last_absolute_pc)
+  ReversePcLookupCache(Isolate* isolate, const ReversePcLookupTable* table)
       : isolate_(isolate),
-        pc_array_(pc_array),
-        length_(length),
-        first_absolute_pc_(first_absolute_pc),
-        last_absolute_pc_(last_absolute_pc) {}
-  ~ReversePcLookupCache() { delete[] pc_array_; }
+        pc_array_(table->pc_array()),
+        length_(table->length()),
+        first_absolute_pc_(table->first_absolute_pc()),
+        last_absolute_pc_(table->last_absolute_pc()) {}
+  ~ReversePcLookupCache() {}
 
   // Builds a [ReversePcLookupCache] and attaches it to the isolate (if
   // `code_order_table` is non-`null`).
@@ -99,7 +123,7 @@ class ReversePcLookupCache {
 
  private:
   Isolate* isolate_;
-  uint32_t* pc_array_;
+  const uint32_t* pc_array_;
   intptr_t length_;
   uword first_absolute_pc_;
   uword last_absolute_pc_;
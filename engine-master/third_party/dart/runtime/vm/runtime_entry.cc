@@ -1937,6 +1937,24 @@ DEFINE_RUNTIME_ENTRY(MegamorphicCacheMissHandler, 3) {
                  ic_data_or_cache.IsICData() ? "icdata" : "cache",
                  cls.ToCString(), args_desc.TypeArgsLen(), name.ToCString());
   }
+  if (ic_data_or_cache.IsMegamorphicCache()) {
+    // The class may have been cached since the stub probed the cache, e.g.
+    // by a racing miss, or not migrated yet while the cache grows. Such hits
+    // need no resolution. Caches holding entry points instead of functions
+    // are resolved again.
+    const MegamorphicCache& cache = MegamorphicCache::Cast(ic_data_or_cache);
+    const Smi& class_id = Smi::Handle(zone, Smi::New(cls.id()));
+    const Object& cached = Object::Handle(zone, cache.Lookup(class_id));
+    if (cached.IsFunction()) {
+      // Move an entry which is only in the old buckets to where the stub
+      // probes. Otherwise the megamorphic mutex is not needed.
+      if (cache.old_buckets() != Array::null()) {
+        cache.Insert(class_id, cached);
+      }
+      arguments.SetReturn(cached);
+      return;
+    }
+  }
   Function& target_function = Function::Handle(
       zone, Resolver::ResolveDynamicForReceiverClass(cls, name, args_desc));
   if (target_function.IsNull()) {
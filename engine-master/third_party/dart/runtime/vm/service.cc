@@ -1480,6 +1480,16 @@ static bool GetMemoryUsage(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_gc_histograms_params[] = {
+    ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetGCHistograms(Thread* thread, JSONStream* js) {
+  thread->isolate()->heap()->PrintGCHistogramsJSON(js);
+  return true;
+}
+
 static const MethodParameter* get_isolate_group_memory_usage_params[] = {
     ISOLATE_GROUP_PARAMETER,
     NULL,
@@ -3934,6 +3944,39 @@ static bool GetNativeAllocationSamples(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_retained_allocation_samples_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetRetainedAllocationSamples(Thread* thread, JSONStream* js) {
+  thread->isolate()->heap()->allocation_sampler()->PrintRetainedJSON(js);
+  return true;
+}
+
+static const MethodParameter* set_allocation_sample_interval_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER,
+    new UIntParameter("interval", true),
+    new BoolParameter("reset", false),
+    NULL,
+};
+
+static bool SetAllocationSampleInterval(Thread* thread, JSONStream* js) {
+  const intptr_t interval = UIntParameter::Parse(js->LookupParam("interval"));
+  const bool reset = BoolParameter::Parse(js->LookupParam("reset"), false);
+  if (interval < 0) {
+    PrintInvalidParamError(js, "interval");
+    return true;
+  }
+  AllocationSampler* sampler = thread->isolate()->heap()->allocation_sampler();
+  if (reset) {
+    sampler->Clear();
+  }
+  sampler->SetInterval(interval);
+  PrintSuccess(js);
+  return true;
+}
+
 static const MethodParameter* clear_cpu_samples_params[] = {
     RUNNABLE_ISOLATE_PARAMETER,
     NULL,
@@ -4032,7 +4075,8 @@ static const MethodParameter* request_heap_snapshot_params[] = {
 
 static bool RequestHeapSnapshot(Thread* thread, JSONStream* js) {
   if (Service::heapsnapshot_stream.enabled()) {
-    HeapSnapshotWriter writer(thread);
+    VmServiceHeapSnapshotChunkedWriter vmservice_writer(thread);
+    HeapSnapshotWriter writer(thread, &vmservice_writer);
     writer.Write();
   }
   // TODO(koda): Provide some id that ties this request to async response(s).
@@ -4780,6 +4824,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_cpu_samples_params },
   { "getFlagList", GetFlagList,
     get_flag_list_params },
+  { "_getGCHistograms", GetGCHistograms,
+    get_gc_histograms_params },
   { "_getHeapMap", GetHeapMap,
     get_heap_map_params },
   { "getInboundReferences", GetInboundReferences,
@@ -4808,6 +4854,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_ports_params },
   { "_getReachableSize", GetReachableSize,
     get_reachable_size_params },
+  { "_getRetainedAllocationSamples", GetRetainedAllocationSamples,
+    get_retained_allocation_samples_params },
   { "_getRetainedSize", GetRetainedSize,
     get_retained_size_params },
   { "getRetainingPath", GetRetainingPath,
@@ -4852,6 +4900,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     request_heap_snapshot_params },
   { "_evaluateCompiledExpression", EvaluateCompiledExpression,
     evaluate_compiled_expression_params },
+  { "_setAllocationSampleInterval", SetAllocationSampleInterval,
+    set_allocation_sample_interval_params },
   { "setExceptionPauseMode", SetExceptionPauseMode,
     set_exception_pause_mode_params },
   { "setFlag", SetFlag,
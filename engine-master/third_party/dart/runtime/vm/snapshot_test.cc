@@ -22,6 +22,10 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, external_snapshot_string_length);
+DECLARE_FLAG(uint64_t, externalize_typed_data_threshold);
+DECLARE_FLAG(bool, parallel_snapshot_fill);
+
 // Check if serialized and deserialized objects are equal.
 static bool Equals(const Object& expected, const Object& actual) {
   if (expected.IsNull()) {
@@ -698,7 +702,52 @@ ISOLATE_UNIT_TEST_CASE(SerializeEmptyByteArray) {
   CheckEncodeDecodeMessage(root);
 }
 
-VM_UNIT_TEST_CASE(FullSnapshot) {
+ISOLATE_UNIT_TEST_CASE(SerializeLargeByteArray) {
+  // Write snapshot with a byte array that is large enough to be sent as
+  // external typed data.
+  const intptr_t kTypedDataLength = 64 * KB;
+  SetFlagScope<uint64_t> sfs(&FLAG_externalize_typed_data_threshold,
+                             kTypedDataLength);
+  TypedData& typed_data = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid, kTypedDataLength));
+  for (intptr_t i = 0; i < kTypedDataLength; i++) {
+    typed_data.SetUint8(i, i & 0xFF);
+  }
+  MessageWriter writer(true);
+  std::unique_ptr<Message> message =
+      writer.WriteMessage(typed_data, ILLEGAL_PORT, Message::kNormalPriority);
+
+  // The contents are not part of the snapshot.
+  EXPECT_LT(message->snapshot_length(), kTypedDataLength);
+  EXPECT_EQ(kTypedDataLength, message->finalizable_data()->external_size());
+
+  // Read object back from the snapshot into a C structure.
+  {
+    ApiNativeScope scope;
+    ApiMessageReader api_reader(message.get());
+    Dart_CObject* root = api_reader.ReadMessage();
+    EXPECT_EQ(Dart_CObject_kTypedData, root->type);
+    EXPECT_EQ(Dart_TypedData_kUint8, root->value.as_typed_data.type);
+    EXPECT_EQ(kTypedDataLength, root->value.as_typed_data.length);
+    for (intptr_t i = 0; i < kTypedDataLength; i++) {
+      EXPECT_EQ(i & 0xFF, root->value.as_typed_data.values[i]);
+    }
+  }
+
+  // Read object back from the snapshot. The receiver adopts the contents.
+  MessageSnapshotReader reader(message.get(), thread);
+  ExternalTypedData& serialized_typed_data = ExternalTypedData::Handle();
+  serialized_typed_data ^= reader.ReadObject();
+  EXPECT(serialized_typed_data.IsExternalTypedData());
+  EXPECT_EQ(kExternalTypedDataUint8ArrayCid,
+            serialized_typed_data.GetClassId());
+  EXPECT_EQ(kTypedDataLength, serialized_typed_data.Length());
+  for (intptr_t i = 0; i < kTypedDataLength; i++) {
+    EXPECT_EQ(i & 0xFF, serialized_typed_data.GetUint8(i));
+  }
+}
+
+static void TestFullSnapshot() {
   const char* kScriptChars =
       "class Fields  {\n"
       "  Fields(int i, int j) : fld1 = i, fld2 = j {}\n"
@@ -775,6 +824,147 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+VM_UNIT_TEST_CASE(FullSnapshot) {
+  TestFullSnapshot();
+}
+
+VM_UNIT_TEST_CASE(FullSnapshotParallelFill) {
+  SetFlagScope<bool> sfs(&FLAG_parallel_snapshot_fill, true);
+  TestFullSnapshot();
+}
+
+// Each external typed data is padded to ExternalTypedData's serialization
+// alignment, which a parallel fill must compute from the start of the
+// snapshot rather than the start of the cluster's section.
+VM_UNIT_TEST_CASE(FullSnapshotParallelFillExternalTypedData) {
+  const char* kScriptChars =
+      "var data;\n"
+      "sum() {\n"
+      "  var result = 0;\n"
+      "  for (var list in data) {\n"
+      "    for (var i = 0; i < list.length; i++) {\n"
+      "      result += list[i] * (i + 1);\n"
+      "    }\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n";
+  const intptr_t kNumLists = 300;
+  const intptr_t kMaxLength = 7;
+  SetFlagScope<bool> sfs(&FLAG_parallel_snapshot_fill, true);
+
+  // Odd lengths make most of the lists need padding.
+  uint8_t bytes[kNumLists][kMaxLength];
+  int64_t expected_sum = 0;
+  for (intptr_t i = 0; i < kNumLists; i++) {
+    for (intptr_t j = 0; j < kMaxLength; j++) {
+      bytes[i][j] = static_cast<uint8_t>(i + j);
+      if (j <= i % kMaxLength) {
+        expected_sum += bytes[i][j] * (j + 1);
+      }
+    }
+  }
+
+  uint8_t* isolate_snapshot_data_buffer;
+  {
+    TestIsolateScope __test_isolate__;
+    Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+    Dart_EnterScope();
+    Dart_Handle lists = Dart_NewList(kNumLists);
+    EXPECT_VALID(lists);
+    for (intptr_t i = 0; i < kNumLists; i++) {
+      Dart_Handle list = Dart_NewExternalTypedData(
+          Dart_TypedData_kUint8, bytes[i], (i % kMaxLength) + 1);
+      EXPECT_VALID(list);
+      EXPECT_VALID(Dart_ListSetAt(lists, i, list));
+    }
+    EXPECT_VALID(Dart_SetField(lib, NewString("data"), lists));
+    Dart_ExitScope();
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+
+    Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+    {
+      TransitionVMToNative to_native(thread);
+      EXPECT_VALID(result);
+    }
+    FullSnapshotWriter writer(Snapshot::kFull, NULL,
+                              &isolate_snapshot_data_buffer, &malloc_allocator,
+                              NULL, /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+  }
+
+  TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  {
+    Dart_EnterScope();
+    Dart_Handle result = Dart_Invoke(TestCase::lib(), NewString("sum"), 0,
+                                     NULL);
+    EXPECT_VALID(result);
+    int64_t sum = 0;
+    EXPECT_VALID(Dart_IntegerToInt64(result, &sum));
+    EXPECT_EQ(expected_sum, sum);
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(isolate_snapshot_data_buffer);
+}
+
+VM_UNIT_TEST_CASE(FullSnapshotExternalStrings) {
+  const char* kScriptChars =
+      "final long = 'This constant string is long enough to be read as an "
+      "external string.';\n"
+      "getLong() => long;\n"
+      "getShort() => 'short';\n";
+  SetFlagScope<int> sfs(&FLAG_external_snapshot_string_length, 32);
+
+  uint8_t* isolate_snapshot_data_buffer;
+  {
+    TestIsolateScope __test_isolate__;
+    Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+    // Initialize the field so that its value is in the snapshot.
+    EXPECT_VALID(Dart_Invoke(lib, NewString("getLong"), 0, NULL));
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+
+    Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+    {
+      TransitionVMToNative to_native(thread);
+      EXPECT_VALID(result);
+    }
+    FullSnapshotWriter writer(Snapshot::kFull, NULL,
+                              &isolate_snapshot_data_buffer, &malloc_allocator,
+                              NULL, /*image_writer*/ nullptr);
+    writer.WriteFullSnapshot();
+  }
+
+  TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  {
+    Dart_EnterScope();
+    Dart_Handle result = Dart_Invoke(TestCase::lib(), NewString("getLong"), 0,
+                                     NULL);
+    EXPECT_VALID(result);
+    EXPECT(Dart_IsExternalString(result));
+    const char* value;
+    EXPECT_VALID(Dart_StringToCString(result, &value));
+    EXPECT_STREQ(
+        "This constant string is long enough to be read as an external "
+        "string.",
+        value);
+
+    result = Dart_Invoke(TestCase::lib(), NewString("getShort"), 0, NULL);
+    EXPECT_VALID(result);
+    EXPECT(!Dart_IsExternalString(result));
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(isolate_snapshot_data_buffer);
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
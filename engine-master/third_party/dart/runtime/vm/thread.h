@@ -237,6 +237,7 @@ class Thread : public ThreadState {
     kMarkerTask = 0x4,
     kSweeperTask = 0x8,
     kCompactorTask = 0x10,
+    kScavengerTask = 0x20,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -488,6 +489,13 @@ class Thread : public ThreadState {
   static intptr_t top_offset() { return OFFSET_OF(Thread, top_); }
   static intptr_t end_offset() { return OFFSET_OF(Thread, end_); }
 
+  // The block of old-space data memory reserved for this thread's
+  // allocations. See PageSpace::TryAllocateDataCached.
+  uword old_space_top() const { return old_space_top_; }
+  uword old_space_end() const { return old_space_end_; }
+  void set_old_space_top(uword value) { old_space_top_ = value; }
+  void set_old_space_end(uword value) { old_space_end_ = value; }
+
   bool bump_allocate() const { return bump_allocate_; }
   void set_bump_allocate(bool b) { bump_allocate_ = b; }
 
@@ -925,6 +933,8 @@ class Thread : public ThreadState {
   uint16_t deferred_interrupts_;
   int32_t stack_overflow_count_;
   bool bump_allocate_;
+  uword old_space_top_ = 0;
+  uword old_space_end_ = 0;
 
   // Compiler state:
   CompilerState* compiler_state_ = nullptr;
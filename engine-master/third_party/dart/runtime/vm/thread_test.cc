@@ -35,6 +35,15 @@ VM_UNIT_TEST_CASE(Mutex) {
   delete mutex;
 }
 
+VM_UNIT_TEST_CASE(TaskKindToCString) {
+  EXPECT_STREQ("kMutatorTask",
+               Thread::TaskKindToCString(Thread::kMutatorTask));
+  EXPECT_STREQ("kCompactorTask",
+               Thread::TaskKindToCString(Thread::kCompactorTask));
+  EXPECT_STREQ("kScavengerTask",
+               Thread::TaskKindToCString(Thread::kScavengerTask));
+}
+
 VM_UNIT_TEST_CASE(Monitor) {
   // This unit test case needs a running isolate.
   TestCase::CreateTestIsolate();
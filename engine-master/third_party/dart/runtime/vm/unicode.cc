@@ -115,10 +115,29 @@ intptr_t Utf8::Encode(const String& src, char* dst, intptr_t len) {
     }
   } else {
     // For two-byte strings, which can contain 3 and 4-byte UTF-8 encodings,
-    // which can result in surrogate pairs, use the more general code.
-    String::CodePointIterator it(src);
-    while (it.Next()) {
-      int32_t ch = it.Current();
+    // which can result in surrogate pairs, use the more general code, except
+    // for runs of ASCII characters, which are copied a block at a time.
+    const uint16_t* data;
+    NoSafepointScope scope;
+    if (src.IsTwoByteString()) {
+      data = TwoByteString::DataStart(src);
+    } else {
+      data = ExternalTwoByteString::DataStart(src);
+    }
+    const intptr_t char_length = src.Length();
+    intptr_t i = 0;
+    while (i < char_length) {
+      if (data[i] <= kMaxOneByteChar) {
+        const intptr_t num_chars =
+            EncodeAscii(&data[i], char_length - i, &dst[pos], len - pos);
+        if (num_chars == 0) {
+          break;
+        }
+        i += num_chars;
+        pos += num_chars;
+        continue;
+      }
+      int32_t ch = Utf16::Next(data, &i, char_length);
       intptr_t num_bytes = Utf8::Length(ch);
       if (pos + num_bytes > len) {
         break;
@@ -27,6 +27,77 @@ ISOLATE_UNIT_TEST_CASE(Utf8Encode) {
   }
 }
 
+// Exercises the block-at-a-time fast paths, which need inputs longer than a
+// block with non-ASCII characters at unaligned positions.
+ISOLATE_UNIT_TEST_CASE(Utf8LongInput) {
+  const char* kAscii = "The quick brown fox jumps over the lazy dog. ";
+  const char* kLatin1 = "\xC3\xA9";                  // U+00E9
+  const char* kBmp = "\xE2\x82\xAC";                 // U+20AC
+  const char* kSupplementary = "\xF0\x9F\x98\x80";  // U+1F600
+
+  // Latin-1.
+  {
+    char src[256];
+    Utils::SNPrint(src, sizeof(src), "%s%s%s%s", kAscii, kLatin1, kAscii,
+                   kAscii);
+    const uint8_t* utf8 = reinterpret_cast<const uint8_t*>(src);
+    const intptr_t utf8_len = strlen(src);
+    EXPECT(Utf8::IsValid(utf8, utf8_len));
+    Utf8::Type type;
+    const intptr_t len = Utf8::CodeUnitCount(utf8, utf8_len, &type);
+    EXPECT_EQ(Utf8::kLatin1, type);
+    EXPECT_EQ(utf8_len - 1, len);
+    uint8_t dst[256];
+    EXPECT(Utf8::DecodeToLatin1(utf8, utf8_len, dst, len));
+    const intptr_t ascii_len = strlen(kAscii);
+    EXPECT(!memcmp(kAscii, dst, ascii_len));
+    EXPECT_EQ(0xE9, dst[ascii_len]);
+    EXPECT(!memcmp(kAscii, &dst[ascii_len + 1], ascii_len));
+    EXPECT(!Utf8::DecodeToLatin1(utf8, utf8_len, dst, len - 1));
+  }
+
+  // BMP and supplementary characters.
+  {
+    char src[256];
+    Utils::SNPrint(src, sizeof(src), "%s%s%s%s%s", kAscii, kBmp, kAscii,
+                   kSupplementary, kAscii);
+    const uint8_t* utf8 = reinterpret_cast<const uint8_t*>(src);
+    const intptr_t utf8_len = strlen(src);
+    EXPECT(Utf8::IsValid(utf8, utf8_len));
+    Utf8::Type type;
+    const intptr_t len = Utf8::CodeUnitCount(utf8, utf8_len, &type);
+    EXPECT_EQ(Utf8::kSupplementary, type);
+    const intptr_t ascii_len = strlen(kAscii);
+    EXPECT_EQ(3 * ascii_len + 3, len);
+    uint16_t dst[256];
+    EXPECT(Utf8::DecodeToUTF16(utf8, utf8_len, dst, len));
+    EXPECT_EQ(0x20AC, dst[ascii_len]);
+    EXPECT_EQ(0xD83D, dst[2 * ascii_len + 1]);
+    EXPECT_EQ(0xDE00, dst[2 * ascii_len + 2]);
+    for (intptr_t i = 0; i < ascii_len; i++) {
+      EXPECT_EQ(kAscii[i], dst[i]);
+      EXPECT_EQ(kAscii[i], dst[ascii_len + 1 + i]);
+      EXPECT_EQ(kAscii[i], dst[2 * ascii_len + 3 + i]);
+    }
+
+    // Encoding the decoded string gives back the input.
+    const String& str = String::Handle(String::FromUTF16(dst, len));
+    EXPECT_EQ(utf8_len, Utf8::Length(str));
+    char encoded[256];
+    EXPECT_EQ(utf8_len, Utf8::Encode(str, encoded, sizeof(encoded)));
+    EXPECT(!memcmp(src, encoded, utf8_len));
+  }
+
+  // An invalid byte after a long run of ASCII characters.
+  {
+    char src[256];
+    Utils::SNPrint(src, sizeof(src), "%s%s", kAscii, kAscii);
+    src[strlen(kAscii) + 3] = static_cast<char>(0xFF);
+    const uint8_t* utf8 = reinterpret_cast<const uint8_t*>(src);
+    EXPECT(!Utf8::IsValid(utf8, strlen(src)));
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(Utf8InvalidByte) {
   {
     uint8_t array[] = {0x41, 0xF0, 0x92};